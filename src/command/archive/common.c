@@ -30,6 +30,8 @@ STRING_EXTERN(WAL_SEGMENT_PARTIAL_REGEXP_STR,                       WAL_SEGMENT_
 STRING_EXTERN(WAL_SEGMENT_DIR_REGEXP_STR,                           WAL_SEGMENT_DIR_REGEXP);
 STRING_EXTERN(WAL_SEGMENT_FILE_REGEXP_STR,                          WAL_SEGMENT_FILE_REGEXP);
 STRING_EXTERN(WAL_TIMELINE_HISTORY_REGEXP_STR,                      WAL_TIMELINE_HISTORY_REGEXP);
+STRING_EXTERN(WAL_BUNDLE_FILE_REGEXP_STR,                           WAL_BUNDLE_FILE_REGEXP);
+STRING_EXTERN(WAL_ARCHIVE_FILE_REGEXP_STR,                          WAL_ARCHIVE_FILE_REGEXP);
 
 /***********************************************************************************************************************************
 Global error file constant
@@ -40,6 +42,51 @@ STRING_STATIC(STATUS_FILE_GLOBAL_STR,                               STATUS_FILE_
 #define STATUS_FILE_GLOBAL_ERROR                                    STATUS_FILE_GLOBAL STATUS_EXT_ERROR
 STRING_STATIC(STATUS_FILE_GLOBAL_ERROR_STR,                         STATUS_FILE_GLOBAL_ERROR);
 
+/***********************************************************************************************************************************
+Local variables
+***********************************************************************************************************************************/
+typedef struct ArchiveSegmentListCache
+{
+    unsigned int repoIdx;                                           // Repository index
+    const String *archiveId;                                        // ArchiveId in the repo
+    const String *path;                                             // WAL segment path in the archiveId
+    StringList *fileList;                                           // Sorted list of WAL segment files in the path
+} ArchiveSegmentListCache;
+
+static struct ArchiveLocal
+{
+    MemContext *memContext;                                         // Mem context for the segment list and bundle index caches
+    List *segmentListCache;                                         // WAL segment lists cached per repo/archiveId/path
+    const Storage *bundleIndexStorage;                              // Storage of the cached bundle index
+    String *bundleIndexPathFile;                                    // Bundle of the cached bundle index
+    List *bundleIndex;                                              // Index of the bundle read most recently (WalBundleSegment)
+} archiveLocal;
+
+/***********************************************************************************************************************************
+Create the mem context for local variables
+***********************************************************************************************************************************/
+static void
+archiveLocalInit(void)
+{
+    FUNCTION_TEST_VOID();
+
+    if (archiveLocal.memContext == NULL)
+    {
+        MEM_CONTEXT_BEGIN(memContextTop())
+        {
+            MEM_CONTEXT_NEW_BEGIN(ArchiveLocal, .childQty = MEM_CONTEXT_QTY_MAX)
+            {
+                archiveLocal.memContext = MEM_CONTEXT_NEW();
+                archiveLocal.segmentListCache = lstNewP(sizeof(ArchiveSegmentListCache));
+            }
+            MEM_CONTEXT_NEW_END();
+        }
+        MEM_CONTEXT_END();
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Get the correct spool queue based on the archive mode
 ***********************************************************************************************************************************/
@@ -306,6 +353,73 @@ archiveIdComparator(const void *const archiveId1, const void *const archiveId2)
     return LST_COMPARATOR_CMP(id1, id2);
 }
 
+/**********************************************************************************************************************************/
+FN_EXTERN const StringList *
+archiveSegmentList(const unsigned int repoIdx, const String *const archiveId, const String *const path, const bool refresh)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(UINT, repoIdx);
+        FUNCTION_LOG_PARAM(STRING, archiveId);
+        FUNCTION_LOG_PARAM(STRING, path);
+        FUNCTION_LOG_PARAM(BOOL, refresh);
+    FUNCTION_LOG_END();
+
+    ASSERT(archiveId != NULL);
+    ASSERT(path != NULL);
+
+    archiveLocalInit();
+
+    // Find the path in the cache
+    ArchiveSegmentListCache *cache = NULL;
+
+    for (unsigned int cacheIdx = 0; cacheIdx < lstSize(archiveLocal.segmentListCache); cacheIdx++)
+    {
+        ArchiveSegmentListCache *const cacheFind = lstGet(archiveLocal.segmentListCache, cacheIdx);
+
+        if (cacheFind->repoIdx == repoIdx && strEq(cacheFind->archiveId, archiveId) && strEq(cacheFind->path, path))
+        {
+            cache = cacheFind;
+            break;
+        }
+    }
+
+    // List the path if it is not cached or a refresh was requested
+    if (cache == NULL || refresh)
+    {
+        MEM_CONTEXT_BEGIN(lstMemContext(archiveLocal.segmentListCache))
+        {
+            StringList *const fileList = strLstSort(
+                storageListP(
+                    storageRepoIdx(repoIdx), strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(archiveId), strZ(path)),
+                    .expression = strNewFmt(
+                        "^%s[0-F]{8}-([0-f]{40}|%s[0-F]{8}\\" WAL_BUNDLE_EXT ")" COMPRESS_TYPE_REGEXP "{0,1}$", strZ(path),
+                        strZ(path))),
+                sortOrderAsc);
+
+            if (cache == NULL)
+            {
+                const ArchiveSegmentListCache cacheNew =
+                {
+                    .repoIdx = repoIdx,
+                    .archiveId = strDup(archiveId),
+                    .path = strDup(path),
+                    .fileList = fileList,
+                };
+
+                cache = lstAdd(archiveLocal.segmentListCache, &cacheNew);
+            }
+            else
+            {
+                strLstFree(cache->fileList);
+                cache->fileList = fileList;
+            }
+        }
+        MEM_CONTEXT_END();
+    }
+
+    FUNCTION_LOG_RETURN_CONST(STRING_LIST, cache->fileList);
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN bool
 walIsPartial(const String *const walSegment)
@@ -485,3 +599,362 @@ walSegmentRange(
 
     FUNCTION_LOG_RETURN(STRING_LIST, result);
 }
+
+/**********************************************************************************************************************************/
+FN_EXTERN String *
+walSegmentExpression(const String *const walSegment)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, walSegment);
+    FUNCTION_TEST_END();
+
+    ASSERT(walSegment != NULL);
+    ASSERT(walIsSegment(walSegment));
+
+    // Partial segments are never bundled
+    if (walIsPartial(walSegment))
+    {
+        FUNCTION_TEST_RETURN(
+            STRING,
+            strNewFmt(
+                "^%.24s" WAL_SEGMENT_PARTIAL_EXT "-[0-f]{40}" COMPRESS_TYPE_REGEXP "{0,1}$", strZ(walSegment)));
+    }
+
+    // Else match the segment or any bundle in the directory. Bundles that do not contain the segment are filtered by the caller.
+    const char *const walSegmentZ = strZ(walSegment);
+    String *const result = strNewFmt(
+        "^%.16s(%.8s-[0-f]{40}|[0-F]{8}-%.16s[0-F]{8}\\" WAL_BUNDLE_EXT ")" COMPRESS_TYPE_REGEXP "{0,1}$", walSegmentZ,
+        walSegmentZ + 16, walSegmentZ);
+
+    FUNCTION_TEST_RETURN(STRING, result);
+}
+
+/***********************************************************************************************************************************
+Get the index of a WAL bundle. The index of the bundle read most recently is kept since the checksum and each segment are usually
+requested from the same bundle in turn. Bundles are never modified once written so the index does not need to be read again.
+***********************************************************************************************************************************/
+static const List *
+walBundleIndexCache(const Storage *const storage, const String *const bundlePathFile, const bool ignoreMissing)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, storage);
+        FUNCTION_LOG_PARAM(STRING, bundlePathFile);
+        FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
+    FUNCTION_LOG_END();
+
+    ASSERT(storage != NULL);
+    ASSERT(bundlePathFile != NULL);
+
+    const List *result = archiveLocal.bundleIndex;
+
+    if (archiveLocal.bundleIndex == NULL || storage != archiveLocal.bundleIndexStorage ||
+        !strEq(bundlePathFile, archiveLocal.bundleIndexPathFile))
+    {
+        archiveLocalInit();
+
+        MEM_CONTEXT_BEGIN(archiveLocal.memContext)
+        {
+            List *const index = walBundleIndex(storage, bundlePathFile, ignoreMissing);
+
+            // A missing bundle is not cached so it will be checked again on the next request
+            if (index != NULL)
+            {
+                lstFree(archiveLocal.bundleIndex);
+                strFree(archiveLocal.bundleIndexPathFile);
+
+                archiveLocal.bundleIndexStorage = storage;
+                archiveLocal.bundleIndexPathFile = strDup(bundlePathFile);
+                archiveLocal.bundleIndex = index;
+            }
+
+            result = index;
+        }
+        MEM_CONTEXT_END();
+    }
+
+    FUNCTION_LOG_RETURN_CONST(LIST, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN String *
+walArchiveFileChecksum(const Storage *const storage, const String *const archivePathFile, const String *const walSegment)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, storage);
+        FUNCTION_LOG_PARAM(STRING, archivePathFile);
+        FUNCTION_LOG_PARAM(STRING, walSegment);
+    FUNCTION_LOG_END();
+
+    ASSERT(storage != NULL);
+    ASSERT(archivePathFile != NULL);
+    ASSERT(walSegment != NULL);
+
+    String *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const String *const archiveFile = strBase(archivePathFile);
+
+        // If a bundle then get the checksum from the index
+        if (walIsBundle(archiveFile))
+        {
+            const List *const index = walBundleIndexCache(storage, archivePathFile, false);
+            const WalBundleSegment *const segment = lstFind(index, &walSegment);
+            ASSERT(segment != NULL);
+
+            MEM_CONTEXT_PRIOR_BEGIN()
+            {
+                result = strDup(segment->checksum);
+            }
+            MEM_CONTEXT_PRIOR_END();
+        }
+        // Else get the checksum from the file name
+        else
+        {
+            MEM_CONTEXT_PRIOR_BEGIN()
+            {
+                result = strSubN(archiveFile, strSize(walSegment) + 1, HASH_TYPE_SHA1_SIZE_HEX);
+            }
+            MEM_CONTEXT_PRIOR_END();
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(STRING, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN StorageRead *
+walSegmentReadNew(
+    const Storage *const storage, const String *const archivePathFile, const String *const walSegment, const bool compressible,
+    const bool ignoreMissing)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, storage);
+        FUNCTION_LOG_PARAM(STRING, archivePathFile);
+        FUNCTION_LOG_PARAM(STRING, walSegment);
+        FUNCTION_LOG_PARAM(BOOL, compressible);
+        FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
+    FUNCTION_LOG_END();
+
+    ASSERT(storage != NULL);
+    ASSERT(archivePathFile != NULL);
+    ASSERT(walSegment != NULL);
+
+    StorageRead *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // If a bundle then limit the read to the segment
+        if (walIsBundle(strBase(archivePathFile)))
+        {
+            const List *const index = walBundleIndexCache(storage, archivePathFile, ignoreMissing);
+
+            if (index != NULL)
+            {
+                const WalBundleSegment *const segment = lstFind(index, &walSegment);
+                ASSERT(segment != NULL);
+
+                MEM_CONTEXT_PRIOR_BEGIN()
+                {
+                    result = storageNewReadP(
+                        storage, archivePathFile, .compressible = compressible, .offset = segment->offset,
+                        .limit = VARUINT64(segment->size));
+                }
+                MEM_CONTEXT_PRIOR_END();
+            }
+        }
+        // Else read the entire file
+        else
+        {
+            MEM_CONTEXT_PRIOR_BEGIN()
+            {
+                result = storageNewReadP(storage, archivePathFile, .compressible = compressible, .ignoreMissing = ignoreMissing);
+            }
+            MEM_CONTEXT_PRIOR_END();
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(STORAGE_READ, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN bool
+walIsBundle(const String *const archiveFile)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, archiveFile);
+    FUNCTION_TEST_END();
+
+    ASSERT(archiveFile != NULL);
+
+    // Create the regular expression to identify WAL bundles if it does not already exist
+    static RegExp *regExpBundle = NULL;
+
+    if (regExpBundle == NULL)
+    {
+        MEM_CONTEXT_BEGIN(memContextTop())
+        {
+            regExpBundle = regExpNew(WAL_BUNDLE_FILE_REGEXP_STR);
+        }
+        MEM_CONTEXT_END();
+    }
+
+    FUNCTION_TEST_RETURN(BOOL, regExpMatch(regExpBundle, archiveFile));
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN bool
+walBundleContains(const String *const bundleFile, const String *const walSegment)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, bundleFile);
+        FUNCTION_TEST_PARAM(STRING, walSegment);
+    FUNCTION_TEST_END();
+
+    ASSERT(bundleFile != NULL);
+    ASSERT(walIsBundle(bundleFile));
+    ASSERT(walSegment != NULL);
+
+    // Bundles only contain complete segments in a single directory, so a fixed-width comparison is enough
+    FUNCTION_TEST_RETURN(
+        BOOL,
+        strSize(walSegment) == WAL_SEGMENT_NAME_SIZE && strncmp(strZ(bundleFile), strZ(walSegment), WAL_SEGMENT_NAME_SIZE) <= 0 &&
+        strncmp(strZ(bundleFile) + WAL_SEGMENT_NAME_SIZE + 1, strZ(walSegment), WAL_SEGMENT_NAME_SIZE) >= 0);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN String *
+walArchiveFileStop(const String *const archiveFile)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, archiveFile);
+    FUNCTION_TEST_END();
+
+    ASSERT(archiveFile != NULL);
+
+    FUNCTION_TEST_RETURN(
+        STRING, strSubN(archiveFile, walIsBundle(archiveFile) ? WAL_SEGMENT_NAME_SIZE + 1 : 0, WAL_SEGMENT_NAME_SIZE));
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN StringList *
+walBundleSegmentList(const String *const bundleFile)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, bundleFile);
+    FUNCTION_TEST_END();
+
+    ASSERT(bundleFile != NULL);
+    ASSERT(walIsBundle(bundleFile));
+
+    StringList *const result = strLstNew();
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // The path is the same for all segments so only the last eight characters need to be incremented
+        const String *const path = strSubN(bundleFile, 0, 16);
+        const uint32_t begin = (uint32_t)strtoul(strZ(strSubN(bundleFile, 16, 8)), NULL, 16);
+        const uint32_t end = (uint32_t)strtoul(strZ(strSubN(bundleFile, WAL_SEGMENT_NAME_SIZE + 1 + 16, 8)), NULL, 16);
+
+        for (uint32_t segmentIdx = begin; segmentIdx <= end; segmentIdx++)
+            strLstAddFmt(result, "%s%08X", strZ(path), segmentIdx);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(STRING_LIST, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+walBundleIndexAdd(Buffer *const index, const Buffer *const checksum, const uint64_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BUFFER, index);
+        FUNCTION_TEST_PARAM(BUFFER, checksum);
+        FUNCTION_TEST_PARAM(UINT64, size);
+    FUNCTION_TEST_END();
+
+    ASSERT(index != NULL);
+    ASSERT(checksum != NULL);
+    ASSERT(bufUsed(checksum) == HASH_TYPE_SHA1_SIZE);
+
+    bufCat(index, checksum);
+
+    // Store the size big-endian so the index is portable
+    uint8_t sizeBuffer[sizeof(uint64_t)];
+
+    for (unsigned int byteIdx = 0; byteIdx < sizeof(uint64_t); byteIdx++)
+        sizeBuffer[byteIdx] = (uint8_t)(size >> ((sizeof(uint64_t) - byteIdx - 1) * 8));
+
+    bufCatC(index, sizeBuffer, 0, sizeof(sizeBuffer));
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN List *
+walBundleIndex(const Storage *const storage, const String *const bundlePathFile, const bool ignoreMissing)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, storage);
+        FUNCTION_LOG_PARAM(STRING, bundlePathFile);
+        FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
+    FUNCTION_LOG_END();
+
+    ASSERT(storage != NULL);
+    ASSERT(bundlePathFile != NULL);
+
+    List *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // The number of entries in the index is determined by the bundle name
+        const StringList *const segmentList = walBundleSegmentList(strBase(bundlePathFile));
+        const size_t indexSize = strLstSize(segmentList) * WAL_BUNDLE_INDEX_ENTRY_SIZE;
+
+        const Buffer *const index = storageGetP(
+            storageNewReadP(storage, bundlePathFile, .ignoreMissing = ignoreMissing, .limit = VARUINT64(indexSize)),
+            .exactSize = indexSize);
+
+        if (index != NULL)
+        {
+            MEM_CONTEXT_PRIOR_BEGIN()
+            {
+                result = lstNewP(sizeof(WalBundleSegment), .sortOrder = sortOrderAsc, .comparator = lstComparatorStr);
+
+                MEM_CONTEXT_BEGIN(lstMemContext(result))
+                {
+                    // Segments are stored after the index
+                    uint64_t offset = indexSize;
+
+                    for (unsigned int segmentIdx = 0; segmentIdx < strLstSize(segmentList); segmentIdx++)
+                    {
+                        const unsigned char *const entry = bufPtrConst(index) + segmentIdx * WAL_BUNDLE_INDEX_ENTRY_SIZE;
+                        uint64_t size = 0;
+
+                        for (unsigned int byteIdx = 0; byteIdx < sizeof(uint64_t); byteIdx++)
+                            size = (size << 8) | entry[HASH_TYPE_SHA1_SIZE + byteIdx];
+
+                        const WalBundleSegment segment =
+                        {
+                            .segment = strDup(strLstGet(segmentList, segmentIdx)),
+                            .checksum = strNewEncode(encodingHex, BUF(entry, HASH_TYPE_SHA1_SIZE)),
+                            .offset = offset,
+                            .size = size,
+                        };
+
+                        lstAdd(result, &segment);
+                        offset += size;
+                    }
+                }
+                MEM_CONTEXT_END();
+            }
+            MEM_CONTEXT_PRIOR_END();
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(LIST, result);
+}
@@ -20,6 +20,7 @@ typedef enum
 } ArchiveMode;
 
 #include "common/compress/helper.h"
+#include "common/crypto/hash.h"
 #include "common/type/stringList.h"
 #include "storage/storage.h"
 
@@ -62,6 +63,38 @@ STRING_DECLARE(WAL_SEGMENT_FILE_REGEXP_STR);
 #define WAL_TIMELINE_HISTORY_REGEXP                                 "^[0-F]{8}.history$"
 STRING_DECLARE(WAL_TIMELINE_HISTORY_REGEXP_STR);
 
+/***********************************************************************************************************************************
+WAL bundle constants
+
+Consecutive WAL segments in the same WAL segment directory may be stored in a single bundle named for the first and last segments,
+e.g. 000000010000000100000001-000000010000000100000010.bundle.gz. The bundle begins with an index that contains the sha1 checksum
+and repo size (big-endian) of each segment, followed by the segments in order. Each segment is compressed and encrypted separately
+so it can be read from the bundle with a range read.
+***********************************************************************************************************************************/
+#define WAL_BUNDLE_EXT                                              ".bundle"
+
+// Size of a bundle index entry
+#define WAL_BUNDLE_INDEX_ENTRY_SIZE                                 (HASH_TYPE_SHA1_SIZE + sizeof(uint64_t))
+
+// WAL bundle file
+#define WAL_BUNDLE_FILE_REGEXP                                                                                                     \
+    "^[0-F]{24}-[0-F]{24}\\" WAL_BUNDLE_EXT COMPRESS_TYPE_REGEXP "{0,1}$"
+STRING_DECLARE(WAL_BUNDLE_FILE_REGEXP_STR);
+
+// WAL segment or bundle file
+#define WAL_ARCHIVE_FILE_REGEXP                                                                                                    \
+    "^[0-F]{24}-([0-f]{40}|[0-F]{24}\\" WAL_BUNDLE_EXT ")" COMPRESS_TYPE_REGEXP "{0,1}$"
+STRING_DECLARE(WAL_ARCHIVE_FILE_REGEXP_STR);
+
+// Segment stored in a WAL bundle
+typedef struct WalBundleSegment
+{
+    const String *segment;                                          // WAL segment name
+    const String *checksum;                                         // Segment checksum
+    uint64_t offset;                                                // Offset of the segment in the bundle
+    uint64_t size;                                                  // Size of the segment in the bundle
+} WalBundleSegment;
+
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
@@ -85,6 +118,11 @@ FN_EXTERN void archiveAsyncExec(ArchiveMode archiveMode, const StringList *comma
 // Comparator function for sorting archive ids by the database history id (the number after the dash) e.g. 9.4-1, 10-2
 FN_EXTERN int archiveIdComparator(const void *item1, const void *item2);
 
+// Get a sorted list of the WAL segment files in an archive path of a repo, e.g. 0000000100000001. The list is cached for the life
+// of the process so each path is only listed once. Set refresh to list the path again, e.g. when a segment may have been archived
+// after the path was cached.
+FN_EXTERN const StringList *archiveSegmentList(unsigned int repoIdx, const String *archiveId, const String *path, bool refresh);
+
 // Is the segment partial?
 FN_EXTERN bool walIsPartial(const String *walSegment);
 
@@ -101,4 +139,35 @@ FN_EXTERN String *walSegmentNext(const String *walSegment, size_t walSegmentSize
 FN_EXTERN StringList *walSegmentRange(
     const String *walSegmentBegin, size_t walSegmentSize, unsigned int pgVersion, unsigned int range);
 
+// Build an expression to find a WAL segment in a WAL segment directory, including bundles that may contain the segment
+FN_EXTERN String *walSegmentExpression(const String *walSegment);
+
+// Get the checksum of a WAL segment stored in an archive file. When the archive file is a bundle the checksum is read from the
+// bundle index, which is why the path of the archive file on the storage is required.
+FN_EXTERN String *walArchiveFileChecksum(const Storage *storage, const String *archivePathFile, const String *walSegment);
+
+// Open a WAL segment stored in an archive file for read. When the archive file is a bundle then the read is limited to the segment.
+// Returns NULL if the bundle is missing and ignoreMissing is set.
+FN_EXTERN StorageRead *walSegmentReadNew(
+    const Storage *storage, const String *archivePathFile, const String *walSegment, bool compressible, bool ignoreMissing);
+
+// Is the archive file a WAL bundle?
+FN_EXTERN bool walIsBundle(const String *archiveFile);
+
+// Does the WAL bundle contain the WAL segment?
+FN_EXTERN bool walBundleContains(const String *bundleFile, const String *walSegment);
+
+// Get the last WAL segment in an archive file, which is the WAL segment itself unless the archive file is a bundle
+FN_EXTERN String *walArchiveFileStop(const String *archiveFile);
+
+// Build a list of the WAL segments in a bundle
+FN_EXTERN StringList *walBundleSegmentList(const String *bundleFile);
+
+// Add an entry to a bundle index
+FN_EXTERN void walBundleIndexAdd(Buffer *index, const Buffer *checksum, uint64_t size);
+
+// Read the index of a WAL bundle into a list of WalBundleSegment sorted by segment. Returns NULL if the bundle is missing and
+// ignoreMissing is set.
+FN_EXTERN List *walBundleIndex(const Storage *storage, const String *bundlePathFile, bool ignoreMissing);
+
 #endif
@@ -33,6 +33,22 @@ Macros for function logging
 #define FUNCTION_LOG_WAL_SEGMENT_FIND_FORMAT(value, buffer, bufferSize)                                                            \
     objNameToLog(value, "WalSegmentFind", buffer, bufferSize)
 
+/***********************************************************************************************************************************
+Does a file in the WAL segment directory match the WAL segment? Bundles in the directory match the expression so also check that the
+bundle contains the WAL segment.
+***********************************************************************************************************************************/
+static bool
+walSegmentFindMatch(RegExp *const regExp, const String *const file, const String *const walSegment)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(REGEXP, regExp);
+        FUNCTION_TEST_PARAM(STRING, file);
+        FUNCTION_TEST_PARAM(STRING, walSegment);
+    FUNCTION_TEST_END();
+
+    FUNCTION_TEST_RETURN(BOOL, regExpMatch(regExp, file) && (!walIsBundle(file) || walBundleContains(file, walSegment)));
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN WalSegmentFind *
 walSegmentFindNew(const Storage *const storage, const String *const archiveId, const bool single, const TimeMSec timeout)
@@ -81,10 +97,8 @@ walSegmentFind(WalSegmentFind *const this, const String *const walSegment)
         Wait *const wait = waitNew(this->timeout);
         const String *const prefix = strSubN(walSegment, 0, 16);
         const String *const path = strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(this->archiveId), strZ(prefix));
-        const String *const expression = strNewFmt(
-            "^%s%s-[0-f]{40}" COMPRESS_TYPE_REGEXP "{0,1}$", strZ(strSubN(walSegment, 0, 24)),
-            walIsPartial(walSegment) ? WAL_SEGMENT_PARTIAL_EXT : "");
-        RegExp *regExp = NULL;
+        const String *const expression = walSegmentExpression(walSegment);
+        RegExp *const regExp = regExpNew(expression);
 
         do
         {
@@ -108,6 +122,16 @@ walSegmentFind(WalSegmentFind *const this, const String *const walSegment)
                         storageListP(this->storage, path, .expression = this->single ? expression : NULL), sortOrderAsc);
                 }
                 MEM_CONTEXT_OBJ_END();
+
+                // Remove bundles that do not contain the WAL segment when finding a single WAL
+                if (this->single)
+                {
+                    for (unsigned int listIdx = strLstSize(this->list) - 1; (int)listIdx >= 0; listIdx--)
+                    {
+                        if (!walSegmentFindMatch(regExp, strLstGet(this->list, listIdx), walSegment))
+                            strLstRemoveIdx(this->list, listIdx);
+                    }
+                }
             }
 
             // If there are results
@@ -119,18 +143,14 @@ walSegmentFind(WalSegmentFind *const this, const String *const walSegment)
 
                 if (!this->single)
                 {
-                    // Build regexp if not yet built
-                    if (regExp == NULL)
-                        regExp = regExpNew(expression);
-
                     // Remove list items that do not match. This prevents us from having check them again on the next find.
-                    while (!strLstEmpty(this->list) && !regExpMatch(regExp, strLstGet(this->list, 0)))
+                    while (!strLstEmpty(this->list) && !walSegmentFindMatch(regExp, strLstGet(this->list, 0), walSegment))
                         strLstRemoveIdx(this->list, 0);
 
                     // Find matches at the beginning of the remaining list
                     match = 0;
 
-                    while (match < strLstSize(this->list) && regExpMatch(regExp, strLstGet(this->list, match)))
+                    while (match < strLstSize(this->list) && walSegmentFindMatch(regExp, strLstGet(this->list, match), walSegment))
                         match++;
                 }
 
@@ -164,13 +184,15 @@ walSegmentFind(WalSegmentFind *const this, const String *const walSegment)
                     MEM_CONTEXT_PRIOR_END();
                 }
 
-                // Remove matching entries so list will be reloaded when empty
+                // Remove matching entries so list will be reloaded when empty. Bundles are kept until the last WAL segment in the
+                // bundle has been found.
                 if (!this->single)
                 {
-                    ASSERT(regExp != NULL);
-
-                    while (!strLstEmpty(this->list) && regExpMatch(regExp, strLstGet(this->list, 0)))
+                    while (!strLstEmpty(this->list) && walSegmentFindMatch(regExp, strLstGet(this->list, 0), walSegment) &&
+                           strEq(walArchiveFileStop(strLstGet(this->list, 0)), strSubN(walSegment, 0, WAL_SEGMENT_NAME_SIZE)))
+                    {
                         strLstRemoveIdx(this->list, 0);
+                    }
                 }
             }
 
@@ -103,11 +103,11 @@ archiveGetFile(
                     ioFilterGroupAdd(ioWriteFilterGroup(storageWriteIo(destination)),
                                      walFilterNew(pgControl, actual));
                 }
-                // Copy the file
+                // Copy the file. If the file is a bundle then only the requested segment is read.
                 storageCopyP(
-                    storageNewReadP(
-                        storageRepoIdx(actual->repoIdx), strNewFmt(STORAGE_REPO_ARCHIVE "/%s", strZ(actual->file)),
-                        .compressible = compressible),
+                    walSegmentReadNew(
+                        storageRepoIdx(actual->repoIdx), strNewFmt(STORAGE_REPO_ARCHIVE "/%s", strZ(actual->file)), request,
+                        compressible, false),
                     destination);
             }
             MEM_CONTEXT_TEMP_END();
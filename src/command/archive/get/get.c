@@ -76,17 +76,12 @@ archiveGetErrorAdd(
     }
 }
 
-// Helper to find a single archive file in the repository using a cache to speed up the process and minimize storageListP() calls
-typedef struct ArchiveGetFindCachePath
-{
-    const String *path;                                             // Cached path in the archiveId
-    const StringList *fileList;                                     // List of files in the cache path
-} ArchiveGetFindCachePath;
-
+// Helper to find a single archive file in the repository using a cache to speed up the process and minimize storageListP() calls.
+// Path lists are cached by archiveSegmentList() so they are shared with WAL filtering in the same process.
 typedef struct ArchiveGetFindCacheArchive
 {
     const String *archiveId;                                        // ArchiveId in the repo
-    List *pathList;                                                 // List of paths cached for archiveId
+    StringList *pathList;                                           // Paths listed for archiveId during this check
 } ArchiveGetFindCacheArchive;
 
 typedef struct ArchiveGetFindCacheRepo
@@ -157,9 +152,16 @@ archiveGetFind(
                             segmentList = storageListP(
                                 storageRepoIdx(cacheRepo->repoIdx),
                                 strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(cacheArchive->archiveId), strZ(path)),
-                                .expression = strNewFmt(
-                                    "^%s%s-[0-f]{40}" COMPRESS_TYPE_REGEXP "{0,1}$", strZ(strSubN(archiveFileRequest, 0, 24)),
-                                    walIsPartial(archiveFileRequest) ? WAL_SEGMENT_PARTIAL_EXT : ""));
+                                .expression = walSegmentExpression(archiveFileRequest));
+
+                            // Remove bundles that do not contain the segment
+                            for (unsigned int segmentIdx = strLstSize(segmentList) - 1; (int)segmentIdx >= 0; segmentIdx--)
+                            {
+                                const String *const file = strLstGet(segmentList, segmentIdx);
+
+                                if (walIsBundle(file) && !walBundleContains(file, archiveFileRequest))
+                                    strLstRemoveIdx(segmentList, segmentIdx);
+                            }
                         }
                         // Else multiple files will be requested so cache list results
                         else
@@ -167,35 +169,27 @@ archiveGetFind(
                             // Partial files cannot be in a list with multiple requests
                             ASSERT(!walIsPartial(archiveFileRequest));
 
-                            // If the path does not exist in the cache then fetch it
-                            const ArchiveGetFindCachePath *cachePath = lstFind(cacheArchive->pathList, &path);
+                            // Get the list of files in the path. The path is listed again the first time it is used in this check
+                            // since the process-wide cache may be older than the files requested.
+                            const bool refresh = !strLstExists(cacheArchive->pathList, path);
+                            const StringList *const fileList = archiveSegmentList(
+                                cacheRepo->repoIdx, cacheArchive->archiveId, path, refresh);
 
-                            if (cachePath == NULL)
-                            {
-                                MEM_CONTEXT_BEGIN(lstMemContext(cacheArchive->pathList))
-                                {
-                                    const ArchiveGetFindCachePath archiveGetFindCachePath =
-                                    {
-                                        .path = strDup(path),
-                                        .fileList = storageListP(
-                                            storageRepoIdx(cacheRepo->repoIdx),
-                                            strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(cacheArchive->archiveId), strZ(path)),
-                                            .expression = strNewFmt(
-                                                "^%s[0-F]{8}-[0-f]{40}" COMPRESS_TYPE_REGEXP "{0,1}$", strZ(path))),
-                                    };
-
-                                    cachePath = lstAdd(cacheArchive->pathList, &archiveGetFindCachePath);
-                                }
-                                MEM_CONTEXT_END();
-                            }
+                            if (refresh)
+                                strLstAdd(cacheArchive->pathList, path);
 
                             // Get a list of all WAL segments that match
                             segmentList = strLstNew();
 
-                            for (unsigned int fileIdx = 0; fileIdx < strLstSize(cachePath->fileList); fileIdx++)
+                            for (unsigned int fileIdx = 0; fileIdx < strLstSize(fileList); fileIdx++)
                             {
-                                if (strBeginsWith(strLstGet(cachePath->fileList, fileIdx), archiveFileRequest))
-                                    strLstAdd(segmentList, strLstGet(cachePath->fileList, fileIdx));
+                                const String *const file = strLstGet(fileList, fileIdx);
+
+                                if (strBeginsWith(file, archiveFileRequest) ||
+                                    (walIsBundle(file) && walBundleContains(file, archiveFileRequest)))
+                                {
+                                    strLstAdd(segmentList, file);
+                                }
                             }
                         }
 
@@ -277,11 +271,18 @@ archiveGetFind(
             // If a segment match list is > 1 then check for duplicates
             if (isSegment && lstSize(matchList) > 1)
             {
-                // Count the number of unique hashes
+                // Count the number of unique hashes. Bundles are skipped since the hash is stored in the bundle index and reading
+                // the index for each request would be expensive. Bundles never contain segments that already exist in a repo when
+                // pushed.
                 StringList *const hashList = strLstNew();
 
                 for (unsigned int matchIdx = 0; matchIdx < lstSize(matchList); matchIdx++)
-                    strLstAddIfMissing(hashList, strSubN(((ArchiveGetFile *)lstGet(matchList, matchIdx))->file, 25, 40));
+                {
+                    const String *const file = ((ArchiveGetFile *)lstGet(matchList, matchIdx))->file;
+
+                    if (!walIsBundle(strBase(file)))
+                        strLstAddIfMissing(hashList, strSubN(file, 25, 40));
+                }
 
                 // If there is more than one unique hash then there are duplicates
                 if (strLstSize(hashList) > 1)
@@ -450,10 +451,7 @@ archiveGetCheck(const StringList *const archiveRequestList)
                         // If the archiveId is most recent or has files then add it
                         if (found)
                         {
-                            ArchiveGetFindCacheArchive cacheArchive =
-                            {
-                                .pathList = lstNewP(sizeof(ArchiveGetFindCachePath), .comparator = lstComparatorStr),
-                            };
+                            ArchiveGetFindCacheArchive cacheArchive = {.pathList = strLstNew()};
 
                             // Copy archiveId into the result list context once rather than making a copy per candidate file later
                             MEM_CONTEXT_BEGIN(lstMemContext(result.archiveFileMapList))
@@ -848,12 +846,61 @@ cmdArchiveGet(void)
 }
 
 /**********************************************************************************************************************************/
+typedef struct ArchiveGetAsyncRange
+{
+    unsigned int archiveFileIdx;                                    // Next index in the range to be processed
+    unsigned int archiveFileEnd;                                    // End of the range (exclusive)
+} ArchiveGetAsyncRange;
+
 typedef struct ArchiveGetAsyncData
 {
     const List *const archiveFileMapList;                           // List of wal segments to process
     unsigned int archiveFileIdx;                                    // Current index in the list to be processed
+    List *rangeList;                                                // Ranges of wal segments per client (only when filtering)
 } ArchiveGetAsyncData;
 
+// When WAL is filtered each client processes a contiguous range of segments so the record continued from the previous segment is
+// usually already known to the client and does not need to be read from the repository again. A client that has finished its range
+// takes over the second half of the largest remaining range.
+static unsigned int
+archiveGetAsyncRangeNext(ArchiveGetAsyncData *const jobData, const unsigned int clientIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(UINT, clientIdx);
+    FUNCTION_TEST_END();
+
+    ArchiveGetAsyncRange *const range = lstGet(jobData->rangeList, clientIdx);
+
+    if (range->archiveFileIdx == range->archiveFileEnd)
+    {
+        ArchiveGetAsyncRange *rangeLargest = NULL;
+
+        for (unsigned int rangeIdx = 0; rangeIdx < lstSize(jobData->rangeList); rangeIdx++)
+        {
+            ArchiveGetAsyncRange *const rangeFind = lstGet(jobData->rangeList, rangeIdx);
+
+            if (rangeLargest == NULL ||
+                rangeFind->archiveFileEnd - rangeFind->archiveFileIdx > rangeLargest->archiveFileEnd - rangeLargest->archiveFileIdx)
+            {
+                rangeLargest = rangeFind;
+            }
+        }
+
+        const unsigned int remaining = rangeLargest->archiveFileEnd - rangeLargest->archiveFileIdx;
+
+        // Nothing left to process
+        if (remaining == 0)
+            FUNCTION_TEST_RETURN(UINT, lstSize(jobData->archiveFileMapList));
+
+        range->archiveFileIdx = rangeLargest->archiveFileIdx + remaining / 2;
+        range->archiveFileEnd = rangeLargest->archiveFileEnd;
+        rangeLargest->archiveFileEnd = range->archiveFileIdx;
+    }
+
+    FUNCTION_TEST_RETURN(UINT, range->archiveFileIdx++);
+}
+
 static ProtocolParallelJob *
 archiveGetAsyncCallback(void *const data, const unsigned int clientIdx)
 {
@@ -866,16 +913,15 @@ archiveGetAsyncCallback(void *const data, const unsigned int clientIdx)
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
-        // No special logic based on the client, we'll just get the next job
-        (void)clientIdx;
-
-        // Get a new job if there are any left
+        // Get a new job if there are any left. Without filtering there is no special logic based on the client, we'll just get the
+        // next job.
         ArchiveGetAsyncData *const jobData = data;
+        const unsigned int archiveFileIdx =
+            jobData->rangeList != NULL ? archiveGetAsyncRangeNext(jobData, clientIdx) : jobData->archiveFileIdx++;
 
-        if (jobData->archiveFileIdx < lstSize(jobData->archiveFileMapList))
+        if (archiveFileIdx < lstSize(jobData->archiveFileMapList))
         {
-            const ArchiveFileMap *const archiveFileMap = lstGet(jobData->archiveFileMapList, jobData->archiveFileIdx);
-            jobData->archiveFileIdx++;
+            const ArchiveFileMap *const archiveFileMap = lstGet(jobData->archiveFileMapList, archiveFileIdx);
 
             ProtocolCommand *const command = protocolCommandNew(PROTOCOL_COMMAND_ARCHIVE_GET_FILE);
             PackWrite *const param = protocolCommandParam(command);
@@ -943,6 +989,26 @@ cmdArchiveGetAsync(void)
                 // Create the parallel executor
                 ArchiveGetAsyncData jobData = {.archiveFileMapList = checkResult.archiveFileMapList};
 
+                // Split segments into contiguous ranges per client when filtering
+                if (cfgOptionTest(cfgOptFilter))
+                {
+                    const unsigned int clientTotal = cfgOptionUInt(cfgOptProcessMax);
+                    const unsigned int archiveFileTotal = lstSize(checkResult.archiveFileMapList);
+
+                    jobData.rangeList = lstNewP(sizeof(ArchiveGetAsyncRange));
+
+                    for (unsigned int clientIdx = 0; clientIdx < clientTotal; clientIdx++)
+                    {
+                        const ArchiveGetAsyncRange range =
+                        {
+                            .archiveFileIdx = (unsigned int)((uint64_t)archiveFileTotal * clientIdx / clientTotal),
+                            .archiveFileEnd = (unsigned int)((uint64_t)archiveFileTotal * (clientIdx + 1) / clientTotal),
+                        };
+
+                        lstAdd(jobData.rangeList, &range);
+                    }
+                }
+
                 ProtocolParallel *const parallelExec = protocolParallelNew(
                     cfgOptionUInt64(cfgOptProtocolTimeout) / 2, archiveGetAsyncCallback, &jobData);
 
@@ -10,6 +10,7 @@ Archive Push File
 #include "common/crypto/cipherBlock.h"
 #include "common/crypto/hash.h"
 #include "common/debug.h"
+#include "common/io/bufferRead.h"
 #include "common/io/filter/group.h"
 #include "common/io/io.h"
 #include "common/log.h"
@@ -92,17 +93,46 @@ archivePushFileIo(
     FUNCTION_TEST_RETURN(BOOL, result);
 }
 
+/***********************************************************************************************************************************
+Compare archive version and systemId to the WAL header
+***********************************************************************************************************************************/
+static void
+archivePushHeaderCheck(const String *const walSource, const unsigned int pgVersion, const uint64_t pgSystemId)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, walSource);
+        FUNCTION_TEST_PARAM(UINT, pgVersion);
+        FUNCTION_TEST_PARAM(UINT64, pgSystemId);
+    FUNCTION_TEST_END();
+
+    ASSERT(walSource != NULL);
+
+    const PgWal walInfo = pgWalFromFile(walSource, storageLocal(), cfgOptionStrNull(cfgOptPgVersionForce));
+
+    if (walInfo.version != pgVersion || walInfo.systemId != pgSystemId)
+    {
+        THROW_FMT(
+            ArchiveMismatchError,
+            "WAL file '%s' version %s, system-id %" PRIu64 " do not match stanza version %s, system-id %" PRIu64,
+            strZ(walSource), strZ(pgVersionToStr(walInfo.version)), walInfo.systemId, strZ(pgVersionToStr(pgVersion)),
+            pgSystemId);
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN ArchivePushFileResult
 archivePushFile(
-    const String *const walSource, const bool headerCheck, const bool modeCheck, const unsigned int pgVersion,
-    const uint64_t pgSystemId, const String *const archiveFile, const CompressType compressType, const int compressLevel,
-    const List *const repoList, const StringList *const priorErrorList)
+    const String *const walSource, const bool headerCheck, const bool modeCheck, const bool singlePass,
+    const unsigned int pgVersion, const uint64_t pgSystemId, const String *const archiveFile, const CompressType compressType,
+    const int compressLevel, const List *const repoList, const StringList *const priorErrorList)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, walSource);
         FUNCTION_LOG_PARAM(BOOL, headerCheck);
         FUNCTION_LOG_PARAM(BOOL, modeCheck);
+        FUNCTION_LOG_PARAM(BOOL, singlePass);
         FUNCTION_LOG_PARAM(UINT, pgVersion);
         FUNCTION_LOG_PARAM(UINT64, pgSystemId);
         FUNCTION_LOG_PARAM(STRING, archiveFile);
@@ -131,18 +161,7 @@ archivePushFile(
 
         // If this is a segment compare archive version and systemId to the WAL header
         if (headerCheck && isSegment)
-        {
-            const PgWal walInfo = pgWalFromFile(walSource, storageLocal(), cfgOptionStrNull(cfgOptPgVersionForce));
-
-            if (walInfo.version != pgVersion || walInfo.systemId != pgSystemId)
-            {
-                THROW_FMT(
-                    ArchiveMismatchError,
-                    "WAL file '%s' version %s, system-id %" PRIu64 " do not match stanza version %s, system-id %" PRIu64,
-                    strZ(walSource), strZ(pgVersionToStr(walInfo.version)), walInfo.systemId, strZ(pgVersionToStr(pgVersion)),
-                    pgSystemId);
-            }
-        }
+            archivePushHeaderCheck(walSource, pgVersion, pgSystemId);
 
         // Set archive destination initially to the archive file, this will be updated later for wal segments
         String *const archiveDestination = strCat(strNew(), archiveFile);
@@ -154,16 +173,33 @@ archivePushFile(
         for (unsigned int repoListIdx = 0; repoListIdx < lstSize(repoList); repoListIdx++)
             destinationCopy[repoListIdx] = true;
 
+        // Will the WAL segment be compressed?
+        const bool compress = isSegment && compressType != compressTypeNone;
+
+        // In single pass mode the WAL segment is read once and the (compressed) result is stored in memory until the checksum is
+        // known, since the checksum is part of the destination name
+        Buffer *walBuffer = NULL;
+
         // Get wal segment checksum and compare it to what exists in the repo, if any
         if (isSegment)
         {
             // Assume that no repos need a copy of the WAL segment and update when a repo needing a copy is found
             destinationCopyAny = false;
 
-            // Generate a sha1 checksum for the wal segment
-            IoRead *const read = storageReadIo(storageNewReadP(storageLocal(), walSource));
+            // Generate a sha1 checksum for the wal segment. In single pass mode also compress the WAL segment.
+            StorageRead *const source = storageNewReadP(storageLocal(), walSource);
+            IoRead *const read = storageReadIo(source);
             ioFilterGroupAdd(ioReadFilterGroup(read), cryptoHashNew(hashTypeSha1));
-            ioReadDrain(read);
+
+            if (singlePass)
+            {
+                if (compress)
+                    ioFilterGroupAdd(ioReadFilterGroup(read), compressFilterP(compressType, compressLevel));
+
+                walBuffer = storageGetP(source);
+            }
+            else
+                ioReadDrain(read);
 
             const String *const walSegmentChecksum = strNewEncode(
                 encodingHex, pckReadBinP(ioFilterGroupResultP(ioReadFilterGroup(read), CRYPTO_HASH_FILTER_TYPE)));
@@ -173,12 +209,28 @@ archivePushFile(
             {
                 const ArchivePushFileRepoData *const repoData = lstGet(repoList, repoListIdx);
 
-                // Check if the WAL segment already exists in the repo
-                const String *walSegmentFile;
+                // Check if the WAL segment already exists in the repo unless the caller has already checked
+                const String *walSegmentFile = repoData->existFile;
+                const String *walSegmentRepoChecksum = NULL;
 
                 TRY_BEGIN()
                 {
-                    walSegmentFile = walSegmentFindOne(storageRepoIdx(repoData->repoIdx), repoData->archiveId, archiveFile, 0);
+                    if (!repoData->existChecked)
+                    {
+                        walSegmentFile = walSegmentFindOne(
+                            storageRepoIdx(repoData->repoIdx), repoData->archiveId, archiveFile, 0);
+                    }
+
+                    // Get the checksum of the WAL segment in the repo, which is read from the index when the segment is bundled
+                    if (walSegmentFile != NULL)
+                    {
+                        walSegmentRepoChecksum = walArchiveFileChecksum(
+                            storageRepoIdx(repoData->repoIdx),
+                            strNewFmt(
+                                STORAGE_REPO_ARCHIVE "/%s/%s/%s", strZ(repoData->archiveId), strZ(strSubN(archiveFile, 0, 16)),
+                                strZ(walSegmentFile)),
+                            archiveFile);
+                    }
                 }
                 CATCH_ANY()
                 {
@@ -192,10 +244,8 @@ archivePushFile(
                     continue;
 
                 // If the WAL segment was found validate the checksum
-                if (walSegmentFile != NULL)
+                if (walSegmentRepoChecksum != NULL)
                 {
-                    const String *const walSegmentRepoChecksum = strSubN(
-                        walSegmentFile, strSize(archiveFile) + 1, HASH_TYPE_SHA1_SIZE_HEX);
 
                     // If the checksums are the same then succeed but warn if archive-mode-check is enabled in case this is a
                     // symptom of some other issue
@@ -235,17 +285,21 @@ archivePushFile(
         // Copy the file if one or more repos require it
         if (destinationCopyAny)
         {
-            // Source file is read once and copied to all repos
-            StorageRead *const source = storageNewReadP(storageLocal(), walSource);
+            // Source file is read once and copied to all repos. In single pass mode the source has already been read into memory.
+            IoRead *const source =
+                walBuffer != NULL ? ioBufferReadNew(walBuffer) : storageReadIo(storageNewReadP(storageLocal(), walSource));
 
             // Is the file compressible during the copy?
             bool compressible = true;
 
-            // If the file will be compressed then add compression filter
-            if (isSegment && compressType != compressTypeNone)
+            // If the file will be compressed then add compression filter (unless it has already been compressed)
+            if (compress)
             {
                 compressExtCat(archiveDestination, compressType);
-                ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(source)), compressFilterP(compressType, compressLevel));
+
+                if (walBuffer == NULL)
+                    ioFilterGroupAdd(ioReadFilterGroup(source), compressFilterP(compressType, compressLevel));
+
                 compressible = false;
             }
 
@@ -276,7 +330,7 @@ archivePushFile(
             }
 
             // Open source file
-            ioReadOpen(storageReadIo(source));
+            ioReadOpen(source);
 
             // Open the destination files now that we know the source file exists and is readable
             for (unsigned int repoListIdx = 0; repoListIdx < lstSize(repoList); repoListIdx++)
@@ -296,7 +350,7 @@ archivePushFile(
             do
             {
                 // Read from source
-                ioRead(storageReadIo(source), read);
+                ioRead(source, read);
 
                 // Write to each destination
                 for (unsigned int repoListIdx = 0; repoListIdx < lstSize(repoList); repoListIdx++)
@@ -313,10 +367,10 @@ archivePushFile(
                 // Clear buffer
                 bufUsedZero(read);
             }
-            while (!ioReadEof(storageReadIo(source)));
+            while (!ioReadEof(source));
 
             // Close the source and destination files
-            ioReadClose(storageReadIo(source));
+            ioReadClose(source);
 
             for (unsigned int repoListIdx = 0; repoListIdx < lstSize(repoList); repoListIdx++)
             {
@@ -339,3 +393,131 @@ archivePushFile(
 
     FUNCTION_LOG_RETURN_STRUCT(result);
 }
+
+/**********************************************************************************************************************************/
+FN_EXTERN ArchivePushFileResult
+archivePushBundle(
+    const String *const walPath, const bool headerCheck, const unsigned int pgVersion, const uint64_t pgSystemId,
+    const String *const bundleFile, const CompressType compressType, const int compressLevel, const List *const repoList,
+    const StringList *const priorErrorList)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STRING, walPath);
+        FUNCTION_LOG_PARAM(BOOL, headerCheck);
+        FUNCTION_LOG_PARAM(UINT, pgVersion);
+        FUNCTION_LOG_PARAM(UINT64, pgSystemId);
+        FUNCTION_LOG_PARAM(STRING, bundleFile);
+        FUNCTION_LOG_PARAM(ENUM, compressType);
+        FUNCTION_LOG_PARAM(INT, compressLevel);
+        FUNCTION_LOG_PARAM_P(VOID, repoList);
+        FUNCTION_LOG_PARAM(STRING_LIST, priorErrorList);
+    FUNCTION_LOG_END();
+
+    FUNCTION_AUDIT_STRUCT();
+
+    ASSERT(walPath != NULL);
+    ASSERT(bundleFile != NULL);
+    ASSERT(walIsBundle(bundleFile));
+    ASSERT(repoList != NULL);
+    ASSERT(priorErrorList != NULL);
+    ASSERT(lstSize(repoList) > 0);
+
+    ArchivePushFileResult result = {.warnList = strLstNew()};
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        StringList *const errorList = strLstDup(priorErrorList);
+        const StringList *const walSegmentList = walBundleSegmentList(bundleFile);
+
+        // Read each WAL segment once to get the checksum and compress it. The segments are held in memory until the bundle has been
+        // written since the size of each segment must be known to write the index at the beginning of the bundle.
+        Buffer **const segmentData = memNew(sizeof(Buffer *) * strLstSize(walSegmentList));
+        const Buffer **const segmentChecksum = memNew(sizeof(Buffer *) * strLstSize(walSegmentList));
+
+        for (unsigned int segmentIdx = 0; segmentIdx < strLstSize(walSegmentList); segmentIdx++)
+        {
+            const String *const walSource = strNewFmt("%s/%s", strZ(walPath), strZ(strLstGet(walSegmentList, segmentIdx)));
+
+            if (headerCheck)
+                archivePushHeaderCheck(walSource, pgVersion, pgSystemId);
+
+            StorageRead *const source = storageNewReadP(storageLocal(), walSource);
+            IoFilterGroup *const filterGroup = ioReadFilterGroup(storageReadIo(source));
+
+            ioFilterGroupAdd(filterGroup, cryptoHashNew(hashTypeSha1));
+
+            if (compressType != compressTypeNone)
+                ioFilterGroupAdd(filterGroup, compressFilterP(compressType, compressLevel));
+
+            segmentData[segmentIdx] = storageGetP(source);
+            segmentChecksum[segmentIdx] = pckReadBinP(ioFilterGroupResultP(filterGroup, CRYPTO_HASH_FILTER_TYPE));
+        }
+
+        // Add the compression extension to the bundle
+        String *const archiveDestination = strCat(strNew(), bundleFile);
+        compressExtCat(archiveDestination, compressType);
+
+        // Write the bundle to each repo. Segments are encrypted separately so they can be decrypted after a range read.
+        for (unsigned int repoListIdx = 0; repoListIdx < lstSize(repoList); repoListIdx++)
+        {
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                const ArchivePushFileRepoData *const repoData = lstGet(repoList, repoListIdx);
+                Buffer *const index = bufNew(strLstSize(walSegmentList) * WAL_BUNDLE_INDEX_ENTRY_SIZE);
+
+                // The index is written first, followed by the segments
+                const Buffer **const bundleData = memNew(sizeof(Buffer *) * (strLstSize(walSegmentList) + 1));
+                const Buffer **const repoSegmentData = bundleData + 1;
+                bundleData[0] = index;
+
+                for (unsigned int segmentIdx = 0; segmentIdx < strLstSize(walSegmentList); segmentIdx++)
+                {
+                    repoSegmentData[segmentIdx] = segmentData[segmentIdx];
+
+                    if (repoData->cipherType != cipherTypeNone)
+                    {
+                        IoRead *const read = ioBufferReadNew(segmentData[segmentIdx]);
+                        ioFilterGroupAdd(
+                            ioReadFilterGroup(read),
+                            cipherBlockNewP(cipherModeEncrypt, repoData->cipherType, BUFSTR(repoData->cipherPass)));
+                        ioReadOpen(read);
+
+                        repoSegmentData[segmentIdx] = ioReadBuf(read);
+                        ioReadClose(read);
+                    }
+
+                    walBundleIndexAdd(index, segmentChecksum[segmentIdx], bufUsed(repoSegmentData[segmentIdx]));
+                }
+
+                // Write the bundle, stopping on the first error
+                IoWrite *const destination = storageWriteIo(
+                    storageNewWriteP(
+                        storageRepoIdxWrite(repoData->repoIdx),
+                        strNewFmt(
+                            STORAGE_REPO_ARCHIVE "/%s/%s/%s", strZ(repoData->archiveId), strZ(strSubN(bundleFile, 0, 16)),
+                            strZ(archiveDestination)),
+                        .compressible = compressType == compressTypeNone && repoData->cipherType == cipherTypeNone));
+
+                bool success = archivePushFileIo(archivePushFileIoTypeOpen, destination, NULL, repoData->repoIdx, errorList);
+
+                for (unsigned int dataIdx = 0; success && dataIdx <= strLstSize(walSegmentList); dataIdx++)
+                {
+                    success = archivePushFileIo(
+                        archivePushFileIoTypeWrite, destination, bundleData[dataIdx], repoData->repoIdx, errorList);
+                }
+
+                if (success)
+                    archivePushFileIo(archivePushFileIoTypeClose, destination, NULL, repoData->repoIdx, errorList);
+            }
+            MEM_CONTEXT_TEMP_END();
+        }
+
+        // Throw any errors, even if some pushes were successful. It is important that PostgreSQL receives an error so it does not
+        // remove the files.
+        if (strLstSize(errorList) > 0)
+            THROW_FMT(CommandError, CFGCMD_ARCHIVE_PUSH " command encountered error(s):\n%s", strZ(strLstJoin(errorList, "\n")));
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_STRUCT(result);
+}
@@ -19,6 +19,8 @@ typedef struct ArchivePushFileRepoData
     const String *archiveId;
     CipherType cipherType;
     const String *cipherPass;
+    bool existChecked;                                              // Has the repo already been checked for the WAL segment?
+    const String *existFile;                                        // WAL segment found in the repo when existChecked is set
 } ArchivePushFileRepoData;
 
 /***********************************************************************************************************************************
@@ -31,8 +33,14 @@ typedef struct ArchivePushFileResult
 
 // Copy a file from the source to the archive
 FN_EXTERN ArchivePushFileResult archivePushFile(
-    const String *walSource, bool headerCheck, bool modeCheck, unsigned int pgVersion, uint64_t pgSystemId,
+    const String *walSource, bool headerCheck, bool modeCheck, bool singlePass, unsigned int pgVersion, uint64_t pgSystemId,
     const String *archiveFile, CompressType compressType, int compressLevel, const List *repoList,
     const StringList *priorErrorList);
 
+// Push consecutive WAL segments from the WAL path to the archive as a single bundle. The segments in the bundle are determined by
+// the bundle file name. The caller must ensure that none of the segments exist in the repos.
+FN_EXTERN ArchivePushFileResult archivePushBundle(
+    const String *walPath, bool headerCheck, unsigned int pgVersion, uint64_t pgSystemId, const String *bundleFile,
+    CompressType compressType, int compressLevel, const List *repoList, const StringList *priorErrorList);
+
 #endif
@@ -30,6 +30,7 @@ archivePushFileProtocol(PackRead *const param, ProtocolServer *const server)
         const String *const walSource = pckReadStrP(param);
         const bool headerCheck = pckReadBoolP(param);
         const bool modeCheck = pckReadBoolP(param);
+        const bool singlePass = pckReadBoolP(param);
         const unsigned int pgVersion = pckReadU32P(param);
         const uint64_t pgSystemId = pckReadU64P(param);
         const String *const archiveFile = pckReadStrP(param);
@@ -50,6 +51,8 @@ archivePushFileProtocol(PackRead *const param, ProtocolServer *const server)
             repo.archiveId = pckReadStrP(param);
             repo.cipherType = pckReadU64P(param);
             repo.cipherPass = pckReadStrP(param);
+            repo.existChecked = pckReadBoolP(param);
+            repo.existFile = pckReadStrP(param);
             pckReadObjEndP(param);
 
             lstAdd(repoList, &repo);
@@ -59,8 +62,65 @@ archivePushFileProtocol(PackRead *const param, ProtocolServer *const server)
 
         // Push file
         const ArchivePushFileResult fileResult = archivePushFile(
-            walSource, headerCheck, modeCheck, pgVersion, pgSystemId, archiveFile, compressType, compressLevel, repoList,
-            priorErrorList);
+            walSource, headerCheck, modeCheck, singlePass, pgVersion, pgSystemId, archiveFile, compressType, compressLevel,
+            repoList, priorErrorList);
+
+        // Return result
+        protocolServerDataPut(server, pckWriteStrLstP(protocolPackNew(), fileResult.warnList));
+        protocolServerDataEndPut(server);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+archivePushBundleProtocol(PackRead *const param, ProtocolServer *const server)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(PACK_READ, param);
+        FUNCTION_LOG_PARAM(PROTOCOL_SERVER, server);
+    FUNCTION_LOG_END();
+
+    ASSERT(param != NULL);
+    ASSERT(server != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Read parameters
+        const String *const walPath = pckReadStrP(param);
+        const bool headerCheck = pckReadBoolP(param);
+        const unsigned int pgVersion = pckReadU32P(param);
+        const uint64_t pgSystemId = pckReadU64P(param);
+        const String *const bundleFile = pckReadStrP(param);
+        const CompressType compressType = pckReadU32P(param);
+        const int compressLevel = pckReadI32P(param);
+        const StringList *const priorErrorList = pckReadStrLstP(param);
+
+        // Read repo data
+        List *const repoList = lstNewP(sizeof(ArchivePushFileRepoData));
+
+        pckReadArrayBeginP(param);
+
+        while (!pckReadNullP(param))
+        {
+            pckReadObjBeginP(param);
+
+            ArchivePushFileRepoData repo = {.repoIdx = pckReadU32P(param)};
+            repo.archiveId = pckReadStrP(param);
+            repo.cipherType = pckReadU64P(param);
+            repo.cipherPass = pckReadStrP(param);
+            pckReadObjEndP(param);
+
+            lstAdd(repoList, &repo);
+        }
+
+        pckReadArrayEndP(param);
+
+        // Push bundle
+        const ArchivePushFileResult fileResult = archivePushBundle(
+            walPath, headerCheck, pgVersion, pgSystemId, bundleFile, compressType, compressLevel, repoList, priorErrorList);
 
         // Return result
         protocolServerDataPut(server, pckWriteStrLstP(protocolPackNew(), fileResult.warnList));
@@ -12,13 +12,16 @@ Functions
 ***********************************************************************************************************************************/
 // Process protocol requests
 FN_EXTERN void archivePushFileProtocol(PackRead *param, ProtocolServer *server);
+FN_EXTERN void archivePushBundleProtocol(PackRead *param, ProtocolServer *server);
 
 /***********************************************************************************************************************************
 Protocol commands for ProtocolServerHandler arrays passed to protocolServerProcess()
 ***********************************************************************************************************************************/
 #define PROTOCOL_COMMAND_ARCHIVE_PUSH_FILE                          STRID5("ap-f", 0x36e010)
+#define PROTOCOL_COMMAND_ARCHIVE_PUSH_BUNDLE                        STRID5("ap-b", 0x16e010)
 
 #define PROTOCOL_SERVER_HANDLER_ARCHIVE_PUSH_LIST                                                                                  \
-    {.command = PROTOCOL_COMMAND_ARCHIVE_PUSH_FILE, .handler = archivePushFileProtocol},
+    {.command = PROTOCOL_COMMAND_ARCHIVE_PUSH_FILE, .handler = archivePushFileProtocol},                                           \
+    {.command = PROTOCOL_COMMAND_ARCHIVE_PUSH_BUNDLE, .handler = archivePushBundleProtocol},
 
 #endif
@@ -3,9 +3,16 @@ Archive Push Command
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
+#ifdef HAVE_INOTIFY
+#include <errno.h>
+#include <limits.h>
+#include <sys/inotify.h>
+#endif
+
 #include "command/archive/common.h"
 #include "command/archive/push/file.h"
 #include "command/archive/push/protocol.h"
@@ -13,8 +20,10 @@ Archive Push Command
 #include "command/control/common.h"
 #include "common/compress/helper.h"
 #include "common/debug.h"
+#include "common/io/fd.h"
 #include "common/log.h"
 #include "common/memContext.h"
+#include "common/regExp.h"
 #include "common/wait.h"
 #include "config/config.h"
 #include "config/exec.h"
@@ -126,13 +135,14 @@ Determine which WAL files need to be pushed to the archive when in async mode
 This is the heart of the "look ahead" functionality in async archiving. Any files in the out directory that do not end in ok are
 removed and any ok files that do not have a corresponding ready file in archive_status (meaning it has been acknowledged by
 PostgreSQL) are removed. Then all ready files that do not have a corresponding ok file (meaning it has already been processed) are
-returned for processing.
+returned for processing. If okListKeep is not NULL then the ok files that were not removed are added to it.
 ***********************************************************************************************************************************/
 static StringList *
-archivePushProcessList(const String *const walPath)
+archivePushProcessList(const String *const walPath, StringList *const okListKeep)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STRING, walPath);
+        FUNCTION_LOG_PARAM(STRING_LIST, okListKeep);
     FUNCTION_LOG_END();
 
     ASSERT(walPath != NULL);
@@ -178,6 +188,15 @@ archivePushProcessList(const String *const walPath)
                 .errorOnMissing = true);
         }
 
+        // Add the ok files that were kept
+        if (okListKeep != NULL)
+        {
+            const StringList *const okKeepList = strLstMergeAnti(okList, okRemoveList);
+
+            for (unsigned int okKeepIdx = 0; okKeepIdx < strLstSize(okKeepList); okKeepIdx++)
+                strLstAdd(okListKeep, strLstGet(okKeepList, okKeepIdx));
+        }
+
         // Return all ready files that are not in the ok list
         result = strLstMove(strLstMergeAnti(readyList, okList), memContextPrior());
     }
@@ -411,9 +430,10 @@ cmdArchivePush(void)
 
                 // Push the file to the archive
                 const ArchivePushFileResult fileResult = archivePushFile(
-                    walFile, cfgOptionBool(cfgOptArchiveHeaderCheck), cfgOptionBool(cfgOptArchiveModeCheck), archiveInfo.pgVersion,
-                    archiveInfo.pgSystemId, archiveFile, compressTypeEnum(cfgOptionStrId(cfgOptCompressType)),
-                    cfgOptionInt(cfgOptCompressLevel), archiveInfo.repoList, archiveInfo.errorList);
+                    walFile, cfgOptionBool(cfgOptArchiveHeaderCheck), cfgOptionBool(cfgOptArchiveModeCheck),
+                    cfgOptionBool(cfgOptArchivePushSinglePass), archiveInfo.pgVersion, archiveInfo.pgSystemId, archiveFile,
+                    compressTypeEnum(cfgOptionStrId(cfgOptCompressType)), cfgOptionInt(cfgOptCompressLevel), archiveInfo.repoList,
+                    archiveInfo.errorList);
 
                 // If a warning was returned then log it
                 for (unsigned int warnIdx = 0; warnIdx < strLstSize(fileResult.warnList); warnIdx++)
@@ -438,8 +458,297 @@ typedef struct ArchivePushAsyncData
     CompressType compressType;                                      // Type of compression for WAL segments
     int compressLevel;                                              // Compression level for wal files
     ArchivePushCheckResult archiveInfo;                             // Archive info
+    List *existList;                                                // Archive path listed for each repo (ArchivePushAsyncExist)
+    unsigned int existAvoidTotal;                                   // Repo list requests avoided when checking for existing WAL
+    bool bundle;                                                    // Push consecutive WAL segments in bundles?
+    unsigned int bundleMax;                                         // Maximum WAL segments in a bundle
+    uint64_t bundleSize;                                            // Maximum size of WAL segments in a bundle
+    unsigned int bundleTotal;                                       // Bundles pushed
+    unsigned int bundleSegmentTotal;                                // WAL segments pushed in bundles
 } ArchivePushAsyncData;
 
+// Archive path listed for a repo. WAL files are processed in order so only the path of the current WAL file needs to be kept.
+typedef struct ArchivePushAsyncExist
+{
+    String *path;                                                   // Archive path that was listed
+    StringList *list;                                               // Files in the archive path (NULL when the list failed)
+} ArchivePushAsyncExist;
+
+// List the archive path for a repo and keep the list for following WAL segments in the same path
+static void
+archivePushAsyncExistList(
+    ArchivePushAsyncData *const jobData, ArchivePushAsyncExist *const exist, const unsigned int repoIdx, const String *const path)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM_P(VOID, exist);
+        FUNCTION_TEST_PARAM(UINT, repoIdx);
+        FUNCTION_TEST_PARAM(STRING, path);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(exist != NULL);
+    ASSERT(path != NULL);
+
+    MEM_CONTEXT_BEGIN(lstMemContext(jobData->existList))
+    {
+        strFree(exist->path);
+        strLstFree(exist->list);
+
+        exist->path = strDup(path);
+        exist->list = NULL;
+
+        // On error the local will find the WAL segment itself and report the error
+        TRY_BEGIN()
+        {
+            exist->list = storageListP(storageRepoIdx(repoIdx), path);
+        }
+        CATCH_ANY()
+        {
+            LOG_DETAIL_FMT(
+                "unable to check %s for existing WAL: %s", cfgOptionGroupName(cfgOptGrpRepo, repoIdx), errorMessage());
+        }
+        TRY_END();
+    }
+    MEM_CONTEXT_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Find a WAL segment in the archive path list. Returns the number of matches and the last match found.
+static unsigned int
+archivePushAsyncExistFind(const StringList *const list, const String *const walFile, const String **const existFile)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING_LIST, list);
+        FUNCTION_TEST_PARAM(STRING, walFile);
+        FUNCTION_TEST_PARAM_P(STRING, existFile);
+    FUNCTION_TEST_END();
+
+    ASSERT(list != NULL);
+    ASSERT(walFile != NULL);
+    ASSERT(existFile != NULL);
+
+    unsigned int result = 0;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        RegExp *const regExp = regExpNew(walSegmentExpression(walFile));
+
+        for (unsigned int listIdx = 0; listIdx < strLstSize(list); listIdx++)
+        {
+            const String *const file = strLstGet(list, listIdx);
+
+            if (regExpMatch(regExp, file) && (!walIsBundle(file) || walBundleContains(file, walFile)))
+            {
+                *existFile = file;
+                result++;
+            }
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(UINT, result);
+}
+
+// Check if a WAL segment exists in a repo using a single list of the archive path for all the WAL segments in the path. Otherwise
+// each local would list the archive path for each WAL segment, which adds up to a lot of requests when catching up on WAL.
+//
+// The list is trusted for the rest of the batch, so a WAL segment pushed to the repo after the list was taken is treated as new.
+// Only the process holding the archive-push async lock pushes WAL for the stanza and the foreground archive-push waits for it
+// rather than pushing WAL itself, so this can only happen when another host (e.g. a standby with archive_mode=always) pushes the
+// same WAL segment during the batch. The list is taken again for the next batch.
+static void
+archivePushAsyncExist(
+    ArchivePushAsyncData *const jobData, const unsigned int repoListIdx, const String *const walFile,
+    ArchivePushFileRepoData *const repoData)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(UINT, repoListIdx);
+        FUNCTION_TEST_PARAM(STRING, walFile);
+        FUNCTION_TEST_PARAM_P(VOID, repoData);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(walFile != NULL);
+    ASSERT(repoData != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        ArchivePushAsyncExist *const exist = lstGet(jobData->existList, repoListIdx);
+        const String *const path = strNewFmt(
+            STORAGE_REPO_ARCHIVE "/%s/%s", strZ(repoData->archiveId), strZ(strSubN(walFile, 0, 16)));
+
+        // List the archive path if it has not already been listed
+        if (!strEq(path, exist->path))
+            archivePushAsyncExistList(jobData, exist, repoData->repoIdx, path);
+        else if (exist->list != NULL)
+            jobData->existAvoidTotal++;
+
+        // Find the WAL segment in the list
+        if (exist->list != NULL)
+        {
+            const String *existFile = NULL;
+            const unsigned int existTotal = archivePushAsyncExistFind(exist->list, walFile, &existFile);
+
+            // If there are duplicates then leave it to the local to report the error
+            if (existTotal <= 1)
+            {
+                repoData->existChecked = true;
+                repoData->existFile = existFile;
+            }
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Get the repo data for a WAL file. If the WAL file is a segment then check if it exists in each repo.
+static List *
+archivePushAsyncRepoList(ArchivePushAsyncData *const jobData, const String *const walFile)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(STRING, walFile);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(walFile != NULL);
+
+    List *const result = lstNewP(sizeof(ArchivePushFileRepoData));
+
+    for (unsigned int repoListIdx = 0; repoListIdx < lstSize(jobData->archiveInfo.repoList); repoListIdx++)
+    {
+        ArchivePushFileRepoData data = *(ArchivePushFileRepoData *)lstGet(jobData->archiveInfo.repoList, repoListIdx);
+
+        // Check if WAL segments exist in the repo here so the archive path is listed once for all the segments in the path
+        if (walIsSegment(walFile))
+            archivePushAsyncExist(jobData, repoListIdx, walFile, &data);
+
+        lstAdd(result, &data);
+    }
+
+    FUNCTION_TEST_RETURN(LIST, result);
+}
+
+// Is the WAL segment known to be missing from all repos?
+static bool
+archivePushAsyncMissing(const List *const repoList)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(LIST, repoList);
+    FUNCTION_TEST_END();
+
+    ASSERT(repoList != NULL);
+
+    bool result = true;
+
+    for (unsigned int repoListIdx = 0; repoListIdx < lstSize(repoList); repoListIdx++)
+    {
+        const ArchivePushFileRepoData *const repoData = lstGet(repoList, repoListIdx);
+
+        if (!repoData->existChecked || repoData->existFile != NULL)
+        {
+            result = false;
+            break;
+        }
+    }
+
+    FUNCTION_TEST_RETURN(BOOL, result);
+}
+
+// Get the size of a WAL file. A missing WAL file is zero size so the error is reported when the file is pushed.
+static uint64_t
+archivePushAsyncSize(const ArchivePushAsyncData *const jobData, const String *const walFile)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(STRING, walFile);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(walFile != NULL);
+
+    uint64_t result;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        result = storageInfoP(
+            storageLocal(), strNewFmt("%s/%s", strZ(jobData->walPath), strZ(walFile)), .ignoreMissing = true).size;
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(UINT64, result);
+}
+
+// Find the WAL segments that follow a WAL segment and can be pushed with it in a bundle. The segments must be consecutive, in the
+// same archive path, and missing from all repos so there is never more than one copy of a segment in a repo. The total size of the
+// segments is limited since they are held in memory while the bundle is written. Returns the bundle file name or NULL when there
+// are no segments to bundle.
+static String *
+archivePushAsyncBundle(ArchivePushAsyncData *const jobData, const String *const walFile, const List *const repoList)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(STRING, walFile);
+        FUNCTION_TEST_PARAM(LIST, repoList);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(walFile != NULL);
+    ASSERT(repoList != NULL);
+
+    String *result = NULL;
+
+    if (walIsSegment(walFile) && !walIsPartial(walFile) && archivePushAsyncMissing(repoList))
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            const String *const path = strSubN(walFile, 0, 16);
+            uint32_t segmentLast = (uint32_t)strtoul(strZ(strSubN(walFile, 16, 8)), NULL, 16);
+            unsigned int segmentTotal = 1;
+            uint64_t sizeTotal = archivePushAsyncSize(jobData, walFile);
+
+            while (segmentTotal < jobData->bundleMax && jobData->walFileIdx < strLstSize(jobData->walFileList))
+            {
+                const String *const walFileNext = strLstGet(jobData->walFileList, jobData->walFileIdx);
+
+                // Stop when the next WAL file is not the next segment in the path or it already exists in a repo
+                if (!strEq(walFileNext, strNewFmt("%s%08X", strZ(path), segmentLast + 1)) ||
+                    !archivePushAsyncMissing(archivePushAsyncRepoList(jobData, walFileNext)))
+                {
+                    break;
+                }
+
+                // Stop when the bundle would be too large
+                const uint64_t size = archivePushAsyncSize(jobData, walFileNext);
+
+                if (sizeTotal + size > jobData->bundleSize)
+                    break;
+
+                segmentLast++;
+                segmentTotal++;
+                sizeTotal += size;
+                jobData->walFileIdx++;
+            }
+
+            if (segmentTotal > 1)
+            {
+                MEM_CONTEXT_PRIOR_BEGIN()
+                {
+                    result = strNewFmt("%s-%s%08X" WAL_BUNDLE_EXT, strZ(walFile), strZ(path), segmentLast);
+                }
+                MEM_CONTEXT_PRIOR_END();
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_TEST_RETURN(STRING, result);
+}
+
 static ProtocolParallelJob *
 archivePushAsyncCallback(void *const data, const unsigned int clientIdx)
 {
@@ -463,39 +772,82 @@ archivePushAsyncCallback(void *const data, const unsigned int clientIdx)
             const String *const walFile = strLstGet(jobData->walFileList, jobData->walFileIdx);
             jobData->walFileIdx++;
 
-            ProtocolCommand *const command = protocolCommandNew(PROTOCOL_COMMAND_ARCHIVE_PUSH_FILE);
-            PackWrite *const param = protocolCommandParam(command);
+            const List *const repoList = archivePushAsyncRepoList(jobData, walFile);
+            const String *const bundleFile = jobData->bundle ? archivePushAsyncBundle(jobData, walFile, repoList) : NULL;
+            ProtocolCommand *command;
 
-            pckWriteStrP(param, strNewFmt("%s/%s", strZ(jobData->walPath), strZ(walFile)));
-            pckWriteBoolP(param, cfgOptionBool(cfgOptArchiveHeaderCheck));
-            pckWriteBoolP(param, cfgOptionBool(cfgOptArchiveModeCheck));
-            pckWriteU32P(param, jobData->archiveInfo.pgVersion);
-            pckWriteU64P(param, jobData->archiveInfo.pgSystemId);
-            pckWriteStrP(param, walFile);
-            pckWriteU32P(param, jobData->compressType);
-            pckWriteI32P(param, jobData->compressLevel);
-            pckWriteStrLstP(param, jobData->archiveInfo.errorList);
-
-            // Add data for each repo to push to
-            pckWriteArrayBeginP(param);
-
-            for (unsigned int repoListIdx = 0; repoListIdx < lstSize(jobData->archiveInfo.repoList); repoListIdx++)
+            // Push a bundle of WAL segments
+            if (bundleFile != NULL)
             {
-                ArchivePushFileRepoData *data = lstGet(jobData->archiveInfo.repoList, repoListIdx);
-
-                pckWriteObjBeginP(param);
-                pckWriteU32P(param, data->repoIdx);
-                pckWriteStrP(param, data->archiveId);
-                pckWriteU64P(param, data->cipherType);
-                pckWriteStrP(param, data->cipherPass);
-                pckWriteObjEndP(param);
+                command = protocolCommandNew(PROTOCOL_COMMAND_ARCHIVE_PUSH_BUNDLE);
+                PackWrite *const param = protocolCommandParam(command);
+
+                pckWriteStrP(param, jobData->walPath);
+                pckWriteBoolP(param, cfgOptionBool(cfgOptArchiveHeaderCheck));
+                pckWriteU32P(param, jobData->archiveInfo.pgVersion);
+                pckWriteU64P(param, jobData->archiveInfo.pgSystemId);
+                pckWriteStrP(param, bundleFile);
+                pckWriteU32P(param, jobData->compressType);
+                pckWriteI32P(param, jobData->compressLevel);
+                pckWriteStrLstP(param, jobData->archiveInfo.errorList);
+
+                // Add data for each repo to push to
+                pckWriteArrayBeginP(param);
+
+                for (unsigned int repoListIdx = 0; repoListIdx < lstSize(repoList); repoListIdx++)
+                {
+                    const ArchivePushFileRepoData *const data = lstGet(repoList, repoListIdx);
+
+                    pckWriteObjBeginP(param);
+                    pckWriteU32P(param, data->repoIdx);
+                    pckWriteStrP(param, data->archiveId);
+                    pckWriteU64P(param, data->cipherType);
+                    pckWriteStrP(param, data->cipherPass);
+                    pckWriteObjEndP(param);
+                }
+
+                pckWriteArrayEndP(param);
             }
+            // Else push a single WAL file
+            else
+            {
+                command = protocolCommandNew(PROTOCOL_COMMAND_ARCHIVE_PUSH_FILE);
+                PackWrite *const param = protocolCommandParam(command);
+
+                pckWriteStrP(param, strNewFmt("%s/%s", strZ(jobData->walPath), strZ(walFile)));
+                pckWriteBoolP(param, cfgOptionBool(cfgOptArchiveHeaderCheck));
+                pckWriteBoolP(param, cfgOptionBool(cfgOptArchiveModeCheck));
+                pckWriteBoolP(param, cfgOptionBool(cfgOptArchivePushSinglePass));
+                pckWriteU32P(param, jobData->archiveInfo.pgVersion);
+                pckWriteU64P(param, jobData->archiveInfo.pgSystemId);
+                pckWriteStrP(param, walFile);
+                pckWriteU32P(param, jobData->compressType);
+                pckWriteI32P(param, jobData->compressLevel);
+                pckWriteStrLstP(param, jobData->archiveInfo.errorList);
+
+                // Add data for each repo to push to
+                pckWriteArrayBeginP(param);
+
+                for (unsigned int repoListIdx = 0; repoListIdx < lstSize(repoList); repoListIdx++)
+                {
+                    const ArchivePushFileRepoData *const data = lstGet(repoList, repoListIdx);
+
+                    pckWriteObjBeginP(param);
+                    pckWriteU32P(param, data->repoIdx);
+                    pckWriteStrP(param, data->archiveId);
+                    pckWriteU64P(param, data->cipherType);
+                    pckWriteStrP(param, data->cipherPass);
+                    pckWriteBoolP(param, data->existChecked);
+                    pckWriteStrP(param, data->existFile);
+                    pckWriteObjEndP(param);
+                }
 
-            pckWriteArrayEndP(param);
+                pckWriteArrayEndP(param);
+            }
 
             MEM_CONTEXT_PRIOR_BEGIN()
             {
-                result = protocolParallelJobNew(VARSTR(walFile), command);
+                result = protocolParallelJobNew(VARSTR(bundleFile != NULL ? bundleFile : walFile), command);
             }
             MEM_CONTEXT_PRIOR_END();
         }
@@ -505,108 +857,133 @@ archivePushAsyncCallback(void *const data, const unsigned int clientIdx)
     FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, result);
 }
 
-FN_EXTERN void
-cmdArchivePushAsync(void)
+// Push a group of WAL files that are ready. WAL files that are pushed or dropped are added to okList. Returns false when any WAL
+// file could not be pushed.
+static bool
+archivePushAsyncProcess(const String *const walPath, const StringList *const walFileList, StringList *const okList)
 {
-    FUNCTION_LOG_VOID(logLevelDebug);
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STRING, walPath);
+        FUNCTION_LOG_PARAM(STRING_LIST, walFileList);
+        FUNCTION_LOG_PARAM(STRING_LIST, okList);
+    FUNCTION_LOG_END();
 
-    ASSERT(cfgCommand() == cfgCmdArchivePush && cfgCommandRole() == cfgCmdRoleAsync);
+    ASSERT(walPath != NULL);
+    ASSERT(walFileList != NULL);
+    ASSERT(okList != NULL);
 
-    // PostgreSQL must be local
-    pgIsLocalVerify();
+    bool result = true;
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
-        // Make sure there is a parameter with the wal path
-        const StringList *const commandParam = cfgCommandParam();
-
-        if (strLstSize(commandParam) != 1)
-            THROW(ParamRequiredError, "WAL path to push required");
-
         ArchivePushAsyncData jobData =
         {
-            .walPath = strLstGet(commandParam, 0),
+            .walPath = walPath,
+            .walFileList = walFileList,
             .compressType = compressTypeEnum(cfgOptionStrId(cfgOptCompressType)),
             .compressLevel = cfgOptionInt(cfgOptCompressLevel),
+            .bundle = cfgOptionBool(cfgOptArchivePushBundle),
+            .bundleMax = cfgOptionBool(cfgOptArchivePushBundle) ? cfgOptionUInt(cfgOptArchivePushBundleMax) : 1,
+            .bundleSize = cfgOptionBool(cfgOptArchivePushBundle) ? cfgOptionUInt64(cfgOptArchivePushBundleSize) : 0,
         };
 
-        TRY_BEGIN()
+        LOG_INFO_FMT(
+            "push %u WAL file(s) to archive: %s%s", strLstSize(jobData.walFileList), strZ(strLstGet(jobData.walFileList, 0)),
+            strLstSize(jobData.walFileList) == 1 ?
+                "" : zNewFmt("...%s", strZ(strLstGet(jobData.walFileList, strLstSize(jobData.walFileList) - 1))));
+
+        // Drop files if queue max has been exceeded
+        if (cfgOptionTest(cfgOptArchivePushQueueMax) && archivePushDrop(jobData.walPath, jobData.walFileList))
         {
-            // Test for stop file
-            lockStopTest();
+            for (unsigned int walFileIdx = 0; walFileIdx < strLstSize(jobData.walFileList); walFileIdx++)
+            {
+                const String *const walFile = strLstGet(jobData.walFileList, walFileIdx);
+                const String *const warning = archivePushDropWarning(walFile, cfgOptionUInt64(cfgOptArchivePushQueueMax));
 
-            // Get a list of WAL files that are ready for processing
-            jobData.walFileList = archivePushProcessList(jobData.walPath);
+                archiveAsyncStatusOkWrite(archiveModePush, walFile, warning);
+                strLstAdd(okList, walFile);
+                LOG_WARN(strZ(warning));
+            }
+        }
+        // Else continue processing
+        else
+        {
+            // Check archive info for each repo
+            jobData.archiveInfo = archivePushCheck(true);
 
-            // The archive-push:async command should not have been called unless there are WAL files to process
-            if (strLstEmpty(jobData.walFileList))
-                THROW(AssertError, "no WAL files to process");
+            // Track the archive path listed for each repo when checking for existing WAL
+            jobData.existList = lstNewP(sizeof(ArchivePushAsyncExist));
+
+            for (unsigned int repoListIdx = 0; repoListIdx < lstSize(jobData.archiveInfo.repoList); repoListIdx++)
+                lstAdd(jobData.existList, &(ArchivePushAsyncExist){0});
+
+            // Create the parallel executor
+            ProtocolParallel *const parallelExec = protocolParallelNew(
+                cfgOptionUInt64(cfgOptProtocolTimeout) / 2, archivePushAsyncCallback, &jobData);
 
-            LOG_INFO_FMT(
-                "push %u WAL file(s) to archive: %s%s", strLstSize(jobData.walFileList), strZ(strLstGet(jobData.walFileList, 0)),
-                strLstSize(jobData.walFileList) == 1 ?
-                    "" : zNewFmt("...%s", strZ(strLstGet(jobData.walFileList, strLstSize(jobData.walFileList) - 1))));
+            for (unsigned int processIdx = 1; processIdx <= cfgOptionUInt(cfgOptProcessMax); processIdx++)
+                protocolParallelClientAdd(parallelExec, protocolLocalGet(protocolStorageTypeRepo, 0, processIdx));
 
-            // Drop files if queue max has been exceeded
-            if (cfgOptionTest(cfgOptArchivePushQueueMax) && archivePushDrop(jobData.walPath, jobData.walFileList))
+            // Process jobs
+            MEM_CONTEXT_TEMP_RESET_BEGIN()
             {
-                for (unsigned int walFileIdx = 0; walFileIdx < strLstSize(jobData.walFileList); walFileIdx++)
+                do
                 {
-                    const String *const walFile = strLstGet(jobData.walFileList, walFileIdx);
-                    const String *const warning = archivePushDropWarning(walFile, cfgOptionUInt64(cfgOptArchivePushQueueMax));
+                    const unsigned int completed = protocolParallelProcess(parallelExec);
 
-                    archiveAsyncStatusOkWrite(archiveModePush, walFile, warning);
-                    LOG_WARN(strZ(warning));
-                }
-            }
-            // Else continue processing
-            else
-            {
-                // Check archive info for each repo
-                jobData.archiveInfo = archivePushCheck(true);
+                    for (unsigned int jobIdx = 0; jobIdx < completed; jobIdx++)
+                    {
+                        protocolKeepAlive();
 
-                // Create the parallel executor
-                ProtocolParallel *const parallelExec = protocolParallelNew(
-                    cfgOptionUInt64(cfgOptProtocolTimeout) / 2, archivePushAsyncCallback, &jobData);
+                        // Get the job and job key
+                        ProtocolParallelJob *const job = protocolParallelResult(parallelExec);
+                        const unsigned int processId = protocolParallelJobProcessId(job);
+                        const String *const jobKey = varStr(protocolParallelJobKey(job));
 
-                for (unsigned int processIdx = 1; processIdx <= cfgOptionUInt(cfgOptProcessMax); processIdx++)
-                    protocolParallelClientAdd(parallelExec, protocolLocalGet(protocolStorageTypeRepo, 0, processIdx));
+                        // Get the WAL files pushed by the job, which is more than one when the job pushed a bundle
+                        const bool bundle = walIsBundle(jobKey);
+                        StringList *const walFileList = bundle ? walBundleSegmentList(jobKey) : strLstNew();
 
-                // Process jobs
-                MEM_CONTEXT_TEMP_RESET_BEGIN()
-                {
-                    do
-                    {
-                        const unsigned int completed = protocolParallelProcess(parallelExec);
+                        if (!bundle)
+                            strLstAdd(walFileList, jobKey);
 
-                        for (unsigned int jobIdx = 0; jobIdx < completed; jobIdx++)
+                        // The job was successful
+                        if (protocolParallelJobErrorCode(job) == 0)
                         {
-                            protocolKeepAlive();
+                            // Output file warnings
+                            const StringList *const fileWarnList = pckReadStrLstP(protocolParallelJobResult(job));
 
-                            // Get the job and job key
-                            ProtocolParallelJob *const job = protocolParallelResult(parallelExec);
-                            const unsigned int processId = protocolParallelJobProcessId(job);
-                            const String *const walFile = varStr(protocolParallelJobKey(job));
+                            for (unsigned int warnIdx = 0; warnIdx < strLstSize(fileWarnList); warnIdx++)
+                                LOG_WARN_PID(processId, strZ(strLstGet(fileWarnList, warnIdx)));
 
-                            // The job was successful
-                            if (protocolParallelJobErrorCode(job) == 0)
+                            for (unsigned int walFileIdx = 0; walFileIdx < strLstSize(walFileList); walFileIdx++)
                             {
-                                // Output file warnings
-                                const StringList *const fileWarnList = pckReadStrLstP(protocolParallelJobResult(job));
-
-                                for (unsigned int warnIdx = 0; warnIdx < strLstSize(fileWarnList); warnIdx++)
-                                    LOG_WARN_PID(processId, strZ(strLstGet(fileWarnList, warnIdx)));
+                                const String *const walFile = strLstGet(walFileList, walFileIdx);
 
                                 // Log success
-                                LOG_DETAIL_PID_FMT(processId, "pushed WAL file '%s' to the archive", strZ(walFile));
+                                LOG_DETAIL_PID_FMT(
+                                    processId, "pushed WAL file '%s' to the archive%s", strZ(walFile),
+                                    bundle ? zNewFmt(" in bundle '%s'", strZ(jobKey)) : "");
 
                                 // Write the status file
                                 archiveAsyncStatusOkWrite(
                                     archiveModePush, walFile, strLstEmpty(fileWarnList) ? NULL : strLstJoin(fileWarnList, "\n"));
+                                strLstAdd(okList, walFile);
+                            }
+
+                            if (bundle)
+                            {
+                                jobData.bundleTotal++;
+                                jobData.bundleSegmentTotal += strLstSize(walFileList);
                             }
-                            // Else the job errored
-                            else
+                        }
+                        // Else the job errored
+                        else
+                        {
+                            for (unsigned int walFileIdx = 0; walFileIdx < strLstSize(walFileList); walFileIdx++)
                             {
+                                const String *const walFile = strLstGet(walFileList, walFileIdx);
+
                                 LOG_WARN_PID_FMT(
                                     processId,
                                     "could not push WAL file '%s' to the archive (will be retried): [%d] %s", strZ(walFile),
@@ -617,16 +994,299 @@ cmdArchivePushAsync(void)
                                     protocolParallelJobErrorMessage(job));
                             }
 
-                            protocolParallelJobFree(job);
+                            result = false;
                         }
 
-                        // Reset the memory context occasionally so we don't use too much memory or slow down processing
-                        MEM_CONTEXT_TEMP_RESET(1000);
+                        protocolParallelJobFree(job);
+                    }
+
+                    // Reset the memory context occasionally so we don't use too much memory or slow down processing
+                    MEM_CONTEXT_TEMP_RESET(1000);
+                }
+                while (!protocolParallelDone(parallelExec));
+            }
+            MEM_CONTEXT_TEMP_END();
+
+            // Log repo list requests avoided by checking for existing WAL once per archive path
+            if (jobData.existAvoidTotal > 0)
+                LOG_DETAIL_FMT("avoided %u repo list request(s) when checking for existing WAL", jobData.existAvoidTotal);
+
+            // Log WAL segments pushed in bundles
+            if (jobData.bundleTotal > 0)
+            {
+                LOG_DETAIL_FMT(
+                    "pushed %u WAL segment(s) to the archive in %u bundle(s)", jobData.bundleSegmentTotal, jobData.bundleTotal);
+            }
+        }
+
+        // Sort the ok list so it can be searched quickly
+        strLstSort(okList, sortOrderAsc);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(BOOL, result);
+}
+
+/***********************************************************************************************************************************
+Watch archive_status for WAL files that become ready while the async process is running. The process pushes them as they become
+ready rather than exiting and being started again by the next archive-push, which would also list archive_status and the spool path
+again.
+***********************************************************************************************************************************/
+#ifdef HAVE_INOTIFY
+
+#define ARCHIVE_PUSH_WATCH_BUFFER_SIZE                              (16 * (sizeof(struct inotify_event) + NAME_MAX + 1))
+
+typedef struct ArchivePushAsyncWatch
+{
+    int fd;                                                         // inotify file descriptor
+    char *buffer;                                                   // Buffer for reading events
+} ArchivePushAsyncWatch;
+
+#define FUNCTION_LOG_ARCHIVE_PUSH_ASYNC_WATCH_TYPE                                                                                 \
+    ArchivePushAsyncWatch *
+#define FUNCTION_LOG_ARCHIVE_PUSH_ASYNC_WATCH_FORMAT(value, buffer, bufferSize)                                                    \
+    objNameToLog(value, "ArchivePushAsyncWatch", buffer, bufferSize)
+
+// Close the inotify file descriptor
+static void
+archivePushAsyncWatchFreeResource(THIS_VOID)
+{
+    THIS(ArchivePushAsyncWatch);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(ARCHIVE_PUSH_ASYNC_WATCH, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    close(this->fd);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+// Start watching archive_status. Returns NULL when the watch cannot be started, in which case the process exits after pushing the
+// WAL files that are ready as it would without a watch.
+static ArchivePushAsyncWatch *
+archivePushAsyncWatchNew(const String *const walPath)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STRING, walPath);
+    FUNCTION_LOG_END();
+
+    ASSERT(walPath != NULL);
+
+    ArchivePushAsyncWatch *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const String *const statusPath = storagePathP(storagePg(), strNewFmt("%s/" PG_PATH_ARCHIVE_STATUS, strZ(walPath)));
+        const int fd = inotify_init1(IN_CLOEXEC);
+        int errNo = errno;
+
+        if (fd != -1)                                               // {uncovered_branch - inotify limits not reached in tests}
+        {
+            // Ready files are created by PostgreSQL and moved to done files once the WAL file has been acknowledged
+            const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_ONLYDIR;
+
+            if (inotify_add_watch(fd, strZ(statusPath), mask) == -1)
+            {
+                errNo = errno;
+                close(fd);
+            }
+            else
+            {
+                MEM_CONTEXT_PRIOR_BEGIN()
+                {
+                    OBJ_NEW_BEGIN(ArchivePushAsyncWatch, .allocQty = 1, .callbackQty = 1)
+                    {
+                        *this = (ArchivePushAsyncWatch)
+                        {
+                            .fd = fd,
+                            .buffer = memNew(ARCHIVE_PUSH_WATCH_BUFFER_SIZE),
+                        };
+
+                        memContextCallbackSet(objMemContext(this), archivePushAsyncWatchFreeResource, this);
                     }
-                    while (!protocolParallelDone(parallelExec));
+                    OBJ_NEW_END();
+
+                    result = this;
+                }
+                MEM_CONTEXT_PRIOR_END();
+            }
+        }
+
+        if (result == NULL)
+            LOG_WARN_FMT("unable to watch '%s' for WAL files that are ready: [%d] %s", strZ(statusPath), errNo, strerror(errNo));
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(ARCHIVE_PUSH_ASYNC_WATCH, result);
+}
+
+// Wait for WAL files to become ready. Returns the WAL files that are ready and have not been pushed, an empty list if no WAL file
+// became ready before the timeout, or NULL if events were lost or archive_status was removed, since the watch can no longer be
+// trusted. Ok files are removed as PostgreSQL acknowledges the WAL files so the spool path does not need to be listed again.
+static StringList *
+archivePushAsyncWatchWait(ArchivePushAsyncWatch *const this, StringList *const okList, const TimeMSec timeout)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(ARCHIVE_PUSH_ASYNC_WATCH, this);
+        FUNCTION_LOG_PARAM(STRING_LIST, okList);
+        FUNCTION_LOG_PARAM(TIME_MSEC, timeout);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(okList != NULL);
+
+    StringList *result = strLstNew();
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Wake up often enough to keep the local and remote processes alive while waiting
+        const TimeMSec keepAliveTime = cfgOptionUInt64(cfgOptProtocolTimeout) / 2;
+        const TimeMSec timeEnd = timeMSec() + timeout;
+        bool lost = false;
+
+        do
+        {
+            // Once a WAL file is ready only read events that are already queued so WAL files that become ready together are pushed
+            // together
+            const TimeMSec timeCurrent = timeMSec();
+            TimeMSec waitTime = 0;
+
+            if (strLstEmpty(result) && timeCurrent < timeEnd)
+                waitTime = timeEnd - timeCurrent < keepAliveTime ? timeEnd - timeCurrent : keepAliveTime;
+
+            if (!fdReadyRead(this->fd, waitTime))
+            {
+                if (waitTime == 0)
+                    break;
+
+                for (unsigned int processIdx = 1; processIdx <= cfgOptionUInt(cfgOptProcessMax); processIdx++)
+                    protocolClientNoOp(protocolLocalGet(protocolStorageTypeRepo, 0, processIdx));
+
+                protocolKeepAlive();
+                continue;
+            }
+
+            const ssize_t size = read(this->fd, this->buffer, ARCHIVE_PUSH_WATCH_BUFFER_SIZE);
+            THROW_ON_SYS_ERROR(size == -1, FileReadError, "unable to read events for WAL files that are ready");
+
+            for (ssize_t bufferIdx = 0; bufferIdx < size;)
+            {
+                const struct inotify_event *const event = (const struct inotify_event *)(this->buffer + bufferIdx);
+                bufferIdx += (ssize_t)(sizeof(struct inotify_event) + event->len);
+
+                // Events were lost or archive_status is no longer being watched
+                if (event->mask & (IN_Q_OVERFLOW | IN_IGNORED | IN_UNMOUNT))
+                {
+                    lost = true;
+                    break;
                 }
-                MEM_CONTEXT_TEMP_END();
+
+                ASSERT(event->len > 0);
+
+                // Skip files that are not ready files
+                const String *const file = STR(event->name);
+
+                if (!strEndsWithZ(file, STATUS_EXT_READY))
+                    continue;
+
+                const String *const walFile = strSubN(file, 0, strSize(file) - STATUS_EXT_READY_SIZE);
+
+                // The WAL file is ready so push it unless it has already been pushed
+                if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+                {
+                    if (!strLstExists(okList, walFile))
+                        strLstAddIfMissing(result, walFile);
+                }
+                // Else the WAL file has been acknowledged by PostgreSQL so the ok file is no longer needed
+                else
+                {
+                    strLstRemove(result, walFile);
+                    strLstRemove(okList, walFile);
+                    storageRemoveP(storageSpoolWrite(), strNewFmt(STORAGE_SPOOL_ARCHIVE_OUT "/%s" STATUS_EXT_OK, strZ(walFile)));
+                }
+            }
+        }
+        while (!lost);
+
+        if (lost)
+        {
+            LOG_DETAIL("stop watching archive_status since events were lost or the path was removed");
+
+            strLstFree(result);
+            result = NULL;
+        }
+        else
+            strLstSort(result, sortOrderAsc);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(STRING_LIST, result);
+}
+
+#endif // HAVE_INOTIFY
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+cmdArchivePushAsync(void)
+{
+    FUNCTION_LOG_VOID(logLevelDebug);
+
+    ASSERT(cfgCommand() == cfgCmdArchivePush && cfgCommandRole() == cfgCmdRoleAsync);
+
+    // PostgreSQL must be local
+    pgIsLocalVerify();
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Make sure there is a parameter with the wal path
+        const StringList *const commandParam = cfgCommandParam();
+
+        if (strLstSize(commandParam) != 1)
+            THROW(ParamRequiredError, "WAL path to push required");
+
+        const String *const walPath = strLstGet(commandParam, 0);
+
+        TRY_BEGIN()
+        {
+            // Test for stop file
+            lockStopTest();
+
+#ifdef HAVE_INOTIFY
+            // Start watching archive_status before getting the list of WAL files so no WAL file that becomes ready is missed
+            const TimeMSec watchTime = cfgOptionUInt64(cfgOptArchivePushWatch);
+            ArchivePushAsyncWatch *const watch = watchTime > 0 ? archivePushAsyncWatchNew(walPath) : NULL;
+#endif
+
+            // Get a list of WAL files that are ready for processing and the WAL files that have already been pushed
+            StringList *const okList = strLstNew();
+            StringList *walFileList = archivePushProcessList(walPath, okList);
+
+            // The archive-push:async command should not have been called unless there are WAL files to process
+            if (strLstEmpty(walFileList))
+                THROW(AssertError, "no WAL files to process");
+
+            bool pushed = archivePushAsyncProcess(walPath, walFileList, okList);
+
+#ifdef HAVE_INOTIFY
+            // Push WAL files as they become ready until none are ready before the watch time expires. Exit on error so the error is
+            // reported and a new process retries the WAL files.
+            while (pushed && watch != NULL)
+            {
+                strLstFree(walFileList);
+                walFileList = archivePushAsyncWatchWait(watch, okList, watchTime);
+
+                if (walFileList == NULL || strLstEmpty(walFileList))
+                    break;
+
+                lockStopTest();
+                pushed = archivePushAsyncProcess(walPath, walFileList, okList);
             }
+#else
+            (void)pushed;
+#endif
         }
         // On any global error write a single error file to cover all unprocessed files
         CATCH_FATAL()
@@ -8,6 +8,7 @@ Backup Command
 #include <time.h>
 #include <unistd.h>
 
+#include "command/archive/common.h"
 #include "command/archive/find.h"
 #include "command/backup/backup.h"
 #include "command/backup/common.h"
@@ -18,6 +19,7 @@ Backup Command
 #include "command/stanza/common.h"
 #include "common/compress/helper.h"
 #include "common/crypto/cipherBlock.h"
+#include "common/crypto/xxhash.h"
 #include "common/debug.h"
 #include "common/io/filter/size.h"
 #include "common/lock.h"
@@ -194,6 +196,15 @@ backupInit(const InfoBackup *const infoBackup)
         cfgOptionSet(cfgOptBackupStandby, cfgSourceParam, BOOL_FALSE_VAR);
     }
 
+    // Warn when there are fewer compress threads than processes since each process will still use a thread
+    if (cfgOptionUInt(cfgOptCompressThreadMax) > 0 && cfgOptionUInt(cfgOptCompressThreadMax) < cfgOptionUInt(cfgOptProcessMax))
+    {
+        LOG_WARN_FMT(
+            "option " CFGOPT_COMPRESS_THREAD_MAX " (%u) is less than " CFGOPT_PROCESS_MAX " (%u) - each process will use one"
+            " compress thread",
+            cfgOptionUInt(cfgOptCompressThreadMax), cfgOptionUInt(cfgOptProcessMax));
+    }
+
     // Get database info when online
     PgControl pgControl = {0};
 
@@ -816,6 +827,8 @@ backupResumeClean(
                                 file.sizeRepo = fileResume.sizeRepo;
                                 file.checksumSha1 = fileResume.checksumSha1;
                                 file.checksumRepoSha1 = fileResume.checksumRepoSha1;
+                                file.checksumXxh3 = fileResume.checksumXxh3;
+                                file.checksumRepoXxh3 = fileResume.checksumRepoXxh3;
                                 file.blockIncrSize = fileResume.blockIncrSize;
                                 file.blockIncrChecksumSize = fileResume.blockIncrChecksumSize;
                                 file.blockIncrMapSize = fileResume.blockIncrMapSize;
@@ -1166,6 +1179,7 @@ backupFilePut(
         {
             // Create file
             bool repoChecksum = false;
+            const bool checksumXxh3 = cfgOptionBool(cfgOptRepoChecksumXxh3);
             const String *const manifestName = strNewFmt(MANIFEST_TARGET_PGDATA "/%s", strZ(name));
             const CompressType compressType = compressTypeEnum(cfgOptionStrId(cfgOptCompressType));
 
@@ -1181,6 +1195,10 @@ backupFilePut(
             // Add SHA1 filter
             ioFilterGroupAdd(filterGroup, cryptoHashNew(hashTypeSha1));
 
+            // Add xxh3 filter
+            if (checksumXxh3)
+                ioFilterGroupAdd(filterGroup, xxHashNew(XX_HASH_SIZE_MAX));
+
             // Add compression
             if (compressType != compressTypeNone)
             {
@@ -1203,8 +1221,13 @@ backupFilePut(
 
             // Capture checksum of file stored in the repo if filters that modify the output have been applied
             if (repoChecksum)
+            {
                 ioFilterGroupAdd(filterGroup, cryptoHashNew(hashTypeSha1));
 
+                if (checksumXxh3)
+                    ioFilterGroupAdd(filterGroup, xxHashNew(XX_HASH_SIZE_MAX));
+            }
+
             // Add size filter last to calculate repo size
             ioFilterGroupAdd(filterGroup, ioSizeNew());
 
@@ -1228,9 +1251,17 @@ backupFilePut(
                 .checksumSha1 = bufPtr(pckReadBinP(ioFilterGroupResultP(filterGroup, CRYPTO_HASH_FILTER_TYPE, .idx = 0))),
             };
 
+            if (checksumXxh3)
+                file.checksumXxh3 = bufPtr(pckReadBinP(ioFilterGroupResultP(filterGroup, XX_HASH_FILTER_TYPE, .idx = 0)));
+
             if (repoChecksum)
+            {
                 file.checksumRepoSha1 = bufPtr(pckReadBinP(ioFilterGroupResultP(filterGroup, CRYPTO_HASH_FILTER_TYPE, .idx = 1)));
 
+                if (checksumXxh3)
+                    file.checksumRepoXxh3 = bufPtr(pckReadBinP(ioFilterGroupResultP(filterGroup, XX_HASH_FILTER_TYPE, .idx = 1)));
+            }
+
             manifestFileAdd(manifest, &file);
 
             LOG_DETAIL_FMT("wrote '%s' file returned from backup stop function", strZ(name));
@@ -1439,6 +1470,8 @@ backupJobResult(
                 const uint64_t repoSize = pckReadU64P(jobResult);
                 const Buffer *const copyChecksum = pckReadBinP(jobResult);
                 const Buffer *const repoChecksum = pckReadBinP(jobResult);
+                const Buffer *const copyChecksumXxh3 = pckReadBinP(jobResult);
+                const Buffer *const repoChecksumXxh3 = pckReadBinP(jobResult);
                 PackRead *const checksumPageResult = pckReadPackReadP(jobResult);
 
                 // Increment backup copy progress. Use the original size since the size may have changed during the copy but for the
@@ -1587,6 +1620,8 @@ backupJobResult(
                     file.sizeRepo = repoSize;
                     file.checksumSha1 = bufPtrConst(copyChecksum);
                     file.checksumRepoSha1 = repoChecksum != NULL ? bufPtrConst(repoChecksum) : NULL;
+                    file.checksumXxh3 = copyChecksumXxh3 != NULL ? bufPtrConst(copyChecksumXxh3) : NULL;
+                    file.checksumRepoXxh3 = repoChecksumXxh3 != NULL ? bufPtrConst(repoChecksumXxh3) : NULL;
                     file.reference = NULL;
                     file.checksumPageError = checksumPageError;
                     file.checksumPageErrorList =
@@ -1698,6 +1733,8 @@ typedef struct BackupJobData
     const PgPageSize pageSize;                                      // Page size
     const CompressType compressType;                                // Backup compression type
     const int compressLevel;                                        // Compress level if backup is compressed
+    const unsigned int compressThreadMax;                           // Compress worker threads for all processes
+    const unsigned int processMax;                                  // Processes that compress files
     const bool delta;                                               // Is this a checksum delta backup?
     const bool bundle;                                              // Bundle files?
     uint64_t bundleSize;                                            // Target bundle size
@@ -1705,8 +1742,10 @@ typedef struct BackupJobData
     uint64_t bundleId;                                              // Bundle id
     const bool blockIncr;                                           // Block incremental?
     size_t blockIncrSizeSuper;                                      // Super block size
+    const bool checksumXxh3;                                        // Record xxh3 checksums in the manifest?
 
     List *queueList;                                                // List of processing queues
+    List *queueSizeList;                                            // Bytes remaining to be copied in each processing queue
 } BackupJobData;
 
 // Identify files that must be copied from the primary
@@ -1788,6 +1827,7 @@ backupProcessQueue(const BackupData *const backupData, Manifest *const manifest,
     {
         // Create list of process queues (use void * instead of List * to avoid Coverity false positive)
         jobData->queueList = lstNewP(sizeof(void *));
+        jobData->queueSizeList = lstNewP(sizeof(uint64_t));
 
         // Generate the list of targets
         StringList *const targetList = strLstNew();
@@ -1810,6 +1850,7 @@ backupProcessQueue(const BackupData *const backupData, Manifest *const manifest,
             {
                 List *const queue = lstNewP(sizeof(ManifestFile *), .comparator = backupProcessQueueComparator);
                 lstAdd(jobData->queueList, &queue);
+                lstAdd(jobData->queueSizeList, &(uint64_t){0});
             }
         }
         MEM_CONTEXT_END();
@@ -1841,9 +1882,11 @@ backupProcessQueue(const BackupData *const backupData, Manifest *const manifest,
                 pgControlFound = true;
 
             // Files that must be copied from the primary are always put in queue 0 when backup from standby
+            unsigned int queueIdx = 0;
+
             if (jobData->backupStandby && backupProcessFilePrimary(jobData->standbyExp, file.name))
             {
-                lstAdd(*(List **)lstGet(jobData->queueList, 0), &filePack);
+                lstAdd(*(List **)lstGet(jobData->queueList, queueIdx), &filePack);
             }
             // Else find the correct queue by matching the file to a target
             else
@@ -1863,10 +1906,12 @@ backupProcessQueue(const BackupData *const backupData, Manifest *const manifest,
                 while (1);
 
                 // Add file to queue
-                lstAdd(*(List **)lstGet(jobData->queueList, targetIdx + queueOffset), &filePack);
+                queueIdx = targetIdx + queueOffset;
+                lstAdd(*(List **)lstGet(jobData->queueList, queueIdx), &filePack);
             }
 
-            // Add size to total
+            // Add size to queue and total
+            *(uint64_t *)lstGet(jobData->queueSizeList, queueIdx) += file.size;
             result += file.size;
 
             // Increment total files
@@ -1897,32 +1942,76 @@ backupProcessQueue(const BackupData *const backupData, Manifest *const manifest,
 
         // Move process queues to prior context
         lstMove(jobData->queueList, memContextPrior());
+        lstMove(jobData->queueSizeList, memContextPrior());
     }
     MEM_CONTEXT_TEMP_END();
 
     FUNCTION_LOG_RETURN(UINT64, result);
 }
 
-// Helper to calculate the next queue to scan based on the client index
+// Helper to find the non-empty queue with the most bytes remaining. Clients that have emptied their own queue steal from this queue
+// since it is the one most likely to extend the tail of the backup. Returns -1 when all queues are empty.
 static int
-backupJobQueueNext(const unsigned int clientIdx, int queueIdx, const unsigned int queueTotal)
+backupJobQueueSteal(const List *const queueList, const List *const queueSizeList, const unsigned int queueOffset)
 {
     FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(LIST, queueList);
+        FUNCTION_TEST_PARAM(LIST, queueSizeList);
+        FUNCTION_TEST_PARAM(UINT, queueOffset);
+    FUNCTION_TEST_END();
+
+    ASSERT(queueList != NULL);
+    ASSERT(queueSizeList != NULL);
+    ASSERT(lstSize(queueList) == lstSize(queueSizeList));
+
+    int result = -1;
+    uint64_t resultSize = 0;
+
+    for (unsigned int queueIdx = queueOffset; queueIdx < lstSize(queueList); queueIdx++)
+    {
+        const uint64_t queueSize = *(const uint64_t *)lstGet(queueSizeList, queueIdx);
+
+        if (!lstEmpty(*(const List **)lstGet(queueList, queueIdx)) && (result == -1 || queueSize > resultSize))
+        {
+            result = (int)queueIdx;
+            resultSize = queueSize;
+        }
+    }
+
+    FUNCTION_TEST_RETURN(INT, result);
+}
+
+// Helper to get the compress worker threads for a client. Threads are divided between the processes set by process-max with the
+// remainder going to the first processes. When threads are enabled each process gets at least one thread, even when there are fewer
+// threads than processes. During backup from standby the primary client is not counted in process-max and only copies files that
+// must come from the primary, so it gets no threads and the total for the standby clients is not exceeded.
+static unsigned int
+backupJobCompressThread(
+    const unsigned int compressThreadMax, const unsigned int processMax, const bool backupStandby, const unsigned int clientIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(UINT, compressThreadMax);
+        FUNCTION_TEST_PARAM(UINT, processMax);
+        FUNCTION_TEST_PARAM(BOOL, backupStandby);
         FUNCTION_TEST_PARAM(UINT, clientIdx);
-        FUNCTION_TEST_PARAM(INT, queueIdx);
-        FUNCTION_TEST_PARAM(UINT, queueTotal);
     FUNCTION_TEST_END();
 
-    // Move (forward or back) to the next queue
-    queueIdx += clientIdx % 2 ? -1 : 1;
+    ASSERT(processMax > 0);
 
-    // Deal with wrapping on either end
-    if (queueIdx < 0)
-        FUNCTION_TEST_RETURN(INT, (int)queueTotal - 1);
-    else if (queueIdx == (int)queueTotal)
-        FUNCTION_TEST_RETURN(INT, 0);
+    unsigned int result = 0;
+
+    if (!backupStandby || clientIdx > 0)
+    {
+        const unsigned int processIdx = clientIdx - (backupStandby ? 1 : 0);
+        ASSERT(processIdx < processMax);
 
-    FUNCTION_TEST_RETURN(INT, queueIdx);
+        result = compressThreadMax / processMax + (processIdx < compressThreadMax % processMax ? 1 : 0);
+
+        if (compressThreadMax > 0 && result == 0)
+            result = 1;
+    }
+
+    FUNCTION_TEST_RETURN(UINT, result);
 }
 
 // Callback to fetch backup jobs for the parallel executor
@@ -1943,12 +2032,15 @@ backupJobCallback(void *const data, const unsigned int clientIdx)
         // Get a new job if there are any left
         BackupJobData *const jobData = data;
 
-        // Determine where to begin scanning the queue (we'll stop when we get back here). When copying from the primary during
-        // backup from standby only queue 0 will be used.
+        // Start with the queue assigned to this client. If that queue is empty then steal from the queue with the most bytes
+        // remaining. When copying from the primary during backup from standby only queue 0 will be used since the primary only has
+        // one queue.
+        const bool primaryOnly = jobData->backupStandby && clientIdx == 0;
         const unsigned int queueOffset = jobData->backupStandby && clientIdx > 0 ? 1 : 0;
-        int queueIdx =
-            jobData->backupStandby && clientIdx == 0 ? 0 : (int)(clientIdx % (lstSize(jobData->queueList) - queueOffset));
-        const int queueEnd = queueIdx;
+        int queueIdx = primaryOnly ? 0 : (int)(clientIdx % (lstSize(jobData->queueList) - queueOffset) + queueOffset);
+
+        if (!primaryOnly && lstEmpty(*(List **)lstGet(jobData->queueList, (unsigned int)queueIdx)))
+            queueIdx = backupJobQueueSteal(jobData->queueList, jobData->queueSizeList, queueOffset);
 
         // Create backup job
         ProtocolCommand *const command = protocolCommandNew(PROTOCOL_COMMAND_BACKUP_FILE);
@@ -1956,9 +2048,9 @@ backupJobCallback(void *const data, const unsigned int clientIdx)
         uint64_t fileTotal = 0;
         uint64_t fileSize = 0;
 
-        do
+        if (queueIdx != -1)
         {
-            List *const queue = *(List **)lstGet(jobData->queueList, (unsigned int)queueIdx + queueOffset);
+            List *const queue = *(List **)lstGet(jobData->queueList, (unsigned int)queueIdx);
             unsigned int fileIdx = 0;
             bool bundle = jobData->bundle;
             const String *fileName = NULL;
@@ -2008,10 +2100,15 @@ backupJobCallback(void *const data, const unsigned int clientIdx)
 
                     pckWriteU32P(param, jobData->compressType);
                     pckWriteI32P(param, jobData->compressLevel);
+                    pckWriteU32P(
+                        param,
+                        backupJobCompressThread(
+                            jobData->compressThreadMax, jobData->processMax, jobData->backupStandby, clientIdx));
                     pckWriteU64P(param, jobData->cipherSubPass == NULL ? cipherTypeNone : cipherTypeAes256Cbc);
                     pckWriteStrP(param, jobData->cipherSubPass);
                     pckWriteU32P(param, jobData->pageSize);
                     pckWriteStrP(param, cfgOptionStrNull(cfgOptPgVersionForce));
+                    pckWriteBoolP(param, jobData->checksumXxh3);
                 }
 
                 pckWriteStrP(param, manifestPathPg(file.name));
@@ -2021,6 +2118,7 @@ backupJobCallback(void *const data, const unsigned int clientIdx)
                 pckWriteU64P(param, file.sizePrior);
                 pckWriteBoolP(param, !backupProcessFilePrimary(jobData->standbyExp, file.name));
                 pckWriteBinP(param, file.checksumSha1 != NULL ? BUF(file.checksumSha1, HASH_TYPE_SHA1_SIZE) : NULL);
+                pckWriteBinP(param, file.checksumXxh3 != NULL ? BUF(file.checksumXxh3, XX_HASH_SIZE_MAX) : NULL);
                 pckWriteBoolP(param, file.checksumPage);
                 pckWriteBoolP(param, cfgOptionBool(cfgOptPageHeaderCheck));
 
@@ -2048,6 +2146,7 @@ backupJobCallback(void *const data, const unsigned int clientIdx)
 
                 pckWriteStrP(param, file.name);
                 pckWriteBinP(param, file.checksumRepoSha1 != NULL ? BUF(file.checksumRepoSha1, HASH_TYPE_SHA1_SIZE) : NULL);
+                pckWriteBinP(param, file.checksumRepoXxh3 != NULL ? BUF(file.checksumRepoXxh3, XX_HASH_SIZE_MAX) : NULL);
                 pckWriteU64P(param, file.sizeRepo);
                 pckWriteBoolP(param, file.resume);
                 pckWriteBoolP(param, file.reference != NULL);
@@ -2056,6 +2155,7 @@ backupJobCallback(void *const data, const unsigned int clientIdx)
                 fileSize += file.size;
 
                 // Remove job from the queue
+                *(uint64_t *)lstGet(jobData->queueSizeList, (unsigned int)queueIdx) -= file.size;
                 lstRemoveIdx(queue, fileIdx);
 
                 // Break if not bundling or bundle size has been reached
@@ -2074,15 +2174,8 @@ backupJobCallback(void *const data, const unsigned int clientIdx)
                         jobData->bundleId++;
                 }
                 MEM_CONTEXT_PRIOR_END();
-
-                break;
             }
-
-            // Don't get next queue when copying from primary during backup from standby since the primary only has one queue
-            if (!jobData->backupStandby || clientIdx > 0)
-                queueIdx = backupJobQueueNext(clientIdx, queueIdx, lstSize(jobData->queueList) - queueOffset);
         }
-        while (queueIdx != queueEnd);
     }
     MEM_CONTEXT_TEMP_END();
 
@@ -2118,6 +2211,8 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
             .backupStandby = backupStandby,
             .compressType = compressTypeEnum(cfgOptionStrId(cfgOptCompressType)),
             .compressLevel = cfgOptionInt(cfgOptCompressLevel),
+            .compressThreadMax = cfgOptionUInt(cfgOptCompressThreadMax),
+            .processMax = cfgOptionUInt(cfgOptProcessMax),
             .cipherType = cfgOptionStrId(cfgOptRepoCipherType),
             .cipherSubPass = manifestCipherSubPass(manifest),
             .pageSize = backupData->pageSize,
@@ -2125,6 +2220,7 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
             .bundle = cfgOptionBool(cfgOptRepoBundle),
             .bundleId = 1,
             .blockIncr = cfgOptionBool(cfgOptRepoBlock),
+            .checksumXxh3 = cfgOptionBool(cfgOptRepoChecksumXxh3),
 
             // Build expression to identify files that can be copied from the standby when standby backup is supported
             .standbyExp = regExpNew(
@@ -2259,6 +2355,9 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
         }
         MEM_CONTEXT_TEMP_END();
 
+        // Report how long the backup ran after the first process ran out of files to copy
+        LOG_DEBUG_FMT("backup tail time %" PRIu64 "ms", protocolParallelTailTime(parallelExec));
+
 #ifdef DEBUG
         // Ensure that all processing queues are empty
         for (unsigned int queueIdx = 0; queueIdx < lstSize(jobData.queueList); queueIdx++)
@@ -2378,10 +2477,11 @@ backupArchiveCheckCopy(const BackupData *const backupData, Manifest *const manif
                         const CompressType archiveCompressType = compressTypeFromName(archiveFile);
                         const CompressType backupCompressType = compressTypeEnum(cfgOptionStrId(cfgOptCompressType));
 
-                        // Open the archive file
-                        StorageRead *const read = storageNewReadP(
+                        // Open the archive file, which may be a bundle containing the segment
+                        StorageRead *const read = walSegmentReadNew(
                             storageRepo(),
-                            strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(backupData->archiveId), strZ(archiveFile)));
+                            strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(backupData->archiveId), strZ(archiveFile)), walSegment,
+                            false, false);
                         IoFilterGroup *const filterGroup = ioReadFilterGroup(storageReadIo(read));
 
                         // Decrypt with archive key if encrypted
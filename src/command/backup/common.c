@@ -6,6 +6,8 @@ Common Functions and Definitions for Backup and Expire Commands
 #include <unistd.h>
 
 #include "command/backup/common.h"
+#include "common/crypto/hash.h"
+#include "common/crypto/xxhash.h"
 #include "common/debug.h"
 #include "common/log.h"
 #include "storage/helper.h"
@@ -44,6 +46,20 @@ backupFileRepoPath(const String *const backupLabel, const BackupFileRepoPathPara
     FUNCTION_TEST_RETURN(STRING, result);
 }
 
+/**********************************************************************************************************************************/
+FN_EXTERN IoFilter *
+backupChecksumFilter(const Buffer *const checksum)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BUFFER, checksum);
+    FUNCTION_TEST_END();
+
+    ASSERT(checksum != NULL);
+
+    FUNCTION_TEST_RETURN(
+        IO_FILTER, bufUsed(checksum) == XX_HASH_SIZE_MAX ? xxHashNew(XX_HASH_SIZE_MAX) : cryptoHashNew(hashTypeSha1));
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN String *
 backupLabelFormat(const BackupType type, const String *const backupLabelPrior, const time_t timestamp)
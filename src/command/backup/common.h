@@ -8,6 +8,7 @@ Common Functions and Definitions for Backup and Expire Commands
 #include <time.h>
 
 #include "common/compress/helper.h"
+#include "common/io/filter/filter.h"
 #include "common/type/string.h"
 #include "info/infoBackup.h"
 
@@ -38,6 +39,11 @@ typedef struct BackupFileRepoPathParam
 
 FN_EXTERN String *backupFileRepoPath(const String *backupLabel, BackupFileRepoPathParam param);
 
+// Create a filter to calculate a checksum of the same type as the expected checksum, i.e. xxh3 when the checksum is XX_HASH_SIZE_MAX
+// bytes and SHA1 otherwise. xxh3 checksums are preferred when they have been recorded in the manifest since they are much faster to
+// calculate than SHA1. The result is retrieved with the filter type.
+FN_EXTERN IoFilter *backupChecksumFilter(const Buffer *checksum);
+
 // Format a backup label from a type and timestamp with an optional prior label
 FN_EXTERN String *backupLabelFormat(BackupType type, const String *backupLabelPrior, time_t timestamp);
 
@@ -6,10 +6,12 @@ Backup File
 #include <string.h>
 
 #include "command/backup/blockIncr.h"
+#include "command/backup/common.h"
 #include "command/backup/file.h"
 #include "command/backup/pageChecksum.h"
 #include "common/crypto/cipherBlock.h"
 #include "common/crypto/hash.h"
+#include "common/crypto/xxhash.h"
 #include "common/debug.h"
 #include "common/io/bufferRead.h"
 #include "common/io/filter/group.h"
@@ -22,6 +24,12 @@ Backup File
 #include "info/manifest.h"
 #include "storage/helper.h"
 
+/***********************************************************************************************************************************
+Minimum file size to compress with worker threads. zstd splits the input into jobs of several MiB per worker, so smaller files would
+not be compressed in parallel and would only pay the cost of starting the workers.
+***********************************************************************************************************************************/
+#define BACKUP_FILE_COMPRESS_THREAD_SIZE_MIN                        (8 * 1024 * 1024)
+
 /***********************************************************************************************************************************
 Helper functions
 ***********************************************************************************************************************************/
@@ -40,8 +48,9 @@ segmentNumber(const String *const pgFile)
 FN_EXTERN List *
 backupFile(
     const String *const repoFile, const uint64_t bundleId, const bool bundleRaw, const unsigned int blockIncrReference,
-    const CompressType repoFileCompressType, const int repoFileCompressLevel, const CipherType cipherType,
-    const String *const cipherPass, const String *const pgVersionForce, const PgPageSize pageSize, const List *const fileList)
+    const CompressType repoFileCompressType, const int repoFileCompressLevel, const unsigned int repoFileCompressThread,
+    const CipherType cipherType, const String *const cipherPass, const String *const pgVersionForce, const PgPageSize pageSize,
+    const bool checksumXxh3, const List *const fileList)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, repoFile);                       // Repo file
@@ -50,10 +59,12 @@ backupFile(
         FUNCTION_LOG_PARAM(UINT, blockIncrReference);               // Block incremental reference to use in map
         FUNCTION_LOG_PARAM(ENUM, repoFileCompressType);             // Compress type for repo file
         FUNCTION_LOG_PARAM(INT, repoFileCompressLevel);             // Compression level for repo file
+        FUNCTION_LOG_PARAM(UINT, repoFileCompressThread);           // Compression worker threads for repo file
         FUNCTION_LOG_PARAM(STRING_ID, cipherType);                  // Encryption type
         FUNCTION_TEST_PARAM(STRING, cipherPass);                    // Password to access the repo file if encrypted
         FUNCTION_LOG_PARAM(ENUM, pageSize);                         // Page size
         FUNCTION_LOG_PARAM(STRING, pgVersionForce);                 // Force pg version
+        FUNCTION_LOG_PARAM(BOOL, checksumXxh3);                     // Calculate xxh3 checksums for the manifest?
         FUNCTION_LOG_PARAM(LIST, fileList);                         // List of files to backup
     FUNCTION_LOG_END();
 
@@ -89,23 +100,27 @@ backupFile(
                 {
                     // Generate checksum/size for the pg file. Only read as many bytes as passed in pgFileSize. If the file has
                     // grown since the manifest was built we don't need to consider the extra bytes since they will be replayed from
-                    // WAL during recovery.
+                    // WAL during recovery. Use the xxh3 checksum when it was recorded since it is much faster to calculate.
+                    const Buffer *const pgFileChecksum =
+                        file->pgFileChecksumXxh3 != NULL ? file->pgFileChecksumXxh3 : file->pgFileChecksum;
+                    IoFilter *const pgFileChecksumFilter = backupChecksumFilter(pgFileChecksum);
+
                     IoRead *const read = storageReadIo(
                         storageNewReadP(
                             storagePg(), file->pgFile, .ignoreMissing = file->pgFileIgnoreMissing,
                             .limit = file->pgFileCopyExactSize ? VARUINT64(file->pgFileSize) : NULL));
-                    ioFilterGroupAdd(ioReadFilterGroup(read), cryptoHashNew(hashTypeSha1));
+                    ioFilterGroupAdd(ioReadFilterGroup(read), pgFileChecksumFilter);
                     ioFilterGroupAdd(ioReadFilterGroup(read), ioSizeNew());
 
                     // If the pg file exists check the checksum/size
                     if (ioReadDrain(read))
                     {
                         const Buffer *const pgTestChecksum = pckReadBinP(
-                            ioFilterGroupResultP(ioReadFilterGroup(read), CRYPTO_HASH_FILTER_TYPE));
+                            ioFilterGroupResultP(ioReadFilterGroup(read), ioFilterType(pgFileChecksumFilter)));
                         const uint64_t pgTestSize = pckReadU64P(ioFilterGroupResultP(ioReadFilterGroup(read), SIZE_FILTER_TYPE));
 
                         // Does the pg file match?
-                        if (file->pgFileSize == pgTestSize && bufEq(file->pgFileChecksum, pgTestChecksum))
+                        if (file->pgFileSize == pgTestSize && bufEq(pgFileChecksum, pgTestChecksum))
                         {
                             pgFileMatch = true;
 
@@ -142,23 +157,38 @@ backupFile(
                     // Else if the pg file matches or is unknown because delta was not performed then check the repo file
                     else if (!file->pgFileDelta || pgFileMatch)
                     {
+                        // Expected checksum of the repo file. When the repo checksum is missing compare to the pg file checksum
+                        // since the repo checksum should only be missing when the repo file was not compressed/encrypted. There is
+                        // no need to worry about old manifests here since resume does not work across versions.
+                        const Buffer *repoFileChecksum = file->repoFileChecksum;
+                        const Buffer *repoFileChecksumXxh3 = file->repoFileChecksumXxh3;
+
+                        if (repoFileChecksum == NULL)
+                        {
+                            repoFileChecksum = file->pgFileChecksum;
+                            repoFileChecksumXxh3 = file->pgFileChecksumXxh3;
+                        }
+
+                        // Prefer the xxh3 checksum when it was recorded
+                        if (repoFileChecksumXxh3 != NULL)
+                            repoFileChecksum = repoFileChecksumXxh3;
+
+                        IoFilter *const repoFileChecksumFilter = backupChecksumFilter(repoFileChecksum);
+
                         // Generate checksum/size for the repo file
                         IoRead *const read = storageReadIo(storageNewReadP(storageRepo(), repoFile));
-                        ioFilterGroupAdd(ioReadFilterGroup(read), cryptoHashNew(hashTypeSha1));
+                        ioFilterGroupAdd(ioReadFilterGroup(read), repoFileChecksumFilter);
                         ioFilterGroupAdd(ioReadFilterGroup(read), ioSizeNew());
                         ioReadDrain(read);
 
                         // Test checksum/size
                         const Buffer *const pgTestChecksum = pckReadBinP(
-                            ioFilterGroupResultP(ioReadFilterGroup(read), CRYPTO_HASH_FILTER_TYPE));
+                            ioFilterGroupResultP(ioReadFilterGroup(read), ioFilterType(repoFileChecksumFilter)));
                         const uint64_t pgTestSize = pckReadU64P(ioFilterGroupResultP(ioReadFilterGroup(read), SIZE_FILTER_TYPE));
 
                         // No need to recopy if checksum/size match. When the repo checksum is missing still compare to repo size
-                        // since the repo checksum should only be missing when the repo file was not compressed/encrypted, i.e. the
-                        // repo size should match the original size. There is no need to worry about old manifests here since resume
-                        // does not work across versions.
-                        if (file->repoFileSize == pgTestSize &&
-                            bufEq(file->repoFileChecksum != NULL ? file->repoFileChecksum : file->pgFileChecksum, pgTestChecksum))
+                        // since the repo size should match the original size.
+                        if (file->repoFileSize == pgTestSize && bufEq(repoFileChecksum, pgTestChecksum))
                         {
                             MEM_CONTEXT_BEGIN(lstMemContext(result))
                             {
@@ -212,6 +242,10 @@ backupFile(
                     }
 
                     ioFilterGroupAdd(ioReadFilterGroup(readIo), cryptoHashNew(hashTypeSha1));
+
+                    if (checksumXxh3)
+                        ioFilterGroupAdd(ioReadFilterGroup(readIo), xxHashNew(XX_HASH_SIZE_MAX));
+
                     ioFilterGroupAdd(ioReadFilterGroup(readIo), ioSizeNew());
 
                     // Add page checksum filter
@@ -224,11 +258,15 @@ backupFile(
                                 file->pgFilePageHeaderCheck, storagePathP(storagePg(), file->pgFile)));
                     }
 
-                    // Compress filter
+                    // Compress filter. Worker threads are only used for large files that are compressed as a whole since block
+                    // incremental compresses each super block separately.
                     IoFilter *const compress =
                         repoFileCompressType != compressTypeNone ?
                             compressFilterP(
-                                repoFileCompressType, repoFileCompressLevel, .raw = bundleRaw || file->blockIncrSize != 0) :
+                                repoFileCompressType, repoFileCompressLevel, .raw = bundleRaw || file->blockIncrSize != 0,
+                                .thread =
+                                    file->blockIncrSize == 0 && file->pgFileSize >= BACKUP_FILE_COMPRESS_THREAD_SIZE_MIN ?
+                                        repoFileCompressThread : 0) :
                             NULL;
 
                     // Encrypt filter
@@ -290,8 +328,13 @@ backupFile(
 
                     // Capture checksum of file stored in the repo if filters that modify the output have been applied
                     if (repoChecksum)
+                    {
                         ioFilterGroupAdd(ioReadFilterGroup(readIo), cryptoHashNew(hashTypeSha1));
 
+                        if (checksumXxh3)
+                            ioFilterGroupAdd(ioReadFilterGroup(readIo), xxHashNew(XX_HASH_SIZE_MAX));
+                    }
+
                     // Add size filter last to calculate repo size
                     ioFilterGroupAdd(ioReadFilterGroup(readIo), ioSizeNew());
 
@@ -392,6 +435,12 @@ backupFile(
                                 fileResult->copyChecksum = pckReadBinP(
                                     ioFilterGroupResultP(ioReadFilterGroup(readIo), CRYPTO_HASH_FILTER_TYPE, .idx = 0));
 
+                                if (checksumXxh3)
+                                {
+                                    fileResult->copyChecksumXxh3 = pckReadBinP(
+                                        ioFilterGroupResultP(ioReadFilterGroup(readIo), XX_HASH_FILTER_TYPE, .idx = 0));
+                                }
+
                                 // Get bundle offset
                                 fileResult->bundleOffset = bundleOffset;
 
@@ -421,6 +470,12 @@ backupFile(
                                 {
                                     fileResult->repoChecksum = pckReadBinP(
                                         ioFilterGroupResultP(ioReadFilterGroup(readIo), CRYPTO_HASH_FILTER_TYPE, .idx = 1));
+
+                                    if (checksumXxh3)
+                                    {
+                                        fileResult->repoChecksumXxh3 = pckReadBinP(
+                                            ioFilterGroupResultP(ioReadFilterGroup(readIo), XX_HASH_FILTER_TYPE, .idx = 1));
+                                    }
                                 }
                             }
                             MEM_CONTEXT_END();
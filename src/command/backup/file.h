@@ -34,6 +34,7 @@ typedef struct BackupFile
     uint64_t pgFileSizePrior;                                       // Prior pg file size (if manifestFileHasReference)
     bool pgFileCopyExactSize;                                       // Copy only pg expected size
     const Buffer *pgFileChecksum;                                   // Expected pg file checksum
+    const Buffer *pgFileChecksumXxh3;                               // Expected pg file xxh3 checksum (NULL if not recorded)
     bool pgFileChecksumPage;                                        // Validate page checksums?
     bool pgFilePageHeaderCheck;                                     // Validate page headers?
     size_t blockIncrSize;                                           // Perform block incremental on this file?
@@ -44,6 +45,7 @@ typedef struct BackupFile
     uint64_t blockIncrMapPriorSize;                                 // Size of prior block incremental map
     const String *manifestFile;                                     // Repo file
     const Buffer *repoFileChecksum;                                 // Expected repo file checksum
+    const Buffer *repoFileChecksumXxh3;                             // Expected repo file xxh3 checksum (NULL if not recorded)
     uint64_t repoFileSize;                                          // Expected repo file size
     bool manifestFileResume;                                        // Checksum repo file before copying
     bool manifestFileHasReference;                                  // Reference to prior backup, if any
@@ -57,6 +59,8 @@ typedef struct BackupFileResult
     uint64_t copySize;
     const Buffer *copyChecksum;                                     // Checksum of pg file
     const Buffer *repoChecksum;                                     // Checksum of repo file (including compression, etc.)
+    const Buffer *copyChecksumXxh3;                                 // xxh3 checksum of pg file (if requested)
+    const Buffer *repoChecksumXxh3;                                 // xxh3 checksum of repo file (if requested)
     uint64_t bundleOffset;                                          // Offset in bundle if any
     uint64_t repoSize;
     uint64_t blockIncrMapSize;                                      // Size of block incremental map (0 if no map)
@@ -65,7 +69,7 @@ typedef struct BackupFileResult
 
 FN_EXTERN List *backupFile(
     const String *repoFile, uint64_t bundleId, bool bundleRaw, unsigned int blockIncrReference, CompressType repoFileCompressType,
-    int repoFileCompressLevel, CipherType cipherType, const String *cipherPass, const String *pgVersionForce, PgPageSize pageSize,
-    const List *fileList);
+    int repoFileCompressLevel, unsigned int repoFileCompressThread, CipherType cipherType, const String *cipherPass,
+    const String *pgVersionForce, PgPageSize pageSize, bool checksumXxh3, const List *fileList);
 
 #endif
@@ -35,10 +35,12 @@ backupFileProtocol(PackRead *const param, ProtocolServer *const server)
         const unsigned int blockIncrReference = (unsigned int)pckReadU64P(param);
         const CompressType repoFileCompressType = (CompressType)pckReadU32P(param);
         const int repoFileCompressLevel = pckReadI32P(param);
+        const unsigned int repoFileCompressThread = pckReadU32P(param);
         const CipherType cipherType = (CipherType)pckReadU64P(param);
         const String *const cipherPass = pckReadStrP(param);
         const PgPageSize pageSize = pckReadU32P(param);
         const String *const pgVersionForce = pckReadStrP(param);
+        const bool checksumXxh3 = pckReadBoolP(param);
 
         // Build the file list
         List *const fileList = lstNewP(sizeof(BackupFile));
@@ -52,6 +54,7 @@ backupFileProtocol(PackRead *const param, ProtocolServer *const server)
             file.pgFileSizePrior = pckReadU64P(param);
             file.pgFileCopyExactSize = pckReadBoolP(param);
             file.pgFileChecksum = pckReadBinP(param);
+            file.pgFileChecksumXxh3 = pckReadBinP(param);
             file.pgFileChecksumPage = pckReadBoolP(param);
             file.pgFilePageHeaderCheck = pckReadBoolP(param);
             file.blockIncrSize = (size_t)pckReadU64P(param);
@@ -71,6 +74,7 @@ backupFileProtocol(PackRead *const param, ProtocolServer *const server)
 
             file.manifestFile = pckReadStrP(param);
             file.repoFileChecksum = pckReadBinP(param);
+            file.repoFileChecksumXxh3 = pckReadBinP(param);
             file.repoFileSize = pckReadU64P(param);
             file.manifestFileResume = pckReadBoolP(param);
             file.manifestFileHasReference = pckReadBoolP(param);
@@ -80,8 +84,8 @@ backupFileProtocol(PackRead *const param, ProtocolServer *const server)
 
         // Backup file
         const List *const result = backupFile(
-            repoFile, bundleId, bundleRaw, blockIncrReference, repoFileCompressType, repoFileCompressLevel, cipherType, cipherPass,
-            pgVersionForce, pageSize, fileList);
+            repoFile, bundleId, bundleRaw, blockIncrReference, repoFileCompressType, repoFileCompressLevel, repoFileCompressThread,
+            cipherType, cipherPass, pgVersionForce, pageSize, checksumXxh3, fileList);
 
         // Return result
         PackWrite *const resultPack = protocolPackNew();
@@ -103,6 +107,8 @@ backupFileProtocol(PackRead *const param, ProtocolServer *const server)
             pckWriteU64P(resultPack, fileResult->repoSize);
             pckWriteBinP(resultPack, fileResult->copyChecksum);
             pckWriteBinP(resultPack, fileResult->repoChecksum);
+            pckWriteBinP(resultPack, fileResult->copyChecksumXxh3);
+            pckWriteBinP(resultPack, fileResult->repoChecksumXxh3);
             pckWritePackP(resultPack, fileResult->pageChecksumResult);
         }
 
@@ -5,6 +5,7 @@ Common Command Routines
 
 #include <inttypes.h>
 #include <string.h>
+#include <sys/resource.h>
 
 #include "common/debug.h"
 #include "common/log.h"
@@ -211,6 +212,20 @@ cmdEnd(const int code, const String *const errorMessage)
             if (statJson != NULL)
                 LOG_DETAIL_FMT("statistics: %s", strZ(statJson));
 
+            // Output memory statistics at trace level since they are only useful when measuring allocations. Peak RSS is reported
+            // in kB on Linux.
+            if (logAny(logLevelTrace))
+            {
+                const MemContextStat memStat = memContextStat();
+                struct rusage usage;
+
+                THROW_ON_SYS_ERROR(getrusage(RUSAGE_SELF, &usage) == -1, KernelError, "unable to get resource usage");
+
+                LOG_TRACE_FMT(
+                    "memory: malloc %" PRIu64 ", realloc %" PRIu64 ", free %" PRIu64 ", arena %" PRIu64 ", peak rss %ld",
+                    memStat.allocTotal, memStat.reAllocTotal, memStat.freeTotal, memStat.arenaTotal, usage.ru_maxrss);
+            }
+
             // Basic info on command end
             String *const info = strCatFmt(strNew(), "%s command end: ", strZ(cfgCommandRoleName()));
 
@@ -699,14 +699,17 @@ removeExpiredArchive(const InfoBackup *const infoBackup, const bool timeBasedFul
                                         removeArchive = true;
                                         const String *const walSubPath = strLstGet(walSubPathList, subIdx);
 
+                                        // A bundle is kept if any archive log it contains is used in a backup
+                                        const String *const walSubPathStart = strSubN(walSubPath, 0, 24);
+                                        const String *const walSubPathStop = walArchiveFileStop(walSubPath);
+
                                         // Determine if the individual archive log is used in a backup
                                         for (unsigned int rangeIdx = 0; rangeIdx < lstSize(archiveRangeList); rangeIdx++)
                                         {
                                             const ArchiveRange *const archiveRange = lstGet(archiveRangeList, rangeIdx);
 
-                                            if (strCmp(strSubN(walSubPath, 0, 24), archiveRange->start) >= 0 &&
-                                                (archiveRange->stop == NULL ||
-                                                 strCmp(strSubN(walSubPath, 0, 24), archiveRange->stop) <= 0))
+                                            if (strCmp(walSubPathStop, archiveRange->start) >= 0 &&
+                                                (archiveRange->stop == NULL || strCmp(walSubPathStart, archiveRange->stop) <= 0))
                                             {
                                                 removeArchive = false;
                                                 break;
@@ -728,10 +731,10 @@ removeExpiredArchive(const InfoBackup *const infoBackup, const bool timeBasedFul
 
                                             // Track that this archive was removed
                                             archiveExpire.total++;
-                                            archiveExpire.stop = strDup(strSubN(walSubPath, 0, 24));
+                                            archiveExpire.stop = strDup(walSubPathStop);
 
                                             if (archiveExpire.start == NULL)
-                                                archiveExpire.start = strDup(strSubN(walSubPath, 0, 24));
+                                                archiveExpire.start = strDup(walSubPathStart);
                                         }
                                         else
                                             logExpire(&archiveExpire, archiveId, repoIdx);
@@ -349,7 +349,7 @@ archiveDbList(
             const StringList *const list = strLstSort(
                 storageListP(
                     storageRepo, strNewFmt("%s/%s", strZ(archivePath), strZ(strLstGet(walDir, idx))),
-                    .expression = WAL_SEGMENT_FILE_REGEXP_STR),
+                    .expression = WAL_ARCHIVE_FILE_REGEXP_STR),
                 sortOrderAsc);
 
             // If wal segments are found, get the oldest one as the archive start
@@ -368,13 +368,13 @@ archiveDbList(
             const StringList *const list = strLstSort(
                 storageListP(
                     storageRepo, strNewFmt("%s/%s", strZ(archivePath), strZ(strLstGet(walDir, idx))),
-                    .expression = WAL_SEGMENT_FILE_REGEXP_STR),
+                    .expression = WAL_ARCHIVE_FILE_REGEXP_STR),
                 sortOrderDesc);
 
-            // If wal segments are found, get the newest one as the archive stop
+            // If wal segments are found, get the newest one as the archive stop (the last segment when the newest is a bundle)
             if (!strLstEmpty(list))
             {
-                archiveStop = strSubN(strLstGet(list, 0), 0, 24);
+                archiveStop = walArchiveFileStop(strLstGet(list, 0));
                 break;
             }
         }
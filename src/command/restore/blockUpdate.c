@@ -0,0 +1,166 @@
+/***********************************************************************************************************************************
+Block Update
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include <string.h>
+#include <unistd.h>
+
+#include "command/restore/blockUpdate.h"
+#include "common/crypto/xxhash.h"
+#include "common/debug.h"
+#include "common/log.h"
+#include "common/type/object.h"
+#include "storage/storage.h"
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct BlockUpdate
+{
+    BlockUpdatePub pub;                                             // Publicly accessible variables
+    IoWrite *write;                                                 // Write to update
+    const String *name;                                             // Name of file being updated (for error messages)
+    size_t checksumSize;                                            // Checksum size
+    const Buffer *blockChecksum;                                    // Checksums of blocks in the existing file
+    Buffer *block;                                                  // Current block
+    uint64_t blockOffset;                                           // Offset of the current block in the file
+    unsigned int blockIdx;                                          // Index of the current block
+};
+
+/***********************************************************************************************************************************
+Write the current block if it does not match the existing block
+***********************************************************************************************************************************/
+static void
+blockUpdateBlock(BlockUpdate *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BLOCK_UPDATE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(!bufEmpty(this->block));
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // The block must be written if it is past the end of the checksum list or the checksum does not match
+        const size_t checksumOffset = this->blockIdx * this->checksumSize;
+
+        if (checksumOffset >= bufUsed(this->blockChecksum) ||
+            memcmp(
+                bufPtrConst(xxHashOne(this->checksumSize, this->block)), bufPtrConst(this->blockChecksum) + checksumOffset,
+                this->checksumSize) != 0)
+        {
+            // Seek to the block offset. It is possible we are already at the correct position but it is easier and safer to let
+            // lseek() figure this out.
+            THROW_ON_SYS_ERROR_FMT(
+                lseek(ioWriteFd(this->write), (off_t)this->blockOffset, SEEK_SET) == -1, FileOpenError, STORAGE_ERROR_READ_SEEK,
+                this->blockOffset, strZ(this->name));
+
+            // Write block and flush since we may seek to a new location for the next block
+            ioWrite(this->write, this->block);
+            ioWriteFlush(this->write);
+
+            this->pub.updateSize += bufUsed(this->block);
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    this->blockOffset += bufUsed(this->block);
+    this->blockIdx++;
+    bufUsedZero(this->block);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Split data into blocks and update blocks that have changed
+***********************************************************************************************************************************/
+static void
+blockUpdateWrite(THIS_VOID, const Buffer *const buffer)
+{
+    THIS(BlockUpdate);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BLOCK_UPDATE, this);
+        FUNCTION_LOG_PARAM(BUFFER, buffer);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(buffer != NULL);
+
+    size_t bufferOffset = 0;
+
+    // Loop until the buffer is consumed
+    while (bufferOffset != bufUsed(buffer))
+    {
+        const size_t copySize = bufRemains(this->block) < bufUsed(buffer) - bufferOffset ?
+            bufRemains(this->block) : bufUsed(buffer) - bufferOffset;
+
+        bufCatSub(this->block, buffer, bufferOffset, copySize);
+        bufferOffset += copySize;
+
+        if (bufFull(this->block))
+            blockUpdateBlock(this);
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Update the final partial block
+***********************************************************************************************************************************/
+static void
+blockUpdateClose(THIS_VOID)
+{
+    THIS(BlockUpdate);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BLOCK_UPDATE, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    if (!bufEmpty(this->block))
+        blockUpdateBlock(this);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN BlockUpdate *
+blockUpdateNew(
+    IoWrite *const write, const String *const name, const size_t blockSize, const size_t checksumSize,
+    const Buffer *const blockChecksum)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_WRITE, write);
+        FUNCTION_LOG_PARAM(STRING, name);
+        FUNCTION_LOG_PARAM(SIZE, blockSize);
+        FUNCTION_LOG_PARAM(SIZE, checksumSize);
+        FUNCTION_LOG_PARAM(BUFFER, blockChecksum);
+    FUNCTION_LOG_END();
+
+    ASSERT(write != NULL);
+    ASSERT(name != NULL);
+    ASSERT(blockSize != 0);
+    ASSERT(checksumSize != 0);
+    ASSERT(blockChecksum != NULL);
+
+    OBJ_NEW_BEGIN(BlockUpdate, .childQty = MEM_CONTEXT_QTY_MAX)
+    {
+        *this = (BlockUpdate)
+        {
+            .write = write,
+            .name = strDup(name),
+            .checksumSize = checksumSize,
+            .blockChecksum = blockChecksum,
+            .block = bufNew(blockSize),
+        };
+
+        this->pub.write = ioWriteNewP(this, .close = blockUpdateClose, .write = blockUpdateWrite);
+    }
+    OBJ_NEW_END();
+
+    FUNCTION_LOG_RETURN(BLOCK_UPDATE, this);
+}
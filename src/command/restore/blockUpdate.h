@@ -0,0 +1,68 @@
+/***********************************************************************************************************************************
+Block Update
+
+Update an existing file in place by writing only the blocks that differ from a block checksum list generated from the file. This is
+used by delta restore so that a large file with a few changed blocks does not need to be completely rewritten. The block checksum
+list must have been generated with the same block and checksum sizes, e.g. by the block checksum filter.
+***********************************************************************************************************************************/
+#ifndef COMMAND_RESTORE_BLOCKUPDATE_H
+#define COMMAND_RESTORE_BLOCKUPDATE_H
+
+#include "common/io/write.h"
+#include "common/type/buffer.h"
+#include "common/type/object.h"
+#include "common/type/string.h"
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct BlockUpdate BlockUpdate;
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+// The write must already be open and must support seeking, i.e. have a valid file descriptor. The name is used for error messages.
+FN_EXTERN BlockUpdate *blockUpdateNew(
+    IoWrite *write, const String *name, size_t blockSize, size_t checksumSize, const Buffer *blockChecksum);
+
+/***********************************************************************************************************************************
+Getters/Setters
+***********************************************************************************************************************************/
+typedef struct BlockUpdatePub
+{
+    IoWrite *write;                                                 // IoWrite interface
+    uint64_t updateSize;                                            // Size of blocks written
+} BlockUpdatePub;
+
+// Write interface
+FN_INLINE_ALWAYS IoWrite *
+blockUpdateIoWrite(BlockUpdate *const this)
+{
+    return THIS_PUB(BlockUpdate)->write;
+}
+
+// Size of blocks that differed and were written
+FN_INLINE_ALWAYS uint64_t
+blockUpdateSize(const BlockUpdate *const this)
+{
+    return THIS_PUB(BlockUpdate)->updateSize;
+}
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+FN_INLINE_ALWAYS void
+blockUpdateFree(BlockUpdate *const this)
+{
+    objFree(this);
+}
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+#define FUNCTION_LOG_BLOCK_UPDATE_TYPE                                                                                             \
+    BlockUpdate *
+#define FUNCTION_LOG_BLOCK_UPDATE_FORMAT(value, buffer, bufferSize)                                                                \
+    objNameToLog(value, "BlockUpdate", buffer, bufferSize)
+
+#endif
@@ -9,11 +9,13 @@ Restore File
 
 #include "command/backup/blockIncr.h"
 #include "command/backup/blockMap.h"
+#include "command/backup/common.h"
 #include "command/restore/blockChecksum.h"
 #include "command/restore/blockDelta.h"
+#include "command/restore/blockUpdate.h"
 #include "command/restore/file.h"
 #include "common/crypto/cipherBlock.h"
-#include "common/crypto/hash.h"
+#include "common/crypto/xxhash.h"
 #include "common/debug.h"
 #include "common/io/fdWrite.h"
 #include "common/io/filter/group.h"
@@ -25,11 +27,19 @@ Restore File
 #include "info/manifest.h"
 #include "storage/helper.h"
 
+/***********************************************************************************************************************************
+Block and checksum size used to update changed files in place during delta restore. Files smaller than two blocks are rewritten
+since there is little to be gained by updating them in place. Unlike block incremental the file is not verified after it has been
+updated so a full size checksum is used to make collisions vanishingly unlikely.
+***********************************************************************************************************************************/
+#define RESTORE_DELTA_BLOCK_SIZE                                    (128 * 1024)
+#define RESTORE_DELTA_CHECKSUM_SIZE                                 XX_HASH_SIZE_MAX
+
 /**********************************************************************************************************************************/
 FN_EXTERN List *
 restoreFile(
     const String *const repoFile, const unsigned int repoIdx, const CompressType repoFileCompressType, const time_t copyTimeBegin,
-    const bool delta, const bool deltaForce, const bool bundleRaw, const String *const cipherPass,
+    const bool delta, const bool deltaForce, const bool bundleRaw, const bool syncDefer, const String *const cipherPass,
     const StringList *const referenceList, List *const fileList)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
@@ -40,6 +50,7 @@ restoreFile(
         FUNCTION_LOG_PARAM(BOOL, delta);
         FUNCTION_LOG_PARAM(BOOL, deltaForce);
         FUNCTION_LOG_PARAM(BOOL, bundleRaw);
+        FUNCTION_LOG_PARAM(BOOL, syncDefer);                        // Skip file sync since the caller will sync later
         FUNCTION_TEST_PARAM(STRING, cipherPass);
         FUNCTION_LOG_PARAM(STRING_LIST, referenceList);             // List of references (for block incremental)
         FUNCTION_LOG_PARAM(LIST, fileList);                         // List of files to restore
@@ -55,8 +66,9 @@ restoreFile(
         // Check files to determine which ones need to be restored
         for (unsigned int fileIdx = 0; fileIdx < lstSize(fileList); fileIdx++)
         {
-            // Use a per-file mem context to reduce memory usage
-            MEM_CONTEXT_TEMP_BEGIN()
+            // Use a per-file mem context to reduce memory usage. The context is allocated from an arena since it makes many small
+            // allocations that are all freed together.
+            MEM_CONTEXT_TEMP_BEGIN(.arena = true)
             {
                 RestoreFile *const file = lstGet(fileList, fileIdx);
                 ASSERT(file->name != NULL);
@@ -102,7 +114,7 @@ restoreFile(
                                     IoWrite *const pgWriteTruncate = storageWriteIo(
                                         storageNewWriteP(
                                             storagePgWrite(), file->name, .noAtomic = true, .noCreatePath = true,
-                                            .noSyncPath = true, .noTruncate = true));
+                                            .noSyncFile = syncDefer, .noSyncPath = true, .noTruncate = true));
                                     ioWriteOpen(pgWriteTruncate);
 
                                     // Truncate to original size
@@ -125,6 +137,11 @@ restoreFile(
 
                                 // Generate checksum for the file if size is not zero
                                 IoRead *read = NULL;
+                                IoFilter *checksumFilter = NULL;
+
+                                // Files that are not block incremental can be updated in place if they are large enough
+                                const bool blockUpdate =
+                                    file->blockIncrMapSize == 0 && file->size >= RESTORE_DELTA_BLOCK_SIZE * 2;
 
                                 if (file->size != 0)
                                 {
@@ -132,7 +149,10 @@ restoreFile(
 
                                     // Calculate checksum only when size matches
                                     if (info.size == file->size)
-                                        ioFilterGroupAdd(ioReadFilterGroup(read), cryptoHashNew(hashTypeSha1));
+                                    {
+                                        checksumFilter = backupChecksumFilter(file->checksum);
+                                        ioFilterGroupAdd(ioReadFilterGroup(read), checksumFilter);
+                                    }
 
                                     // Generate block checksum list if block incremental
                                     if (file->blockIncrMapSize != 0)
@@ -150,7 +170,8 @@ restoreFile(
                                     (info.size == file->size &&
                                      bufEq(
                                          file->checksum,
-                                         pckReadBinP(ioFilterGroupResultP(ioReadFilterGroup(read), CRYPTO_HASH_FILTER_TYPE)))))
+                                         pckReadBinP(
+                                             ioFilterGroupResultP(ioReadFilterGroup(read), ioFilterType(checksumFilter))))))
                                 {
                                     // If the checksum/size are now the same but the time is not, then set the time back to the
                                     // backup time. This helps with unit testing, but also presents a pristine version of the
@@ -171,9 +192,22 @@ restoreFile(
                                     fileResult->result = restoreResultPreserve;
                                 }
 
-                                // If block incremental and not preserving the file, store the block checksum list for later use in
-                                // reconstructing the pg file
-                                if (file->blockIncrMapSize != 0 && fileResult->result != restoreResultPreserve)
+                                // If the file can be updated in place and is not being preserved then generate the block checksum
+                                // list. This is only done after the checksum does not match since most files are unchanged. The
+                                // file has been truncated to the expected size so the checksums will line up with the blocks in
+                                // the repo.
+                                if (blockUpdate && fileResult->result != restoreResultPreserve)
+                                {
+                                    read = storageReadIo(storageNewReadP(storagePg(), file->name));
+                                    ioFilterGroupAdd(
+                                        ioReadFilterGroup(read),
+                                        blockChecksumNew(RESTORE_DELTA_BLOCK_SIZE, RESTORE_DELTA_CHECKSUM_SIZE));
+                                    ioReadDrain(read);
+                                }
+
+                                // If block incremental (or update in place) and not preserving the file, store the block checksum
+                                // list for later use in reconstructing the pg file
+                                if ((file->blockIncrMapSize != 0 || blockUpdate) && fileResult->result != restoreResultPreserve)
                                 {
                                     PackRead *const blockChecksumResult = ioFilterGroupResultP(
                                         ioReadFilterGroup(read), BLOCK_CHECKSUM_FILTER_TYPE);
@@ -195,7 +229,8 @@ restoreFile(
                     // Create destination file
                     StorageWrite *const pgFileWrite = storageNewWriteP(
                         storagePgWrite(), file->name, .modeFile = file->mode, .user = file->user, .group = file->group,
-                        .timeModified = file->timeModified, .noAtomic = true, .noCreatePath = true, .noSyncPath = true);
+                        .timeModified = file->timeModified, .noAtomic = true, .noCreatePath = true, .noSyncFile = syncDefer,
+                        .noSyncPath = true);
 
                     ioWriteOpen(storageWriteIo(pgFileWrite));
 
@@ -222,8 +257,9 @@ restoreFile(
 
         for (unsigned int fileIdx = 0; fileIdx < lstSize(fileList); fileIdx++)
         {
-            // Use a per-file mem context to reduce memory usage
-            MEM_CONTEXT_TEMP_BEGIN()
+            // Use a per-file mem context to reduce memory usage. The context is allocated from an arena since it makes many small
+            // allocations that are all freed together.
+            MEM_CONTEXT_TEMP_BEGIN(.arena = true)
             {
                 const RestoreFile *const file = lstGet(fileList, fileIdx);
                 RestoreFileResult *const fileResult = lstGet(result, fileIdx);
@@ -284,8 +320,8 @@ restoreFile(
                     // Create pg file
                     StorageWrite *const pgFileWrite = storageNewWriteP(
                         storagePgWrite(), file->name, .modeFile = file->mode, .user = file->user, .group = file->group,
-                        .timeModified = file->timeModified, .noAtomic = true, .noCreatePath = true, .noSyncPath = true,
-                        .noTruncate = file->blockChecksum != NULL);
+                        .timeModified = file->timeModified, .noAtomic = true, .noCreatePath = true, .noSyncFile = syncDefer,
+                        .noSyncPath = true, .noTruncate = file->blockChecksum != NULL);
 
                     // If block incremental file
                     const Buffer *checksum = NULL;
@@ -367,16 +403,32 @@ restoreFile(
                         // correctly. However, it seems better to check and the pages should still be buffered making the operation
                         // very fast.
                         IoRead *const read = storageReadIo(storageNewReadP(storagePg(), file->name));
+                        IoFilter *const checksumFilter = backupChecksumFilter(file->checksum);
 
-                        ioFilterGroupAdd(ioReadFilterGroup(read), cryptoHashNew(hashTypeSha1));
+                        ioFilterGroupAdd(ioReadFilterGroup(read), checksumFilter);
                         ioReadDrain(read);
 
-                        checksum = pckReadBinP(ioFilterGroupResultP(ioReadFilterGroup(read), CRYPTO_HASH_FILTER_TYPE));
+                        checksum = pckReadBinP(ioFilterGroupResultP(ioReadFilterGroup(read), ioFilterType(checksumFilter)));
                     }
                     // Else normal file
                     else
                     {
-                        IoFilterGroup *const filterGroup = ioWriteFilterGroup(storageWriteIo(pgFileWrite));
+                        // If a block checksum list was generated for the existing file then update it in place by writing only the
+                        // blocks that have changed. Otherwise write the entire file.
+                        IoWrite *write = storageWriteIo(pgFileWrite);
+                        BlockUpdate *blockUpdate = NULL;
+
+                        if (file->blockChecksum != NULL)
+                        {
+                            ioWriteOpen(write);
+
+                            blockUpdate = blockUpdateNew(
+                                write, storagePathP(storagePg(), file->name), RESTORE_DELTA_BLOCK_SIZE, RESTORE_DELTA_CHECKSUM_SIZE,
+                                file->blockChecksum);
+                            write = blockUpdateIoWrite(blockUpdate);
+                        }
+
+                        IoFilterGroup *const filterGroup = ioWriteFilterGroup(write);
 
                         // Add decryption filter
                         if (cipherPass != NULL)
@@ -390,19 +442,27 @@ restoreFile(
                         if (repoFileCompressType != compressTypeNone)
                             ioFilterGroupAdd(filterGroup, decompressFilterP(repoFileCompressType, .raw = bundleRaw));
 
-                        // Add sha1 filter
-                        ioFilterGroupAdd(filterGroup, cryptoHashNew(hashTypeSha1));
+                        // Add checksum filter
+                        IoFilter *const checksumFilter = backupChecksumFilter(file->checksum);
+                        ioFilterGroupAdd(filterGroup, checksumFilter);
 
                         // Add size filter
                         ioFilterGroupAdd(filterGroup, ioSizeNew());
 
                         // Copy file
-                        ioWriteOpen(storageWriteIo(pgFileWrite));
-                        ioCopyP(storageReadIo(repoFileRead), storageWriteIo(pgFileWrite), .limit = file->limit);
-                        ioWriteClose(storageWriteIo(pgFileWrite));
+                        ioWriteOpen(write);
+                        ioCopyP(storageReadIo(repoFileRead), write, .limit = file->limit);
+                        ioWriteClose(write);
+
+                        // Close the updated file and record how much of it was written
+                        if (blockUpdate != NULL)
+                        {
+                            ioWriteClose(storageWriteIo(pgFileWrite));
+                            fileResult->blockIncrDeltaSize = blockUpdateSize(blockUpdate);
+                        }
 
                         // Get checksum result
-                        checksum = pckReadBinP(ioFilterGroupResultP(filterGroup, CRYPTO_HASH_FILTER_TYPE));
+                        checksum = pckReadBinP(ioFilterGroupResultP(filterGroup, ioFilterType(checksumFilter)));
                     }
 
                     // If more than one file is being copied from a single read then decrement the limit
@@ -37,18 +37,18 @@ typedef struct RestoreFile
     size_t blockIncrSize;                                           // Block incremental size (when map size > 0)
     size_t blockIncrChecksumSize;                                   // Checksum size (when map size > 0)
     const String *manifestFile;                                     // Manifest file
-    const Buffer *blockChecksum;                                    // Checksums for block incremental restore, set in restoreFile()
+    const Buffer *blockChecksum;                                    // Checksums for block incremental/update, set in restoreFile()
 } RestoreFile;
 
 typedef struct RestoreFileResult
 {
     const String *manifestFile;                                     // Manifest file
     RestoreResult result;                                           // Restore result (e.g. preserve, copy)
-    uint64_t blockIncrDeltaSize;                                    // Size restored by block incremental delta
+    uint64_t blockIncrDeltaSize;                                    // Size restored by block incremental delta or block update
 } RestoreFileResult;
 
 FN_EXTERN List *restoreFile(
     const String *repoFile, unsigned int repoIdx, CompressType repoFileCompressType, time_t copyTimeBegin, bool delta,
-    bool deltaForce, bool bundleRaw, const String *cipherPass, const StringList *referenceList, List *fileList);
+    bool deltaForce, bool bundleRaw, bool syncDefer, const String *cipherPass, const StringList *referenceList, List *fileList);
 
 #endif
@@ -12,10 +12,12 @@ Restore Command
 #include "command/restore/protocol.h"
 #include "command/restore/restore.h"
 #include "common/crypto/cipherBlock.h"
+#include "common/crypto/xxhash.h"
 #include "common/debug.h"
 #include "common/log.h"
 #include "common/partialRestore.h"
 #include "common/regExp.h"
+#include "common/time.h"
 #include "common/user.h"
 #include "config/config.h"
 #include "config/exec.h"
@@ -2027,11 +2029,12 @@ restoreProcessQueueComparator(const void *const item1, const void *const item2)
 }
 
 static uint64_t
-restoreProcessQueue(const Manifest *const manifest, List **const queueList)
+restoreProcessQueue(const Manifest *const manifest, List **const queueList, List **const queueSizeList)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(MANIFEST, manifest);
         FUNCTION_LOG_PARAM_P(LIST, queueList);
+        FUNCTION_LOG_PARAM_P(LIST, queueSizeList);
     FUNCTION_LOG_END();
 
     FUNCTION_AUDIT_HELPER();
@@ -2044,6 +2047,7 @@ restoreProcessQueue(const Manifest *const manifest, List **const queueList)
     {
         // Create list of process queues (use void * instead of List * to avoid Coverity false positive)
         *queueList = lstNewP(sizeof(void *));
+        *queueSizeList = lstNewP(sizeof(uint64_t));
 
         // Generate the list of processing queues (there is always at least one)
         StringList *const targetList = strLstNew();
@@ -2064,6 +2068,7 @@ restoreProcessQueue(const Manifest *const manifest, List **const queueList)
             {
                 List *const queue = lstNewP(sizeof(ManifestFile *), .comparator = restoreProcessQueueComparator);
                 lstAdd(*queueList, &queue);
+                lstAdd(*queueSizeList, &(uint64_t){0});
             }
         }
         MEM_CONTEXT_END();
@@ -2108,7 +2113,8 @@ restoreProcessQueue(const Manifest *const manifest, List **const queueList)
             // Add file to queue
             lstAdd(*(List **)lstGet(*queueList, targetIdx), &filePack);
 
-            // Add size to total
+            // Add size to queue and total
+            *(uint64_t *)lstGet(*queueSizeList, targetIdx) += file.size;
             result += file.size;
         }
 
@@ -2120,6 +2126,7 @@ restoreProcessQueue(const Manifest *const manifest, List **const queueList)
 
         // Move process queues to prior context
         lstMove(*queueList, memContextPrior());
+        lstMove(*queueSizeList, memContextPrior());
     }
     MEM_CONTEXT_TEMP_END();
 
@@ -2257,6 +2264,9 @@ restoreJobResult(
                     if (blockIncrDeltaSize != file.size)
                         strCatFmt(log, "%s/", strZ(strSizeFormat(blockIncrDeltaSize)));
                 }
+                // Else add block update size, i.e. amount of an existing file that was updated in place
+                else if (blockIncrDeltaSize != 0)
+                    strCatFmt(log, "delta %s/", strZ(strSizeFormat(blockIncrDeltaSize)));
 
                 // Add size and percent complete
                 sizeRestored += file.size;
@@ -2289,32 +2299,42 @@ typedef struct RestoreJobData
     unsigned int repoIdx;                                           // Internal repo idx
     Manifest *manifest;                                             // Backup manifest
     List *queueList;                                                // List of processing queues
+    List *queueSizeList;                                            // Bytes remaining to be restored in each processing queue
     RegExp *zeroExp;                                                // Identify files that should be sparse zeroed
     const String *cipherSubPass;                                    // Passphrase used to decrypt files in the backup
     const String *rootReplaceUser;                                  // User to replace invalid users when root
     const String *rootReplaceGroup;                                 // Group to replace invalid group when root
 } RestoreJobData;
 
-// Helper to calculate the next queue to scan based on the client index
+// Helper to find the non-empty queue with the most bytes remaining. Clients that have emptied their own queue steal from this queue
+// since it is the one most likely to extend the tail of the restore. Returns -1 when all queues are empty.
 static int
-restoreJobQueueNext(const unsigned int clientIdx, int queueIdx, const unsigned int queueTotal)
+restoreJobQueueSteal(const List *const queueList, const List *const queueSizeList)
 {
     FUNCTION_TEST_BEGIN();
-        FUNCTION_TEST_PARAM(UINT, clientIdx);
-        FUNCTION_TEST_PARAM(INT, queueIdx);
-        FUNCTION_TEST_PARAM(UINT, queueTotal);
+        FUNCTION_TEST_PARAM(LIST, queueList);
+        FUNCTION_TEST_PARAM(LIST, queueSizeList);
     FUNCTION_TEST_END();
 
-    // Move (forward or back) to the next queue
-    queueIdx += clientIdx % 2 ? -1 : 1;
+    ASSERT(queueList != NULL);
+    ASSERT(queueSizeList != NULL);
+    ASSERT(lstSize(queueList) == lstSize(queueSizeList));
+
+    int result = -1;
+    uint64_t resultSize = 0;
+
+    for (unsigned int queueIdx = 0; queueIdx < lstSize(queueList); queueIdx++)
+    {
+        const uint64_t queueSize = *(const uint64_t *)lstGet(queueSizeList, queueIdx);
 
-    // Deal with wrapping on either end
-    if (queueIdx < 0)
-        FUNCTION_TEST_RETURN(INT, (int)queueTotal - 1);
-    else if (queueIdx == (int)queueTotal)
-        FUNCTION_TEST_RETURN(INT, 0);
+        if (!lstEmpty(*(const List **)lstGet(queueList, queueIdx)) && (result == -1 || queueSize > resultSize))
+        {
+            result = (int)queueIdx;
+            resultSize = queueSize;
+        }
+    }
 
-    FUNCTION_TEST_RETURN(INT, queueIdx);
+    FUNCTION_TEST_RETURN(INT, result);
 }
 
 // Callback to fetch restore jobs for the parallel executor
@@ -2335,14 +2355,17 @@ restoreJobCallback(void *const data, const unsigned int clientIdx)
         // Get a new job if there are any left
         RestoreJobData *const jobData = data;
 
-        // Determine where to begin scanning the queue (we'll stop when we get back here)
+        // Start with the queue assigned to this client. If that queue is empty then steal from the queue with the most bytes
+        // remaining.
         ProtocolCommand *const command = protocolCommandNew(PROTOCOL_COMMAND_RESTORE_FILE);
         PackWrite *param = NULL;
         int queueIdx = (int)(clientIdx % lstSize(jobData->queueList));
-        const int queueEnd = queueIdx;
+
+        if (lstEmpty(*(List **)lstGet(jobData->queueList, (unsigned int)queueIdx)))
+            queueIdx = restoreJobQueueSteal(jobData->queueList, jobData->queueSizeList);
 
         // Create restore job
-        do
+        if (queueIdx != -1)
         {
             List *const queue = *(List **)lstGet(jobData->queueList, (unsigned int)queueIdx);
             bool fileAdded = false;
@@ -2384,6 +2407,7 @@ restoreJobCallback(void *const data, const unsigned int clientIdx)
                     pckWriteBoolP(param, cfgOptionBool(cfgOptDelta));
                     pckWriteBoolP(param, cfgOptionBool(cfgOptDelta) && cfgOptionBool(cfgOptForce));
                     pckWriteBoolP(param, file.bundleId != 0 && manifestData(jobData->manifest)->bundleRaw);
+                    pckWriteBoolP(param, cfgOptionBool(cfgOptSyncDefer));
                     pckWriteStrP(param, jobData->cipherSubPass);
                     pckWriteStrLstP(param, manifestReferenceList(jobData->manifest));
 
@@ -2391,7 +2415,12 @@ restoreJobCallback(void *const data, const unsigned int clientIdx)
                 }
 
                 pckWriteStrP(param, restoreFilePgPath(jobData->manifest, file.name));
-                pckWriteBinP(param, BUF(file.checksumSha1, HASH_TYPE_SHA1_SIZE));
+
+                // Send the xxh3 checksum when present since it is much faster to calculate. The checksum type is determined by size.
+                pckWriteBinP(
+                    param,
+                    file.checksumXxh3 != NULL ?
+                        BUF(file.checksumXxh3, XX_HASH_SIZE_MAX) : BUF(file.checksumSha1, HASH_TYPE_SHA1_SIZE));
                 pckWriteU64P(param, file.size);
                 pckWriteTimeP(param, file.timestamp);
                 pckWriteModeP(param, file.mode);
@@ -2429,6 +2458,7 @@ restoreJobCallback(void *const data, const unsigned int clientIdx)
                 pckWriteStrP(param, file.name);
 
                 // Remove job from the queue
+                *(uint64_t *)lstGet(jobData->queueSizeList, (unsigned int)queueIdx) -= file.size;
                 lstRemoveIdx(queue, 0);
 
                 // Break if the file is not bundled
@@ -2444,19 +2474,50 @@ restoreJobCallback(void *const data, const unsigned int clientIdx)
                     result = protocolParallelJobNew(bundleId != 0 ? VARUINT64(bundleId) : VARSTR(fileName), command);
                 }
                 MEM_CONTEXT_PRIOR_END();
-
-                break;
             }
-
-            queueIdx = restoreJobQueueNext(clientIdx, queueIdx, lstSize(jobData->queueList));
         }
-        while (queueIdx != queueEnd);
     }
     MEM_CONTEXT_TEMP_END();
 
     FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, result);
 }
 
+/***********************************************************************************************************************************
+Sync the file systems that files were restored to when file sync was deferred
+***********************************************************************************************************************************/
+static void
+restoreSyncFileSystem(const Manifest *const manifest)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+    FUNCTION_LOG_END();
+
+    ASSERT(manifest != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        StringList *const pathSynced = strLstNew();
+
+        for (unsigned int targetIdx = 0; targetIdx < manifestTargetTotal(manifest); targetIdx++)
+        {
+            const String *const pgPath = manifestTargetPath(manifest, manifestTarget(manifest, targetIdx));
+
+            // Don't sync the same path twice. Different paths on the same file system will be synced again but that is cheap since
+            // there will be nothing left to write.
+            if (strLstExists(pathSynced, pgPath))
+                continue;
+
+            strLstAdd(pathSynced, pgPath);
+
+            LOG_DETAIL_FMT("sync file system for '%s'", strZ(pgPath));
+            storagePathSyncP(storageLocalWrite(), pgPath, .fileSystem = true);
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN void
 cmdRestore(void)
@@ -2465,6 +2526,8 @@ cmdRestore(void)
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
+        const TimeMSec timeBegin = timeMSec();
+
         // Get information for the current user
         userInit();
 
@@ -2549,12 +2612,14 @@ cmdRestore(void)
         restoreCleanBuild(jobData.manifest, jobData.rootReplaceUser, jobData.rootReplaceGroup);
 
         // Generate processing queues
-        const uint64_t sizeTotal = restoreProcessQueue(jobData.manifest, &jobData.queueList);
+        const uint64_t sizeTotal = restoreProcessQueue(jobData.manifest, &jobData.queueList, &jobData.queueSizeList);
 
         // Save manifest to the data directory so we can restart a delta restore even if the PG_VERSION file is missing
         manifestSave(jobData.manifest, storageWriteIo(storageNewWriteP(storagePgWrite(), BACKUP_MANIFEST_FILE_STR)));
 
         // Create the parallel executor
+        const TimeMSec timeCopyBegin = timeMSec();
+
         ProtocolParallel *const parallelExec = protocolParallelNew(
             cfgOptionUInt64(cfgOptProtocolTimeout) / 2, restoreJobCallback, &jobData);
 
@@ -2583,6 +2648,20 @@ cmdRestore(void)
         }
         MEM_CONTEXT_TEMP_END();
 
+        // Report how long the restore ran after the first process ran out of files to restore
+        LOG_DEBUG_FMT("restore tail time %" PRIu64 "ms", protocolParallelTailTime(parallelExec));
+
+        const TimeMSec timeCopy = timeMSec() - timeCopyBegin;
+
+        // Sync restored files if sync was deferred. This must be done before recovery settings are written so a cluster with
+        // unsynced files cannot be started.
+        const TimeMSec timeFileSyncBegin = timeMSec();
+
+        if (cfgOptionBool(cfgOptSyncDefer))
+            restoreSyncFileSystem(jobData.manifest);
+
+        const TimeMSec timeFileSync = timeMSec() - timeFileSyncBegin;
+
         // Write recovery settings. Use the data directory to set permissions and ownership for recovery files.
         StorageInfo fileInfo = storageInfoP(storagePg(), NULL);
         fileInfo.user = restoreManifestOwnerReplace(fileInfo.user, jobData.rootReplaceUser);
@@ -2595,6 +2674,7 @@ cmdRestore(void)
         storageRemoveP(storagePgWrite(), BACKUP_MANIFEST_FILE_STR);
 
         // Sync file link paths. These need to be synced separately because they are not linked from the data directory.
+        const TimeMSec timePathSyncBegin = timeMSec();
         StringList *const pathSynced = strLstNew();
 
         for (unsigned int targetIdx = 0; targetIdx < manifestTargetTotal(jobData.manifest); targetIdx++)
@@ -2675,9 +2755,14 @@ cmdRestore(void)
         LOG_DETAIL_FMT("sync path '%s'", strZ(storagePathP(storagePg(), PG_PATH_GLOBAL_STR)));
         storagePathSyncP(storagePgWrite(), PG_PATH_GLOBAL_STR);
 
+        const TimeMSec timePathSync = timeMSec() - timePathSyncBegin;
+
         // Restore info
         LOG_INFO_FMT(
             "restore size = %s, file total = %u", strZ(strSizeFormat(sizeRestored)), manifestFileTotal(jobData.manifest));
+        LOG_DETAIL_FMT(
+            "restore time: copy %" PRIu64 "ms, file sync %" PRIu64 "ms, path sync %" PRIu64 "ms, total %" PRIu64 "ms", timeCopy,
+            timeFileSync, timePathSync, timeMSec() - timeBegin);
     }
     MEM_CONTEXT_TEMP_END();
 
@@ -12,9 +12,13 @@ Server Command
 #include "common/fork.h"
 #include "common/io/socket/server.h"
 #include "common/io/tls/server.h"
+#include "common/lock.h"
+#include "common/time.h"
 #include "config/config.h"
+#include "config/exec.h"
 #include "config/load.h"
 #include "protocol/helper.h"
+#include "storage/helper.h"
 
 /***********************************************************************************************************************************
 Local variables
@@ -27,6 +31,9 @@ static struct ServerLocal
     const char **argList;                                           // Argument list
 
     List *processList;                                              // List of child processes
+    unsigned int workerTotal;                                       // Persistent workers (0 to fork a process per connection)
+    bool workerStop;                                                // Workers have been asked to stop for a reload
+    String *workerConfig;                                           // Client config the worker storage was created for
 
     bool sigHup;                                                    // SIGHUP was caught
     bool sigTerm;                                                   // SIGTERM was caught
@@ -70,6 +77,8 @@ cmdServerInit(void)
             cfgOptionStr(cfgOptTlsServerCertFile), cfgOptionUInt64(cfgOptProtocolTimeout));
     }
     MEM_CONTEXT_END();
+
+    serverLocal.workerTotal = cfgOptionUInt(cfgOptTlsServerWorker);
 }
 
 /***********************************************************************************************************************************
@@ -109,6 +118,124 @@ cmdServerSigChild(const int signalType, siginfo_t *const signalInfo, void *const
     }
 }
 
+/***********************************************************************************************************************************
+Free worker storage when the client config does not match the config the storage was created for. Otherwise the storage, including
+any object store connections, is reused for the new client.
+***********************************************************************************************************************************/
+static void
+cmdServerWorkerStorage(void)
+{
+    FUNCTION_LOG_VOID(logLevelDebug);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // The process id is ignored since it differs between locals that otherwise have the same config
+        KeyValue *const optionReplace = kvNew();
+        kvPut(optionReplace, VARSTRDEF(CFGOPT_PROCESS), NULL);
+
+        const String *const config = strLstJoin(cfgExecParam(cfgCommand(), cfgCommandRole(), optionReplace, false, false), " ");
+
+        if (serverLocal.workerConfig == NULL || !strEq(config, serverLocal.workerConfig))
+        {
+            // Freeing storage also resets dry-run, which is never enabled for remotes
+            storageHelperFree();
+            storageHelperDryRunInit(false);
+
+            MEM_CONTEXT_BEGIN(serverLocal.memContext)
+            {
+                strFree(serverLocal.workerConfig);
+                serverLocal.workerConfig = strDup(config);
+            }
+            MEM_CONTEXT_END();
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Block/unblock the signals that are handled differently by workers. They are blocked while a worker is started so the worker does not
+receive them before its own handlers are set.
+***********************************************************************************************************************************/
+static void
+cmdServerWorkerSignal(const int how)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INT, how);
+    FUNCTION_TEST_END();
+
+    sigset_t signalSet;
+    sigemptyset(&signalSet);
+    sigaddset(&signalSet, SIGHUP);
+    sigaddset(&signalSet, SIGTERM);
+    sigprocmask(how, &signalSet, NULL);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Accept and process client connections until SIGHUP is caught. SIGTERM is handled by the standard exit handler.
+***********************************************************************************************************************************/
+static void
+cmdServerWorker(void)
+{
+    FUNCTION_LOG_VOID(logLevelDebug);
+
+    // Reset SIGCHLD to default
+    sigaction(SIGCHLD, &(struct sigaction){.sa_handler = SIG_DFL}, NULL);
+
+    // Set standard signal handlers but stop after the current client on SIGHUP
+    exitInit();
+    sigaction(SIGHUP, &(struct sigaction){.sa_handler = cmdServerSigHup}, NULL);
+    cmdServerWorkerSignal(SIG_UNBLOCK);
+
+    // Disable logging and close log file
+    logClose();
+
+    while (!serverLocal.sigHup)
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            // Accept a new connection. The listening socket is shared by all workers so only one of them will get the connection.
+            IoSession *const socketSession = ioServerAccept(serverLocal.socketServer, NULL);
+
+            if (socketSession != NULL)
+            {
+                TRY_BEGIN()
+                {
+                    // Start standard remote processing if a server is returned
+                    ProtocolServer *const server = protocolServer(serverLocal.tlsServer, socketSession);
+
+                    if (server != NULL)
+                    {
+                        cmdServerWorkerStorage();
+                        cmdRemote(server);
+                    }
+                }
+                CATCH_ANY()
+                {
+                    // The error has already been sent to the client if possible. Free storage since it may have been left in an
+                    // inconsistent state.
+                    storageHelperFree();
+
+                    strFree(serverLocal.workerConfig);
+                    serverLocal.workerConfig = NULL;
+                }
+                TRY_END();
+
+                // Release any lock acquired for the client and restore the server config for the next client
+                lockRelease(false);
+                cfgLoad(serverLocal.argListSize, serverLocal.argList);
+                logClose();
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN void
 cmdServer(const unsigned int argListSize, const char *argList[])
@@ -137,46 +264,81 @@ cmdServer(const unsigned int argListSize, const char *argList[])
         // Accept connections indefinitely. The only way to exit this loop is for the process to receive a signal.
         do
         {
-            // Accept a new connection
-            IoSession *const socketSession = ioServerAccept(serverLocal.socketServer, NULL);
+            // Start workers until the requested number are running. Workers are not started while a reload is pending.
+            if (serverLocal.workerTotal > 0)
+            {
+                if (!serverLocal.sigHup && lstSize(serverLocal.processList) < serverLocal.workerTotal)
+                {
+                    cmdServerWorkerSignal(SIG_BLOCK);
 
-            if (socketSession != NULL)
+                    const pid_t pid = forkSafe();
+
+                    if (pid == 0)
+                    {
+                        cmdServerWorker();
+                        break;
+                    }
+
+                    lstAdd(serverLocal.processList, &pid);
+                    cmdServerWorkerSignal(SIG_UNBLOCK);
+                }
+                // Else wait for a worker to exit or a signal
+                else
+                    sleepMSec(100);
+            }
+            // Else accept a new connection
+            else
             {
-                // Fork off the child process
-                pid_t pid = forkSafe();
+                IoSession *const socketSession = ioServerAccept(serverLocal.socketServer, NULL);
 
-                if (pid == 0)
+                if (socketSession != NULL)
                 {
-                    // Reset SIGCHLD to default
-                    sigaction(SIGCHLD, &(struct sigaction){.sa_handler = SIG_DFL}, NULL);
+                    // Fork off the child process
+                    pid_t pid = forkSafe();
 
-                    // Set standard signal handlers
-                    exitInit();
+                    if (pid == 0)
+                    {
+                        // Reset SIGCHLD to default
+                        sigaction(SIGCHLD, &(struct sigaction){.sa_handler = SIG_DFL}, NULL);
 
-                    // Close the server socket so we don't hold the port open if the parent exits first
-                    ioServerFree(serverLocal.socketServer);
+                        // Set standard signal handlers
+                        exitInit();
 
-                    // Disable logging and close log file
-                    logClose();
+                        // Close the server socket so we don't hold the port open if the parent exits first
+                        ioServerFree(serverLocal.socketServer);
 
-                    // Start standard remote processing if a server is returned
-                    ProtocolServer *server = protocolServer(serverLocal.tlsServer, socketSession);
+                        // Disable logging and close log file
+                        logClose();
 
-                    if (server != NULL)
-                        cmdRemote(server);
+                        // Start standard remote processing if a server is returned
+                        ProtocolServer *server = protocolServer(serverLocal.tlsServer, socketSession);
+
+                        if (server != NULL)
+                            cmdRemote(server);
+
+                        break;
+                    }
+                    // Add process to list
+                    else
+                        lstAdd(serverLocal.processList, &pid);
 
-                    break;
+                    // Free the socket since the child is now using it
+                    ioSessionFree(socketSession);
                 }
-                // Add process to list
-                else
-                    lstAdd(serverLocal.processList, &pid);
+            }
+
+            // Workers hold the listening socket open so they must exit before the server can be reinitialized. Each worker exits
+            // after finishing its current client.
+            if (serverLocal.sigHup && serverLocal.workerTotal > 0 && !serverLocal.workerStop)
+            {
+                for (unsigned int processIdx = 0; processIdx < lstSize(serverLocal.processList); processIdx++)
+                    kill(*(pid_t *)lstGet(serverLocal.processList, processIdx), SIGHUP);
 
-                // Free the socket since the child is now using it
-                ioSessionFree(socketSession);
+                serverLocal.workerStop = true;
             }
 
             // Reload configuration
-            if (serverLocal.sigHup)
+            if (serverLocal.sigHup && (serverLocal.workerTotal == 0 || lstEmpty(serverLocal.processList)))
             {
                 LOG_DETAIL("configuration reload begin");
 
@@ -188,8 +350,9 @@ cmdServer(const unsigned int argListSize, const char *argList[])
 
                 LOG_DETAIL("configuration reload end");
 
-                // Reset flag
+                // Reset flags
                 serverLocal.sigHup = false;
+                serverLocal.workerStop = false;
             }
         }
         while (!serverLocal.sigTerm);
@@ -3,9 +3,9 @@ Verify File
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include "command/backup/common.h"
 #include "command/verify/file.h"
 #include "common/crypto/cipherBlock.h"
-#include "common/crypto/hash.h"
 #include "common/debug.h"
 #include "common/io/filter/group.h"
 #include "common/io/filter/sink.h"
@@ -52,8 +52,9 @@ verifyFile(
         if (compressType != compressTypeNone)
             ioFilterGroupAdd(filterGroup, decompressFilterP(compressType));
 
-        // Add sha1 filter
-        ioFilterGroupAdd(filterGroup, cryptoHashNew(hashTypeSha1));
+        // Add checksum filter of the same type as the expected checksum
+        IoFilter *const checksumFilter = backupChecksumFilter(fileChecksum);
+        ioFilterGroupAdd(filterGroup, checksumFilter);
 
         // Add size filter
         ioFilterGroupAdd(filterGroup, ioSizeNew());
@@ -65,7 +66,7 @@ verifyFile(
         if (ioReadDrain(read))
         {
             // Validate checksum
-            if (!bufEq(fileChecksum, pckReadBinP(ioFilterGroupResultP(filterGroup, CRYPTO_HASH_FILTER_TYPE))))
+            if (!bufEq(fileChecksum, pckReadBinP(ioFilterGroupResultP(filterGroup, ioFilterType(checksumFilter)))))
             {
                 result = verifyChecksumMismatch;
             }
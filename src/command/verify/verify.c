@@ -16,6 +16,7 @@ Verify contents of the repository.
 #include "command/verify/verify.h"
 #include "common/compress/helper.h"
 #include "common/crypto/cipherBlock.h"
+#include "common/crypto/xxhash.h"
 #include "common/debug.h"
 #include "common/io/fdWrite.h"
 #include "common/io/io.h"
@@ -109,6 +110,15 @@ typedef struct VerifyBackupResult
     List *invalidFileList;                                          // List of invalid files found in the backup
 } VerifyBackupResult;
 
+// WAL file stored in a bundle. The file name is built from the segment and checksum so it can be verified like any other WAL file.
+typedef struct VerifyWalBundleFile
+{
+    String *file;                                                   // WAL file name (segment, checksum, and compression extension)
+    String *bundle;                                                 // Bundle containing the WAL file
+    uint64_t offset;                                                // Offset of the WAL file in the bundle
+    uint64_t size;                                                  // Size of the WAL file in the bundle
+} VerifyWalBundleFile;
+
 // Job data stucture for processing and results collection
 typedef struct VerifyJobData
 {
@@ -116,6 +126,7 @@ typedef struct VerifyJobData
     StringList *archiveIdList;                                      // List of archive ids to verify
     StringList *walPathList;                                        // WAL path list for a single archive id
     StringList *walFileList;                                        // WAL file list for a single WAL path
+    List *walBundleList;                                            // WAL files in walFileList that are stored in bundles
     StringList *backupList;                                         // List of backups to verify
     Manifest *manifest;                                             // Manifest contents with list of files to verify
     unsigned int manifestFileIdx;                                   // Index of the file within the manifest file list to process
@@ -164,17 +175,19 @@ verifyInvalidFileAdd(List *const invalidFileList, const VerifyResult reason, con
 Load a file into memory
 ***********************************************************************************************************************************/
 static StorageRead *
-verifyFileLoad(const String *const pathFileName, const String *const cipherPass)
+verifyFileLoad(const String *const pathFileName, const uint64_t offset, const Variant *const limit, const String *const cipherPass)
 {
     FUNCTION_TEST_BEGIN();
         FUNCTION_TEST_PARAM(STRING, pathFileName);                  // Fully qualified path/file name
+        FUNCTION_TEST_PARAM(UINT64, offset);                        // Offset to read in file
+        FUNCTION_TEST_PARAM(VARIANT, limit);                        // Limit to read from file
         FUNCTION_TEST_PARAM(STRING, cipherPass);                    // Password to open file if encrypted
     FUNCTION_TEST_END();
 
     ASSERT(pathFileName != NULL);
 
     // Read the file and error if missing
-    StorageRead *const result = storageNewReadP(storageRepo(), pathFileName);
+    StorageRead *const result = storageNewReadP(storageRepo(), pathFileName, .offset = offset, .limit = limit);
 
     // *read points to a location within result so update result with contents based on necessary filters
     IoRead *const read = storageReadIo(result);
@@ -212,7 +225,7 @@ verifyInfoFile(const String *const pathFileName, const bool keepFile, const Stri
     {
         TRY_BEGIN()
         {
-            IoRead *const infoRead = storageReadIo(verifyFileLoad(pathFileName, cipherPass));
+            IoRead *const infoRead = storageReadIo(verifyFileLoad(pathFileName, 0, NULL, cipherPass));
 
             // If directed to keep the loaded file in memory, then move the file into the result, else drain the io and close it
             if (keepFile)
@@ -638,6 +651,98 @@ verifyCreateArchiveIdRange(
     FUNCTION_TEST_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Replace bundles in the WAL file list with the WAL files they contain
+***********************************************************************************************************************************/
+static void
+verifyArchiveBundleExpand(VerifyJobData *const jobData, const String *const walFilePath)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(STRING, walFilePath);                   // Path of the WAL files
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(walFilePath != NULL);
+
+    // Free the old bundle list
+    lstFree(jobData->walBundleList);
+
+    MEM_CONTEXT_BEGIN(jobData->memContext)
+    {
+        jobData->walBundleList = lstNewP(sizeof(VerifyWalBundleFile), .comparator = lstComparatorStr);
+    }
+    MEM_CONTEXT_END();
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        unsigned int walFileIdx = 0;
+
+        while (walFileIdx < strLstSize(jobData->walFileList))
+        {
+            const String *const bundle = strLstGet(jobData->walFileList, walFileIdx);
+
+            if (!walIsBundle(bundle))
+            {
+                walFileIdx++;
+                continue;
+            }
+
+            const String *const bundlePathFile = strNewFmt("%s/%s", strZ(walFilePath), strZ(bundle));
+            const List *index = NULL;
+
+            // An invalid index is an error but the WAL files in the bundle cannot be verified so they will show up as missing
+            TRY_BEGIN()
+            {
+                index = walBundleIndex(storageRepo(), bundlePathFile, false);
+            }
+            CATCH_ANY()
+            {
+                LOG_INFO_FMT("invalid bundle '%s': [%d] %s", strZ(bundlePathFile), errorCode(), errorMessage());
+                jobData->jobErrorTotal++;
+            }
+            TRY_END();
+
+            if (index != NULL)
+            {
+                const String *const compressExt = compressExtStr(compressTypeFromName(bundle));
+
+                for (unsigned int indexIdx = 0; indexIdx < lstSize(index); indexIdx++)
+                {
+                    const WalBundleSegment *const segment = lstGet(index, indexIdx);
+                    const String *const file = strNewFmt(
+                        "%s-%s%s", strZ(segment->segment), strZ(segment->checksum), strZ(compressExt));
+
+                    strLstAdd(jobData->walFileList, file);
+
+                    MEM_CONTEXT_BEGIN(lstMemContext(jobData->walBundleList))
+                    {
+                        const VerifyWalBundleFile bundleFile =
+                        {
+                            .file = strDup(file),
+                            .bundle = strDup(bundle),
+                            .offset = segment->offset,
+                            .size = segment->size,
+                        };
+
+                        lstAdd(jobData->walBundleList, &bundleFile);
+                    }
+                    MEM_CONTEXT_END();
+                }
+            }
+
+            // Remove the bundle. WAL files added from the bundle are at the end of the list and are skipped since they are not
+            // bundles.
+            strLstRemoveIdx(jobData->walFileList, walFileIdx);
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    lstSort(jobData->walBundleList, sortOrderAsc);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Return verify jobs for the archive
 ***********************************************************************************************************************************/
@@ -711,21 +816,28 @@ verifyArchive(VerifyJobData *const jobData)
 
                         MEM_CONTEXT_BEGIN(jobData->memContext)
                         {
-                            jobData->walFileList = strLstSort(
-                                storageListP(storageRepo(), walFilePath, .expression = WAL_SEGMENT_FILE_REGEXP_STR), sortOrderAsc);
+                            jobData->walFileList = storageListP(
+                                storageRepo(), walFilePath, .expression = WAL_ARCHIVE_FILE_REGEXP_STR);
                         }
                         MEM_CONTEXT_END();
 
+                        // Bundled WAL files are verified individually
+                        verifyArchiveBundleExpand(jobData, walFilePath);
+                        strLstSort(jobData->walFileList, sortOrderAsc);
+
                         if (!strLstEmpty(jobData->walFileList))
                         {
                             if (archiveResult->pgWalInfo.size == 0)
                             {
-                                // Initialize the WAL segment size from the first WAL
+                                // Initialize the WAL segment size from the first WAL, which may be stored in a bundle
+                                const String *const walFile = strLstGet(jobData->walFileList, 0);
+                                const VerifyWalBundleFile *const bundleFile = lstFind(jobData->walBundleList, &walFile);
                                 StorageRead *const walRead = verifyFileLoad(
                                     strNewFmt(
                                         STORAGE_REPO_ARCHIVE "/%s/%s/%s", strZ(archiveResult->archiveId), strZ(walPath),
-                                        strZ(strLstGet(jobData->walFileList, 0))),
-                                    jobData->walCipherPass);
+                                        strZ(bundleFile != NULL ? bundleFile->bundle : walFile)),
+                                    bundleFile != NULL ? bundleFile->offset : 0,
+                                    bundleFile != NULL ? VARUINT64(bundleFile->size) : NULL, jobData->walCipherPass);
 
                                 const PgWal walInfo = pgWalFromBuffer(
                                     storageGetP(walRead, .exactSize = PG_WAL_HEADER_SIZE), cfgOptionStrNull(cfgOptPgVersionForce));
@@ -746,10 +858,13 @@ verifyArchive(VerifyJobData *const jobData)
                     // If there are WAL files, then verify them
                     if (!strLstEmpty(jobData->walFileList))
                     {
-                        // Get the fully qualified file name and checksum
+                        // Get the fully qualified file name and checksum. If the WAL file is in a bundle then read it from the
+                        // bundle.
                         const String *const fileName = strLstGet(jobData->walFileList, 0);
+                        const VerifyWalBundleFile *const bundleFile = lstFind(jobData->walBundleList, &fileName);
                         const String *const filePathName = strNewFmt(
-                            STORAGE_REPO_ARCHIVE "/%s/%s/%s", strZ(archiveResult->archiveId), strZ(walPath), strZ(fileName));
+                            STORAGE_REPO_ARCHIVE "/%s/%s/%s", strZ(archiveResult->archiveId), strZ(walPath),
+                            strZ(bundleFile != NULL ? bundleFile->bundle : fileName));
                         const Buffer *const checksum = bufNewDecode(
                             encodingHex, strSubN(fileName, WAL_SEGMENT_NAME_SIZE + 1, HASH_TYPE_SHA1_SIZE_HEX));
 
@@ -758,14 +873,27 @@ verifyArchive(VerifyJobData *const jobData)
                         PackWrite *const param = protocolCommandParam(command);
 
                         pckWriteStrP(param, filePathName);
-                        pckWriteBoolP(param, false);
+
+                        if (bundleFile != NULL)
+                        {
+                            pckWriteBoolP(param, true);
+                            pckWriteU64P(param, bundleFile->offset);
+                            pckWriteU64P(param, bundleFile->size);
+                        }
+                        else
+                            pckWriteBoolP(param, false);
+
                         pckWriteU32P(param, compressTypeFromName(filePathName));
                         pckWriteBinP(param, checksum);
                         pckWriteU64P(param, archiveResult->pgWalInfo.size);
                         pckWriteStrP(param, jobData->walCipherPass);
 
-                        // Assign job to result, prepending the archiveId to the key for consistency with backup processing
-                        const String *const jobKey = strNewFmt("%s/%s", strZ(archiveResult->archiveId), strZ(filePathName));
+                        // Assign job to result, prepending the archiveId to the key for consistency with backup processing. For
+                        // bundles the WAL file name is appended so the key ends with the WAL segment like any other WAL file.
+                        String *const jobKey = strNewFmt("%s/%s", strZ(archiveResult->archiveId), strZ(filePathName));
+
+                        if (bundleFile != NULL)
+                            strCatFmt(jobKey, "/%s", strZ(fileName));
 
                         MEM_CONTEXT_PRIOR_BEGIN()
                         {
@@ -998,11 +1126,16 @@ verifyBackup(VerifyJobData *const jobData)
                             else
                                 pckWriteBoolP(param, false);
 
-                            // Use the repo checksum when present
+                            // Use the repo checksum when present. xxh3 checksums are preferred when present since they are much
+                            // faster to calculate.
                             if (fileData.checksumRepoSha1 != NULL)
                             {
                                 pckWriteU32P(param, compressTypeNone);
-                                pckWriteBinP(param, BUF(fileData.checksumRepoSha1, HASH_TYPE_SHA1_SIZE));
+                                pckWriteBinP(
+                                    param,
+                                    fileData.checksumRepoXxh3 != NULL ?
+                                        BUF(fileData.checksumRepoXxh3, XX_HASH_SIZE_MAX) :
+                                        BUF(fileData.checksumRepoSha1, HASH_TYPE_SHA1_SIZE));
                                 pckWriteU64P(param, fileData.sizeRepo);
                                 pckWriteStrP(param, NULL);
                             }
@@ -1010,7 +1143,11 @@ verifyBackup(VerifyJobData *const jobData)
                             else
                             {
                                 pckWriteU32P(param, manifestData(jobData->manifest)->backupOptionCompressType);
-                                pckWriteBinP(param, BUF(fileData.checksumSha1, HASH_TYPE_SHA1_SIZE));
+                                pckWriteBinP(
+                                    param,
+                                    fileData.checksumXxh3 != NULL ?
+                                        BUF(fileData.checksumXxh3, XX_HASH_SIZE_MAX) :
+                                        BUF(fileData.checksumSha1, HASH_TYPE_SHA1_SIZE));
                                 pckWriteU64P(param, fileData.size);
                                 pckWriteStrP(param, jobData->backupCipherPass);
                             }
@@ -23,6 +23,6 @@ Level constants
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
-FN_EXTERN IoFilter *gzCompressNew(int level, bool raw);
+FN_EXTERN IoFilter *gzCompressNew(int level, bool raw, unsigned int thread);
 
 #endif
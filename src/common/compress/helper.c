@@ -39,7 +39,7 @@ static const struct CompressHelperLocal
     const String *const type;                                       // Compress type -- must be extension without period prefixed
     const String *const ext;                                        // File extension with period prefixed
     StringId compressType;                                          // Type of the compression filter
-    IoFilter *(*compressNew)(int, bool);                            // Function to create new compression filter
+    IoFilter *(*compressNew)(int, bool, unsigned int);              // Function to create new compression filter
     StringId decompressType;                                        // Type of the decompression filter
     IoFilter *(*decompressNew)(bool);                               // Function to create new decompression filter
     int levelDefault : 8;                                           // Default compression level
@@ -236,13 +236,14 @@ compressFilter(const CompressType type, const int level, const CompressFilterPar
         FUNCTION_TEST_PARAM(ENUM, type);
         FUNCTION_TEST_PARAM(INT, level);
         FUNCTION_TEST_PARAM(BOOL, param.raw);
+        FUNCTION_TEST_PARAM(UINT, param.thread);
     FUNCTION_TEST_END();
 
     ASSERT(type < LENGTH_OF(compressHelperLocal));
     ASSERT(type != compressTypeNone);
     compressTypePresent(type);
 
-    FUNCTION_TEST_RETURN(IO_FILTER, compressHelperLocal[type].compressNew(level, param.raw));
+    FUNCTION_TEST_RETURN(IO_FILTER, compressHelperLocal[type].compressNew(level, param.raw, param.thread));
 }
 
 /**********************************************************************************************************************************/
@@ -271,8 +272,9 @@ compressFilterPack(const StringId filterType, const Pack *const filterParam)
                 PackRead *const paramRead = pckReadNew(filterParam);
                 const int level = pckReadI32P(paramRead);
                 const bool raw = pckReadBoolP(paramRead);
+                const unsigned int thread = pckReadU32P(paramRead);
 
-                result = ioFilterMove(compress->compressNew(level, raw), memContextPrior());
+                result = ioFilterMove(compress->compressNew(level, raw, thread), memContextPrior());
                 break;
             }
             else if (filterType == compress->decompressType)
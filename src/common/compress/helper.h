@@ -54,6 +54,7 @@ typedef struct CompressFilterParam
 {
     VAR_PARAM_HEADER;
     bool raw;                                                       // Omit headers, checksum, etc. when possible
+    unsigned int thread;                                            // Worker threads when supported (0 = compress in caller)
 } CompressFilterParam;
 
 #define compressFilterP(type, level, ...)                                                                                          \
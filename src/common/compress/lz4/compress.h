@@ -25,7 +25,7 @@ Level constants
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
-FN_EXTERN IoFilter *lz4CompressNew(int level, bool raw);
+FN_EXTERN IoFilter *lz4CompressNew(int level, bool raw, unsigned int thread);
 
 #endif
 
@@ -22,6 +22,7 @@ typedef struct ZstCompress
 {
     ZSTD_CStream *context;                                          // Compression context
     int level;                                                      // Compression level
+    unsigned int thread;                                            // Worker threads (0 = compress in the calling thread)
     IoFilter *filter;                                               // Filter interface
 
     bool inputSame;                                                 // Is the same input required on the next process call?
@@ -36,8 +37,8 @@ static void
 zstCompressToLog(const ZstCompress *const this, StringStatic *const debugLog)
 {
     strStcFmt(
-        debugLog, "{level: %d, inputSame: %s, inputOffset: %zu, flushing: %s}", this->level, cvtBoolToConstZ(this->inputSame),
-        this->inputOffset, cvtBoolToConstZ(this->flushing));
+        debugLog, "{level: %d, thread: %u, inputSame: %s, inputOffset: %zu, flushing: %s}", this->level, this->thread,
+        cvtBoolToConstZ(this->inputSame), this->inputOffset, cvtBoolToConstZ(this->flushing));
 }
 
 #define FUNCTION_LOG_ZST_COMPRESS_TYPE                                                                                             \
@@ -103,8 +104,13 @@ zstCompressProcess(THIS_VOID, const Buffer *const uncompressed, Buffer *const co
             .size = bufUsed(uncompressed) - this->inputOffset,
         };
 
-        // Perform compression
-        zstError(ZSTD_compressStream(this->context, &out, &in));
+        // Perform compression. With worker threads the input may not be entirely consumed even when there is space in the output
+        // buffer, so keep going until one or the other is exhausted.
+        do
+        {
+            zstError(ZSTD_compressStream(this->context, &out, &in));
+        }
+        while (in.pos < in.size && out.pos < out.size);
 
         // If the input buffer was not entirely consumed then set inputSame and store the offset where processing will restart
         if (in.pos < in.size)
@@ -164,11 +170,12 @@ zstCompressInputSame(const THIS_VOID)
 
 /**********************************************************************************************************************************/
 FN_EXTERN IoFilter *
-zstCompressNew(const int level, const bool raw)
+zstCompressNew(const int level, const bool raw, const unsigned int thread)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(INT, level);
         (void)raw;                                                  // Raw unsupported
+        FUNCTION_LOG_PARAM(UINT, thread);
     FUNCTION_LOG_END();
 
     ASSERT(level >= ZST_COMPRESS_LEVEL_MIN && level <= ZST_COMPRESS_LEVEL_MAX);
@@ -186,6 +193,15 @@ zstCompressNew(const int level, const bool raw)
 
         // Initialize context
         zstError(ZSTD_initCStream(this->context, this->level));
+
+        // Compress with worker threads when requested. If libzstd was built without multithreading support then setting workers
+        // fails and compression continues in the calling thread, which produces the same output.
+#if ZSTD_VERSION_NUMBER >= 10400
+        if (thread > 0 && !ZSTD_isError(ZSTD_CCtx_setParameter(this->context, ZSTD_c_nbWorkers, (int)thread)))
+            this->thread = thread;
+#else
+        (void)thread;                                               // Threads unsupported
+#endif
     }
     OBJ_NEW_END();
 
@@ -197,6 +213,8 @@ zstCompressNew(const int level, const bool raw)
         PackWrite *const packWrite = pckWriteNewP();
 
         pckWriteI32P(packWrite, level);
+        pckWriteBoolP(packWrite, false);
+        pckWriteU32P(packWrite, thread);
         pckWriteEndP(packWrite);
 
         paramList = pckMove(pckWriteResult(packWrite), memContextPrior());
@@ -32,6 +32,22 @@ Include local MD5 code
 ***********************************************************************************************************************************/
 #include "common/crypto/md5.vendor.c.inc"
 
+/***********************************************************************************************************************************
+Digests are looked up once per process and cached. OpenSSL >= 3 fetches digests from a provider and when a digest is not fetched
+explicitly the fetch is repeated each time a context is initialized, which is a noticeable part of the cost of hashing a small file.
+***********************************************************************************************************************************/
+#define CRYPTO_HASH_DIGEST_CACHE_MAX                                4
+
+static struct CryptoHashLocal
+{
+    unsigned int digestTotal;                                       // Digests in the cache
+    struct
+    {
+        HashType type;                                              // Hash type
+        const EVP_MD *digest;                                       // Digest
+    } digestList[CRYPTO_HASH_DIGEST_CACHE_MAX];
+} cryptoHashLocal;
+
 /***********************************************************************************************************************************
 Object type
 ***********************************************************************************************************************************/
@@ -166,6 +182,63 @@ cryptoHashResult(THIS_VOID)
     FUNCTION_LOG_RETURN(PACK, result);
 }
 
+/***********************************************************************************************************************************
+Get a digest from the cache or look it up
+***********************************************************************************************************************************/
+static const EVP_MD *
+cryptoHashDigest(const HashType type)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING_ID, type);
+    FUNCTION_TEST_END();
+
+    const EVP_MD *result = NULL;
+
+    // Search the cache
+    for (unsigned int digestIdx = 0; digestIdx < cryptoHashLocal.digestTotal; digestIdx++)
+    {
+        if (cryptoHashLocal.digestList[digestIdx].type == type)
+        {
+            result = cryptoHashLocal.digestList[digestIdx].digest;
+            break;
+        }
+    }
+
+    // Else lookup the digest
+    if (result == NULL)
+    {
+        char typeZ[STRID_MAX + 1];
+        strIdToZ(type, typeZ);
+
+        // Fetched digests are reference counted and would need to be freed so only fetch when there is room in the cache
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        if (cryptoHashLocal.digestTotal < CRYPTO_HASH_DIGEST_CACHE_MAX)
+        {
+            result = EVP_MD_fetch(NULL, typeZ, NULL);
+
+            // Clear the error left by a failed fetch so it is not reported by a later unrelated error
+            if (result == NULL)
+                ERR_clear_error();
+        }
+        else
+#endif
+            result = EVP_get_digestbyname(typeZ);
+
+        if (result == NULL)
+            THROW_FMT(AssertError, "unable to load hash '%s'", typeZ);
+
+        // Add the digest to the cache
+        if (cryptoHashLocal.digestTotal < CRYPTO_HASH_DIGEST_CACHE_MAX)
+        {
+            cryptoHashLocal.digestList[cryptoHashLocal.digestTotal].type = type;
+            cryptoHashLocal.digestList[cryptoHashLocal.digestTotal].digest = result;
+            cryptoHashLocal.digestTotal++;
+        }
+    }
+
+    FUNCTION_TEST_RETURN_CONST_P(VOID, result);
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN IoFilter *
 cryptoHashNew(const HashType type)
@@ -194,11 +267,7 @@ cryptoHashNew(const HashType type)
         else
         {
             // Lookup digest
-            char typeZ[STRID_MAX + 1];
-            strIdToZ(type, typeZ);
-
-            if ((this->hashType = EVP_get_digestbyname(typeZ)) == NULL)
-                THROW_FMT(AssertError, "unable to load hash '%s'", typeZ);
+            this->hashType = cryptoHashDigest(type);
 
             // Create context
             cryptoError((this->hashContext = EVP_MD_CTX_create()) == NULL, "unable to create hash context");
@@ -300,11 +369,7 @@ cryptoHmacOne(const HashType type, const Buffer *const key, const Buffer *const
     cryptoInit();
 
     // Lookup digest
-    char typeZ[STRID_MAX + 1];
-    strIdToZ(type, typeZ);
-
-    const EVP_MD *const hashType = EVP_get_digestbyname(typeZ);
-    ASSERT(hashType != NULL);
+    const EVP_MD *const hashType = cryptoHashDigest(type);
 
     // Allocate a buffer to hold the hmac
     Buffer *const result = bufNew((size_t)EVP_MD_size(hashType));
@@ -60,6 +60,8 @@ struct MemContext
     bool allocInitialized : 1;                                      // Has the allocation list been initialized?
     MemQty callbackQty : 2;                                         // How many callbacks can this context have?
     bool callbackInitialized : 1;                                   // Has the callback been initialized?
+    bool arena : 1;                                                 // Are allocations and child contexts made from an arena?
+    bool arenaOwner : 1;                                            // Does this context own the arena?
     size_t allocExtra : 16;                                         // Size of extra allocation (1kB max)
 
     unsigned int contextParentIdx;                                  // Index in the parent context list
@@ -101,6 +103,29 @@ typedef struct MemContextCallbackOne
     void *argument;                                                 // Argument to pass to callback function
 } MemContextCallbackOne;
 
+// Arena block. Blocks are chained so they can be freed with the context that owns the arena.
+typedef struct MemContextArenaBlock
+{
+    struct MemContextArenaBlock *next;                              // Next block in the arena
+    size_t size;                                                    // Size of the block including this header
+} MemContextArenaBlock;
+
+// Arena owned by a mem context
+typedef struct MemContextArena
+{
+    MemContextArenaBlock *blockList;                                // Blocks allocated for the arena
+    unsigned char *free;                                            // Free space in the current block
+    size_t freeSize;                                                // Size of free space in the current block
+} MemContextArena;
+
+// Arena allocations are aligned the same as malloc() on common platforms. The block header is the same size so the first allocation
+// in a block is aligned.
+#define MEM_CONTEXT_ARENA_ALIGN                                     (sizeof(void *) * 2)
+
+// Round size up to the arena alignment
+#define MEM_CONTEXT_ARENA_SIZE(size)                                                                                               \
+    (((size) + MEM_CONTEXT_ARENA_ALIGN - 1) & ~(MEM_CONTEXT_ARENA_ALIGN - 1))
+
 /***********************************************************************************************************************************
 Possible sizes for the manifest based on options
 ***********************************************************************************************************************************/
@@ -183,6 +208,16 @@ memContextCallbackOne(MemContext *const memContext)
          memContextSizePossible[memContext->childQty][memContext->allocQty][0] + memContext->allocExtra);
 }
 
+// Get pointer to arena part
+static MemContextArena *
+memContextArenaOwned(MemContext *const memContext)
+{
+    return
+        (MemContextArena *)
+        ((unsigned char *)(memContext + 1) +
+         memContextSizePossible[memContext->childQty][memContext->allocQty][memContext->callbackQty] + memContext->allocExtra);
+}
+
 /***********************************************************************************************************************************
 Top context
 
@@ -231,6 +266,11 @@ static struct MemContextStack
 static unsigned int memContextCurrentStackIdx = 0;
 static unsigned int memContextMaxStackIdx = 0;
 
+/***********************************************************************************************************************************
+Memory allocation statistics
+***********************************************************************************************************************************/
+static MemContextStat memContextStatLocal;
+
 /***********************************************************************************************************************************
 ***********************************************************************************************************************************/
 #ifdef DEBUG
@@ -407,6 +447,8 @@ memAllocInternal(const size_t size)
     if (buffer == NULL)
         THROW_FMT(MemoryError, "unable to allocate %zu bytes", size);
 
+    memContextStatLocal.allocTotal++;
+
     // Return the buffer
     FUNCTION_TEST_RETURN_P(VOID, buffer);
 }
@@ -452,6 +494,8 @@ memReAllocInternal(void *const bufferOld, const size_t sizeNew)
     if (bufferNew == NULL)
         THROW_FMT(MemoryError, "unable to reallocate %zu bytes", sizeNew);
 
+    memContextStatLocal.reAllocTotal++;
+
     // Return the buffer
     FUNCTION_TEST_RETURN_P(VOID, bufferNew);
 }
@@ -493,9 +537,120 @@ memFreeInternal(void *const buffer)
 
     free(buffer);
 
+    memContextStatLocal.freeTotal++;
+
     FUNCTION_TEST_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Find the context that owns the arena used by a context. Returns NULL if the context is not in an arena.
+***********************************************************************************************************************************/
+static MemContext *
+memContextArenaOwner(MemContext *memContext)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MEM_CONTEXT, memContext);
+    FUNCTION_TEST_END();
+
+    while (memContext != NULL && !memContext->arenaOwner)
+        memContext = memContext->contextParent;
+
+    FUNCTION_TEST_RETURN(MEM_CONTEXT, memContext);
+}
+
+/***********************************************************************************************************************************
+Allocate memory from the arena used by a context
+***********************************************************************************************************************************/
+static void *
+memContextArenaAlloc(MemContext *const memContext, const size_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MEM_CONTEXT, memContext);
+        FUNCTION_TEST_PARAM(SIZE, size);
+    FUNCTION_TEST_END();
+
+    ASSERT(memContext != NULL);
+    ASSERT(memContext->arena);
+
+    MemContextArena *const arena = memContextArenaOwned(memContextArenaOwner(memContext));
+    const size_t sizeAlign = MEM_CONTEXT_ARENA_SIZE(size);
+    void *result;
+
+    // Large allocations get their own block so the free space in the current block is not wasted
+    if (sizeAlign > MEM_CONTEXT_ARENA_BLOCK_SIZE / 4)
+    {
+        MemContextArenaBlock *const block = memAllocInternal(sizeof(MemContextArenaBlock) + sizeAlign);
+        *block = (MemContextArenaBlock){.next = arena->blockList, .size = sizeof(MemContextArenaBlock) + sizeAlign};
+        arena->blockList = block;
+
+        result = block + 1;
+    }
+    else
+    {
+        // Allocate a new block when there is not enough free space in the current block
+        if (sizeAlign > arena->freeSize)
+        {
+            MemContextArenaBlock *const block = memAllocInternal(MEM_CONTEXT_ARENA_BLOCK_SIZE);
+            *block = (MemContextArenaBlock){.next = arena->blockList, .size = MEM_CONTEXT_ARENA_BLOCK_SIZE};
+            arena->blockList = block;
+
+            arena->free = (unsigned char *)(block + 1);
+            arena->freeSize = MEM_CONTEXT_ARENA_BLOCK_SIZE - sizeof(MemContextArenaBlock);
+        }
+
+        result = arena->free;
+        arena->free += sizeAlign;
+        arena->freeSize -= sizeAlign;
+
+        memContextStatLocal.arenaTotal++;
+    }
+
+    FUNCTION_TEST_RETURN_P(VOID, result);
+}
+
+/***********************************************************************************************************************************
+Resize memory allocated from the arena used by a context. The last allocation in the current block is resized in place when there is
+enough free space, which is common when a string or buffer is grown. Otherwise new memory is allocated and the old memory is not
+reused until the arena is freed.
+***********************************************************************************************************************************/
+static void *
+memContextArenaReAlloc(MemContext *const memContext, void *const bufferOld, const size_t sizeOld, const size_t sizeNew)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MEM_CONTEXT, memContext);
+        FUNCTION_TEST_PARAM_P(VOID, bufferOld);
+        FUNCTION_TEST_PARAM(SIZE, sizeOld);
+        FUNCTION_TEST_PARAM(SIZE, sizeNew);
+    FUNCTION_TEST_END();
+
+    ASSERT(memContext != NULL);
+    ASSERT(memContext->arena);
+    ASSERT(bufferOld != NULL);
+
+    MemContextArena *const arena = memContextArenaOwned(memContextArenaOwner(memContext));
+    const size_t sizeOldAlign = MEM_CONTEXT_ARENA_SIZE(sizeOld);
+    const size_t sizeNewAlign = MEM_CONTEXT_ARENA_SIZE(sizeNew);
+    void *result;
+
+    // Resize in place when this is the last allocation in the current block and there is enough free space
+    if ((unsigned char *)bufferOld + sizeOldAlign == arena->free && sizeNewAlign <= sizeOldAlign + arena->freeSize &&
+        sizeNewAlign <= MEM_CONTEXT_ARENA_BLOCK_SIZE / 4)
+    {
+        arena->free = (unsigned char *)bufferOld + sizeNewAlign;
+        arena->freeSize = arena->freeSize + sizeOldAlign - sizeNewAlign;
+
+        result = bufferOld;
+    }
+    // Else allocate new memory and copy the old contents
+    else
+    {
+        result = memContextArenaAlloc(memContext, sizeNew);
+        memcpy(result, bufferOld, sizeOld < sizeNew ? sizeOld : sizeNew);
+    }
+
+    FUNCTION_TEST_RETURN_P(VOID, result);
+}
+
 /***********************************************************************************************************************************
 Find space for a new mem context
 ***********************************************************************************************************************************/
@@ -561,6 +716,7 @@ memContextNew(
         FUNCTION_TEST_PARAM(UINT, param.allocQty);
         FUNCTION_TEST_PARAM(UINT, param.callbackQty);
         FUNCTION_TEST_PARAM(SIZE, param.allocExtra);
+        FUNCTION_TEST_PARAM(BOOL, param.arena);
     FUNCTION_TEST_END();
 
     ASSERT(name != NULL);
@@ -585,8 +741,14 @@ memContextNew(
     const MemQty allocQty = param.allocQty > 1 ? memQtyMany : (MemQty)param.allocQty;
     const MemQty callbackQty = (MemQty)param.callbackQty;
 
-    MemContext *const this = memAllocInternal(
-        sizeof(MemContext) + allocExtra + memContextSizePossible[childQty][allocQty][callbackQty]);
+    // A context created in an arena context uses the same arena, otherwise the context owns a new arena when requested
+    const bool arena = param.arena || contextCurrent->arena;
+    const bool arenaOwner = arena && !contextCurrent->arena;
+    const size_t size =
+        sizeof(MemContext) + allocExtra + memContextSizePossible[childQty][allocQty][callbackQty] +
+        (arenaOwner ? sizeof(MemContextArena) : 0);
+
+    MemContext *const this = contextCurrent->arena ? memContextArenaAlloc(contextCurrent, size) : memAllocInternal(size);
 
     *this = (MemContext)
     {
@@ -604,6 +766,8 @@ memContextNew(
         .childQty = childQty,
         .allocQty = allocQty,
         .callbackQty = callbackQty,
+        .arena = arena,
+        .arenaOwner = arenaOwner,
 
         // Set extra allocation
         .allocExtra = (uint16_t)allocExtra,
@@ -612,6 +776,10 @@ memContextNew(
         .contextParent = contextCurrent,
     };
 
+    // Initialize arena
+    if (arenaOwner)
+        *memContextArenaOwned(this) = (MemContextArena){0};
+
     // Find space for the new context
     if (contextCurrent->childQty == memQtyOne)
     {
@@ -733,12 +901,16 @@ memContextAllocNew(const size_t size)
     FUNCTION_TEST_END();
 
     // Allocate memory
-    MemContextAlloc *const result = memAllocInternal(sizeof(MemContextAlloc) + size);
-
-    // Find space for the new allocation
     MemContext *const contextCurrent = memContextStack[memContextCurrentStackIdx].memContext;
     ASSERT(contextCurrent->allocQty != memQtyNone);
 
+    MemContextAlloc *const result =
+        contextCurrent->arena ?
+            memContextArenaAlloc(contextCurrent, sizeof(MemContextAlloc) + size) :
+            memAllocInternal(sizeof(MemContextAlloc) + size);
+
+    // Find space for the new allocation
+
     if (contextCurrent->allocQty == memQtyOne)
     {
         MemContextAllocOne *const contextAlloc = memContextAllocOne(contextCurrent);
@@ -813,14 +985,18 @@ memContextAllocResize(MemContextAlloc *alloc, const size_t size)
     FUNCTION_TEST_END();
 
     // Resize the allocation
-    alloc = memReAllocInternal(alloc, sizeof(MemContextAlloc) + size);
-    alloc->size = (unsigned int)(sizeof(MemContextAlloc) + size);
-
-    // Update pointer in allocation list in case the realloc moved the allocation
     MemContext *const currentContext = memContextStack[memContextCurrentStackIdx].memContext;
     ASSERT(currentContext->allocQty != memQtyNone);
     ASSERT(currentContext->allocInitialized);
 
+    alloc =
+        currentContext->arena ?
+            memContextArenaReAlloc(currentContext, alloc, alloc->size, sizeof(MemContextAlloc) + size) :
+            memReAllocInternal(alloc, sizeof(MemContextAlloc) + size);
+    alloc->size = (unsigned int)(sizeof(MemContextAlloc) + size);
+
+    // Update pointer in allocation list in case the realloc moved the allocation
+
     if (currentContext->allocQty == memQtyOne)
     {
         ASSERT(memContextAllocOne(currentContext)->alloc != NULL);
@@ -913,8 +1089,9 @@ memFree(void *const buffer)
         contextAlloc->list[alloc->allocIdx] = NULL;
     }
 
-    // Free the allocation
-    memFreeInternal(alloc);
+    // Free the allocation. Arena allocations are freed with the arena.
+    if (!contextCurrent->arena)
+        memFreeInternal(alloc);
 
     FUNCTION_TEST_RETURN_VOID();
 }
@@ -938,6 +1115,17 @@ memContextMove(MemContext *const this, MemContext *const parentNew)
         ASSERT(this->contextParent->childQty != memQtyNone);
         ASSERT(this->contextParent->childInitialized);
 
+        // Error if the context would outlive the arena it was allocated from. This check is done in production builds as well since
+        // the context memory would be freed with the arena while still in use.
+        if (this->arena && !this->arenaOwner && memContextArenaOwner(parentNew) != memContextArenaOwner(this))
+        {
+#ifdef DEBUG
+            THROW_FMT(AssertError, "cannot move context '%s' out of arena", this->name);
+#else
+            THROW(AssertError, "cannot move context out of arena");
+#endif
+        }
+
         // Null out the context in the old parent
         if (this->contextParent->childQty == memQtyOne)
         {
@@ -1112,6 +1300,19 @@ memContextPrior(void)
     FUNCTION_TEST_RETURN(MEM_CONTEXT, memContextStack[memContextCurrentStackIdx - priorIdx].memContext);
 }
 
+/**********************************************************************************************************************************/
+FN_EXTERN bool
+memContextArena(const MemContext *const this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MEM_CONTEXT, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(BOOL, this->arena);
+}
+
 /**********************************************************************************************************************************/
 #ifdef DEBUG
 
@@ -1195,11 +1396,23 @@ memContextSize(const MemContext *const this)
     if (this->callbackQty != memQtyNone)
         offset += sizeof(MemContextCallbackOne);
 
+    // Size of arena
+    if (this->arenaOwner)
+        offset += sizeof(MemContextArena);
+
     FUNCTION_TEST_RETURN(SIZE, (size_t)(offset - (unsigned char *)this) + total);
 }
 
 #endif // DEBUG
 
+/**********************************************************************************************************************************/
+FN_EXTERN MemContextStat
+memContextStat(void)
+{
+    FUNCTION_TEST_VOID();
+    FUNCTION_TEST_RETURN_TYPE(MemContextStat, memContextStatLocal);
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN void
 memContextClean(const unsigned int tryDepth, const bool fatal)
@@ -1337,7 +1550,7 @@ memContextFreeRecurse(MemContext *const this)
         {
             MemContextAllocOne *const contextAlloc = memContextAllocOne(this);
 
-            if (contextAlloc->alloc != NULL)
+            if (contextAlloc->alloc != NULL && !this->arena)
                 memFreeInternal(contextAlloc->alloc);
         }
         else
@@ -1346,14 +1559,32 @@ memContextFreeRecurse(MemContext *const this)
 
             MemContextAllocMany *const contextAlloc = memContextAllocMany(this);
 
-            for (unsigned int allocIdx = 0; allocIdx < contextAlloc->listSize; allocIdx++)
-                if (contextAlloc->list[allocIdx] != NULL)
-                    memFreeInternal(contextAlloc->list[allocIdx]);
+            // Arena allocations are freed with the arena
+            if (!this->arena)
+            {
+                for (unsigned int allocIdx = 0; allocIdx < contextAlloc->listSize; allocIdx++)
+                    if (contextAlloc->list[allocIdx] != NULL)
+                        memFreeInternal(contextAlloc->list[allocIdx]);
+            }
 
             memFreeInternal(contextAlloc->list);
         }
     }
 
+    // Free arena blocks
+    if (this->arenaOwner)
+    {
+        MemContextArenaBlock *block = memContextArenaOwned(this)->blockList;
+
+        while (block != NULL)
+        {
+            MemContextArenaBlock *const blockNext = block->next;
+
+            memFreeInternal(block);
+            block = blockNext;
+        }
+    }
+
     // Free the memory context so the slot can be reused (if not the top mem context)
     if (this != memContextTop())
     {
@@ -1374,7 +1605,9 @@ memContextFreeRecurse(MemContext *const this)
             memContextChildMany(this->contextParent)->list[this->contextParentIdx] = NULL;
         }
 
-        memFreeInternal(this);
+        // Contexts allocated from an arena are freed with the arena
+        if (!this->arena || this->arenaOwner)
+            memFreeInternal(this);
     }
     // Else reset top context. In practice it is uncommon for the top mem context to be freed and then used again.
     else
@@ -38,6 +38,14 @@ Space is reserved for this many allocations when a context is created. When more
 ***********************************************************************************************************************************/
 #define MEM_CONTEXT_ALLOC_INITIAL_SIZE                              4
 
+/***********************************************************************************************************************************
+Define arena block size
+
+Arena contexts allocate memory in blocks of this size. Allocations larger than a quarter of the block size are given their own block
+so they do not waste the remainder of the current block.
+***********************************************************************************************************************************/
+#define MEM_CONTEXT_ARENA_BLOCK_SIZE                                8192
+
 /***********************************************************************************************************************************
 Functions and macros to audit a mem context by detecting new child contexts/allocations that were created begin the begin/end but
 are not the expected return type.
@@ -160,7 +168,7 @@ Note that memory context names are expected to live for the lifetime of the cont
 /***********************************************************************************************************************************
 Create a temporary memory context and make sure it is freed when done (even on error)
 
-MEM_CONTEXT_TEMP_BEGIN()
+MEM_CONTEXT_TEMP_BEGIN(...)
 {
     <A temp memory context is now the current context>
     <Temp context can be accessed with the MEM_CONTEXT_TEMP() macro>
@@ -170,20 +178,23 @@ MEM_CONTEXT_TEMP_END();
 
 <Prior memory context is restored>
 <Temp memory context is freed>
+
+Pass .arena = true to allocate the temp context and everything created in it from an arena (see MemContextNewParam).
 ***********************************************************************************************************************************/
 #define MEM_CONTEXT_TEMP()                                                                                                         \
     MEM_CONTEXT_TEMP_memContext
 
-#define MEM_CONTEXT_TEMP_BEGIN()                                                                                                   \
+#define MEM_CONTEXT_TEMP_BEGIN(...)                                                                                                \
     do                                                                                                                             \
     {                                                                                                                              \
         MemContext *MEM_CONTEXT_TEMP() = memContextNewP(                                                                           \
-            "temporary", .childQty = MEM_CONTEXT_QTY_MAX, .allocQty = MEM_CONTEXT_QTY_MAX);                                        \
+            "temporary", .childQty = MEM_CONTEXT_QTY_MAX, .allocQty = MEM_CONTEXT_QTY_MAX, __VA_ARGS__);                           \
         memContextSwitch(MEM_CONTEXT_TEMP());
 
-#define MEM_CONTEXT_TEMP_RESET_BEGIN()                                                                                             \
-    MEM_CONTEXT_TEMP_BEGIN()                                                                                                       \
-    unsigned int MEM_CONTEXT_TEMP_loopTotal = 0;
+#define MEM_CONTEXT_TEMP_RESET_BEGIN(...)                                                                                          \
+    MEM_CONTEXT_TEMP_BEGIN(__VA_ARGS__)                                                                                            \
+    unsigned int MEM_CONTEXT_TEMP_loopTotal = 0;                                                                                   \
+    const bool MEM_CONTEXT_TEMP_arena = memContextArena(MEM_CONTEXT_TEMP());
 
 #define MEM_CONTEXT_TEMP_RESET(resetTotal)                                                                                         \
     do                                                                                                                             \
@@ -194,7 +205,9 @@ MEM_CONTEXT_TEMP_END();
         {                                                                                                                          \
             memContextSwitchBack();                                                                                                \
             memContextDiscard();                                                                                                   \
-            MEM_CONTEXT_TEMP() = memContextNewP("temporary", .childQty = MEM_CONTEXT_QTY_MAX, .allocQty = MEM_CONTEXT_QTY_MAX);    \
+            MEM_CONTEXT_TEMP() = memContextNewP(                                                                                   \
+                "temporary", .childQty = MEM_CONTEXT_QTY_MAX, .allocQty = MEM_CONTEXT_QTY_MAX,                                     \
+                .arena = MEM_CONTEXT_TEMP_arena);                                                                                  \
             memContextSwitch(MEM_CONTEXT_TEMP());                                                                                  \
             MEM_CONTEXT_TEMP_loopTotal = 0;                                                                                        \
         }                                                                                                                          \
@@ -236,8 +249,15 @@ typedef struct MemContextNewParam
     uint8_t allocQty;                                               // How many allocations can this context have?
     uint8_t callbackQty;                                            // How many callbacks can this context have?
     uint16_t allocExtra;                                            // Extra memory to allocate with the context
+    bool arena;                                                     // Allocate the context and its children from an arena?
 } MemContextNewParam;
 
+// An arena context makes its allocations, child contexts, and their allocations from blocks of memory that are only freed when the
+// arena context is freed. This saves a malloc()/free() for most allocations but memory freed before the arena context is freed is
+// not reused, so arenas are best suited to short-lived contexts, e.g. temp contexts in loops. A context created in an arena context
+// always uses the same arena. A context allocated from an arena must not be moved to a parent outside the arena because the memory
+// will be freed with the arena context. memContextMove() will error if this is attempted.
+
 // Maximum amount of extra memory that can be allocated with the context using allocExtra
 #define MEM_CONTEXT_ALLOC_EXTRA_MAX                                 UINT16_MAX
 
@@ -310,11 +330,27 @@ FN_EXTERN MemContext *memContextPrior(void);
 // place to put long-lived mem contexts since they won't be automatically freed until the program exits.
 FN_EXTERN MemContext *memContextTop(void);
 
+// Does the context allocate from an arena?
+FN_EXTERN bool memContextArena(const MemContext *this);
+
 // Get total size of mem context and all children
 #ifdef DEBUG
 FN_EXTERN size_t memContextSize(const MemContext *this);
 #endif // DEBUG
 
+/***********************************************************************************************************************************
+Memory allocation statistics for the process, e.g. to measure the effect of arena contexts on a command
+***********************************************************************************************************************************/
+typedef struct MemContextStat
+{
+    uint64_t allocTotal;                                            // Calls to malloc()
+    uint64_t reAllocTotal;                                          // Calls to realloc()
+    uint64_t freeTotal;                                             // Calls to free()
+    uint64_t arenaTotal;                                            // Allocations from arena blocks that did not call malloc()
+} MemContextStat;
+
+FN_EXTERN MemContextStat memContextStat(void);
+
 /***********************************************************************************************************************************
 Macros for function logging
 ***********************************************************************************************************************************/
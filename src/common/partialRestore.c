@@ -1,4 +1,7 @@
 #include "build.auto.h"
+
+#include <string.h>
+
 #include "common/type/json.h"
 #include "common/type/list.h"
 #include "config/config.h"
@@ -111,6 +114,117 @@ buildFilterList(JsonRead *const json)
     return lstSort(result, sortOrderAsc);
 }
 
+/***********************************************************************************************************************************
+Relation filter
+
+The filter list is flattened into an open-addressing hash set keyed by (dbOid, spcNode, relNode) so that each lookup during WAL
+filtering is a hash and usually a single probe into one contiguous array, rather than a binary search over the database list
+followed by a binary search over the table list. A database is stored as the key (dbOid, 0, 0), which cannot collide with a table
+since relfilenode 0 is rejected when the filter is parsed. An empty slot has dbOid 0, which is also rejected when parsing.
+***********************************************************************************************************************************/
+typedef struct RelationFilterEntry
+{
+    Oid dbOid;                                                      // Database oid (0 when the slot is empty)
+    Oid spcNode;                                                    // Tablespace oid (0 for a database entry)
+    Oid relNode;                                                    // Relfilenode (0 for a database entry)
+} RelationFilterEntry;
+
+typedef struct RelationFilter
+{
+    unsigned int slotMask;                                          // Total slots - 1 (total slots is a power of two)
+    RelationFilterEntry *slotList;                                  // Slots
+} RelationFilter;
+
+static struct PartialRestoreLocal
+{
+    MemContext *memContext;                                         // Mem context for the relation filter
+    RelationFilter *filter;                                         // Relation filter loaded from the filter file
+} partialRestoreLocal;
+
+// Hash a key using the murmur3 finalizer on a combination of the fields
+static unsigned int
+relationFilterHash(const Oid dbOid, const Oid spcNode, const Oid relNode)
+{
+    uint32_t hash = dbOid * 0x9E3779B1U ^ spcNode * 0x85EBCA77U ^ relNode * 0xC2B2AE3DU;
+
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6BU;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35U;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+// Find the slot for a key, which will either contain the key or be empty
+static RelationFilterEntry *
+relationFilterSlot(const RelationFilter *const this, const Oid dbOid, const Oid spcNode, const Oid relNode)
+{
+    unsigned int slotIdx = relationFilterHash(dbOid, spcNode, relNode) & this->slotMask;
+
+    while (true)
+    {
+        RelationFilterEntry *const slot = &this->slotList[slotIdx];
+
+        if (slot->dbOid == 0 || (slot->dbOid == dbOid && slot->relNode == relNode && slot->spcNode == spcNode))
+            return slot;
+
+        slotIdx = (slotIdx + 1) & this->slotMask;
+    }
+}
+
+static void
+relationFilterAdd(RelationFilter *const this, const Oid dbOid, const Oid spcNode, const Oid relNode)
+{
+    *relationFilterSlot(this, dbOid, spcNode, relNode) = (RelationFilterEntry){
+        .dbOid = dbOid, .spcNode = spcNode, .relNode = relNode};
+}
+
+static bool
+relationFilterExists(const RelationFilter *const this, const Oid dbOid, const Oid spcNode, const Oid relNode)
+{
+    return relationFilterSlot(this, dbOid, spcNode, relNode)->dbOid != 0;
+}
+
+// Build the hash set from the list created by buildFilterList()
+static RelationFilter *
+relationFilterNew(const List *const databaseList)
+{
+    // Count entries
+    unsigned int entryTotal = lstSize(databaseList);
+
+    for (unsigned int dbIdx = 0; dbIdx < lstSize(databaseList); dbIdx++)
+        entryTotal += lstSize(((const DataBase *)lstGet(databaseList, dbIdx))->tables);
+
+    // Size the slot list so the load factor is at most 50%
+    unsigned int slotTotal = 16;
+
+    while (slotTotal < entryTotal * 2)
+        slotTotal *= 2;
+
+    RelationFilter *const this = memNew(sizeof(RelationFilter));
+    *this = (RelationFilter){.slotMask = slotTotal - 1, .slotList = memNew(sizeof(RelationFilterEntry) * slotTotal)};
+
+    memset(this->slotList, 0, sizeof(RelationFilterEntry) * slotTotal);
+
+    // Add databases and tables
+    for (unsigned int dbIdx = 0; dbIdx < lstSize(databaseList); dbIdx++)
+    {
+        const DataBase *const dataBase = lstGet(databaseList, dbIdx);
+
+        relationFilterAdd(this, dataBase->dbOid, 0, 0);
+
+        for (unsigned int tableIdx = 0; tableIdx < lstSize(dataBase->tables); tableIdx++)
+        {
+            const Table *const table = lstGet(dataBase->tables, tableIdx);
+            relationFilterAdd(this, dataBase->dbOid, table->spcNode, table->relNode);
+        }
+    }
+
+    return this;
+}
+
+/**********************************************************************************************************************************/
 FN_EXTERN bool
 isRelationNeeded(const Oid dbNode, const Oid spcNode, const Oid relNode)
 {
@@ -120,8 +234,8 @@ isRelationNeeded(const Oid dbNode, const Oid spcNode, const Oid relNode)
     if (pgDbIsSystemId(dbNode) && pgDbIsSystemId(relNode))
         return true;
 
-    static List *filterList = NULL;
-    if (filterList == NULL)
+    // Load the filter on first use. It is kept in a context under the top context so it is valid for the life of the process.
+    if (partialRestoreLocal.filter == NULL)
     {
         const String *const filter_path = cfgOptionStrNull(cfgOptFilter);
         if (!strBeginsWith(filter_path, FSLASH_STR))
@@ -129,23 +243,28 @@ isRelationNeeded(const Oid dbNode, const Oid spcNode, const Oid relNode)
             THROW(AssertError, "The path to the filter info file is not absolute");
         }
 
-        const Storage *const local_storage = storageLocal();
-        StorageRead *const storageRead = storageNewReadP(local_storage, filter_path);
-        Buffer *const jsonFile = storageGetP(storageRead);
-        JsonRead *const jsonRead = jsonReadNew(strNewBuf(jsonFile));
-
-        filterList = buildFilterList(jsonRead);
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            const Buffer *const jsonFile = storageGetP(storageNewReadP(storageLocal(), filter_path));
+            JsonRead *const jsonRead = jsonReadNew(strNewBuf(jsonFile));
+            const List *const filterList = buildFilterList(jsonRead);
 
-        jsonReadFree(jsonRead);
-        bufFree(jsonFile);
-        storageReadFree(storageRead);
+            MEM_CONTEXT_BEGIN(memContextTop())
+            {
+                MEM_CONTEXT_NEW_BEGIN(PartialRestore, .allocQty = MEM_CONTEXT_QTY_MAX)
+                {
+                    partialRestoreLocal.memContext = MEM_CONTEXT_NEW();
+                    partialRestoreLocal.filter = relationFilterNew(filterList);
+                }
+                MEM_CONTEXT_NEW_END();
+            }
+            MEM_CONTEXT_END();
+        }
+        MEM_CONTEXT_TEMP_END();
     }
 
-    const DataBase *const db = lstFind(filterList, &dbNode);
-    if (db == NULL)
+    if (!relationFilterExists(partialRestoreLocal.filter, dbNode, 0, 0))
         return false;
 
-    return
-        pgDbIsSystemId(relNode) ||
-        lstExists(db->tables, &(Table){.spcNode = spcNode, .relNode = relNode});
+    return pgDbIsSystemId(relNode) || relationFilterExists(partialRestoreLocal.filter, dbNode, spcNode, relNode);
 }
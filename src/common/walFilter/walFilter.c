@@ -6,6 +6,7 @@
 #include "common/log.h"
 #include "common/type/object.h"
 
+#include "command/archive/common.h"
 #include "common/compress/helper.h"
 #include "common/partialRestore.h"
 #include "config/config.h"
@@ -69,8 +70,13 @@ typedef struct WalFilter
 
     XLogPageHeaderData *currentPageHeader;
 
-    XLogRecord *record;
+    // Current record. Points into the input page when the record fits on a single page, otherwise to recordBuf.
+    const XLogRecord *record;
+    XLogRecord *recordBuf;
     uint32_t recBufSize;
+    // Start of the current record (including the page header written before it) in the input buffer. NULL if the record was
+    // not read entirely from the current input buffer and so cannot be forwarded as is.
+    const unsigned char *recordBegin;
     // Size of header of the current record on the current page
     size_t headerSize;
     // How many bytes we read from this record
@@ -92,6 +98,24 @@ typedef struct WalFilter
     bool isSwitchWal;
 } WalFilterState;
 
+/***********************************************************************************************************************************
+Incomplete record at the end of the last segment filtered by this process. When consecutive segments are filtered by the same
+process the beginning of the record continued in the next segment is restored from here instead of reading the whole previous
+segment from the repository again.
+***********************************************************************************************************************************/
+static struct WalFilterLocal
+{
+    MemContext *memContext;                                         // Mem context for the tail
+    unsigned int repoIdx;                                           // Repository the segment was read from
+    String *file;                                                   // Repository path of the segment
+    uint64_t segno;                                                 // Segment number, only checked when the file is a bundle
+    ReadStep step;                                                  // Step the record read was interrupted at
+    size_t gotLen;                                                  // Bytes of the record in the segment
+    size_t totLen;                                                  // Record size on the last page of the segment
+    size_t headerSize;                                              // Size of record header on the last page of the segment
+    Buffer *record;                                                 // Beginning of the record
+} walFilterLocal;
+
 /***********************************************************************************************************************************
 Render as string for logging
 ***********************************************************************************************************************************/
@@ -136,6 +160,7 @@ getNextPage(WalFilterState *const this, const Buffer *const input)
         ASSERT(this->currentStep != noStep);
         this->inputOffset = 0;
         this->inputSame = false;
+        this->recordBegin = NULL;
         return false;
     }
 
@@ -210,106 +235,128 @@ stepBeginOfRecord:
     }
 
     // Record header can be split between pages but first field xl_tot_len is always on single page
-    uint32_t record_size = getRecordSize(((unsigned char *) this->currentPageHeader) + this->pageOffset);
+    const unsigned char *const recordData = ((unsigned char *) this->currentPageHeader) + this->pageOffset;
+    uint32_t record_size = getRecordSize(recordData);
 
-    if (this->recBufSize < record_size)
-    {
-        MEM_CONTEXT_OBJ_BEGIN(this)
-        {
-            this->record = memResize(this->record, record_size);
-        }
-        MEM_CONTEXT_OBJ_END();
-        this->recBufSize = record_size;
-    }
+    // The output mirrors the input, so the position of recPtr on the page is where this record starts in the input page
+    this->recordBegin = ((const unsigned char *) this->currentPageHeader) + this->recPtr % this->walPageSize;
 
-    memcpy(
-        this->record,
-        ((unsigned char *) this->currentPageHeader) + this->pageOffset,
-        Min(SizeOfXLogRecord, this->walPageSize - this->pageOffset));
+    // If the whole record is on this page then validate it in place without copying it
+    if (record_size >= SizeOfXLogRecord && record_size <= this->walPageSize - this->pageOffset)
+    {
+        this->record = (const XLogRecord *) recordData;
+        this->totLen = record_size;
+        this->headerSize = SizeOfXLogRecord;
 
-    this->totLen = this->record->xl_tot_len;
+        this->walInterface->validXLogRecordHeader(this->record, this->heapPageSize);
+        this->gotLen = record_size;
 
-    // If header is split read rest of the header from next page
-    if (SizeOfXLogRecord > this->walPageSize - this->pageOffset)
+        // Move pointer to the next record on the page
+        this->pageOffset += MAXALIGN(this->totLen);
+    }
+    else
     {
-        this->gotLen = this->walPageSize - this->pageOffset;
-        this->currentStep = stepReadHeader;
-stepReadHeader:
-        if (!getNextPage(this, input))
+        if (this->recBufSize < record_size)
         {
-            return ReadRecordNeedBuffer;
+            MEM_CONTEXT_OBJ_BEGIN(this)
+            {
+                this->recordBuf = memResize(this->recordBuf, record_size);
+            }
+            MEM_CONTEXT_OBJ_END();
+            this->recBufSize = record_size;
         }
 
-        if (this->currentPageHeader->xlp_info & XLP_FIRST_IS_OVERWRITE_CONTRECORD)
+        this->record = this->recordBuf;
+
+        memcpy(this->recordBuf, recordData, Min(SizeOfXLogRecord, this->walPageSize - this->pageOffset));
+
+        this->totLen = this->record->xl_tot_len;
+
+        // If header is split read rest of the header from next page
+        if (SizeOfXLogRecord > this->walPageSize - this->pageOffset)
         {
-            // This record has been overwritten.
-            // Write to the output what we managed to read as is, skipping filtering.
-            return ReadRecordSuccess;
-        }
+            this->gotLen = this->walPageSize - this->pageOffset;
+            this->currentStep = stepReadHeader;
+stepReadHeader:
+            if (!getNextPage(this, input))
+            {
+                return ReadRecordNeedBuffer;
+            }
+
+            if (this->currentPageHeader->xlp_info & XLP_FIRST_IS_OVERWRITE_CONTRECORD)
+            {
+                // This record has been overwritten.
+                // Write to the output what we managed to read as is, skipping filtering.
+                return ReadRecordSuccess;
+            }
+
+            if (!(this->currentPageHeader->xlp_info & XLP_FIRST_IS_CONTRECORD))
+            {
+                THROW_FMT(FormatError, "%s - should be XLP_FIRST_IS_CONTRECORD", strZ(pgLsnToStr(this->recPtr)));
+            }
 
-        if (!(this->currentPageHeader->xlp_info & XLP_FIRST_IS_CONTRECORD))
+            memcpy(
+                ((char *) this->recordBuf) + this->gotLen,
+                ((unsigned char *) this->currentPageHeader) + this->pageOffset,
+                SizeOfXLogRecord - this->gotLen);
+            this->totLen -= this->gotLen;
+            this->headerSize = SizeOfXLogRecord - this->gotLen;
+        }
+        else
         {
-            THROW_FMT(FormatError, "%s - should be XLP_FIRST_IS_CONTRECORD", strZ(pgLsnToStr(this->recPtr)));
+            this->headerSize = SizeOfXLogRecord;
         }
+        this->gotLen = SizeOfXLogRecord;
 
+        this->walInterface->validXLogRecordHeader(this->record, this->heapPageSize);
+        // Read rest of the record on this page
+        size_t toRead = Min(
+            this->record->xl_tot_len - SizeOfXLogRecord, this->walPageSize - this->pageOffset - SizeOfXLogRecord);
         memcpy(
-            ((char *) this->record) + this->gotLen,
-            ((unsigned char *) this->currentPageHeader) + this->pageOffset,
-            SizeOfXLogRecord - this->gotLen);
-        this->totLen -= this->gotLen;
-        this->headerSize = SizeOfXLogRecord - this->gotLen;
-    }
-    else
-    {
-        this->headerSize = SizeOfXLogRecord;
-    }
-    this->gotLen = SizeOfXLogRecord;
+            (void *) XLogRecGetData(this->recordBuf),
+            ((unsigned char *) this->currentPageHeader) + this->pageOffset + this->headerSize,
+            toRead);
+        this->gotLen += toRead;
 
-    this->walInterface->validXLogRecordHeader(this->record, this->heapPageSize);
-    // Read rest of the record on this page
-    size_t toRead = Min(this->record->xl_tot_len - SizeOfXLogRecord, this->walPageSize - this->pageOffset - SizeOfXLogRecord);
-    memcpy(
-        (void *) XLogRecGetData(this->record),
-        ((unsigned char *) this->currentPageHeader) + this->pageOffset + this->headerSize,
-        toRead);
-    this->gotLen += toRead;
+        // Move pointer to the next record on the page
+        this->pageOffset += MAXALIGN(this->totLen);
 
-    // Move pointer to the next record on the page
-    this->pageOffset += MAXALIGN(this->totLen);
-
-    // Rest of the record data is on the next page
-    while (this->gotLen != this->record->xl_tot_len)
-    {
-        this->currentStep = stepReadBody;
-stepReadBody:
-        if (!getNextPage(this, input))
+        // Rest of the record data is on the next page
+        while (this->gotLen != this->record->xl_tot_len)
         {
-            return ReadRecordNeedBuffer;
-        }
+            this->currentStep = stepReadBody;
+stepReadBody:
+            if (!getNextPage(this, input))
+            {
+                return ReadRecordNeedBuffer;
+            }
 
-        if (this->currentPageHeader->xlp_info & XLP_FIRST_IS_OVERWRITE_CONTRECORD)
-        {
-            // This record has been overwritten.
-            // Write to the output what we managed to read as is, skipping filtering.
-            return ReadRecordSuccess;
-        }
+            if (this->currentPageHeader->xlp_info & XLP_FIRST_IS_OVERWRITE_CONTRECORD)
+            {
+                // This record has been overwritten.
+                // Write to the output what we managed to read as is, skipping filtering.
+                return ReadRecordSuccess;
+            }
 
-        if (!(this->currentPageHeader->xlp_info & XLP_FIRST_IS_CONTRECORD))
-        {
-            THROW_FMT(FormatError, "%s - should be XLP_FIRST_IS_CONTRECORD", strZ(pgLsnToStr(this->recPtr)));
-        }
+            if (!(this->currentPageHeader->xlp_info & XLP_FIRST_IS_CONTRECORD))
+            {
+                THROW_FMT(FormatError, "%s - should be XLP_FIRST_IS_CONTRECORD", strZ(pgLsnToStr(this->recPtr)));
+            }
 
-        if (this->currentPageHeader->xlp_rem_len == 0 ||
-            this->totLen != (this->currentPageHeader->xlp_rem_len + this->gotLen))
-        {
-            THROW_FMT(FormatError, "%s - invalid contrecord length: expect: %zu, get %u", strZ(pgLsnToStr(this->recPtr)),
-                      this->record->xl_tot_len - this->gotLen, this->currentPageHeader->xlp_rem_len);
-        }
+            if (this->currentPageHeader->xlp_rem_len == 0 ||
+                this->totLen != (this->currentPageHeader->xlp_rem_len + this->gotLen))
+            {
+                THROW_FMT(FormatError, "%s - invalid contrecord length: expect: %zu, get %u", strZ(pgLsnToStr(this->recPtr)),
+                          this->record->xl_tot_len - this->gotLen, this->currentPageHeader->xlp_rem_len);
+            }
 
-        size_t to_write = Min(this->currentPageHeader->xlp_rem_len, this->walPageSize - this->pageOffset);
-        memcpy(((char *) this->record) + this->gotLen, ((unsigned char *) this->currentPageHeader) + this->pageOffset, to_write);
-        this->pageOffset += MAXALIGN(to_write);
-        this->gotLen += to_write;
+            size_t to_write = Min(this->currentPageHeader->xlp_rem_len, this->walPageSize - this->pageOffset);
+            memcpy(
+                ((char *) this->recordBuf) + this->gotLen, ((unsigned char *) this->currentPageHeader) + this->pageOffset,
+                to_write);
+            this->pageOffset += MAXALIGN(to_write);
+            this->gotLen += to_write;
+        }
     }
     this->walInterface->validXLogRecord(this->record, this->heapPageSize);
 
@@ -321,31 +368,44 @@ stepReadBody:
     return ReadRecordSuccess;
 }
 
-static void
+// Returns true if the record was rewritten to XLOG_NOOP. In this case the record is always materialized in recordBuf.
+static bool
 filterRecord(WalFilterState *const this)
 {
     const RelFileNode *const node = getRelFileNodeGPDB6(this->record);
     if (!node)
     {
-        return;
+        return false;
     }
 
-    bool isPassTheFilter;
-
-    // isRelationNeeded can allocate memory on the first call. Therefore, we switch the context.
-    MEM_CONTEXT_OBJ_BEGIN(this)
-    isPassTheFilter = isRelationNeeded(node->dbNode, node->spcNode, node->relNode);
-    MEM_CONTEXT_OBJ_END();
+    if (isRelationNeeded(node->dbNode, node->spcNode, node->relNode))
+    {
+        return false;
+    }
 
-    if (isPassTheFilter)
+    // The record was validated in place on the input page, so copy it before modifying
+    if (this->record != this->recordBuf)
     {
-        return;
+        if (this->recBufSize < this->record->xl_tot_len)
+        {
+            MEM_CONTEXT_OBJ_BEGIN(this)
+            {
+                this->recordBuf = memResize(this->recordBuf, this->record->xl_tot_len);
+            }
+            MEM_CONTEXT_OBJ_END();
+            this->recBufSize = this->record->xl_tot_len;
+        }
+
+        memcpy(this->recordBuf, this->record, this->record->xl_tot_len);
+        this->record = this->recordBuf;
     }
 
-    this->record->xl_rmid = RM_XLOG_ID;
+    this->recordBuf->xl_rmid = RM_XLOG_ID;
     // Save 4 least significant bits which represent backup blocks flags.
-    this->record->xl_info = (uint8_t) (XLOG_NOOP | (this->record->xl_info & XLR_INFO_MASK));
-    this->record->xl_crc = this->walInterface->xLogRecordChecksum(this->record, this->heapPageSize);
+    this->recordBuf->xl_info = (uint8_t) (XLOG_NOOP | (this->recordBuf->xl_info & XLR_INFO_MASK));
+    this->recordBuf->xl_crc = this->walInterface->xLogRecordChecksum(this->recordBuf, this->heapPageSize);
+
+    return true;
 }
 
 static void
@@ -394,26 +454,38 @@ writeRecord(WalFilterState *const this, Buffer *const output, const unsigned cha
     this->gotLen = 0;
 }
 
-static const StorageRead *
-getNearWal (WalFilterState *const this, bool isNext)
+// Write a record that passed the filter unchanged by forwarding the range it occupies in the input buffer, page headers included.
+// Only the alignment padding is written separately since it is not guaranteed to be zeroed in the input.
+static void
+writeRecordInput(WalFilterState *const this, Buffer *const output)
 {
-    const String *walSegment = NULL;
-    const TimeLineID timeLine = this->currentPageHeader->xlp_tli;
-    uint64_t segno = this->currentPageHeader->xlp_pageaddr / this->segSize;
-    const String *const path = strNewFmt("%08X%08X", timeLine, (uint32) (segno / XLogSegmentsPerXLogId(this->segSize)));
+    ASSERT(this->recordBegin != NULL);
 
-    const StringList *const segmentList = storageListP(
-        storageRepoIdx(this->archiveInfo->repoIdx),
-        strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(this->archiveInfo->archiveId), strZ(path)),
-        .expression = strNewFmt("^[0-f]{24}-[0-f]{40}" COMPRESS_TYPE_REGEXP "{0,1}$"));
+    const unsigned char *const recordEnd = ((const unsigned char *) this->currentPageHeader) + this->pageOffset;
+    const size_t alignSize = MAXALIGN(this->gotLen) - this->gotLen;
+    const size_t size = (size_t) (recordEnd - this->recordBegin);
 
-    if (strLstEmpty(segmentList))
-    {
-        // an exotic case where we couldn't even find the current file.
-        THROW(FormatError, "no WAL files were found in the repository");
-    }
+    ASSERT(size >= alignSize);
 
+    checkOutputSize(output, size);
+    memcpy(bufRemainsPtr(output), this->recordBegin, size - alignSize);
+    memset(bufRemainsPtr(output) + size - alignSize, 0, alignSize);
+    bufUsedInc(output, size);
+
+    this->recPtr += size;
+    this->gotLen = 0;
+}
+
+// Find the nearest previous/next segment in a list of segment files. Returns NULL if the current segment is the oldest/newest. The
+// segment number found is returned in foundSegNo since it cannot be determined from the file name when the file is a bundle.
+static const String *
+getNearWalFind(
+    const WalFilterState *const this, const StringList *const segmentList, const uint64_t segno, const bool isNext,
+    uint64_t *const foundSegNo)
+{
+    const String *walSegment = NULL;
     uint64_t segnoDiff = UINT64_MAX;
+
     for (uint32_t i = 0; i < strLstSize(segmentList); i++)
     {
         const String *const file = strSubN(strLstGet(segmentList, i), 0, 24);
@@ -421,12 +493,25 @@ getNearWal (WalFilterState *const this, bool isNext)
         uint64_t fileSegNo = 0;
         XLogFromFileName(strZ(file), &tli, &fileSegNo, this->segSize);
 
+        // A bundle contains a range of segments so use the segment in the range that is nearest to the current segment
+        if (walIsBundle(strLstGet(segmentList, i)))
+        {
+            uint64_t fileSegNoLast = 0;
+            XLogFromFileName(strZ(walArchiveFileStop(strLstGet(segmentList, i))), &tli, &fileSegNoLast, this->segSize);
+
+            if (isNext && fileSegNo <= segno && segno < fileSegNoLast)
+                fileSegNo = segno + 1;
+            else if (!isNext && fileSegNo < segno)
+                fileSegNo = fileSegNoLast < segno ? fileSegNoLast : segno - 1;
+        }
+
         if (isNext)
         {
             if (fileSegNo - segno < segnoDiff && fileSegNo > segno)
             {
                 segnoDiff = fileSegNo - segno;
                 walSegment = strLstGet(segmentList, i);
+                *foundSegNo = fileSegNo;
             }
         }
         else
@@ -435,42 +520,191 @@ getNearWal (WalFilterState *const this, bool isNext)
             {
                 segnoDiff = segno - fileSegNo;
                 walSegment = strLstGet(segmentList, i);
+                *foundSegNo = fileSegNo;
             }
         }
     }
 
+    return walSegment;
+}
+
+// Find the repository path of the nearest previous/next segment. Returns NULL if the current segment is the oldest/newest.
+static const String *
+getNearWalFile(WalFilterState *const this, const bool isNext, const bool refresh, uint64_t *const foundSegNo)
+{
+    const TimeLineID timeLine = this->currentPageHeader->xlp_tli;
+    uint64_t segno = this->currentPageHeader->xlp_pageaddr / this->segSize;
+    const String *const path = strNewFmt("%08X%08X", timeLine, (uint32) (segno / XLogSegmentsPerXLogId(this->segSize)));
+
+    // The path is listed once per process. If the segment is not found then list again in case it was archived after the path was
+    // listed.
+    const StringList *segmentList = archiveSegmentList(this->archiveInfo->repoIdx, this->archiveInfo->archiveId, path, refresh);
+    const String *walSegment = getNearWalFind(this, segmentList, segno, isNext, foundSegNo);
+
+    if (walSegment == NULL && !refresh)
+    {
+        segmentList = archiveSegmentList(this->archiveInfo->repoIdx, this->archiveInfo->archiveId, path, true);
+        walSegment = getNearWalFind(this, segmentList, segno, isNext, foundSegNo);
+    }
+
+    if (strLstEmpty(segmentList))
+    {
+        // an exotic case where we couldn't even find the current file.
+        THROW(FormatError, "no WAL files were found in the repository");
+    }
+
     // current file is oldest/newest
-    if (segnoDiff == UINT64_MAX)
+    if (walSegment == NULL)
     {
         return NULL;
     }
 
+    return strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s/%s", strZ(this->archiveInfo->archiveId), strZ(path), strZ(walSegment));
+}
+
+// Open the segment found by getNearWalFile(), which may be stored in a bundle
+static StorageRead *
+getNearWalOpen(const WalFilterState *const this, const String *const walFile, const uint64_t segno, const bool ignoreMissing)
+{
     const bool compressible =
         this->archiveInfo->cipherType == cipherTypeNone && compressTypeFromName(this->archiveInfo->file) == compressTypeNone;
+    const String *const walSegment = strNewFmt(
+        "%08X%08X%08X", this->currentPageHeader->xlp_tli, (uint32) (segno / XLogSegmentsPerXLogId(this->segSize)),
+        (uint32) (segno % XLogSegmentsPerXLogId(this->segSize)));
+
+    StorageRead *const storageRead = walSegmentReadNew(
+        storageRepoIdx(this->archiveInfo->repoIdx), walFile, walSegment, compressible, ignoreMissing);
 
-    const StorageRead *const storageRead = storageNewReadP(
-        storageRepoIdx(this->archiveInfo->repoIdx),
-        strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(this->archiveInfo->archiveId), strZ(walSegment)),
-        .compressible = compressible);
+    if (storageRead != NULL)
+        buildArchiveGetPipeLine(ioReadFilterGroup(storageReadIo(storageRead)), this->archiveInfo);
 
-    buildArchiveGetPipeLine(ioReadFilterGroup(storageReadIo(storageRead)), this->archiveInfo);
     return storageRead;
 }
 
+// Open the nearest previous/next segment found by getNearWalFile(). Returns NULL if there is no such segment.
+static const StorageRead *
+getNearWal(WalFilterState *const this, const bool isNext, const String *walFile, uint64_t segno)
+{
+    StorageRead *storageRead = getNearWalOpen(this, walFile, segno, true);
+
+    // The segment was removed after the path was listed so list the path again
+    if (storageRead == NULL || !ioReadOpen(storageReadIo(storageRead)))
+    {
+        walFile = getNearWalFile(this, isNext, true, &segno);
+
+        if (walFile == NULL)
+        {
+            return NULL;
+        }
+
+        storageRead = getNearWalOpen(this, walFile, segno, false);
+        ioReadOpen(storageReadIo(storageRead));
+    }
+
+    return storageRead;
+}
+
+// Remember the incomplete record at the end of the segment being filtered so it does not need to be read again when the next
+// segment is filtered by this process.
+static void
+walFilterTailSave(const WalFilterState *const this)
+{
+    if (this->archiveInfo == NULL || (this->currentStep != stepReadHeader && this->currentStep != stepReadBody))
+    {
+        return;
+    }
+
+    if (walFilterLocal.memContext == NULL)
+    {
+        MEM_CONTEXT_BEGIN(memContextTop())
+        {
+            MEM_CONTEXT_NEW_BEGIN(WalFilterLocal, .childQty = MEM_CONTEXT_QTY_MAX, .allocQty = MEM_CONTEXT_QTY_MAX)
+            {
+                walFilterLocal.memContext = MEM_CONTEXT_NEW();
+                walFilterLocal.record = bufNew(this->gotLen);
+            }
+            MEM_CONTEXT_NEW_END();
+        }
+        MEM_CONTEXT_END();
+    }
+
+    MEM_CONTEXT_BEGIN(walFilterLocal.memContext)
+    {
+        strFree(walFilterLocal.file);
+        walFilterLocal.file = strNewFmt(STORAGE_REPO_ARCHIVE "/%s", strZ(this->archiveInfo->file));
+    }
+    MEM_CONTEXT_END();
+
+    walFilterLocal.repoIdx = this->archiveInfo->repoIdx;
+    walFilterLocal.segno = this->currentPageHeader->xlp_pageaddr / this->segSize;
+    walFilterLocal.step = this->currentStep;
+    walFilterLocal.gotLen = this->gotLen;
+    walFilterLocal.totLen = this->totLen;
+    walFilterLocal.headerSize = this->headerSize;
+
+    bufUsedZero(walFilterLocal.record);
+    bufCatC(walFilterLocal.record, (const unsigned char *) this->recordBuf, 0, this->gotLen);
+}
+
+// Restore the incomplete record saved by walFilterTailSave() if it was saved for the specified file. Returns true on success.
+static bool
+walFilterTailRestore(WalFilterState *const this, const String *const walFile, const uint64_t segno)
+{
+    if (walFilterLocal.file == NULL || walFilterLocal.repoIdx != this->archiveInfo->repoIdx ||
+        !strEq(walFilterLocal.file, walFile) || (walIsBundle(strBase(walFile)) && walFilterLocal.segno != segno))
+    {
+        return false;
+    }
+
+    const uint32_t recordSize = getRecordSize(bufPtrConst(walFilterLocal.record));
+
+    if (this->recBufSize < recordSize)
+    {
+        MEM_CONTEXT_OBJ_BEGIN(this)
+        {
+            this->recordBuf = memResize(this->recordBuf, recordSize);
+        }
+        MEM_CONTEXT_OBJ_END();
+        this->recBufSize = recordSize;
+    }
+
+    memcpy(this->recordBuf, bufPtrConst(walFilterLocal.record), bufUsed(walFilterLocal.record));
+    this->record = this->recordBuf;
+    this->currentStep = walFilterLocal.step;
+    this->gotLen = walFilterLocal.gotLen;
+    this->totLen = walFilterLocal.totLen;
+    this->headerSize = walFilterLocal.headerSize;
+
+    return true;
+}
+
 static bool
 readBeginOfRecord(WalFilterState *const this)
 {
     bool result = false;
     MEM_CONTEXT_TEMP_BEGIN();
 
-    const StorageRead *const storageRead = getNearWal(this, false);
+    uint64_t segno = 0;
+    const String *const walFile = getNearWalFile(this, false, false, &segno);
 
-    if (storageRead == NULL)
+    if (walFile == NULL)
+    {
+        goto end;
+    }
+
+    // The previous segment was filtered by this process so its incomplete record is already known
+    if (walFilterTailRestore(this, walFile, segno))
     {
+        result = this->gotLen < offsetof(XLogRecord, xl_rmid) + SIZE_OF_STRUCT_MEMBER(XLogRecord, xl_rmid);
         goto end;
     }
 
-    ioReadOpen(storageReadIo(storageRead));
+    const StorageRead *const storageRead = getNearWal(this, false, walFile, segno);
+
+    if (storageRead == NULL)
+    {
+        goto end;
+    }
     this->isBegin = true;
     this->inputOffset = 0;
     this->pageOffset = 0;
@@ -503,15 +737,15 @@ getEndOfRecord(WalFilterState *const this)
 {
     MEM_CONTEXT_TEMP_BEGIN();
 
-    const StorageRead *const storageRead = getNearWal(this, true);
+    uint64_t segno = 0;
+    const String *const walFile = getNearWalFile(this, true, false, &segno);
+    const StorageRead *const storageRead = walFile != NULL ? getNearWal(this, true, walFile, segno) : NULL;
 
     if (storageRead == NULL)
     {
         THROW_FMT(FormatError, "The file with the end of the %s record is missing", strZ(pgLsnToStr(this->recPtr)));
     }
 
-    ioReadOpen(storageReadIo(storageRead));
-
     Buffer *const buffer = bufNew(this->walPageSize);
     size_t size = ioRead(storageReadIo(storageRead), buffer);
     bufUsedSet(buffer, size);
@@ -555,6 +789,8 @@ walFilterProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
         {
             const size_t size_on_page = this->gotLen;
 
+            walFilterTailSave(this);
+
             // if xl_info and xl_rmid of the header is in current file then read end of record from next file if it exits
             if (this->gotLen >= offsetof(XLogRecord, xl_rmid) + SIZE_OF_STRUCT_MEMBER(XLogRecord, xl_rmid))
             {
@@ -641,12 +877,17 @@ walFilterProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
     if (readRecord(this, input) == ReadRecordSuccess)
     {
         // In the case of overwrite contrecord, we do not need to try to filter it, since the record may not have a body at all.
-        if (this->gotLen == this->record->xl_tot_len)
+        const bool complete = this->gotLen == this->record->xl_tot_len;
+
+        // Records that pass the filter unchanged are forwarded directly from the input buffer when they were read from it entirely
+        if (complete && !filterRecord(this) && this->recordBegin != NULL)
         {
-            filterRecord(this);
+            writeRecordInput(this, output);
+        }
+        else
+        {
+            writeRecord(this, output, (const unsigned char *) this->record);
         }
-
-        writeRecord(this, output, (const unsigned char *) this->record);
 
         this->inputSame = true;
         lstClearFast(this->pageHeaders);
@@ -689,7 +930,7 @@ walFilterNew(const PgControl pgControl, const ArchiveGetFile *const archiveInfo)
     {
         *this = (WalFilterState){
             .isBegin = true,
-            .record = memNew(pgControl.pageSize),
+            .recordBuf = memNew(pgControl.pageSize),
             .recBufSize = pgControl.pageSize,
             .pageHeaders = lstNewP(SizeOfXLogLongPHD),
             .archiveInfo = archiveInfo,
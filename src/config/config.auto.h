@@ -53,7 +53,12 @@ Option constants
 #define CFGOPT_ARCHIVE_MISSING_RETRY                                "archive-missing-retry"
 #define CFGOPT_ARCHIVE_MODE                                         "archive-mode"
 #define CFGOPT_ARCHIVE_MODE_CHECK                                   "archive-mode-check"
+#define CFGOPT_ARCHIVE_PUSH_BUNDLE                                  "archive-push-bundle"
+#define CFGOPT_ARCHIVE_PUSH_BUNDLE_MAX                              "archive-push-bundle-max"
+#define CFGOPT_ARCHIVE_PUSH_BUNDLE_SIZE                             "archive-push-bundle-size"
 #define CFGOPT_ARCHIVE_PUSH_QUEUE_MAX                               "archive-push-queue-max"
+#define CFGOPT_ARCHIVE_PUSH_SINGLE_PASS                             "archive-push-single-pass"
+#define CFGOPT_ARCHIVE_PUSH_WATCH                                   "archive-push-watch"
 #define CFGOPT_ARCHIVE_TIMEOUT                                      "archive-timeout"
 #define CFGOPT_BACKUP_STANDBY                                       "backup-standby"
 #define CFGOPT_BETA                                                 "beta"
@@ -65,6 +70,7 @@ Option constants
 #define CFGOPT_COMPRESS                                             "compress"
 #define CFGOPT_COMPRESS_LEVEL                                       "compress-level"
 #define CFGOPT_COMPRESS_LEVEL_NETWORK                               "compress-level-network"
+#define CFGOPT_COMPRESS_THREAD_MAX                                  "compress-thread-max"
 #define CFGOPT_COMPRESS_TYPE                                        "compress-type"
 #define CFGOPT_CONFIG                                               "config"
 #define CFGOPT_CONFIG_INCLUDE_PATH                                  "config-include-path"
@@ -81,7 +87,9 @@ Option constants
 #define CFGOPT_FORCE                                                "force"
 #define CFGOPT_FORK                                                 "fork"
 #define CFGOPT_IGNORE_MISSING                                       "ignore-missing"
+#define CFGOPT_IO_DIRECT                                            "io-direct"
 #define CFGOPT_IO_TIMEOUT                                           "io-timeout"
+#define CFGOPT_IO_URING                                             "io-uring"
 #define CFGOPT_JOB_RETRY                                            "job-retry"
 #define CFGOPT_JOB_RETRY_INTERVAL                                   "job-retry-interval"
 #define CFGOPT_LINK_ALL                                             "link-all"
@@ -119,6 +127,7 @@ Option constants
 #define CFGOPT_STANZA                                               "stanza"
 #define CFGOPT_START_FAST                                           "start-fast"
 #define CFGOPT_STOP_AUTO                                            "stop-auto"
+#define CFGOPT_SYNC_DEFER                                           "sync-defer"
 #define CFGOPT_TABLESPACE_MAP                                       "tablespace-map"
 #define CFGOPT_TABLESPACE_MAP_ALL                                   "tablespace-map-all"
 #define CFGOPT_TARGET                                               "target"
@@ -134,10 +143,11 @@ Option constants
 #define CFGOPT_TLS_SERVER_CERT_FILE                                 "tls-server-cert-file"
 #define CFGOPT_TLS_SERVER_KEY_FILE                                  "tls-server-key-file"
 #define CFGOPT_TLS_SERVER_PORT                                      "tls-server-port"
+#define CFGOPT_TLS_SERVER_WORKER                                    "tls-server-worker"
 #define CFGOPT_TYPE                                                 "type"
 #define CFGOPT_VERBOSE                                              "verbose"
 
-#define CFG_OPTION_TOTAL                                            181
+#define CFG_OPTION_TOTAL                                            195
 
 /***********************************************************************************************************************************
 Option value constants
@@ -399,7 +409,12 @@ typedef enum
     cfgOptArchiveMissingRetry,
     cfgOptArchiveMode,
     cfgOptArchiveModeCheck,
+    cfgOptArchivePushBundle,
+    cfgOptArchivePushBundleMax,
+    cfgOptArchivePushBundleSize,
     cfgOptArchivePushQueueMax,
+    cfgOptArchivePushSinglePass,
+    cfgOptArchivePushWatch,
     cfgOptArchiveTimeout,
     cfgOptBackupStandby,
     cfgOptBeta,
@@ -411,6 +426,7 @@ typedef enum
     cfgOptCompress,
     cfgOptCompressLevel,
     cfgOptCompressLevelNetwork,
+    cfgOptCompressThreadMax,
     cfgOptCompressType,
     cfgOptConfig,
     cfgOptConfigIncludePath,
@@ -427,7 +443,9 @@ typedef enum
     cfgOptForce,
     cfgOptFork,
     cfgOptIgnoreMissing,
+    cfgOptIoDirect,
     cfgOptIoTimeout,
+    cfgOptIoUring,
     cfgOptJobRetry,
     cfgOptJobRetryInterval,
     cfgOptLinkAll,
@@ -488,6 +506,7 @@ typedef enum
     cfgOptRepoBundle,
     cfgOptRepoBundleLimit,
     cfgOptRepoBundleSize,
+    cfgOptRepoChecksumXxh3,
     cfgOptRepoCipherPass,
     cfgOptRepoCipherType,
     cfgOptRepoGcsBucket,
@@ -538,9 +557,12 @@ typedef enum
     cfgOptRepoSftpPublicKeyFile,
     cfgOptRepoStorageCaFile,
     cfgOptRepoStorageCaPath,
+    cfgOptRepoStorageDownloadChunkMax,
+    cfgOptRepoStorageDownloadChunkSize,
     cfgOptRepoStorageHost,
     cfgOptRepoStoragePort,
     cfgOptRepoStorageTag,
+    cfgOptRepoStorageUploadChunkMax,
     cfgOptRepoStorageUploadChunkSize,
     cfgOptRepoStorageVerifyTls,
     cfgOptRepoType,
@@ -554,6 +576,7 @@ typedef enum
     cfgOptStanza,
     cfgOptStartFast,
     cfgOptStopAuto,
+    cfgOptSyncDefer,
     cfgOptTablespaceMap,
     cfgOptTablespaceMapAll,
     cfgOptTarget,
@@ -569,6 +592,7 @@ typedef enum
     cfgOptTlsServerCertFile,
     cfgOptTlsServerKeyFile,
     cfgOptTlsServerPort,
+    cfgOptTlsServerWorker,
     cfgOptType,
     cfgOptVerbose,
 } ConfigOption;
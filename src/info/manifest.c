@@ -8,6 +8,7 @@ Backup Manifest Handler
 #include <time.h>
 
 #include "common/crypto/cipherBlock.h"
+#include "common/crypto/xxhash.h"
 #include "common/debug.h"
 #include "common/log.h"
 #include "common/regExp.h"
@@ -99,6 +100,8 @@ typedef enum
 {
     manifestFilePackFlagChecksum,
     manifestFilePackFlagChecksumRepo,
+    manifestFilePackFlagChecksumXxh3,
+    manifestFilePackFlagChecksumRepoXxh3,
     manifestFilePackFlagReference,
     manifestFilePackFlagBundle,
     manifestFilePackFlagBlockIncr,
@@ -141,6 +144,12 @@ manifestFilePack(const Manifest *const manifest, const ManifestFile *const file)
     if (file->checksumRepoSha1 != NULL)
         flag |= 1 << manifestFilePackFlagChecksumRepo;
 
+    if (file->checksumXxh3 != NULL)
+        flag |= 1 << manifestFilePackFlagChecksumXxh3;
+
+    if (file->checksumRepoXxh3 != NULL)
+        flag |= 1 << manifestFilePackFlagChecksumRepoXxh3;
+
     if (file->copy)
         flag |= 1 << manifestFilePackFlagCopy;
 
@@ -222,6 +231,20 @@ manifestFilePack(const Manifest *const manifest, const ManifestFile *const file)
         bufferPos += HASH_TYPE_SHA1_SIZE;
     }
 
+    // xxh3 checksum
+    if (file->checksumXxh3 != NULL)
+    {
+        memcpy((uint8_t *)buffer + bufferPos, file->checksumXxh3, XX_HASH_SIZE_MAX);
+        bufferPos += XX_HASH_SIZE_MAX;
+    }
+
+    // xxh3 repo checksum
+    if (file->checksumRepoXxh3 != NULL)
+    {
+        memcpy((uint8_t *)buffer + bufferPos, file->checksumRepoXxh3, XX_HASH_SIZE_MAX);
+        bufferPos += XX_HASH_SIZE_MAX;
+    }
+
     // Reference
     if (file->reference != NULL)
     {
@@ -359,6 +382,20 @@ manifestFileUnpack(const Manifest *const manifest, const ManifestFilePack *const
         bufferPos += HASH_TYPE_SHA1_SIZE;
     }
 
+    // xxh3 checksum
+    if (flag & (1 << manifestFilePackFlagChecksumXxh3))
+    {
+        result.checksumXxh3 = (const uint8_t *)filePack + bufferPos;
+        bufferPos += XX_HASH_SIZE_MAX;
+    }
+
+    // xxh3 repo checksum
+    if (flag & (1 << manifestFilePackFlagChecksumRepoXxh3))
+    {
+        result.checksumRepoXxh3 = (const uint8_t *)filePack + bufferPos;
+        bufferPos += XX_HASH_SIZE_MAX;
+    }
+
     // Reference
     if (flag & (1 << manifestFilePackFlagReference))
     {
@@ -1735,6 +1772,8 @@ manifestBuildIncr(
                         file.sizeRepo = filePrior.sizeRepo;
                         file.checksumSha1 = filePrior.checksumSha1;
                         file.checksumRepoSha1 = filePrior.checksumRepoSha1;
+                        file.checksumXxh3 = filePrior.checksumXxh3;
+                        file.checksumRepoXxh3 = filePrior.checksumRepoXxh3;
                         file.reference = filePrior.reference != NULL ? filePrior.reference : manifestPrior->pub.data.backupLabel;
                         file.checksumPage = filePrior.checksumPage;
                         file.checksumPageError = filePrior.checksumPageError;
@@ -1909,6 +1948,8 @@ manifestBuildComplete(
 #define MANIFEST_KEY_BUNDLE_OFFSET                                  STRID5("bno", 0x3dc20)
 #define MANIFEST_KEY_CHECKSUM                                       STRID5("checksum", 0x6d66b195030)
 #define MANIFEST_KEY_CHECKSUM_REPO                                  STRID5("rck", 0x2c720)
+#define MANIFEST_KEY_CHECKSUM_REPO_XXH3                             STRID5("rxh", 0x23120)
+#define MANIFEST_KEY_CHECKSUM_XXH3                                  STRID5("xxh", 0x23180)
 #define MANIFEST_KEY_CHECKSUM_PAGE                                  "checksum-page"
 #define MANIFEST_KEY_CHECKSUM_PAGE_ERROR                            "checksum-page-error"
 #define MANIFEST_KEY_DB_CATALOG_VERSION                             "db-catalog-version"
@@ -2111,6 +2152,10 @@ manifestLoadCallback(void *const callbackData, const String *const section, cons
         if (sizeRepoExists)
             file.sizeRepo = jsonReadUInt64(json);
 
+        // The xxh3 checksums are only present when enabled for the backup. Older versions skip these keys and use SHA1.
+        if (jsonReadKeyExpectStrId(json, MANIFEST_KEY_CHECKSUM_REPO_XXH3))
+            file.checksumRepoXxh3 = bufPtr(bufNewDecode(encodingHex, jsonReadStr(json)));
+
         // Size is required so error if it is not present. Older versions removed the size before the backup to ensure that the
         // manifest was updated during the backup, so size can be missing in partial manifests. This error will prevent older
         // partials from being resumed.
@@ -2146,6 +2191,10 @@ manifestLoadCallback(void *const callbackData, const String *const section, cons
         else
             file.user = manifest->fileUserDefault;
 
+        // xxh3 checksum
+        if (jsonReadKeyExpectStrId(json, MANIFEST_KEY_CHECKSUM_XXH3))
+            file.checksumXxh3 = bufPtr(bufNewDecode(encodingHex, jsonReadStr(json)));
+
         manifestFileAdd(manifest, &file);
     }
     // -----------------------------------------------------------------------------------------------------------------------------
@@ -2780,7 +2829,8 @@ manifestSaveCallback(void *const callbackData, const String *const sectionNext,
     // -----------------------------------------------------------------------------------------------------------------------------
     if (infoSaveSection(infoSaveData, MANIFEST_SECTION_TARGET_FILE, sectionNext))
     {
-        MEM_CONTEXT_TEMP_RESET_BEGIN()
+        // Use an arena since each file makes many small allocations for the JSON value that are freed together on reset
+        MEM_CONTEXT_TEMP_RESET_BEGIN(.arena = true)
         {
             for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
             {
@@ -2846,6 +2896,13 @@ manifestSaveCallback(void *const callbackData, const String *const sectionNext,
                 if (file.sizeRepo != file.size)
                     jsonWriteUInt64(jsonWriteKeyStrId(json, MANIFEST_KEY_SIZE_REPO), file.sizeRepo);
 
+                if (file.checksumRepoXxh3 != NULL)
+                {
+                    jsonWriteStr(
+                        jsonWriteKeyStrId(json, MANIFEST_KEY_CHECKSUM_REPO_XXH3),
+                        strNewEncode(encodingHex, BUF(file.checksumRepoXxh3, XX_HASH_SIZE_MAX)));
+                }
+
                 jsonWriteUInt64(jsonWriteKeyStrId(json, MANIFEST_KEY_SIZE), file.size);
 
                 if (file.sizeOriginal != file.size)
@@ -2856,6 +2913,14 @@ manifestSaveCallback(void *const callbackData, const String *const sectionNext,
                 if (!varEq(manifestOwnerVar(file.user), saveData->userDefault))
                     jsonWriteVar(jsonWriteKeyZ(json, MANIFEST_KEY_USER), manifestOwnerVar(file.user));
 
+                // Save the xxh3 checksum with the same rules as the SHA1 checksum
+                if (file.size != 0 && file.checksumXxh3 != NULL)
+                {
+                    jsonWriteStr(
+                        jsonWriteKeyStrId(json, MANIFEST_KEY_CHECKSUM_XXH3),
+                        strNewEncode(encodingHex, BUF(file.checksumXxh3, XX_HASH_SIZE_MAX)));
+                }
+
                 infoSaveValue(
                     infoSaveData, MANIFEST_SECTION_TARGET_FILE, strZ(file.name), jsonWriteResult(jsonWriteObjectEnd(json)));
 
@@ -148,6 +148,8 @@ typedef struct ManifestFile
     mode_t mode;                                                    // File mode
     const uint8_t *checksumSha1;                                    // SHA1 checksum
     const uint8_t *checksumRepoSha1;                                // SHA1 checksum as stored in repo (including compression, etc.)
+    const uint8_t *checksumXxh3;                                    // xxh3-128 checksum (optional, faster to verify than SHA1)
+    const uint8_t *checksumRepoXxh3;                                // xxh3-128 checksum as stored in repo (optional)
     const String *checksumPageErrorList;                            // List of page checksum errors if there are any
     const String *user;                                             // User name
     const String *group;                                            // Group name
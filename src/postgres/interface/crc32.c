@@ -1,8 +1,20 @@
 /***********************************************************************************************************************************
 CRC-32 Calculation
+
+Both CRC variants are computed with slicing-by-8, i.e. eight bytes are consumed per iteration using eight lookup tables. The first
+table of each variant is the classic byte-at-a-time table and the remaining seven are derived from it on first use. When the CPU
+supports SSE 4.2 the CRC-32C calculation uses the crc32 instruction instead, which processes eight bytes per instruction. The
+implementation is selected once at runtime so the same binary runs correctly on hosts without SSE 4.2.
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include <stdbool.h>
+#include <string.h>
+
+#ifdef HAVE_CRC32C_SSE42
+#include <nmmintrin.h>
+#endif
+
 #include "postgres/interface/crc32.h"
 
 /**********************************************************************************************************************************/
@@ -42,17 +54,6 @@ static const uint32_t crc32_lookup[256] =
     0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D,
 };
 
-FN_EXTERN uint32_t
-crc32One(const unsigned char *data, size_t size)
-{
-    uint32_t result = 0xffffffff;
-
-    while (size--)
-        result = crc32_lookup[((result >> 24) ^ *data++) & 0xFF] ^ (result << 8);
-
-    return result ^ 0xffffffff;
-}
-
 /**********************************************************************************************************************************/
 static const uint32_t crc32c_lookup[256] =
 {
@@ -90,32 +91,178 @@ static const uint32_t crc32c_lookup[256] =
     0x79B737BA, 0x8BDCB4B9, 0x988C474D, 0x6AE7C44E, 0xBE2DA0A5, 0x4C4623A6, 0x5F16D052, 0xAD7D5351,
 };
 
+/***********************************************************************************************************************************
+Local variables
+***********************************************************************************************************************************/
+#define CRC32_SLICE_TOTAL                                           8
+
+typedef uint32_t (*Crc32cCompFunction)(uint32_t crc, const unsigned char *data, size_t size);
+
+static struct Crc32Local
+{
+    bool init;                                                      // Have the tables been generated and the engine selected?
+    Crc32cCompFunction crc32cComp;                                  // Selected CRC-32C engine
+    uint32_t crc32Table[CRC32_SLICE_TOTAL][256];                    // CRC-32 slicing tables
+    uint32_t crc32cTable[CRC32_SLICE_TOTAL][256];                   // CRC-32C slicing tables
+} crc32Local;
+
+/***********************************************************************************************************************************
+CRC-32C using slicing-by-8. Bytes are loaded individually so the result does not depend on alignment or endianness.
+***********************************************************************************************************************************/
+static uint32_t
+crc32cCompSlice8(uint32_t crc, const unsigned char *data, size_t size)
+{
+    uint32_t (*const table)[256] = crc32Local.crc32cTable;
+
+    while (size >= 8)
+    {
+        const uint32_t word1 =
+            crc ^ ((uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24);
+        const uint32_t word2 = (uint32_t)data[4] | (uint32_t)data[5] << 8 | (uint32_t)data[6] << 16 | (uint32_t)data[7] << 24;
+
+        crc =
+            table[7][word1 & 0xFF] ^ table[6][(word1 >> 8) & 0xFF] ^ table[5][(word1 >> 16) & 0xFF] ^ table[4][word1 >> 24] ^
+            table[3][word2 & 0xFF] ^ table[2][(word2 >> 8) & 0xFF] ^ table[1][(word2 >> 16) & 0xFF] ^ table[0][word2 >> 24];
+
+        data += 8;
+        size -= 8;
+    }
+
+    while (size--)
+        crc = table[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+
+    return crc;
+}
+
+/***********************************************************************************************************************************
+CRC-32C using the SSE 4.2 crc32 instruction
+***********************************************************************************************************************************/
+#ifdef HAVE_CRC32C_SSE42
+
+__attribute__((target("sse4.2"))) static uint32_t
+crc32cCompSse42(uint32_t crc, const unsigned char *data, size_t size)
+{
+    // Process leading bytes until the data is 8-byte aligned
+    while (size > 0 && ((uintptr_t)data & 7) != 0)
+    {
+        crc = _mm_crc32_u8(crc, *data++);
+        size--;
+    }
+
+    // Process 8 bytes at a time
+    uint64_t crc64 = crc;
+
+    while (size >= 8)
+    {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+
+        crc64 = _mm_crc32_u64(crc64, word);
+
+        data += 8;
+        size -= 8;
+    }
+
+    crc = (uint32_t)crc64;
+
+    // Process trailing bytes
+    while (size--)
+        crc = _mm_crc32_u8(crc, *data++);
+
+    return crc;
+}
+
+#endif // HAVE_CRC32C_SSE42
+
+/***********************************************************************************************************************************
+Generate slicing tables and select the CRC-32C engine. This is done once per process.
+***********************************************************************************************************************************/
+static void
+crc32InitTable(void)
+{
+    if (!crc32Local.init)
+    {
+        memcpy(crc32Local.crc32Table[0], crc32_lookup, sizeof(crc32_lookup));
+        memcpy(crc32Local.crc32cTable[0], crc32c_lookup, sizeof(crc32c_lookup));
+
+        for (unsigned int sliceIdx = 1; sliceIdx < CRC32_SLICE_TOTAL; sliceIdx++)
+        {
+            for (unsigned int byteIdx = 0; byteIdx < 256; byteIdx++)
+            {
+                // CRC-32 (legacy) shifts left, i.e. the high byte is the next table index
+                const uint32_t crc32Prior = crc32Local.crc32Table[sliceIdx - 1][byteIdx];
+                crc32Local.crc32Table[sliceIdx][byteIdx] = (crc32Prior << 8) ^ crc32_lookup[crc32Prior >> 24];
+
+                // CRC-32C is reflected so it shifts right, i.e. the low byte is the next table index
+                const uint32_t crc32cPrior = crc32Local.crc32cTable[sliceIdx - 1][byteIdx];
+                crc32Local.crc32cTable[sliceIdx][byteIdx] = (crc32cPrior >> 8) ^ crc32c_lookup[crc32cPrior & 0xFF];
+            }
+        }
+
+        crc32Local.crc32cComp = crc32cCompSlice8;
+
+#ifdef HAVE_CRC32C_SSE42
+        if (__builtin_cpu_supports("sse4.2"))
+            crc32Local.crc32cComp = crc32cCompSse42;
+#endif
+
+        crc32Local.init = true;
+    }
+}
+
+/**********************************************************************************************************************************/
 FN_EXTERN uint32_t
-crc32cOne(const unsigned char *data, size_t size)
+crc32One(const unsigned char *data, size_t size)
 {
+    crc32InitTable();
+
+    uint32_t (*const table)[256] = crc32Local.crc32Table;
     uint32_t result = 0xffffffff;
 
+    while (size >= 8)
+    {
+        const uint32_t word1 =
+            result ^ ((uint32_t)data[0] << 24 | (uint32_t)data[1] << 16 | (uint32_t)data[2] << 8 | (uint32_t)data[3]);
+        const uint32_t word2 = (uint32_t)data[4] << 24 | (uint32_t)data[5] << 16 | (uint32_t)data[6] << 8 | (uint32_t)data[7];
+
+        result =
+            table[7][word1 >> 24] ^ table[6][(word1 >> 16) & 0xFF] ^ table[5][(word1 >> 8) & 0xFF] ^ table[4][word1 & 0xFF] ^
+            table[3][word2 >> 24] ^ table[2][(word2 >> 16) & 0xFF] ^ table[1][(word2 >> 8) & 0xFF] ^ table[0][word2 & 0xFF];
+
+        data += 8;
+        size -= 8;
+    }
+
     while (size--)
-        result = crc32c_lookup[(result ^ *data++) & 0xFF] ^ (result >> 8);
+        result = table[0][((result >> 24) ^ *data++) & 0xFF] ^ (result << 8);
 
     return result ^ 0xffffffff;
 }
 
-// crc32c calculation in a few steps. this is needed to calculate the crc32c for XRecord.
+/**********************************************************************************************************************************/
+FN_EXTERN uint32_t
+crc32cOne(const unsigned char *data, size_t size)
+{
+    return crc32cFinish(crc32cComp(crc32cInit(), data, size));
+}
+
+/**********************************************************************************************************************************/
 FN_EXTERN uint32_t
 crc32cInit(void)
 {
     return 0xffffffff;
 }
 
+/**********************************************************************************************************************************/
 FN_EXTERN uint32_t
 crc32cComp(uint32_t crc, const unsigned char *data, size_t size)
 {
-    while (size--)
-        crc = crc32c_lookup[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
-    return crc;
+    crc32InitTable();
+
+    return crc32Local.crc32cComp(crc, data, size);
 }
 
+/**********************************************************************************************************************************/
 FN_EXTERN uint32_t
 crc32cFinish(uint32_t crc)
 {
@@ -1,7 +1,8 @@
 /***********************************************************************************************************************************
 CRC-32 Calculation
 
-CRC-32 and CRC-32C calculations required to validate the integrity of pg_control.
+CRC-32 and CRC-32C calculations required to validate the integrity of pg_control and WAL records. The fastest CRC-32C implementation
+available on the current CPU is selected on first use.
 ***********************************************************************************************************************************/
 #ifndef POSTGRES_INTERFACE_CRC32_H
 #define POSTGRES_INTERFACE_CRC32_H
@@ -18,10 +19,13 @@ FN_EXTERN uint32_t crc32One(const unsigned char *data, size_t size);
 // Generate CRC-32C checksum (required by >= 9.5)
 FN_EXTERN uint32_t crc32cOne(const unsigned char *data, size_t size);
 
+// Incremental CRC-32C calculation, i.e. crc32cFinish(crc32cComp(crc32cInit(), data, size)) == crc32cOne(data, size)
 FN_EXTERN uint32_t crc32cInit(void);
 
+// Add data to a CRC-32C calculation
 FN_EXTERN uint32_t crc32cComp(uint32_t crc, const unsigned char *data, size_t size);
 
+// Finish a CRC-32C calculation
 FN_EXTERN uint32_t crc32cFinish(uint32_t crc);
 
 #endif
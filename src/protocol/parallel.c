@@ -3,8 +3,10 @@ Protocol Parallel Executor
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include <inttypes.h>
+#include <limits.h>
+#include <poll.h>
 #include <string.h>
-#include <sys/select.h>
 
 #include "common/debug.h"
 #include "common/log.h"
@@ -28,6 +30,13 @@ struct ProtocolParallel
     List *jobList;                                                  // List of jobs to be processed
 
     ProtocolParallelJob **clientJobList;                            // Jobs being processing by each client
+    unsigned int clientRunningTotal;                                // Total clients running jobs
+    struct pollfd *clientPollList;                                  // Poll list with fd set only for clients running jobs
+    TimeMSec *clientBusyTime;                                       // Time each client spent running jobs
+    TimeMSec *clientIdleTime;                                       // Time each client spent waiting for a job
+    TimeMSec *clientStateTime;                                      // Time each client last started or finished a job
+    TimeMSec tailBegin;                                             // Time the first client ran out of jobs
+    TimeMSec tailTime;                                              // Time from first client running out of jobs until done
 
     ProtocolParallelJobState state;                                 // Overall state of job processing
 };
@@ -101,60 +110,51 @@ protocolParallelProcess(ProtocolParallel *this)
         // If called for the first time, initialize processing
         if (this->state == protocolParallelJobStatePending)
         {
+            const unsigned int clientTotal = lstSize(this->clientList);
+            const TimeMSec timeBegin = timeMSec();
+
             MEM_CONTEXT_OBJ_BEGIN(this)
             {
-                this->clientJobList = memNewPtrArray(lstSize(this->clientList));
+                this->clientJobList = memNewPtrArray(clientTotal);
+                this->clientPollList = memNew(sizeof(struct pollfd) * clientTotal);
+                this->clientBusyTime = memNew(sizeof(TimeMSec) * clientTotal);
+                this->clientIdleTime = memNew(sizeof(TimeMSec) * clientTotal);
+                this->clientStateTime = memNew(sizeof(TimeMSec) * clientTotal);
             }
             MEM_CONTEXT_OBJ_END();
 
-            this->state = protocolParallelJobStateRunning;
-        }
-
-        // Initialize the file descriptor set used for select
-        fd_set selectSet;
-        FD_ZERO(&selectSet);
-        int fdMax = -1;
-
-        // Find clients that are running jobs
-        unsigned int clientRunningTotal = 0;
-
-        for (unsigned int clientIdx = 0; clientIdx < lstSize(this->clientList); clientIdx++)
-        {
-            if (this->clientJobList[clientIdx] != NULL)
+            // Clients are not polled until they are running a job. The poll list is kept between calls and only updated when a
+            // client starts or finishes a job, and unlike select() there is no limit on the value of the fds.
+            for (unsigned int clientIdx = 0; clientIdx < clientTotal; clientIdx++)
             {
-                int fd = protocolClientIoReadFd(*(ProtocolClient **)lstGet(this->clientList, clientIdx));
-                FD_SET(fd, &selectSet);
-
-                // Find the max file descriptor needed for select()
-                MAX_ASSIGN(fdMax, fd);
-
-                clientRunningTotal++;
+                this->clientPollList[clientIdx] = (struct pollfd){.fd = -1, .events = POLLIN};
+                this->clientBusyTime[clientIdx] = 0;
+                this->clientIdleTime[clientIdx] = 0;
+                this->clientStateTime[clientIdx] = timeBegin;
             }
+
+            this->state = protocolParallelJobStateRunning;
         }
 
         // If clients are running then wait for one to finish
-        if (clientRunningTotal > 0)
+        if (this->clientRunningTotal > 0)
         {
-            // Initialize timeout struct used for select. Recreate this structure each time since Linux (at least) will modify it.
-            struct timeval timeoutSelect;
-            timeoutSelect.tv_sec = (time_t)(this->timeout / MSEC_PER_SEC);
-            timeoutSelect.tv_usec = (suseconds_t)(this->timeout % MSEC_PER_SEC * 1000);
+            ASSERT(this->timeout < INT_MAX);
 
             // Determine if there is data to be read
-            int completed = select(fdMax + 1, &selectSet, NULL, NULL, &timeoutSelect);
-            THROW_ON_SYS_ERROR(completed == -1, AssertError, "unable to select from parallel client(s)");
+            const int completed = poll(this->clientPollList, lstSize(this->clientList), (int)this->timeout);
+            THROW_ON_SYS_ERROR(completed == -1, AssertError, "unable to poll parallel client(s)");
 
             // If any jobs have completed then get the results
             if (completed > 0)
             {
+                const TimeMSec timeEnd = timeMSec();
+
                 for (unsigned int clientIdx = 0; clientIdx < lstSize(this->clientList); clientIdx++)
                 {
                     ProtocolParallelJob *job = this->clientJobList[clientIdx];
 
-                    if (job != NULL &&
-                        FD_ISSET(
-                            protocolClientIoReadFd(*(ProtocolClient **)lstGet(this->clientList, clientIdx)),
-                            &selectSet))
+                    if (job != NULL && this->clientPollList[clientIdx].revents != 0)
                     {
                         MEM_CONTEXT_TEMP_BEGIN()
                         {
@@ -173,6 +173,11 @@ protocolParallelProcess(ProtocolParallel *this)
 
                             protocolParallelJobStateSet(job, protocolParallelJobStateDone);
                             this->clientJobList[clientIdx] = NULL;
+                            this->clientPollList[clientIdx].fd = -1;
+                            this->clientRunningTotal--;
+
+                            this->clientBusyTime[clientIdx] += timeEnd - this->clientStateTime[clientIdx];
+                            this->clientStateTime[clientIdx] = timeEnd;
                         }
                         MEM_CONTEXT_TEMP_END();
                     }
@@ -211,10 +216,24 @@ protocolParallelProcess(ProtocolParallel *this)
                     protocolParallelJobProcessIdSet(job, clientIdx + 1);
                     protocolParallelJobStateSet(job, protocolParallelJobStateRunning);
                     this->clientJobList[clientIdx] = job;
+                    this->clientPollList[clientIdx].fd = protocolClientIoReadFd(
+                        *(ProtocolClient **)lstGet(this->clientList, clientIdx));
+                    this->clientRunningTotal++;
+
+                    const TimeMSec timeBegin = timeMSec();
+
+                    this->clientIdleTime[clientIdx] += timeBegin - this->clientStateTime[clientIdx];
+                    this->clientStateTime[clientIdx] = timeBegin;
                 }
                 // Else no more jobs for this client so free it
                 else
+                {
                     protocolLocalFree(clientIdx + 1);
+
+                    // The tail begins when the first client runs out of jobs while others may still be running
+                    if (this->tailBegin == 0)
+                        this->tailBegin = timeMSec();
+                }
             }
         }
     }
@@ -252,6 +271,51 @@ protocolParallelResult(ProtocolParallel *this)
     FUNCTION_LOG_RETURN(PROTOCOL_PARALLEL_JOB, result);
 }
 
+/**********************************************************************************************************************************/
+FN_EXTERN TimeMSec
+protocolParallelClientBusyTime(const ProtocolParallel *const this, const unsigned int clientIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PROTOCOL_PARALLEL, this);
+        FUNCTION_TEST_PARAM(UINT, clientIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->state != protocolParallelJobStatePending);
+    ASSERT(clientIdx < lstSize(this->clientList));
+
+    FUNCTION_TEST_RETURN(TIME_MSEC, this->clientBusyTime[clientIdx]);
+}
+
+FN_EXTERN TimeMSec
+protocolParallelClientIdleTime(const ProtocolParallel *const this, const unsigned int clientIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PROTOCOL_PARALLEL, this);
+        FUNCTION_TEST_PARAM(UINT, clientIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->state != protocolParallelJobStatePending);
+    ASSERT(clientIdx < lstSize(this->clientList));
+
+    FUNCTION_TEST_RETURN(TIME_MSEC, this->clientIdleTime[clientIdx]);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN TimeMSec
+protocolParallelTailTime(const ProtocolParallel *const this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PROTOCOL_PARALLEL, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->state == protocolParallelJobStateDone);
+
+    FUNCTION_TEST_RETURN(TIME_MSEC, this->tailTime);
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN bool
 protocolParallelDone(ProtocolParallel *this)
@@ -265,7 +329,19 @@ protocolParallelDone(ProtocolParallel *this)
 
     // If there are no jobs left then we are done
     if (this->state != protocolParallelJobStateDone && lstEmpty(this->jobList))
+    {
         this->state = protocolParallelJobStateDone;
+        this->tailTime = this->tailBegin == 0 ? 0 : timeMSec() - this->tailBegin;
+
+        // Log time spent by each client running jobs and waiting for jobs. High idle time means that clients are starved, i.e. the
+        // main process is not handing out jobs fast enough.
+        for (unsigned int clientIdx = 0; clientIdx < lstSize(this->clientList); clientIdx++)
+        {
+            LOG_DEBUG_FMT(
+                "client %u busy time %" PRIu64 "ms, idle time %" PRIu64 "ms", clientIdx + 1, this->clientBusyTime[clientIdx],
+                this->clientIdleTime[clientIdx]);
+        }
+    }
 
     FUNCTION_LOG_RETURN(BOOL, this->state == protocolParallelJobStateDone);
 }
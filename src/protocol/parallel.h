@@ -30,6 +30,17 @@ FN_EXTERN ProtocolParallel *protocolParallelNew(TimeMSec timeout, ParallelJobCal
 /***********************************************************************************************************************************
 Getters/Setters
 ***********************************************************************************************************************************/
+// Time (in ms) a client spent running jobs, i.e. from sending a command until its result was read
+FN_EXTERN TimeMSec protocolParallelClientBusyTime(const ProtocolParallel *this, unsigned int clientIdx);
+
+// Time (in ms) a client spent waiting for a job, i.e. from reading a result until the next command was sent. This includes the time
+// waiting for the results of other clients to be processed, so high idle time means the client is starved.
+FN_EXTERN TimeMSec protocolParallelClientIdleTime(const ProtocolParallel *this, unsigned int clientIdx);
+
+// Time (in ms) from when the first client ran out of jobs until all jobs were done. A long tail relative to the total time means
+// that work was not evenly distributed between the clients. Only valid once processing is done.
+FN_EXTERN TimeMSec protocolParallelTailTime(const ProtocolParallel *this);
+
 // Are all jobs done?
 FN_EXTERN bool protocolParallelDone(ProtocolParallel *this);
 
@@ -4,113 +4,68 @@ Azure Storage Read
 #include "build.auto.h"
 
 #include "common/debug.h"
-#include "common/io/http/client.h"
 #include "common/log.h"
-#include "common/type/object.h"
 #include "storage/azure/read.h"
-#include "storage/read.intern.h"
+#include "storage/readHttp.h"
 
 /***********************************************************************************************************************************
-Object type
+Request a range of the object. The ETag pins the version of the object so the request fails with 412 if it has been overwritten.
 ***********************************************************************************************************************************/
-typedef struct StorageReadAzure
+static HttpRequest *
+storageReadAzureRequest(
+    void *const driver, const String *const name, const uint64_t offset, const Variant *const limit, const String *const version)
 {
-    StorageReadInterface interface;                                 // Interface
-    StorageAzure *storage;                                          // Storage that created this object
-
-    HttpResponse *httpResponse;                                     // HTTP response
-} StorageReadAzure;
-
-/***********************************************************************************************************************************
-Macros for function logging
-***********************************************************************************************************************************/
-#define FUNCTION_LOG_STORAGE_READ_AZURE_TYPE                                                                                       \
-    StorageReadAzure *
-#define FUNCTION_LOG_STORAGE_READ_AZURE_FORMAT(value, buffer, bufferSize)                                                          \
-    objNameToLog(value, "StorageReadAzure", buffer, bufferSize)
-
-/***********************************************************************************************************************************
-Open the file
-***********************************************************************************************************************************/
-static bool
-storageReadAzureOpen(THIS_VOID)
-{
-    THIS(StorageReadAzure);
-
     FUNCTION_LOG_BEGIN(logLevelTrace);
-        FUNCTION_LOG_PARAM(STORAGE_READ_AZURE, this);
+        FUNCTION_LOG_PARAM(STORAGE_AZURE, driver);
+        FUNCTION_LOG_PARAM(STRING, name);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(VARIANT, limit);
+        FUNCTION_LOG_PARAM(STRING, version);
     FUNCTION_LOG_END();
 
-    ASSERT(this != NULL);
-    ASSERT(this->httpResponse == NULL);
+    ASSERT(driver != NULL);
+    ASSERT(name != NULL);
+
+    HttpHeader *const header = httpHeaderPutRange(httpHeaderNew(NULL), offset, limit);
 
-    bool result = false;
+    if (version != NULL)
+        httpHeaderPut(header, HTTP_HEADER_IF_MATCH_STR, version);
 
-    // Request the file
-    MEM_CONTEXT_OBJ_BEGIN(this)
-    {
-        this->httpResponse = storageAzureRequestP(
-            this->storage, HTTP_VERB_GET_STR, .path = this->interface.name,
-            .header = httpHeaderPutRange(httpHeaderNew(NULL), this->interface.offset, this->interface.limit),
-            .allowMissing = true, .contentIo = true);
-    }
-    MEM_CONTEXT_OBJ_END();
+    HttpRequest *const result = storageAzureRequestAsyncP(driver, HTTP_VERB_GET_STR, .path = name, .header = header);
 
-    if (httpResponseCodeOk(this->httpResponse))
-    {
-        result = true;
-    }
-    // Else error unless ignore missing
-    else if (!this->interface.ignoreMissing)
-        THROW_FMT(FileMissingError, STORAGE_ERROR_READ_MISSING, strZ(this->interface.name));
+    httpHeaderFree(header);
 
-    FUNCTION_LOG_RETURN(BOOL, result);
+    FUNCTION_LOG_RETURN(HTTP_REQUEST, result);
 }
 
 /***********************************************************************************************************************************
-Read from a file
+Get the response to a range request
 ***********************************************************************************************************************************/
-static size_t
-storageReadAzure(THIS_VOID, Buffer *const buffer, const bool block)
+static HttpResponse *
+storageReadAzureResponse(HttpRequest *const request, const bool allowMissing)
 {
-    THIS(StorageReadAzure);
-
     FUNCTION_LOG_BEGIN(logLevelTrace);
-        FUNCTION_LOG_PARAM(STORAGE_READ_AZURE, this);
-        FUNCTION_LOG_PARAM(BUFFER, buffer);
-        FUNCTION_LOG_PARAM(BOOL, block);
+        FUNCTION_LOG_PARAM(HTTP_REQUEST, request);
+        FUNCTION_LOG_PARAM(BOOL, allowMissing);
     FUNCTION_LOG_END();
 
-    ASSERT(this != NULL && this->httpResponse != NULL);
-    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
-    ASSERT(buffer != NULL && !bufFull(buffer));
+    ASSERT(request != NULL);
 
-    FUNCTION_LOG_RETURN(SIZE, ioRead(httpResponseIoRead(this->httpResponse), buffer));
+    FUNCTION_LOG_RETURN(HTTP_RESPONSE, storageAzureResponseP(request, .allowMissing = allowMissing, .contentIo = true));
 }
 
-/***********************************************************************************************************************************
-Has file reached EOF?
-***********************************************************************************************************************************/
-static bool
-storageReadAzureEof(THIS_VOID)
+/**********************************************************************************************************************************/
+static const StorageReadHttpInterface storageReadAzureInterface =
 {
-    THIS(StorageReadAzure);
-
-    FUNCTION_TEST_BEGIN();
-        FUNCTION_TEST_PARAM(STORAGE_READ_AZURE, this);
-    FUNCTION_TEST_END();
-
-    ASSERT(this != NULL && this->httpResponse != NULL);
-    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
+    .versionHeader = STRDEF(HTTP_HEADER_ETAG),
+    .request = storageReadAzureRequest,
+    .response = storageReadAzureResponse,
+};
 
-    FUNCTION_TEST_RETURN(BOOL, ioReadEof(httpResponseIoRead(this->httpResponse)));
-}
-
-/**********************************************************************************************************************************/
 FN_EXTERN StorageRead *
 storageReadAzureNew(
     StorageAzure *const storage, const String *const name, const bool ignoreMissing, const uint64_t offset,
-    const Variant *const limit)
+    const Variant *const limit, const size_t chunkSize, const unsigned int chunkMax)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_AZURE, storage);
@@ -118,35 +73,15 @@ storageReadAzureNew(
         FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
         FUNCTION_LOG_PARAM(UINT64, offset);
         FUNCTION_LOG_PARAM(VARIANT, limit);
+        FUNCTION_LOG_PARAM(SIZE, chunkSize);
+        FUNCTION_LOG_PARAM(UINT, chunkMax);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
     ASSERT(name != NULL);
 
-    OBJ_NEW_BEGIN(StorageReadAzure, .childQty = MEM_CONTEXT_QTY_MAX)
-    {
-        *this = (StorageReadAzure)
-        {
-            .storage = storage,
-
-            .interface = (StorageReadInterface)
-            {
-                .type = STORAGE_AZURE_TYPE,
-                .name = strDup(name),
-                .ignoreMissing = ignoreMissing,
-                .offset = offset,
-                .limit = varDup(limit),
-
-                .ioInterface = (IoReadInterface)
-                {
-                    .eof = storageReadAzureEof,
-                    .open = storageReadAzureOpen,
-                    .read = storageReadAzure,
-                },
-            },
-        };
-    }
-    OBJ_NEW_END();
-
-    FUNCTION_LOG_RETURN(STORAGE_READ, storageReadNew(this, &this->interface));
+    FUNCTION_LOG_RETURN(
+        STORAGE_READ,
+        storageReadHttpNew(
+            storage, &storageReadAzureInterface, STORAGE_AZURE_TYPE, name, ignoreMissing, offset, limit, chunkSize, chunkMax));
 }
@@ -40,9 +40,10 @@ typedef struct StorageWriteAzure
     StorageWriteInterface interface;                                // Interface
     StorageAzure *storage;                                          // Storage that created this object
 
-    HttpRequest *request;                                           // Async block upload request
+    List *requestList;                                              // Async block upload requests in block order
     uint64_t fileId;                                                // Id to used to make file block identifiers unique
     size_t blockSize;                                               // Size of blocks for multi-block upload
+    unsigned int blockMax;                                          // Maximum async block upload requests in flight
     Buffer *blockBuffer;                                            // Block buffer (stores data until blockSize is reached)
     StringList *blockIdList;                                        // List of uploaded block ids
 } StorageWriteAzure;
@@ -70,10 +71,11 @@ storageWriteAzureOpen(THIS_VOID)
     ASSERT(this != NULL);
     ASSERT(this->blockBuffer == NULL);
 
-    // Allocate the block buffer
+    // Allocate the block buffer and async request list
     MEM_CONTEXT_OBJ_BEGIN(this)
     {
         this->blockBuffer = bufNew(this->blockSize);
+        this->requestList = lstNewP(sizeof(HttpRequest *));
     }
     MEM_CONTEXT_OBJ_END();
 
@@ -81,7 +83,7 @@ storageWriteAzureOpen(THIS_VOID)
 }
 
 /***********************************************************************************************************************************
-Flush bytes to upload block
+Flush bytes to upload block. Up to blockMax blocks may be in flight at once, each on its own session from the HttpClient pool.
 ***********************************************************************************************************************************/
 static void
 storageWriteAzureBlock(StorageWriteAzure *const this)
@@ -91,15 +93,15 @@ storageWriteAzureBlock(StorageWriteAzure *const this)
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
+    ASSERT(!lstEmpty(this->requestList));
 
-    // If there is an outstanding async request then wait for the response. Since the part id has already been stored there is
-    // nothing to do except make sure the request did not error.
-    if (this->request != NULL)
-    {
-        httpResponseFree(storageAzureResponseP(this->request));
-        httpRequestFree(this->request);
-        this->request = NULL;
-    }
+    // Wait for the response to the oldest outstanding async request. Since the block id has already been stored there is nothing
+    // to do except make sure the request did not error.
+    HttpRequest *const request = *(HttpRequest **)lstGet(this->requestList, 0);
+
+    httpResponseFree(storageAzureResponseP(request));
+    httpRequestFree(request);
+    lstRemoveIdx(this->requestList, 0);
 
     FUNCTION_LOG_RETURN_VOID();
 }
@@ -117,8 +119,9 @@ storageWriteAzureBlockAsync(StorageWriteAzure *const this)
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
-        // Complete prior async request, if any
-        storageWriteAzureBlock(this);
+        // Complete the oldest async request if the maximum are already in flight
+        if (lstSize(this->requestList) >= this->blockMax)
+            storageWriteAzureBlock(this);
 
         // Create the block id list
         if (this->blockIdList == NULL)
@@ -141,12 +144,14 @@ storageWriteAzureBlockAsync(StorageWriteAzure *const this)
         httpQueryAdd(query, AZURE_QUERY_COMP_STR, AZURE_QUERY_VALUE_BLOCK_STR);
         httpQueryAdd(query, AZURE_QUERY_BLOCK_ID_STR, blockId);
 
-        MEM_CONTEXT_OBJ_BEGIN(this)
+        MEM_CONTEXT_BEGIN(lstMemContext(this->requestList))
         {
-            this->request = storageAzureRequestAsyncP(
+            HttpRequest *const request = storageAzureRequestAsyncP(
                 this->storage, HTTP_VERB_PUT_STR, .path = this->interface.name, .query = query, .content = this->blockBuffer);
+
+            lstAdd(this->requestList, &request);
         }
-        MEM_CONTEXT_OBJ_END();
+        MEM_CONTEXT_END();
 
         strLstAdd(this->blockIdList, blockId);
     }
@@ -223,8 +228,9 @@ storageWriteAzureClose(THIS_VOID)
                 if (!bufEmpty(this->blockBuffer))
                     storageWriteAzureBlockAsync(this);
 
-                // Complete prior async request, if any
-                storageWriteAzureBlock(this);
+                // Complete all outstanding async requests
+                while (!lstEmpty(this->requestList))
+                    storageWriteAzureBlock(this);
 
                 // Generate the xml block list
                 XmlDocument *const blockXml = xmlDocumentNew(AZURE_XML_TAG_BLOCK_LIST_STR);
@@ -262,17 +268,21 @@ storageWriteAzureClose(THIS_VOID)
 
 /**********************************************************************************************************************************/
 FN_EXTERN StorageWrite *
-storageWriteAzureNew(StorageAzure *const storage, const String *const name, const uint64_t fileId, const size_t blockSize)
+storageWriteAzureNew(
+    StorageAzure *const storage, const String *const name, const uint64_t fileId, const size_t blockSize,
+    const unsigned int blockMax)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_AZURE, storage);
         FUNCTION_LOG_PARAM(STRING, name);
         FUNCTION_LOG_PARAM(UINT64, fileId);
         FUNCTION_LOG_PARAM(UINT64, blockSize);
+        FUNCTION_LOG_PARAM(UINT, blockMax);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
     ASSERT(name != NULL);
+    ASSERT(blockMax > 0);
 
     OBJ_NEW_BEGIN(StorageWriteAzure, .childQty = MEM_CONTEXT_QTY_MAX)
     {
@@ -281,6 +291,7 @@ storageWriteAzureNew(StorageAzure *const storage, const String *const name, cons
             .storage = storage,
             .fileId = fileId,
             .blockSize = blockSize,
+            .blockMax = blockMax,
 
             .interface = (StorageWriteInterface)
             {
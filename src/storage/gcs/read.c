@@ -4,120 +4,80 @@ GCS Storage Read
 #include "build.auto.h"
 
 #include "common/debug.h"
-#include "common/io/http/client.h"
-#include "common/io/read.h"
 #include "common/log.h"
-#include "common/type/object.h"
 #include "storage/gcs/read.h"
-#include "storage/read.intern.h"
+#include "storage/readHttp.h"
 
 /***********************************************************************************************************************************
-GCS query tokens
+GCS headers and query tokens
 ***********************************************************************************************************************************/
+#define GCS_HEADER_GENERATION                                       "x-goog-generation"
+
 STRING_STATIC(GCS_QUERY_ALT_STR,                                    "alt");
+STRING_STATIC(GCS_QUERY_IF_GENERATION_MATCH_STR,                    "ifGenerationMatch");
 
 /***********************************************************************************************************************************
-Object type
+Request a range of the object. The generation pins the version of the object so the request fails with 412 if it has been
+overwritten. The JSON API used for reads takes the generation precondition as a query parameter rather than a header.
 ***********************************************************************************************************************************/
-typedef struct StorageReadGcs
+static HttpRequest *
+storageReadGcsRequest(
+    void *const driver, const String *const name, const uint64_t offset, const Variant *const limit, const String *const version)
 {
-    StorageReadInterface interface;                                 // Interface
-    StorageGcs *storage;                                            // Storage that created this object
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_GCS, driver);
+        FUNCTION_LOG_PARAM(STRING, name);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(VARIANT, limit);
+        FUNCTION_LOG_PARAM(STRING, version);
+    FUNCTION_LOG_END();
 
-    HttpResponse *httpResponse;                                     // HTTP response
-} StorageReadGcs;
+    ASSERT(driver != NULL);
+    ASSERT(name != NULL);
 
-/***********************************************************************************************************************************
-Macros for function logging
-***********************************************************************************************************************************/
-#define FUNCTION_LOG_STORAGE_READ_GCS_TYPE                                                                                         \
-    StorageReadGcs *
-#define FUNCTION_LOG_STORAGE_READ_GCS_FORMAT(value, buffer, bufferSize)                                                            \
-    objNameToLog(value, "StorageReadGcs", buffer, bufferSize)
+    HttpHeader *const header = httpHeaderPutRange(httpHeaderNew(NULL), offset, limit);
+    HttpQuery *const query = httpQueryAdd(httpQueryNewP(), GCS_QUERY_ALT_STR, GCS_QUERY_MEDIA_STR);
 
-/***********************************************************************************************************************************
-Open the file
-***********************************************************************************************************************************/
-static bool
-storageReadGcsOpen(THIS_VOID)
-{
-    THIS(StorageReadGcs);
+    if (version != NULL)
+        httpQueryAdd(query, GCS_QUERY_IF_GENERATION_MATCH_STR, version);
 
-    FUNCTION_LOG_BEGIN(logLevelTrace);
-        FUNCTION_LOG_PARAM(STORAGE_READ_GCS, this);
-    FUNCTION_LOG_END();
+    HttpRequest *const result = storageGcsRequestAsyncP(
+        driver, HTTP_VERB_GET_STR, .object = name, .header = header, .query = query);
+
+    httpHeaderFree(header);
+    httpQueryFree(query);
 
-    ASSERT(this != NULL);
-    ASSERT(this->httpResponse == NULL);
-
-    bool result = false;
-
-    // Request the file
-    MEM_CONTEXT_OBJ_BEGIN(this)
-    {
-        this->httpResponse = storageGcsRequestP(
-            this->storage, HTTP_VERB_GET_STR, .object = this->interface.name,
-            .header = httpHeaderPutRange(httpHeaderNew(NULL), this->interface.offset, this->interface.limit),
-            .allowMissing = true, .contentIo = true,
-            .query = httpQueryAdd(httpQueryNewP(), GCS_QUERY_ALT_STR, GCS_QUERY_MEDIA_STR));
-    }
-    MEM_CONTEXT_OBJ_END();
-
-    if (httpResponseCodeOk(this->httpResponse))
-    {
-        result = true;
-    }
-    // Else error unless ignore missing
-    else if (!this->interface.ignoreMissing)
-        THROW_FMT(FileMissingError, STORAGE_ERROR_READ_MISSING, strZ(this->interface.name));
-
-    FUNCTION_LOG_RETURN(BOOL, result);
+    FUNCTION_LOG_RETURN(HTTP_REQUEST, result);
 }
 
 /***********************************************************************************************************************************
-Read from a file
+Get the response to a range request
 ***********************************************************************************************************************************/
-static size_t
-storageReadGcs(THIS_VOID, Buffer *const buffer, const bool block)
+static HttpResponse *
+storageReadGcsResponse(HttpRequest *const request, const bool allowMissing)
 {
-    THIS(StorageReadGcs);
-
     FUNCTION_LOG_BEGIN(logLevelTrace);
-        FUNCTION_LOG_PARAM(STORAGE_READ_GCS, this);
-        FUNCTION_LOG_PARAM(BUFFER, buffer);
-        FUNCTION_LOG_PARAM(BOOL, block);
+        FUNCTION_LOG_PARAM(HTTP_REQUEST, request);
+        FUNCTION_LOG_PARAM(BOOL, allowMissing);
     FUNCTION_LOG_END();
 
-    ASSERT(this != NULL && this->httpResponse != NULL);
-    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
-    ASSERT(buffer != NULL && !bufFull(buffer));
+    ASSERT(request != NULL);
 
-    FUNCTION_LOG_RETURN(SIZE, ioRead(httpResponseIoRead(this->httpResponse), buffer));
+    FUNCTION_LOG_RETURN(HTTP_RESPONSE, storageGcsResponseP(request, .allowMissing = allowMissing, .contentIo = true));
 }
 
-/***********************************************************************************************************************************
-Has file reached EOF?
-***********************************************************************************************************************************/
-static bool
-storageReadGcsEof(THIS_VOID)
+/**********************************************************************************************************************************/
+static const StorageReadHttpInterface storageReadGcsInterface =
 {
-    THIS(StorageReadGcs);
-
-    FUNCTION_TEST_BEGIN();
-        FUNCTION_TEST_PARAM(STORAGE_READ_GCS, this);
-    FUNCTION_TEST_END();
-
-    ASSERT(this != NULL && this->httpResponse != NULL);
-    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
+    .versionHeader = STRDEF(GCS_HEADER_GENERATION),
+    .request = storageReadGcsRequest,
+    .response = storageReadGcsResponse,
+};
 
-    FUNCTION_TEST_RETURN(BOOL, ioReadEof(httpResponseIoRead(this->httpResponse)));
-}
-
-/**********************************************************************************************************************************/
 FN_EXTERN StorageRead *
 storageReadGcsNew(
     StorageGcs *const storage, const String *const name, const bool ignoreMissing, const uint64_t offset,
-    const Variant *const limit)
+    const Variant *const limit, const size_t chunkSize, const unsigned int chunkMax)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_GCS, storage);
@@ -125,35 +85,15 @@ storageReadGcsNew(
         FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
         FUNCTION_LOG_PARAM(UINT64, offset);
         FUNCTION_LOG_PARAM(VARIANT, limit);
+        FUNCTION_LOG_PARAM(SIZE, chunkSize);
+        FUNCTION_LOG_PARAM(UINT, chunkMax);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
     ASSERT(name != NULL);
 
-    OBJ_NEW_BEGIN(StorageReadGcs, .childQty = MEM_CONTEXT_QTY_MAX)
-    {
-        *this = (StorageReadGcs)
-        {
-            .storage = storage,
-
-            .interface = (StorageReadInterface)
-            {
-                .type = STORAGE_GCS_TYPE,
-                .name = strDup(name),
-                .ignoreMissing = ignoreMissing,
-                .offset = offset,
-                .limit = varDup(limit),
-
-                .ioInterface = (IoReadInterface)
-                {
-                    .eof = storageReadGcsEof,
-                    .open = storageReadGcsOpen,
-                    .read = storageReadGcs,
-                },
-            },
-        };
-    }
-    OBJ_NEW_END();
-
-    FUNCTION_LOG_RETURN(STORAGE_READ, storageReadNew(this, &this->interface));
+    FUNCTION_LOG_RETURN(
+        STORAGE_READ,
+        storageReadHttpNew(
+            storage, &storageReadGcsInterface, STORAGE_GCS_TYPE, name, ignoreMissing, offset, limit, chunkSize, chunkMax));
 }
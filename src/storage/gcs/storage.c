@@ -101,6 +101,8 @@ struct StorageGcs
     const String *bucket;                                           // Bucket to store data in
     const String *endpoint;                                         // Endpoint
     size_t chunkSize;                                               // Block size for resumable upload
+    size_t readChunkSize;                                           // Chunk size for ranged reads
+    unsigned int readChunkMax;                                      // Maximum chunks in flight for ranged reads
     unsigned int deleteMax;                                         // Maximum objects that can be deleted in one request
     const Buffer *tag;                                              // Tags to be applied to objects
 
@@ -890,7 +892,9 @@ storageGcsNewRead(THIS_VOID, const String *const file, const bool ignoreMissing,
     ASSERT(this != NULL);
     ASSERT(file != NULL);
 
-    FUNCTION_LOG_RETURN(STORAGE_READ, storageReadGcsNew(this, file, ignoreMissing, param.offset, param.limit));
+    FUNCTION_LOG_RETURN(
+        STORAGE_READ,
+        storageReadGcsNew(this, file, ignoreMissing, param.offset, param.limit, this->readChunkSize, this->readChunkMax));
 }
 
 /**********************************************************************************************************************************/
@@ -1133,9 +1137,9 @@ static const StorageInterface storageInterfaceGcs =
 FN_EXTERN Storage *
 storageGcsNew(
     const String *const path, const bool write, StoragePathExpressionCallback pathExpressionFunction, const String *const bucket,
-    const StorageGcsKeyType keyType, const String *const key, const size_t chunkSize, const KeyValue *const tag,
-    const String *const endpoint, const TimeMSec timeout, const bool verifyPeer, const String *const caFile,
-    const String *const caPath)
+    const StorageGcsKeyType keyType, const String *const key, const size_t chunkSize, const size_t readChunkSize,
+    const unsigned int readChunkMax, const KeyValue *const tag, const String *const endpoint, const TimeMSec timeout,
+    const bool verifyPeer, const String *const caFile, const String *const caPath)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, path);
@@ -1145,6 +1149,8 @@ storageGcsNew(
         FUNCTION_LOG_PARAM(STRING_ID, keyType);
         FUNCTION_TEST_PARAM(STRING, key);
         FUNCTION_LOG_PARAM(SIZE, chunkSize);
+        FUNCTION_LOG_PARAM(SIZE, readChunkSize);
+        FUNCTION_LOG_PARAM(UINT, readChunkMax);
         FUNCTION_LOG_PARAM(KEY_VALUE, tag);
         FUNCTION_LOG_PARAM(STRING, endpoint);
         FUNCTION_LOG_PARAM(TIME_MSEC, timeout);
@@ -1157,6 +1163,8 @@ storageGcsNew(
     ASSERT(bucket != NULL);
     ASSERT(keyType == storageGcsKeyTypeAuto || key != NULL);
     ASSERT(chunkSize != 0);
+    ASSERT(readChunkSize != 0);
+    ASSERT(readChunkMax != 0);
 
     OBJ_NEW_BEGIN(StorageGcs, .childQty = MEM_CONTEXT_QTY_MAX)
     {
@@ -1167,6 +1175,8 @@ storageGcsNew(
             .bucket = strDup(bucket),
             .keyType = keyType,
             .chunkSize = chunkSize,
+            .readChunkSize = readChunkSize,
+            .readChunkMax = readChunkMax,
             .deleteMax = STORAGE_GCS_DELETE_MAX,
         };
 
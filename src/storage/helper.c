@@ -194,7 +194,12 @@ storagePgGet(const unsigned int pgIdx, const bool write)
     }
     // Use Posix storage
     else
-        result = storagePosixNewP(cfgOptionIdxStr(cfgOptPgPath, pgIdx), .write = write);
+    {
+        result = storagePosixNewP(
+            cfgOptionIdxStr(cfgOptPgPath, pgIdx), .write = write,
+            .ioUring = cfgOptionValid(cfgOptIoUring) && cfgOptionBool(cfgOptIoUring),
+            .direct = cfgOptionValid(cfgOptIoDirect) && cfgOptionBool(cfgOptIoDirect));
+    }
 
     FUNCTION_TEST_RETURN(STORAGE, result);
 }
@@ -387,7 +392,9 @@ storageRepoGet(const unsigned int repoIdx, const bool write)
             CHECK(AssertError, type == STORAGE_POSIX_TYPE, "invalid storage type");
 
             result = storagePosixNewP(
-                cfgOptionIdxStr(cfgOptRepoPath, repoIdx), .write = write, .pathExpressionFunction = storageRepoPathExpression);
+                cfgOptionIdxStr(cfgOptRepoPath, repoIdx), .write = write, .pathExpressionFunction = storageRepoPathExpression,
+                .ioUring = cfgOptionValid(cfgOptIoUring) && cfgOptionBool(cfgOptIoUring),
+                .direct = cfgOptionValid(cfgOptIoDirect) && cfgOptionBool(cfgOptIoDirect));
         }
     }
 
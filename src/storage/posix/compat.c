@@ -0,0 +1,172 @@
+/***********************************************************************************************************************************
+Posix Storage Compatibility
+***********************************************************************************************************************************/
+// Must be set before any system header is included. It is limited to this module so the rest of the build stays POSIX.
+#define _GNU_SOURCE
+
+#include "build.auto.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
+#ifdef HAVE_LINUX_FS_H
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
+#include "common/debug.h"
+#include "storage/posix/compat.h"
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+posixCompatAdvise(const int fd, const off_t offset, const off_t size, const PosixCompatAdvice advice)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INT, fd);
+        FUNCTION_TEST_PARAM(INT64, offset);
+        FUNCTION_TEST_PARAM(INT64, size);
+        FUNCTION_TEST_PARAM(ENUM, advice);
+    FUNCTION_TEST_END();
+
+#ifdef HAVE_POSIX_FADVISE
+    static const int adviceMap[] = {POSIX_FADV_SEQUENTIAL, POSIX_FADV_WILLNEED, POSIX_FADV_DONTNEED};
+
+    posix_fadvise(fd, offset, size, adviceMap[advice]);
+#else
+    (void)fd;
+    (void)offset;
+    (void)size;
+    (void)advice;
+#endif
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN int
+posixCompatCloneFile(const int fdDest, const int fdSource)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INT, fdDest);
+        FUNCTION_TEST_PARAM(INT, fdSource);
+    FUNCTION_TEST_END();
+
+#if defined(HAVE_LINUX_FS_H) && defined(FICLONE)
+    FUNCTION_TEST_RETURN(INT, ioctl(fdDest, FICLONE, fdSource));
+#else
+    (void)fdDest;
+    (void)fdSource;
+
+    errno = ENOSYS;
+    FUNCTION_TEST_RETURN(INT, -1);
+#endif
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN ssize_t
+posixCompatCopyFileRange(const int fdSource, off_t *const offsetSource, const int fdDest, const size_t size)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INT, fdSource);
+        FUNCTION_TEST_PARAM_P(VOID, offsetSource);
+        FUNCTION_TEST_PARAM(INT, fdDest);
+        FUNCTION_TEST_PARAM(SIZE, size);
+    FUNCTION_TEST_END();
+
+#ifdef HAVE_COPY_FILE_RANGE
+    FUNCTION_TEST_RETURN_TYPE(ssize_t, copy_file_range(fdSource, offsetSource, fdDest, NULL, size, 0));
+#else
+    (void)fdSource;
+    (void)offsetSource;
+    (void)fdDest;
+    (void)size;
+
+    errno = ENOSYS;
+    FUNCTION_TEST_RETURN_TYPE(ssize_t, -1);
+#endif
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN int
+posixCompatOpenDirect(const char *const pathFile, const int flags)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRINGZ, pathFile);
+        FUNCTION_TEST_PARAM(INT, flags);
+    FUNCTION_TEST_END();
+
+#ifdef HAVE_O_DIRECT
+    FUNCTION_TEST_RETURN(INT, open(pathFile, flags | O_DIRECT, 0));
+#else
+    (void)pathFile;
+    (void)flags;
+
+    errno = EINVAL;
+    FUNCTION_TEST_RETURN(INT, -1);
+#endif
+}
+
+/**********************************************************************************************************************************/
+#ifdef HAVE_IO_URING
+
+FN_EXTERN int
+posixCompatUringSetup(const unsigned int depth, struct io_uring_params *const params)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(UINT, depth);
+        FUNCTION_TEST_PARAM_P(VOID, params);
+    FUNCTION_TEST_END();
+
+    FUNCTION_TEST_RETURN(INT, (int)syscall(__NR_io_uring_setup, depth, params));
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN int
+posixCompatUringEnter(const int fd, const unsigned int submitTotal, const unsigned int waitTotal, const unsigned int flags)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INT, fd);
+        FUNCTION_TEST_PARAM(UINT, submitTotal);
+        FUNCTION_TEST_PARAM(UINT, waitTotal);
+        FUNCTION_TEST_PARAM(UINT, flags);
+    FUNCTION_TEST_END();
+
+    FUNCTION_TEST_RETURN(INT, (int)syscall(__NR_io_uring_enter, fd, submitTotal, waitTotal, flags, NULL, 0));
+}
+
+#endif // HAVE_IO_URING
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+posixCompatSync(void)
+{
+    FUNCTION_TEST_VOID();
+
+    sync();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN int
+posixCompatSyncFs(const int fd)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INT, fd);
+    FUNCTION_TEST_END();
+
+#ifdef HAVE_SYNCFS
+    FUNCTION_TEST_RETURN(INT, syncfs(fd));
+#else
+    (void)fd;
+
+    errno = ENOSYS;
+    FUNCTION_TEST_RETURN(INT, -1);
+#endif
+}
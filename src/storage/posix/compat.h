@@ -0,0 +1,59 @@
+/***********************************************************************************************************************************
+Posix Storage Compatibility
+
+Wrappers for system calls that are not declared when building with _POSIX_C_SOURCE, which glibc only declares when _GNU_SOURCE is
+set. The wrappers are built in their own module with _GNU_SOURCE set and are always available. When configure did not detect a
+system call the wrapper fails with ENOSYS so callers can fall back to portable code in the same way as when the kernel does not
+support the system call.
+***********************************************************************************************************************************/
+#ifndef STORAGE_POSIX_COMPAT_H
+#define STORAGE_POSIX_COMPAT_H
+
+#include <sys/types.h>
+
+/***********************************************************************************************************************************
+Advice for posixCompatAdvise()
+***********************************************************************************************************************************/
+typedef enum
+{
+    posixCompatAdviseSequential,                                    // Range will be read sequentially (POSIX_FADV_SEQUENTIAL)
+    posixCompatAdviseWillNeed,                                      // Range will be needed soon (POSIX_FADV_WILLNEED)
+    posixCompatAdviseDontNeed,                                      // Range will not be needed again (POSIX_FADV_DONTNEED)
+} PosixCompatAdvice;
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Advise the kernel how a range of a file will be used (posix_fadvise). This is only a hint so it is ignored when not available.
+FN_EXTERN void posixCompatAdvise(int fd, off_t offset, off_t size, PosixCompatAdvice advice);
+
+// Clone the source file into the destination file so the files share blocks on file systems that support reflinks (FICLONE)
+FN_EXTERN int posixCompatCloneFile(int fdDest, int fdSource);
+
+// Copy a range of the source file to the current position of the destination file in the kernel (copy_file_range). The source
+// offset is updated by the size copied.
+FN_EXTERN ssize_t posixCompatCopyFileRange(int fdSource, off_t *offsetSource, int fdDest, size_t size);
+
+// Open a file with direct I/O, bypassing the page cache (O_DIRECT). Fails with EINVAL when direct I/O is not available, which is
+// also the error returned by the kernel when the file system does not support direct I/O.
+FN_EXTERN int posixCompatOpenDirect(const char *pathFile, int flags);
+
+#ifdef HAVE_IO_URING
+
+// Create an io_uring (io_uring_setup)
+struct io_uring_params;
+
+FN_EXTERN int posixCompatUringSetup(unsigned int depth, struct io_uring_params *params);
+
+// Submit io_uring operations and wait for completions (io_uring_enter)
+FN_EXTERN int posixCompatUringEnter(int fd, unsigned int submitTotal, unsigned int waitTotal, unsigned int flags);
+
+#endif // HAVE_IO_URING
+
+// Sync all file systems (sync)
+FN_EXTERN void posixCompatSync(void);
+
+// Sync the file system containing the file descriptor (syncfs)
+FN_EXTERN int posixCompatSyncFs(int fd);
+
+#endif
@@ -3,19 +3,43 @@ Posix Storage Read
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include <errno.h>
 #include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "common/debug.h"
+#include "common/io/io.h"
 #include "common/io/read.h"
 #include "common/log.h"
 #include "common/type/object.h"
+#include "storage/posix/compat.h"
 #include "storage/posix/read.h"
 #include "storage/read.intern.h"
 
+/***********************************************************************************************************************************
+Alignment of the memory, offset, and size of direct reads. This is the largest logical block size in common use.
+***********************************************************************************************************************************/
+#define STORAGE_POSIX_DIRECT_ALIGN                                  4096
+
 /***********************************************************************************************************************************
 Object types
 ***********************************************************************************************************************************/
+#ifdef HAVE_IO_URING
+
+typedef struct StorageReadPosixSlot
+{
+    Buffer *buffer;                                                 // Buffer the kernel reads into
+    struct iovec iov;                                               // Vector passed to io_uring
+    size_t size;                                                    // Requested read size (0 when no read is queued)
+    size_t consumed;                                                // Bytes copied to the caller
+    int result;                                                     // Bytes read or -errno
+    bool done;                                                      // Has the read completed?
+} StorageReadPosixSlot;
+
+#endif // HAVE_IO_URING
+
 typedef struct StorageReadPosix
 {
     StorageReadInterface interface;                                 // Interface
@@ -25,6 +49,25 @@ typedef struct StorageReadPosix
     uint64_t current;                                               // Current bytes read from file
     uint64_t limit;                                                 // Limit bytes to be read from file (UINT64_MAX for no limit)
     bool eof;
+    bool direct;                                                    // Bypass the page cache?
+    bool dropCache;                                                 // Drop pages from the page cache after reading?
+
+    Buffer *directBuffer;                                           // Buffer for direct reads (NULL when not reading directly)
+    unsigned char *directPtr;                                       // Aligned start of the direct read buffer
+    size_t directSize;                                              // Size of each direct read
+    uint64_t directPos;                                             // Position in the file of the next direct read
+    size_t directSkip;                                              // Bytes before the offset to skip after the first direct read
+    size_t directUsed;                                              // Bytes in the direct read buffer
+    size_t directConsumed;                                          // Bytes in the direct read buffer copied to the caller
+    bool directEof;                                                 // Has the last direct read been done?
+
+#ifdef HAVE_IO_URING
+    PosixUring *uring;                                              // io_uring used to read ahead (NULL when not reading ahead)
+    StorageReadPosixSlot *slotList;                                 // Read ahead slots, consumed in order
+    unsigned int slotTotal;                                         // Total read ahead slots
+    unsigned int slotIdx;                                           // Slot to be consumed next
+    uint64_t queued;                                                // Bytes queued for read (relative to the offset)
+#endif
 } StorageReadPosix;
 
 /***********************************************************************************************************************************
@@ -35,6 +78,241 @@ Macros for function logging
 #define FUNCTION_LOG_STORAGE_READ_POSIX_FORMAT(value, buffer, bufferSize)                                                          \
     objNameToLog(value, "StorageReadPosix", buffer, bufferSize)
 
+/***********************************************************************************************************************************
+Queue a read ahead into a slot at the next offset
+***********************************************************************************************************************************/
+#ifdef HAVE_IO_URING
+
+static void
+storageReadPosixUringQueue(StorageReadPosix *const this, const unsigned int slotIdx)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_POSIX, this);
+        FUNCTION_LOG_PARAM(UINT, slotIdx);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->uring != NULL);
+    ASSERT(slotIdx < this->slotTotal);
+
+    StorageReadPosixSlot *const slot = &this->slotList[slotIdx];
+
+    // Reduce the read size if it would exceed the limit
+    slot->size = bufSize(slot->buffer);
+    slot->consumed = 0;
+    slot->done = false;
+
+    if (this->queued + slot->size > this->limit)
+        slot->size = (size_t)(this->limit - this->queued);
+
+    // Nothing is queued when the limit has been reached
+    if (slot->size != 0)
+    {
+        slot->iov = (struct iovec){.iov_base = bufPtr(slot->buffer), .iov_len = slot->size};
+        posixUringQueue(this->uring, posixUringOpRead, this->fd, &slot->iov, this->interface.offset + this->queued, slotIdx);
+        this->queued += slot->size;
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Start reading ahead with io_uring
+
+Only files that need more than one read are read ahead since there is nothing to gain for small files. The size of the file is
+used to decide how many reads to queue but is not used to detect EOF, so files that are growing are read the same way as without
+io_uring.
+***********************************************************************************************************************************/
+static void
+storageReadPosixUringOpen(StorageReadPosix *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_POSIX, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->uring == NULL);
+
+    this->uring = storagePosixUringClaim(this->storage);
+
+    if (this->uring != NULL)
+    {
+        struct stat statFile;
+
+        THROW_ON_SYS_ERROR_FMT(
+            fstat(this->fd, &statFile) == -1, FileOpenError, STORAGE_ERROR_INFO, strZ(this->interface.name));
+
+        // Determine how much will be read
+        uint64_t size = (uint64_t)statFile.st_size > this->interface.offset ?
+            (uint64_t)statFile.st_size - this->interface.offset : 0;
+
+        if (size > this->limit)
+            size = this->limit;
+
+        // Release the io_uring if the file can be read with a single read
+        if (size < ioBufferSize())
+        {
+            storagePosixUringRelease(this->storage);
+            this->uring = NULL;
+        }
+        // Else queue reads. An extra read is queued to detect EOF when the file size is a multiple of the buffer size.
+        else
+        {
+            const uint64_t slotTotal = size / ioBufferSize() + 1;
+
+            this->slotTotal =
+                slotTotal > posixUringDepth(this->uring) ? posixUringDepth(this->uring) : (unsigned int)slotTotal;
+
+            MEM_CONTEXT_OBJ_BEGIN(this)
+            {
+                this->slotList = memNew(sizeof(StorageReadPosixSlot) * this->slotTotal);
+
+                for (unsigned int slotIdx = 0; slotIdx < this->slotTotal; slotIdx++)
+                {
+                    this->slotList[slotIdx] = (StorageReadPosixSlot){.buffer = bufNew(ioBufferSize())};
+                    storageReadPosixUringQueue(this, slotIdx);
+                }
+            }
+            MEM_CONTEXT_OBJ_END();
+
+            posixUringSubmit(this->uring);
+        }
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Read from the next read ahead slot
+***********************************************************************************************************************************/
+static size_t
+storageReadPosixUring(StorageReadPosix *const this, Buffer *const buffer)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_POSIX, this);
+        FUNCTION_LOG_PARAM(BUFFER, buffer);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->uring != NULL);
+    ASSERT(buffer != NULL && !bufFull(buffer));
+
+    StorageReadPosixSlot *const slot = &this->slotList[this->slotIdx];
+    ASSERT(slot->size != 0);
+
+    // Wait for the slot read to complete. Reads for other slots may complete first.
+    while (!slot->done)
+    {
+        const PosixUringResult result = posixUringWait(this->uring);
+
+        this->slotList[result.tag].result = result.result;
+        this->slotList[result.tag].done = true;
+    }
+
+    // Error occurred during read
+    if (slot->result < 0)
+    {
+        errno = -slot->result;
+        THROW_SYS_ERROR_FMT(FileReadError, "unable to read '%s'", strZ(this->interface.name));
+    }
+
+    // Copy as much of the slot as will fit in the buffer
+    size_t result = (size_t)slot->result - slot->consumed;
+
+    if (result > bufRemains(buffer))
+        result = bufRemains(buffer);
+
+    memcpy(bufRemainsPtr(buffer), bufPtr(slot->buffer) + slot->consumed, result);
+    bufUsedInc(buffer, result);
+    slot->consumed += result;
+    this->current += result;
+
+    // When the slot has been consumed then a short read or reaching the limit is EOF, else queue the next read into the slot
+    if (slot->consumed == (size_t)slot->result)
+    {
+        // Release the io_uring at EOF so it can be used by other reads and writes before this file is closed
+        if ((size_t)slot->result != slot->size || this->current == this->limit)
+        {
+            this->eof = true;
+
+            posixUringDrain(this->uring);
+            storagePosixUringRelease(this->storage);
+            this->uring = NULL;
+        }
+        else
+        {
+            storageReadPosixUringQueue(this, this->slotIdx);
+            posixUringSubmit(this->uring);
+
+            this->slotIdx = (this->slotIdx + 1) % this->slotTotal;
+        }
+    }
+
+    FUNCTION_LOG_RETURN(SIZE, result);
+}
+
+#endif // HAVE_IO_URING
+
+/***********************************************************************************************************************************
+Read with direct I/O
+
+Direct reads must be aligned so the file is read in aligned blocks into an aligned buffer and then copied to the caller. Data before
+the offset in the first block and after the limit in the last block are discarded.
+***********************************************************************************************************************************/
+static size_t
+storageReadPosixDirect(StorageReadPosix *const this, Buffer *const buffer)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_POSIX, this);
+        FUNCTION_LOG_PARAM(BUFFER, buffer);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->directBuffer != NULL);
+    ASSERT(buffer != NULL && !bufFull(buffer));
+
+    // Read the next block when the direct read buffer has been consumed
+    if (this->directConsumed == this->directUsed && !this->directEof)
+    {
+        const ssize_t actualBytes = pread(this->fd, this->directPtr, this->directSize, (off_t)this->directPos);
+
+        // Error occurred during read
+        if (actualBytes == -1)
+            THROW_SYS_ERROR_FMT(FileReadError, "unable to read '%s'", strZ(this->interface.name));
+
+        this->directPos += (uint64_t)actualBytes;
+        this->directUsed = (size_t)actualBytes;
+
+        // Skip data before the offset
+        this->directConsumed = this->directSkip < this->directUsed ? this->directSkip : this->directUsed;
+        this->directSkip = 0;
+
+        // A short read is EOF, the same as a regular read
+        if (this->directUsed != this->directSize)
+            this->directEof = true;
+    }
+
+    // Copy as much of the direct read buffer as will fit in the buffer without exceeding the limit
+    size_t result = this->directUsed - this->directConsumed;
+
+    if (result > bufRemains(buffer))
+        result = bufRemains(buffer);
+
+    if (this->current + result > this->limit)
+        result = (size_t)(this->limit - this->current);
+
+    memcpy(bufRemainsPtr(buffer), this->directPtr + this->directConsumed, result);
+    bufUsedInc(buffer, result);
+    this->directConsumed += result;
+    this->current += result;
+
+    // EOF when the limit has been reached or the last block has been consumed
+    if (this->current == this->limit || (this->directEof && this->directConsumed == this->directUsed))
+        this->eof = true;
+
+    FUNCTION_LOG_RETURN(SIZE, result);
+}
+
 /***********************************************************************************************************************************
 Close file descriptor
 ***********************************************************************************************************************************/
@@ -49,6 +327,16 @@ storageReadPosixFreeResource(THIS_VOID)
 
     ASSERT(this != NULL);
 
+#ifdef HAVE_IO_URING
+    // Wait for reads ahead to complete before the file is closed and release the io_uring for use by other reads and writes
+    if (this->uring != NULL)
+    {
+        posixUringDrain(this->uring);
+        storagePosixUringRelease(this->storage);
+        this->uring = NULL;
+    }
+#endif
+
     if (this->fd != -1)
         THROW_ON_SYS_ERROR_FMT(close(this->fd) == -1, FileCloseError, STORAGE_ERROR_READ_CLOSE, strZ(this->interface.name));
 
@@ -70,8 +358,21 @@ storageReadPosixOpen(THIS_VOID)
     ASSERT(this != NULL);
     ASSERT(this->fd == -1);
 
-    // Open the file
-    this->fd = open(strZ(this->interface.name), O_RDONLY, 0);
+    // Open the file with direct I/O to bypass the page cache when requested. Some filesystems do not support direct I/O so open the
+    // file normally when it is rejected and drop pages from the page cache after they have been read instead.
+    bool directOpen = false;
+
+    if (this->direct)
+    {
+        this->fd = posixCompatOpenDirect(strZ(this->interface.name), O_RDONLY);
+        directOpen = this->fd != -1 || errno != EINVAL;
+    }
+
+    if (!directOpen)
+    {
+        this->fd = open(strZ(this->interface.name), O_RDONLY, 0);
+        this->dropCache = this->direct;
+    }
 
     // Handle errors
     if (this->fd == -1)
@@ -90,12 +391,44 @@ storageReadPosixOpen(THIS_VOID)
         // Set free callback to ensure the file descriptor is freed
         memContextCallbackSet(objMemContext(this), storageReadPosixFreeResource, this);
 
-        // Seek to offset
-        if (this->interface.offset != 0)
+        // Allocate an aligned buffer for direct reads. Reads start at the block containing the offset.
+        if (directOpen)
+        {
+            this->directSize = (ioBufferSize() + STORAGE_POSIX_DIRECT_ALIGN - 1) & ~(size_t)(STORAGE_POSIX_DIRECT_ALIGN - 1);
+            this->directPos = this->interface.offset & ~(uint64_t)(STORAGE_POSIX_DIRECT_ALIGN - 1);
+            this->directSkip = (size_t)(this->interface.offset - this->directPos);
+
+            MEM_CONTEXT_OBJ_BEGIN(this)
+            {
+                this->directBuffer = bufNew(this->directSize + STORAGE_POSIX_DIRECT_ALIGN);
+            }
+            MEM_CONTEXT_OBJ_END();
+
+            this->directPtr = (unsigned char *)
+                (((uintptr_t)bufPtr(this->directBuffer) + STORAGE_POSIX_DIRECT_ALIGN - 1) &
+                 ~(uintptr_t)(STORAGE_POSIX_DIRECT_ALIGN - 1));
+        }
+        else
         {
-            THROW_ON_SYS_ERROR_FMT(
-                lseek(this->fd, (off_t)this->interface.offset, SEEK_SET) == -1, FileOpenError, STORAGE_ERROR_READ_SEEK,
-                this->interface.offset, strZ(this->interface.name));
+            // Seek to offset
+            if (this->interface.offset != 0)
+            {
+                THROW_ON_SYS_ERROR_FMT(
+                    lseek(this->fd, (off_t)this->interface.offset, SEEK_SET) == -1, FileOpenError, STORAGE_ERROR_READ_SEEK,
+                    this->interface.offset, strZ(this->interface.name));
+            }
+
+            // Advise the kernel that the file will be read sequentially so it reads ahead more aggressively. When there is a limit
+            // the range to be read is known so the kernel can start reading it now.
+            posixCompatAdvise(this->fd, (off_t)this->interface.offset, 0, posixCompatAdviseSequential);
+
+            if (this->limit != 0 && this->limit != UINT64_MAX)
+                posixCompatAdvise(this->fd, (off_t)this->interface.offset, (off_t)this->limit, posixCompatAdviseWillNeed);
+
+#ifdef HAVE_IO_URING
+            // Start reading ahead
+            storageReadPosixUringOpen(this);
+#endif
         }
     }
 
@@ -124,27 +457,49 @@ storageReadPosix(THIS_VOID, Buffer *const buffer, const bool block)
 
     if (!this->eof)
     {
-        // Determine expected bytes to read. If remaining size in the buffer would exceed the limit then reduce the expected read.
-        size_t expectedBytes = bufRemains(buffer);
+        // Read with direct I/O
+        if (this->directBuffer != NULL)
+            actualBytes = (ssize_t)storageReadPosixDirect(this, buffer);
+        else
+#ifdef HAVE_IO_URING
+        // Read from the read ahead slots
+        if (this->uring != NULL)
+            actualBytes = (ssize_t)storageReadPosixUring(this, buffer);
+        // Else read from the file
+        else
+#endif
+        {
+            // Determine expected bytes to read. If remaining size in the buffer would exceed the limit then reduce the expected
+            // read.
+            size_t expectedBytes = bufRemains(buffer);
 
-        if (this->current + expectedBytes > this->limit)
-            expectedBytes = (size_t)(this->limit - this->current);
+            if (this->current + expectedBytes > this->limit)
+                expectedBytes = (size_t)(this->limit - this->current);
 
-        // Read from file
-        actualBytes = read(this->fd, bufRemainsPtr(buffer), expectedBytes);
+            // Read from file
+            actualBytes = read(this->fd, bufRemainsPtr(buffer), expectedBytes);
 
-        // Error occurred during read
-        if (actualBytes == -1)
-            THROW_SYS_ERROR_FMT(FileReadError, "unable to read '%s'", strZ(this->interface.name));
+            // Error occurred during read
+            if (actualBytes == -1)
+                THROW_SYS_ERROR_FMT(FileReadError, "unable to read '%s'", strZ(this->interface.name));
 
-        // Update amount of buffer used
-        bufUsedInc(buffer, (size_t)actualBytes);
-        this->current += (uint64_t)actualBytes;
+            // Update amount of buffer used
+            bufUsedInc(buffer, (size_t)actualBytes);
+            this->current += (uint64_t)actualBytes;
 
-        // If less data than expected was read or the limit has been reached then EOF. The file may not actually be EOF but we are
-        // not concerned with files that are growing. Just read up to the point where the file is being extended.
-        if ((size_t)actualBytes != expectedBytes || this->current == this->limit)
-            this->eof = true;
+            // If less data than expected was read or the limit has been reached then EOF. The file may not actually be EOF but we
+            // are not concerned with files that are growing. Just read up to the point where the file is being extended.
+            if ((size_t)actualBytes != expectedBytes || this->current == this->limit)
+                this->eof = true;
+        }
+
+        // Drop the pages that were just read from the page cache
+        if (this->dropCache && actualBytes > 0)
+        {
+            posixCompatAdvise(
+                this->fd, (off_t)(this->interface.offset + this->current) - actualBytes, (off_t)actualBytes,
+                posixCompatAdviseDontNeed);
+        }
     }
 
     FUNCTION_LOG_RETURN(SIZE, (size_t)actualBytes);
@@ -209,23 +564,25 @@ storageReadPosixFd(const THIS_VOID)
 FN_EXTERN StorageRead *
 storageReadPosixNew(
     StoragePosix *const storage, const String *const name, const bool ignoreMissing, const uint64_t offset,
-    const Variant *const limit)
+    const Variant *const limit, const bool direct)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STRING, name);
         FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
         FUNCTION_LOG_PARAM(UINT64, offset);
         FUNCTION_LOG_PARAM(VARIANT, limit);
+        FUNCTION_LOG_PARAM(BOOL, direct);
     FUNCTION_LOG_END();
 
     ASSERT(name != NULL);
 
-    OBJ_NEW_BEGIN(StorageReadPosix, .childQty = MEM_CONTEXT_QTY_MAX, .callbackQty = 1)
+    OBJ_NEW_BEGIN(StorageReadPosix, .childQty = MEM_CONTEXT_QTY_MAX, .allocQty = 1, .callbackQty = 1)
     {
         *this = (StorageReadPosix)
         {
             .storage = storage,
             .fd = -1,
+            .direct = direct,
 
             // Rather than enable/disable limit checking just use a big number when there is no limit. We can feel pretty confident
             // that no files will be > UINT64_MAX in size. This is a copy of the interface limit but it simplifies the code during
@@ -16,6 +16,7 @@ Posix Storage
 #include "common/log.h"
 #include "common/regExp.h"
 #include "common/user.h"
+#include "storage/posix/compat.h"
 #include "storage/posix/read.h"
 #include "storage/posix/storage.intern.h"
 #include "storage/posix/write.h"
@@ -33,6 +34,13 @@ Object type
 struct StoragePosix
 {
     STORAGE_COMMON_MEMBER;
+    bool ioUring;                                                   // Use io_uring for reads and writes when available?
+    bool direct;                                                    // Bypass the page cache for reads and writes?
+
+#ifdef HAVE_IO_URING
+    PosixUring *uring;                                              // io_uring shared by reads and writes (created on first use)
+    bool uringClaimed;                                              // Is the io_uring claimed by a read or write?
+#endif
 };
 
 /**********************************************************************************************************************************/
@@ -357,7 +365,7 @@ storagePosixNewRead(THIS_VOID, const String *const file, const bool ignoreMissin
     ASSERT(this != NULL);
     ASSERT(file != NULL);
 
-    FUNCTION_LOG_RETURN(STORAGE_READ, storageReadPosixNew(this, file, ignoreMissing, param.offset, param.limit));
+    FUNCTION_LOG_RETURN(STORAGE_READ, storageReadPosixNew(this, file, ignoreMissing, param.offset, param.limit, this->direct));
 }
 
 /**********************************************************************************************************************************/
@@ -388,7 +396,8 @@ storagePosixNewWrite(THIS_VOID, const String *const file, const StorageInterface
         STORAGE_WRITE,
         storageWritePosixNew(
             this, file, param.modeFile, param.modePath, param.user, param.group, param.timeModified, param.createPath,
-            param.syncFile, this->interface.pathSync != NULL ? param.syncPath : false, param.atomic, param.truncate));
+            param.syncFile, this->interface.pathSync != NULL ? param.syncPath : false, param.atomic, param.truncate,
+            this->direct));
 }
 
 /**********************************************************************************************************************************/
@@ -510,7 +519,7 @@ storagePosixPathSync(THIS_VOID, const String *const path, const StorageInterface
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_POSIX, this);
         FUNCTION_LOG_PARAM(STRING, path);
-        (void)param;                                                // No parameters are used
+        FUNCTION_LOG_PARAM(BOOL, param.fileSystem);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
@@ -529,8 +538,24 @@ storagePosixPathSync(THIS_VOID, const String *const path, const StorageInterface
     }
     else
     {
-        // Attempt to sync the directory
-        if (fsync(fd) == -1)
+        // Attempt to sync the file system or the directory. When syncfs() is not available then sync() is used to sync all file
+        // systems, which is still much faster than syncing files individually.
+        int result;
+
+        if (param.fileSystem)
+        {
+            result = posixCompatSyncFs(fd);
+
+            if (result == -1 && errno == ENOSYS)
+            {
+                posixCompatSync();
+                result = 0;
+            }
+        }
+        else
+            result = fsync(fd);
+
+        if (result == -1)
         {
             const int errNo = errno;
 
@@ -571,6 +596,67 @@ storagePosixRemove(THIS_VOID, const String *const file, const StorageInterfaceRe
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/**********************************************************************************************************************************/
+#ifdef HAVE_IO_URING
+
+FN_EXTERN PosixUring *
+storagePosixUringClaim(StoragePosix *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_POSIX, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    PosixUring *result = NULL;
+
+    if (this->ioUring && !this->uringClaimed)
+    {
+        // Create the io_uring on first use. If it cannot be created then disable io_uring for this storage.
+        if (this->uring == NULL)
+        {
+            MEM_CONTEXT_OBJ_BEGIN(this)
+            {
+                this->uring = posixUringNew(STORAGE_POSIX_URING_DEPTH);
+            }
+            MEM_CONTEXT_OBJ_END();
+
+            if (this->uring == NULL)                                                                                // {vm_covered}
+            {
+                LOG_DETAIL("io_uring is not available, using regular system calls");                               // {vm_covered}
+                this->ioUring = false;                                                                              // {vm_covered}
+            }
+        }
+
+        if (this->uring != NULL)
+        {
+            this->uringClaimed = true;
+            result = this->uring;
+        }
+    }
+
+    FUNCTION_LOG_RETURN(POSIX_URING, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+storagePosixUringRelease(StoragePosix *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_POSIX, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->uringClaimed);
+    ASSERT(posixUringInFlight(this->uring) == 0);
+
+    this->uringClaimed = false;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+#endif // HAVE_IO_URING
+
 /**********************************************************************************************************************************/
 static const StorageInterface storageInterfacePosix =
 {
@@ -591,7 +677,8 @@ static const StorageInterface storageInterfacePosix =
 FN_EXTERN Storage *
 storagePosixNewInternal(
     const StringId type, const String *const path, const mode_t modeFile, const mode_t modePath, const bool write,
-    StoragePathExpressionCallback pathExpressionFunction, const bool pathSync)
+    StoragePathExpressionCallback pathExpressionFunction, const bool pathSync, const bool ioUring,
+    const bool direct)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING_ID, type);
@@ -601,6 +688,8 @@ storagePosixNewInternal(
         FUNCTION_LOG_PARAM(BOOL, write);
         FUNCTION_LOG_PARAM(FUNCTIONP, pathExpressionFunction);
         FUNCTION_LOG_PARAM(BOOL, pathSync);
+        FUNCTION_LOG_PARAM(BOOL, ioUring);
+        FUNCTION_LOG_PARAM(BOOL, direct);
     FUNCTION_LOG_END();
 
     ASSERT(type != 0);
@@ -617,6 +706,8 @@ storagePosixNewInternal(
         *this = (StoragePosix)
         {
             .interface = storageInterfacePosix,
+            .ioUring = ioUring,
+            .direct = direct,
         };
 
         // Disable path sync when not supported
@@ -643,11 +734,14 @@ storagePosixNew(const String *const path, const StoragePosixNewParam param)
         FUNCTION_LOG_PARAM(MODE, param.modePath);
         FUNCTION_LOG_PARAM(BOOL, param.write);
         FUNCTION_LOG_PARAM(FUNCTIONP, param.pathExpressionFunction);
+        FUNCTION_LOG_PARAM(BOOL, param.ioUring);
+        FUNCTION_LOG_PARAM(BOOL, param.direct);
     FUNCTION_LOG_END();
 
     FUNCTION_LOG_RETURN(
         STORAGE,
         storagePosixNewInternal(
             STORAGE_POSIX_TYPE, path, param.modeFile == 0 ? STORAGE_MODE_FILE_DEFAULT : param.modeFile,
-            param.modePath == 0 ? STORAGE_MODE_PATH_DEFAULT : param.modePath, param.write, param.pathExpressionFunction, true));
+            param.modePath == 0 ? STORAGE_MODE_PATH_DEFAULT : param.modePath, param.write, param.pathExpressionFunction, true,
+            param.ioUring, param.direct));
 }
@@ -21,6 +21,8 @@ typedef struct StoragePosixNewParam
     mode_t modeFile;
     mode_t modePath;
     StoragePathExpressionCallback *pathExpressionFunction;
+    bool ioUring;
+    bool direct;
 } StoragePosixNewParam;
 
 #define storagePosixNewP(path, ...)                                                                                                \
@@ -5,18 +5,38 @@ Posix Storage Internal
 #define STORAGE_POSIX_STORAGE_INTERN_H
 
 #include "storage/posix/storage.h"
+#include "storage/posix/uring.h"
 
 /***********************************************************************************************************************************
 Object type
 ***********************************************************************************************************************************/
 typedef struct StoragePosix StoragePosix;
 
+/***********************************************************************************************************************************
+Maximum reads or writes of a single file kept in flight when io_uring is enabled
+***********************************************************************************************************************************/
+#define STORAGE_POSIX_URING_DEPTH                                   8
+
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
 FN_EXTERN Storage *storagePosixNewInternal(
     StringId type, const String *path, mode_t modeFile, mode_t modePath, bool write,
-    StoragePathExpressionCallback pathExpressionFunction, bool pathSync);
+    StoragePathExpressionCallback pathExpressionFunction, bool pathSync, bool ioUring, bool direct);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+#ifdef HAVE_IO_URING
+
+// Claim the io_uring for exclusive use by a read or write. NULL is returned when io_uring is disabled, not supported by the kernel,
+// or already claimed by another read or write, in which case regular system calls should be used.
+FN_EXTERN PosixUring *storagePosixUringClaim(StoragePosix *this);
+
+// Release a claimed io_uring. All operations must have completed.
+FN_EXTERN void storagePosixUringRelease(StoragePosix *this);
+
+#endif // HAVE_IO_URING
 
 /***********************************************************************************************************************************
 Macros for function logging
@@ -0,0 +1,310 @@
+/***********************************************************************************************************************************
+Posix Storage io_uring
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#ifdef HAVE_IO_URING
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "common/debug.h"
+#include "common/log.h"
+#include "storage/posix/compat.h"
+#include "storage/posix/uring.h"
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct PosixUring
+{
+    PosixUringPub pub;                                              // Publicly accessible variables
+    int fd;                                                         // io_uring file descriptor
+    unsigned int queued;                                            // Operations queued but not yet submitted
+
+    void *sqRing;                                                   // Submission ring mapping
+    size_t sqRingSize;                                              // Submission ring mapping size
+    void *cqRing;                                                   // Completion ring mapping (may be the same as sqRing)
+    size_t cqRingSize;                                              // Completion ring mapping size
+    struct io_uring_sqe *sqeList;                                   // Submission queue entries
+    size_t sqeListSize;                                             // Submission queue entries mapping size
+
+    unsigned int *sqTail;                                           // Submission ring tail (written by us)
+    const unsigned int *sqMask;                                     // Submission ring mask
+    unsigned int *sqArray;                                          // Submission ring index array
+    unsigned int *cqHead;                                           // Completion ring head (written by us)
+    const unsigned int *cqTail;                                     // Completion ring tail (written by the kernel)
+    const unsigned int *cqMask;                                     // Completion ring mask
+    const struct io_uring_cqe *cqeList;                             // Completion queue entries
+};
+
+/***********************************************************************************************************************************
+Unmap the rings and close the file descriptor
+***********************************************************************************************************************************/
+static void
+posixUringFreeResource(THIS_VOID)
+{
+    THIS(PosixUring);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(POSIX_URING, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    // Make sure the kernel is not referencing any memory that will be freed after this
+    posixUringDrain(this);
+
+    if (this->sqeList != NULL && this->sqeList != MAP_FAILED)
+        munmap(this->sqeList, this->sqeListSize);
+
+    if (this->cqRing != NULL && this->cqRing != MAP_FAILED && this->cqRing != this->sqRing)
+        munmap(this->cqRing, this->cqRingSize);
+
+    if (this->sqRing != NULL && this->sqRing != MAP_FAILED)
+        munmap(this->sqRing, this->sqRingSize);
+
+    close(this->fd);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Submit queued operations and optionally wait for completions
+***********************************************************************************************************************************/
+static void
+posixUringEnter(PosixUring *const this, const unsigned int waitTotal)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(POSIX_URING, this);
+        FUNCTION_LOG_PARAM(UINT, waitTotal);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    const int result = posixCompatUringEnter(this->fd, this->queued, waitTotal, waitTotal > 0 ? IORING_ENTER_GETEVENTS : 0);
+
+    // Interrupted system calls are retried by the caller since there is no completion yet
+    if (result == -1)
+    {
+        if (errno != EINTR)                                                                                         // {vm_covered}
+            THROW_SYS_ERROR(KernelError, "unable to submit io_uring operations");                                   // {vm_covered}
+    }
+    else
+        this->queued -= (unsigned int)result;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN PosixUring *
+posixUringNew(const unsigned int depth)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(UINT, depth);
+    FUNCTION_LOG_END();
+
+    ASSERT(depth > 0);
+
+    PosixUring *this = NULL;
+
+    // Create the ring. If this fails then io_uring is not available and the caller will fall back to regular system calls.
+    struct io_uring_params params = {0};
+    const int fd = posixCompatUringSetup(depth, &params);
+
+    if (fd != -1)
+    {
+        OBJ_NEW_BASE_BEGIN(PosixUring, .childQty = MEM_CONTEXT_QTY_MAX, .callbackQty = 1)
+        {
+            this = OBJ_NEW_ALLOC();
+
+            *this = (PosixUring)
+            {
+                .pub =
+                {
+                    .depth = depth,
+                },
+                .fd = fd,
+                .sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int),
+                .cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe),
+                .sqeListSize = params.sq_entries * sizeof(struct io_uring_sqe),
+            };
+
+            memContextCallbackSet(objMemContext(this), posixUringFreeResource, this);
+
+            // Newer kernels map both rings with a single mmap()
+            if (params.features & IORING_FEAT_SINGLE_MMAP)
+            {
+                if (this->cqRingSize > this->sqRingSize)
+                    this->sqRingSize = this->cqRingSize;
+
+                this->cqRingSize = this->sqRingSize;
+            }
+
+            // Map the rings and the submission queue entries. Mapping can fail even though the ring was created, e.g. when the
+            // locked memory limit is too low, so stop at the first failure.
+            this->sqRing = mmap(NULL, this->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, IORING_OFF_SQ_RING);
+
+            if (this->sqRing != MAP_FAILED)                                      // {uncovered_branch - mmap does not fail in tests}
+            {
+                if (params.features & IORING_FEAT_SINGLE_MMAP)
+                    this->cqRing = this->sqRing;
+                else
+                {
+                    this->cqRing = mmap(                                                                            // {vm_covered}
+                        NULL, this->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, IORING_OFF_CQ_RING);        // {vm_covered}
+                }
+
+                if (this->cqRing != MAP_FAILED)                                  // {uncovered_branch - mmap does not fail in tests}
+                    this->sqeList = mmap(NULL, this->sqeListSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, IORING_OFF_SQES);
+            }
+
+            // Locate the ring fields
+            if (this->sqeList != NULL && this->sqeList != MAP_FAILED)            // {uncovered_branch - mmap does not fail in tests}
+            {
+                this->sqTail = (unsigned int *)((char *)this->sqRing + params.sq_off.tail);
+                this->sqMask = (unsigned int *)((char *)this->sqRing + params.sq_off.ring_mask);
+                this->sqArray = (unsigned int *)((char *)this->sqRing + params.sq_off.array);
+                this->cqHead = (unsigned int *)((char *)this->cqRing + params.cq_off.head);
+                this->cqTail = (unsigned int *)((char *)this->cqRing + params.cq_off.tail);
+                this->cqMask = (unsigned int *)((char *)this->cqRing + params.cq_off.ring_mask);
+                this->cqeList = (struct io_uring_cqe *)((char *)this->cqRing + params.cq_off.cqes);
+            }
+        }
+        OBJ_NEW_END();
+
+        // If mapping failed then free the ring, which unmaps what was mapped and closes the file descriptor, so the caller will
+        // fall back to regular system calls
+        if (this->sqeList == NULL || this->sqeList == MAP_FAILED)                // {uncovered_branch - mmap does not fail in tests}
+        {
+            posixUringFree(this);                                                       // {uncovered - mmap does not fail in tests}
+            this = NULL;                                                                // {uncovered - mmap does not fail in tests}
+        }
+    }
+
+    FUNCTION_LOG_RETURN(POSIX_URING, this);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+posixUringQueue(
+    PosixUring *const this, const PosixUringOp op, const int fd, const struct iovec *const iov, const uint64_t offset,
+    const uint64_t tag)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(POSIX_URING, this);
+        FUNCTION_LOG_PARAM(ENUM, op);
+        FUNCTION_LOG_PARAM(INT, fd);
+        FUNCTION_LOG_PARAM_P(VOID, iov);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(UINT64, tag);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(fd != -1);
+    ASSERT(iov != NULL);
+    ASSERT(this->pub.inFlight < this->pub.depth);
+
+    // Fill the next free entry. Only this process adds entries so the tail does not need to be loaded atomically.
+    const unsigned int tail = *this->sqTail;
+    const unsigned int index = tail & *this->sqMask;
+    struct io_uring_sqe *const sqe = &this->sqeList[index];
+
+    // Vectored operations are used since they are supported by all kernels with io_uring
+    *sqe = (struct io_uring_sqe)
+    {
+        .opcode = (uint8_t)(op == posixUringOpRead ? IORING_OP_READV : IORING_OP_WRITEV),
+        .fd = fd,
+        .off = offset,
+        .addr = (uint64_t)(uintptr_t)iov,
+        .len = 1,
+        .user_data = tag,
+    };
+
+    this->sqArray[index] = index;
+
+    // Make the entry visible to the kernel
+    __atomic_store_n(this->sqTail, tail + 1, __ATOMIC_RELEASE);
+
+    this->queued++;
+    this->pub.inFlight++;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+posixUringSubmit(PosixUring *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(POSIX_URING, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    // Retry until all queued operations have been accepted by the kernel
+    while (this->queued > 0)
+        posixUringEnter(this, 0);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN PosixUringResult
+posixUringWait(PosixUring *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(POSIX_URING, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->pub.inFlight > 0);
+
+    PosixUringResult result;
+
+    do
+    {
+        // Check for a completion. Only this process consumes completions so the head does not need to be loaded atomically.
+        const unsigned int head = *this->cqHead;
+
+        if (head != __atomic_load_n(this->cqTail, __ATOMIC_ACQUIRE))
+        {
+            const struct io_uring_cqe *const cqe = &this->cqeList[head & *this->cqMask];
+
+            result = (PosixUringResult){.tag = cqe->user_data, .result = cqe->res};
+
+            // Release the entry back to the kernel
+            __atomic_store_n(this->cqHead, head + 1, __ATOMIC_RELEASE);
+            this->pub.inFlight--;
+
+            break;
+        }
+
+        // Submit queued operations and wait for a completion
+        posixUringEnter(this, 1);
+    }
+    while (true);
+
+    FUNCTION_LOG_RETURN_STRUCT(result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+posixUringDrain(PosixUring *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(POSIX_URING, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    while (this->pub.inFlight > 0)
+        posixUringWait(this);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+#endif // HAVE_IO_URING
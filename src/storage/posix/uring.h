@@ -0,0 +1,106 @@
+/***********************************************************************************************************************************
+Posix Storage io_uring
+
+Minimal io_uring submission/completion ring used by the posix read and write drivers to keep several reads or writes of the same
+file in flight. The ring is driven directly with the io_uring_setup()/io_uring_enter() system calls so there is no dependency on
+liburing.
+
+The caller is responsible for never having more operations in flight than the depth requested at creation. Completions may be
+returned in any order so each operation is submitted with a tag that the caller uses to match the completion to the operation.
+***********************************************************************************************************************************/
+#ifdef HAVE_IO_URING
+
+#ifndef STORAGE_POSIX_URING_H
+#define STORAGE_POSIX_URING_H
+
+#include <sys/uio.h>
+
+#include "common/type/object.h"
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct PosixUring PosixUring;
+
+/***********************************************************************************************************************************
+Operation types
+***********************************************************************************************************************************/
+typedef enum
+{
+    posixUringOpRead,                                               // Read into iovec at offset
+    posixUringOpWrite,                                              // Write from iovec at offset
+} PosixUringOp;
+
+// Result of a completed operation
+typedef struct PosixUringResult
+{
+    uint64_t tag;                                                   // Tag passed when the operation was submitted
+    int result;                                                     // Bytes transferred or -errno on error
+} PosixUringResult;
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+// Returns NULL when io_uring is not available, e.g. the kernel is too old or io_uring has been disabled
+FN_EXTERN PosixUring *posixUringNew(unsigned int depth);
+
+/***********************************************************************************************************************************
+Getters/Setters
+***********************************************************************************************************************************/
+typedef struct PosixUringPub
+{
+    unsigned int depth;                                             // Maximum operations in flight
+    unsigned int inFlight;                                          // Operations submitted but not yet completed
+} PosixUringPub;
+
+// Maximum operations in flight
+FN_INLINE_ALWAYS unsigned int
+posixUringDepth(const PosixUring *const this)
+{
+    return THIS_PUB(PosixUring)->depth;
+}
+
+// Operations submitted but not yet completed
+FN_INLINE_ALWAYS unsigned int
+posixUringInFlight(const PosixUring *const this)
+{
+    return THIS_PUB(PosixUring)->inFlight;
+}
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Queue an operation. The iovec and the memory it references must remain valid until the operation completes. Queued operations are
+// passed to the kernel by posixUringSubmit() or posixUringWait().
+FN_EXTERN void posixUringQueue(PosixUring *this, PosixUringOp op, int fd, const struct iovec *iov, uint64_t offset, uint64_t tag);
+
+// Submit queued operations without waiting for completions
+FN_EXTERN void posixUringSubmit(PosixUring *this);
+
+// Submit queued operations and wait for the next completion
+FN_EXTERN PosixUringResult posixUringWait(PosixUring *this);
+
+// Wait for all operations in flight to complete and discard the results. Used to make sure the kernel is no longer referencing
+// memory before it is freed, so errors are ignored.
+FN_EXTERN void posixUringDrain(PosixUring *this);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+FN_INLINE_ALWAYS void
+posixUringFree(PosixUring *const this)
+{
+    objFree(this);
+}
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+#define FUNCTION_LOG_POSIX_URING_TYPE                                                                                              \
+    PosixUring *
+#define FUNCTION_LOG_POSIX_URING_FORMAT(value, buffer, bufferSize)                                                                 \
+    objNameToLog(value, "PosixUring", buffer, bufferSize)
+
+#endif
+
+#endif // HAVE_IO_URING
@@ -3,6 +3,7 @@ Posix Storage File write
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -13,12 +14,38 @@ Posix Storage File write
 #include "common/log.h"
 #include "common/type/object.h"
 #include "common/user.h"
+#include "storage/posix/compat.h"
 #include "storage/posix/write.h"
 #include "storage/write.intern.h"
 
+/***********************************************************************************************************************************
+Maximum bytes to copy with a single call to copy_file_range()
+***********************************************************************************************************************************/
+#define STORAGE_POSIX_COPY_SIZE_MAX                                 ((size_t)1024 * 1024 * 1024)
+
 /***********************************************************************************************************************************
 Object type
 ***********************************************************************************************************************************/
+#ifdef HAVE_IO_URING
+
+typedef struct StorageWritePosixSlot
+{
+    Buffer *buffer;                                                 // Copy of the data being written
+    struct iovec iov;                                               // Vector passed to io_uring
+    uint64_t offset;                                                // Offset of the write in the file
+    bool queued;                                                    // Is the write in flight?
+} StorageWritePosixSlot;
+
+typedef struct StorageWritePosixUring
+{
+    PosixUring *ring;                                               // Claimed io_uring (NULL when writing directly)
+    StorageWritePosixSlot slotList[STORAGE_POSIX_URING_DEPTH];      // Write slots, reused in order
+    unsigned int slotIdx;                                           // Slot to be used for the next write
+    uint64_t offset;                                                // Offset of the next write in the file
+} StorageWritePosixUring;
+
+#endif // HAVE_IO_URING
+
 typedef struct StorageWritePosix
 {
     StorageWriteInterface interface;                                // Interface
@@ -27,6 +54,12 @@ typedef struct StorageWritePosix
     const String *nameTmp;
     const String *path;
     int fd;                                                         // File descriptor
+    bool direct;                                                    // Bypass the page cache?
+
+#ifdef HAVE_IO_URING
+    StorageWritePosixUring *uring;                                  // io_uring write state (allocated separately so the fd
+                                                                    // getter can switch back to direct writes)
+#endif
 } StorageWritePosix;
 
 /***********************************************************************************************************************************
@@ -44,6 +77,119 @@ Since open is called more than once use constants to make sure these parameters
 ***********************************************************************************************************************************/
 #define FILE_OPEN_PURPOSE                                           "write"
 
+/***********************************************************************************************************************************
+Check a completed write
+***********************************************************************************************************************************/
+#ifdef HAVE_IO_URING
+
+static void
+storageWritePosixUringComplete(const StorageWritePosix *const this, const PosixUringResult result)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_WRITE_POSIX, this);
+        FUNCTION_LOG_PARAM(UINT64, result.tag);
+        FUNCTION_LOG_PARAM(INT, result.result);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(result.tag < STORAGE_POSIX_URING_DEPTH);
+
+    StorageWritePosixSlot *const slot = &this->uring->slotList[result.tag];
+    ASSERT(slot->queued);
+
+    slot->queued = false;
+
+    // Error when the write failed or was short, the same as a direct write
+    if (result.result < 0 || (size_t)result.result != slot->iov.iov_len)
+    {
+        if (result.result < 0)
+            errno = -result.result;
+
+        THROW_SYS_ERROR_FMT(FileWriteError, "unable to write '%s'", strZ(this->nameTmp));
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Queue a write with io_uring
+***********************************************************************************************************************************/
+static void
+storageWritePosixUring(StorageWritePosix *const this, const Buffer *const buffer)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_WRITE_POSIX, this);
+        FUNCTION_LOG_PARAM(BUFFER, buffer);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->uring->ring != NULL);
+    ASSERT(buffer != NULL);
+
+    StorageWritePosixSlot *const slot = &this->uring->slotList[this->uring->slotIdx];
+
+    // Wait for the prior write from the slot to complete. Writes from other slots may complete first.
+    while (slot->queued)
+        storageWritePosixUringComplete(this, posixUringWait(this->uring->ring));
+
+    // Copy the data since the caller may reuse the buffer before the write completes
+    if (slot->buffer == NULL)
+    {
+        MEM_CONTEXT_OBJ_BEGIN(this)
+        {
+            slot->buffer = bufNew(bufUsed(buffer));
+        }
+        MEM_CONTEXT_OBJ_END();
+    }
+
+    bufUsedZero(slot->buffer);
+    bufCat(slot->buffer, buffer);
+
+    // Queue the write
+    slot->iov = (struct iovec){.iov_base = bufPtr(slot->buffer), .iov_len = bufUsed(slot->buffer)};
+    slot->offset = this->uring->offset;
+    slot->queued = true;
+
+    posixUringQueue(this->uring->ring, posixUringOpWrite, this->fd, &slot->iov, slot->offset, this->uring->slotIdx);
+    posixUringSubmit(this->uring->ring);
+
+    this->uring->slotIdx = (this->uring->slotIdx + 1) % STORAGE_POSIX_URING_DEPTH;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Wait for writes in flight to complete and release the io_uring. Further writes are made directly to the file.
+***********************************************************************************************************************************/
+static void
+storageWritePosixUringFinish(const StorageWritePosix *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_WRITE_POSIX, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    if (this->uring->ring != NULL)
+    {
+        // Check every completion so write errors are not lost
+        while (posixUringInFlight(this->uring->ring) > 0)
+            storageWritePosixUringComplete(this, posixUringWait(this->uring->ring));
+
+        storagePosixUringRelease(this->storage);
+        this->uring->ring = NULL;
+
+        // Writes queued with io_uring do not move the file position so move it past the data that has been written
+        THROW_ON_SYS_ERROR_FMT(
+            lseek(this->fd, (off_t)this->uring->offset, SEEK_SET) == -1, FileWriteError, "unable to seek to %" PRIu64 " in '%s'",
+            this->uring->offset, strZ(this->nameTmp));
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+#endif // HAVE_IO_URING
+
 /***********************************************************************************************************************************
 Close file descriptor
 ***********************************************************************************************************************************/
@@ -58,6 +204,16 @@ storageWritePosixFreeResource(THIS_VOID)
 
     ASSERT(this != NULL);
 
+#ifdef HAVE_IO_URING
+    // Wait for writes in flight to complete before the file is closed. Errors are ignored since the write has already failed.
+    if (this->uring->ring != NULL)
+    {
+        posixUringDrain(this->uring->ring);
+        storagePosixUringRelease(this->storage);
+        this->uring->ring = NULL;
+    }
+#endif
+
     THROW_ON_SYS_ERROR_FMT(close(this->fd) == -1, FileCloseError, STORAGE_ERROR_WRITE_CLOSE, strZ(this->nameTmp));
 
     FUNCTION_LOG_RETURN_VOID();
@@ -151,6 +307,11 @@ storageWritePosixOpen(THIS_VOID)
         MEM_CONTEXT_TEMP_END();
     }
 
+#ifdef HAVE_IO_URING
+    // Claim the io_uring to write behind
+    this->uring->ring = storagePosixUringClaim(this->storage);
+#endif
+
     FUNCTION_LOG_RETURN_VOID();
 }
 
@@ -171,9 +332,23 @@ storageWritePosix(THIS_VOID, const Buffer *const buffer)
     ASSERT(buffer != NULL);
     ASSERT(this->fd != -1);
 
-    // Write the data
-    if (write(this->fd, bufPtrConst(buffer), bufUsed(buffer)) != (ssize_t)bufUsed(buffer))
-        THROW_SYS_ERROR_FMT(FileWriteError, "unable to write '%s'", strZ(this->nameTmp));
+#ifdef HAVE_IO_URING
+    // Queue the write with io_uring. The first write is made directly so files written with a single write, which are the majority,
+    // do not pay the cost of copying the data and waiting for the write to complete.
+    if (this->uring->ring != NULL && this->uring->offset != 0)
+        storageWritePosixUring(this, buffer);
+    // Else write the data directly
+    else
+#endif
+    {
+        if (write(this->fd, bufPtrConst(buffer), bufUsed(buffer)) != (ssize_t)bufUsed(buffer))
+            THROW_SYS_ERROR_FMT(FileWriteError, "unable to write '%s'", strZ(this->nameTmp));
+    }
+
+#ifdef HAVE_IO_URING
+    // Track the offset of the next write
+    this->uring->offset += bufUsed(buffer);
+#endif
 
     FUNCTION_LOG_RETURN_VOID();
 }
@@ -195,10 +370,19 @@ storageWritePosixClose(THIS_VOID)
     // Close if the file has not already been closed
     if (this->fd != -1)
     {
+#ifdef HAVE_IO_URING
+        // Complete writes in flight
+        storageWritePosixUringFinish(this);
+#endif
+
         // Sync the file
         if (this->interface.syncFile)
             THROW_ON_SYS_ERROR_FMT(fsync(this->fd) == -1, FileSyncError, STORAGE_ERROR_WRITE_SYNC, strZ(this->nameTmp));
 
+        // Drop the file from the page cache. Dirty pages cannot be dropped so this is only useful after the file has been synced.
+        if (this->direct && this->interface.syncFile)
+            posixCompatAdvise(this->fd, 0, 0, posixCompatAdviseDontNeed);
+
         // Close the file
         memContextCallbackClear(objMemContext(this));
         THROW_ON_SYS_ERROR_FMT(close(this->fd) == -1, FileCloseError, STORAGE_ERROR_WRITE_CLOSE, strZ(this->nameTmp));
@@ -243,15 +427,97 @@ storageWritePosixFd(const THIS_VOID)
 
     ASSERT(this != NULL);
 
+#ifdef HAVE_IO_URING
+    // The caller may seek and write using the file descriptor so complete writes in flight and switch to direct writes
+    storageWritePosixUringFinish(this);
+#endif
+
     FUNCTION_TEST_RETURN(INT, this->fd);
 }
 
+/***********************************************************************************************************************************
+Copy from a posix source file in the kernel. A reflink is tried first since no data is copied at all, then copy_file_range(), which
+copies in the kernel and may also be offloaded by the file system.
+***********************************************************************************************************************************/
+static bool
+storageWritePosixCopyFrom(THIS_VOID, StorageRead *const source)
+{
+    THIS(StorageWritePosix);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_WRITE_POSIX, this);
+        FUNCTION_LOG_PARAM(STORAGE_READ, source);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->fd != -1);
+    ASSERT(source != NULL);
+
+    bool result = false;
+
+    // Only files read by the posix driver have a file descriptor that can be copied from
+    if (storageReadType(source) == STORAGE_POSIX_TYPE)
+    {
+        const int fdSource = ioReadFd(storageReadIo(source));
+        const uint64_t offset = storageReadOffset(source);
+        const Variant *const limit = storageReadLimit(source);
+
+#ifdef HAVE_IO_URING
+        // Release the io_uring since nothing will be written through it
+        storageWritePosixUringFinish(this);
+#endif
+
+        // Clone the whole file when the file system supports reflinks. This fails when the files are on different file systems or
+        // the file system does not support reflinks, in which case try copying.
+        if (offset == 0 && limit == NULL)
+            result = posixCompatCloneFile(this->fd, fdSource) == 0;
+
+        if (!result)
+        {
+            off_t offsetIn = (off_t)offset;
+            uint64_t remains = limit == NULL ? UINT64_MAX : varUInt64(limit);
+            bool copied = false;
+
+            result = true;
+
+            while (remains > 0)
+            {
+                const ssize_t size = posixCompatCopyFileRange(
+                    fdSource, &offsetIn, this->fd,
+                    remains > STORAGE_POSIX_COPY_SIZE_MAX ? STORAGE_POSIX_COPY_SIZE_MAX : (size_t)remains);
+
+                if (size == -1)
+                {
+                    // If nothing has been copied and the kernel or file system does not support the copy then let the caller copy
+                    if (!copied && (errno == EXDEV || errno == EINVAL || errno == ENOSYS || errno == EOPNOTSUPP))
+                    {
+                        result = false;
+                        break;
+                    }
+
+                    THROW_SYS_ERROR_FMT(
+                        FileWriteError, "unable to copy '%s' to '%s'", strZ(storageReadName(source)), strZ(this->nameTmp));
+                }
+
+                // Stop at the end of the source file
+                if (size == 0)
+                    break;
+
+                remains -= (uint64_t)size;
+                copied = true;
+            }
+        }
+    }
+
+    FUNCTION_LOG_RETURN(BOOL, result);
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN StorageWrite *
 storageWritePosixNew(
     StoragePosix *const storage, const String *const name, const mode_t modeFile, const mode_t modePath, const String *const user,
     const String *const group, const time_t timeModified, const bool createPath, const bool syncFile, const bool syncPath,
-    const bool atomic, const bool truncate)
+    const bool atomic, const bool truncate, const bool direct)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_POSIX, storage);
@@ -266,6 +532,7 @@ storageWritePosixNew(
         FUNCTION_LOG_PARAM(BOOL, syncPath);
         FUNCTION_LOG_PARAM(BOOL, atomic);
         FUNCTION_LOG_PARAM(BOOL, truncate);
+        FUNCTION_LOG_PARAM(BOOL, direct);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
@@ -273,13 +540,14 @@ storageWritePosixNew(
     ASSERT(modeFile != 0);
     ASSERT(modePath != 0);
 
-    OBJ_NEW_BEGIN(StorageWritePosix, .childQty = MEM_CONTEXT_QTY_MAX, .callbackQty = 1)
+    OBJ_NEW_BEGIN(StorageWritePosix, .childQty = MEM_CONTEXT_QTY_MAX, .allocQty = 1, .callbackQty = 1)
     {
         *this = (StorageWritePosix)
         {
             .storage = storage,
             .path = strPath(name),
             .fd = -1,
+            .direct = direct,
 
             .interface = (StorageWriteInterface)
             {
@@ -295,6 +563,7 @@ storageWritePosixNew(
                 .truncate = truncate,
                 .user = strDup(user),
                 .timeModified = timeModified,
+                .copyFrom = storageWritePosixCopyFrom,
 
                 .ioInterface = (IoWriteInterface)
                 {
@@ -308,6 +577,11 @@ storageWritePosixNew(
 
         // Create temp file name
         this->nameTmp = atomic ? strNewFmt("%s." STORAGE_FILE_TEMP_EXT, strZ(name)) : this->interface.name;
+
+#ifdef HAVE_IO_URING
+        this->uring = memNew(sizeof(StorageWritePosixUring));
+        *this->uring = (StorageWritePosixUring){0};
+#endif
     }
     OBJ_NEW_END();
 
@@ -0,0 +1,284 @@
+/***********************************************************************************************************************************
+HTTP Storage Read
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include "common/debug.h"
+#include "common/log.h"
+#include "common/type/list.h"
+#include "common/type/object.h"
+#include "storage/read.intern.h"
+#include "storage/readHttp.h"
+#include "storage/storage.h"
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct StorageReadHttp
+{
+    StorageReadInterface interface;                                 // Interface
+    void *driver;                                                   // Storage that created this object
+    StorageReadHttpInterface httpInterface;                         // Driver callbacks
+
+    HttpResponse *httpResponse;                                     // HTTP response
+
+    size_t chunkSize;                                               // Size of chunks for ranged reads
+    unsigned int chunkMax;                                          // Maximum chunks in flight for ranged reads
+    List *requestList;                                              // Chunk requests in flight (oldest first) for ranged reads
+    uint64_t chunkOffset;                                           // Offset of the next chunk to request
+    uint64_t chunkEnd;                                              // Offset where the ranged read ends
+    const String *version;                                          // Object version returned with the first chunk
+} StorageReadHttp;
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+#define FUNCTION_LOG_STORAGE_READ_HTTP_TYPE                                                                                        \
+    StorageReadHttp *
+#define FUNCTION_LOG_STORAGE_READ_HTTP_FORMAT(value, buffer, bufferSize)                                                           \
+    objNameToLog(value, "StorageReadHttp", buffer, bufferSize)
+
+/***********************************************************************************************************************************
+Ranged reads larger than the chunk size are split into chunks that are requested concurrently, up to chunkMax at a time. Each chunk
+request holds its own session so the server can send all chunks in flight at once, with data that has not been read yet buffered by
+the operating system. Responses are read in the order they were requested so chunks are delivered in order and the read looks the
+same as a single request to the caller. Whenever a chunk is completely read another is requested to keep the window full.
+
+The first chunk is requested alone and the version of the object in the response is required for the remaining chunks. Otherwise an
+object overwritten during the read could return chunks from both versions, which would look like a valid read to the caller.
+***********************************************************************************************************************************/
+static void
+storageReadHttpChunkAsync(StorageReadHttp *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_HTTP, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->requestList != NULL);
+    ASSERT(this->chunkOffset < this->chunkEnd);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const uint64_t chunkSize = this->chunkEnd - this->chunkOffset < this->chunkSize ?
+            this->chunkEnd - this->chunkOffset : this->chunkSize;
+
+        HttpRequest *const request = httpRequestMove(
+            this->httpInterface.request(this->driver, this->interface.name, this->chunkOffset, VARUINT64(chunkSize), this->version),
+            lstMemContext(this->requestList));
+
+        lstAdd(this->requestList, &request);
+
+        this->chunkOffset += chunkSize;
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+// Get the response for the oldest chunk request and request more chunks if there are more to read. The first chunk is allowed to be
+// missing so open can decide whether to error and the object version in the response is pinned for the remaining chunks.
+static void
+storageReadHttpChunkNext(StorageReadHttp *const this, const bool first)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_HTTP, this);
+        FUNCTION_LOG_PARAM(BOOL, first);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(!lstEmpty(this->requestList));
+
+    HttpRequest *const request = *(HttpRequest **)lstGet(this->requestList, 0);
+
+    httpResponseFree(this->httpResponse);
+
+    MEM_CONTEXT_OBJ_BEGIN(this)
+    {
+        this->httpResponse = this->httpInterface.response(request, first);
+    }
+    MEM_CONTEXT_OBJ_END();
+
+    httpRequestFree(request);
+    lstRemoveIdx(this->requestList, 0);
+
+    if (httpResponseCodeOk(this->httpResponse))
+    {
+        if (first)
+        {
+            MEM_CONTEXT_OBJ_BEGIN(this)
+            {
+                this->version = strDup(httpHeaderGet(httpResponseHeader(this->httpResponse), this->httpInterface.versionHeader));
+            }
+            MEM_CONTEXT_OBJ_END();
+        }
+
+        while (lstSize(this->requestList) < this->chunkMax && this->chunkOffset < this->chunkEnd)
+            storageReadHttpChunkAsync(this);
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Open the file
+***********************************************************************************************************************************/
+static bool
+storageReadHttpOpen(THIS_VOID)
+{
+    THIS(StorageReadHttp);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_HTTP, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->httpResponse == NULL);
+
+    bool result = false;
+
+    // Request the range in chunks when it is large enough to benefit
+    if (this->chunkMax > 1 && this->interface.limit != NULL && varUInt64(this->interface.limit) > this->chunkSize)
+    {
+        MEM_CONTEXT_OBJ_BEGIN(this)
+        {
+            this->requestList = lstNewP(sizeof(HttpRequest *));
+        }
+        MEM_CONTEXT_OBJ_END();
+
+        this->chunkOffset = this->interface.offset;
+        this->chunkEnd = this->interface.offset + varUInt64(this->interface.limit);
+
+        storageReadHttpChunkAsync(this);
+        storageReadHttpChunkNext(this, true);
+    }
+    // Else request the file
+    else
+    {
+        MEM_CONTEXT_OBJ_BEGIN(this)
+        {
+            HttpRequest *const request = this->httpInterface.request(
+                this->driver, this->interface.name, this->interface.offset, this->interface.limit, NULL);
+
+            this->httpResponse = this->httpInterface.response(request, true);
+            httpRequestFree(request);
+        }
+        MEM_CONTEXT_OBJ_END();
+    }
+
+    if (httpResponseCodeOk(this->httpResponse))
+    {
+        result = true;
+    }
+    // Else error unless ignore missing
+    else if (!this->interface.ignoreMissing)
+        THROW_FMT(FileMissingError, STORAGE_ERROR_READ_MISSING, strZ(this->interface.name));
+
+    FUNCTION_LOG_RETURN(BOOL, result);
+}
+
+/***********************************************************************************************************************************
+Read from a file
+***********************************************************************************************************************************/
+static size_t
+storageReadHttp(THIS_VOID, Buffer *const buffer, const bool block)
+{
+    THIS(StorageReadHttp);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_HTTP, this);
+        FUNCTION_LOG_PARAM(BUFFER, buffer);
+        FUNCTION_LOG_PARAM(BOOL, block);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL && this->httpResponse != NULL);
+    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
+    ASSERT(buffer != NULL && !bufFull(buffer));
+
+    const size_t result = ioRead(httpResponseIoRead(this->httpResponse), buffer);
+
+    // Move to the next chunk when the current chunk has been read
+    if (this->requestList != NULL && !lstEmpty(this->requestList) && ioReadEof(httpResponseIoRead(this->httpResponse)))
+        storageReadHttpChunkNext(this, false);
+
+    FUNCTION_LOG_RETURN(SIZE, result);
+}
+
+/***********************************************************************************************************************************
+Has file reached EOF?
+***********************************************************************************************************************************/
+static bool
+storageReadHttpEof(THIS_VOID)
+{
+    THIS(StorageReadHttp);
+
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_READ_HTTP, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL && this->httpResponse != NULL);
+    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
+
+    FUNCTION_TEST_RETURN(
+        BOOL,
+        ioReadEof(httpResponseIoRead(this->httpResponse)) && (this->requestList == NULL || lstEmpty(this->requestList)));
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN StorageRead *
+storageReadHttpNew(
+    void *const driver, const StorageReadHttpInterface *const interface, const StringId type, const String *const name,
+    const bool ignoreMissing, const uint64_t offset, const Variant *const limit, const size_t chunkSize,
+    const unsigned int chunkMax)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM_P(VOID, driver);
+        FUNCTION_LOG_PARAM_P(VOID, interface);
+        FUNCTION_LOG_PARAM(STRING_ID, type);
+        FUNCTION_LOG_PARAM(STRING, name);
+        FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(VARIANT, limit);
+        FUNCTION_LOG_PARAM(SIZE, chunkSize);
+        FUNCTION_LOG_PARAM(UINT, chunkMax);
+    FUNCTION_LOG_END();
+
+    ASSERT(driver != NULL);
+    ASSERT(interface != NULL);
+    ASSERT(interface->versionHeader != NULL);
+    ASSERT(interface->request != NULL);
+    ASSERT(interface->response != NULL);
+    ASSERT(name != NULL);
+    ASSERT(chunkSize != 0);
+    ASSERT(chunkMax != 0);
+
+    OBJ_NEW_BEGIN(StorageReadHttp, .childQty = MEM_CONTEXT_QTY_MAX)
+    {
+        *this = (StorageReadHttp)
+        {
+            .driver = driver,
+            .httpInterface = *interface,
+            .chunkSize = chunkSize,
+            .chunkMax = chunkMax,
+
+            .interface = (StorageReadInterface)
+            {
+                .type = type,
+                .name = strDup(name),
+                .ignoreMissing = ignoreMissing,
+                .offset = offset,
+                .limit = varDup(limit),
+
+                .ioInterface = (IoReadInterface)
+                {
+                    .eof = storageReadHttpEof,
+                    .open = storageReadHttpOpen,
+                    .read = storageReadHttp,
+                },
+            },
+        };
+    }
+    OBJ_NEW_END();
+
+    FUNCTION_LOG_RETURN(STORAGE_READ, storageReadNew(this, &this->interface));
+}
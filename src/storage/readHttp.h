@@ -0,0 +1,38 @@
+/***********************************************************************************************************************************
+HTTP Storage Read
+
+Read shared by the storage drivers that read objects with ranged HTTP GET requests. The driver provides callbacks to send a request
+for a range of the object and to get the response, and this module handles missing files and splitting large ranges into chunks.
+***********************************************************************************************************************************/
+#ifndef STORAGE_READ_HTTP_H
+#define STORAGE_READ_HTTP_H
+
+#include "common/io/http/request.h"
+#include "common/io/http/response.h"
+#include "storage/read.h"
+
+/***********************************************************************************************************************************
+Driver interface
+***********************************************************************************************************************************/
+typedef struct StorageReadHttpInterface
+{
+    // Response header containing the object version, e.g. the ETag. When the response to the first chunk of a ranged read has this
+    // header the remaining chunks are requested for the same version so the chunks cannot come from different versions.
+    const String *versionHeader;
+
+    // Send an async GET request for a range of the object. The limit is NULL to read to the end of the object. When version is not
+    // NULL the request must fail unless the object still has this version.
+    HttpRequest *(*request)(void *driver, const String *name, uint64_t offset, const Variant *limit, const String *version);
+
+    // Get the response to a request with content io. Missing files return the response when allowMissing is true.
+    HttpResponse *(*response)(HttpRequest *request, bool allowMissing);
+} StorageReadHttpInterface;
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+FN_EXTERN StorageRead *storageReadHttpNew(
+    void *driver, const StorageReadHttpInterface *interface, StringId type, const String *name, bool ignoreMissing, uint64_t offset,
+    const Variant *limit, size_t chunkSize, unsigned int chunkMax);
+
+#endif
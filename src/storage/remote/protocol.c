@@ -20,7 +20,6 @@ Local variables
 ***********************************************************************************************************************************/
 static struct
 {
-    MemContext *memContext;                                         // Mem context
     void *driver;                                                   // Storage driver used for requests
 
     const StorageRemoteFilterHandler *filterHandler;                // Filter handler list
@@ -143,20 +142,9 @@ storageRemoteFeatureProtocol(PackRead *const param, ProtocolServer *const server
         const Storage *storage =
             cfgOptionStrId(cfgOptRemoteType) == protocolStorageTypeRepo ? storageRepoWrite() : storagePgWrite();
 
-        // Store local variables in the server context
-        if (storageRemoteProtocolLocal.memContext == NULL)
-        {
-            MEM_CONTEXT_PRIOR_BEGIN()
-            {
-                MEM_CONTEXT_NEW_BEGIN(StorageRemoteProtocol, .childQty = MEM_CONTEXT_QTY_MAX)
-                {
-                    storageRemoteProtocolLocal.memContext = memContextCurrent();
-                    storageRemoteProtocolLocal.driver = storageDriver(storage);
-                }
-                MEM_CONTEXT_NEW_END();
-            }
-            MEM_CONTEXT_PRIOR_END();
-        }
+        // Store the driver used for requests. This is done on every call since a server worker may process more than one client
+        // and the storage may have been recreated for a new client.
+        storageRemoteProtocolLocal.driver = storageDriver(storage);
 
         // Return storage features
         PackWrite *result = protocolPackNew();
@@ -602,9 +590,10 @@ storageRemotePathSyncProtocol(PackRead *const param, ProtocolServer *const serve
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
-        const String *path = pckReadStrP(param);
+        const String *const path = pckReadStrP(param);
+        const bool fileSystem = pckReadBoolP(param);
 
-        storageInterfacePathSyncP(storageRemoteProtocolLocal.driver, path);
+        storageInterfacePathSyncP(storageRemoteProtocolLocal.driver, path, .fileSystem = fileSystem);
         protocolServerDataEndPut(server);
     }
     MEM_CONTEXT_TEMP_END();
@@ -4,115 +4,68 @@ S3 Storage Read
 #include "build.auto.h"
 
 #include "common/debug.h"
-#include "common/io/http/client.h"
 #include "common/log.h"
-#include "common/type/object.h"
-#include "storage/read.intern.h"
+#include "storage/readHttp.h"
 #include "storage/s3/read.h"
 
 /***********************************************************************************************************************************
-Object type
+Request a range of the object. The ETag pins the version of the object so the request fails with 412 if it has been overwritten.
 ***********************************************************************************************************************************/
-#define STORAGE_READ_S3_TYPE                                        StorageReadS3
-#define STORAGE_READ_S3_PREFIX                                      storageReadS3
-
-typedef struct StorageReadS3
-{
-    StorageReadInterface interface;                                 // Interface
-    StorageS3 *storage;                                             // Storage that created this object
-
-    HttpResponse *httpResponse;                                     // HTTP response
-} StorageReadS3;
-
-/***********************************************************************************************************************************
-Macros for function logging
-***********************************************************************************************************************************/
-#define FUNCTION_LOG_STORAGE_READ_S3_TYPE                                                                                          \
-    StorageReadS3 *
-#define FUNCTION_LOG_STORAGE_READ_S3_FORMAT(value, buffer, bufferSize)                                                             \
-    objNameToLog(value, "StorageReadS3", buffer, bufferSize)
-
-/***********************************************************************************************************************************
-Open the file
-***********************************************************************************************************************************/
-static bool
-storageReadS3Open(THIS_VOID)
+static HttpRequest *
+storageReadS3Request(
+    void *const driver, const String *const name, const uint64_t offset, const Variant *const limit, const String *const version)
 {
-    THIS(StorageReadS3);
-
     FUNCTION_LOG_BEGIN(logLevelTrace);
-        FUNCTION_LOG_PARAM(STORAGE_READ_S3, this);
+        FUNCTION_LOG_PARAM(STORAGE_S3, driver);
+        FUNCTION_LOG_PARAM(STRING, name);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(VARIANT, limit);
+        FUNCTION_LOG_PARAM(STRING, version);
     FUNCTION_LOG_END();
 
-    ASSERT(this != NULL);
-    ASSERT(this->httpResponse == NULL);
+    ASSERT(driver != NULL);
+    ASSERT(name != NULL);
 
-    bool result = false;
+    HttpHeader *const header = httpHeaderPutRange(httpHeaderNew(NULL), offset, limit);
 
-    // Request the file
-    MEM_CONTEXT_OBJ_BEGIN(this)
-    {
-        this->httpResponse = storageS3RequestP(
-            this->storage, HTTP_VERB_GET_STR, this->interface.name,
-            .header = httpHeaderPutRange(httpHeaderNew(NULL), this->interface.offset, this->interface.limit),
-            .allowMissing = true, .contentIo = true, .sseC = true);
-    }
-    MEM_CONTEXT_OBJ_END();
+    if (version != NULL)
+        httpHeaderPut(header, HTTP_HEADER_IF_MATCH_STR, version);
 
-    if (httpResponseCodeOk(this->httpResponse))
-    {
-        result = true;
-    }
-    // Else error unless ignore missing
-    else if (!this->interface.ignoreMissing)
-        THROW_FMT(FileMissingError, STORAGE_ERROR_READ_MISSING, strZ(this->interface.name));
+    HttpRequest *const result = storageS3RequestAsyncP(driver, HTTP_VERB_GET_STR, name, .header = header, .sseC = true);
 
-    FUNCTION_LOG_RETURN(BOOL, result);
+    httpHeaderFree(header);
+
+    FUNCTION_LOG_RETURN(HTTP_REQUEST, result);
 }
 
 /***********************************************************************************************************************************
-Read from a file
+Get the response to a range request
 ***********************************************************************************************************************************/
-static size_t
-storageReadS3(THIS_VOID, Buffer *const buffer, const bool block)
+static HttpResponse *
+storageReadS3Response(HttpRequest *const request, const bool allowMissing)
 {
-    THIS(StorageReadS3);
-
     FUNCTION_LOG_BEGIN(logLevelTrace);
-        FUNCTION_LOG_PARAM(STORAGE_READ_S3, this);
-        FUNCTION_LOG_PARAM(BUFFER, buffer);
-        FUNCTION_LOG_PARAM(BOOL, block);
+        FUNCTION_LOG_PARAM(HTTP_REQUEST, request);
+        FUNCTION_LOG_PARAM(BOOL, allowMissing);
     FUNCTION_LOG_END();
 
-    ASSERT(this != NULL && this->httpResponse != NULL);
-    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
-    ASSERT(buffer != NULL && !bufFull(buffer));
+    ASSERT(request != NULL);
 
-    FUNCTION_LOG_RETURN(SIZE, ioRead(httpResponseIoRead(this->httpResponse), buffer));
+    FUNCTION_LOG_RETURN(HTTP_RESPONSE, storageS3ResponseP(request, .allowMissing = allowMissing, .contentIo = true));
 }
 
-/***********************************************************************************************************************************
-Has file reached EOF?
-***********************************************************************************************************************************/
-static bool
-storageReadS3Eof(THIS_VOID)
+/**********************************************************************************************************************************/
+static const StorageReadHttpInterface storageReadS3Interface =
 {
-    THIS(StorageReadS3);
-
-    FUNCTION_TEST_BEGIN();
-        FUNCTION_TEST_PARAM(STORAGE_READ_S3, this);
-    FUNCTION_TEST_END();
-
-    ASSERT(this != NULL && this->httpResponse != NULL);
-    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
+    .versionHeader = STRDEF(HTTP_HEADER_ETAG),
+    .request = storageReadS3Request,
+    .response = storageReadS3Response,
+};
 
-    FUNCTION_TEST_RETURN(BOOL, ioReadEof(httpResponseIoRead(this->httpResponse)));
-}
-
-/**********************************************************************************************************************************/
 FN_EXTERN StorageRead *
 storageReadS3New(
-    StorageS3 *const storage, const String *const name, const bool ignoreMissing, const uint64_t offset, const Variant *const limit)
+    StorageS3 *const storage, const String *const name, const bool ignoreMissing, const uint64_t offset, const Variant *const limit,
+    const size_t chunkSize, const unsigned int chunkMax)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_S3, storage);
@@ -120,36 +73,16 @@ storageReadS3New(
         FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
         FUNCTION_LOG_PARAM(UINT64, offset);
         FUNCTION_LOG_PARAM(VARIANT, limit);
+        FUNCTION_LOG_PARAM(SIZE, chunkSize);
+        FUNCTION_LOG_PARAM(UINT, chunkMax);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
     ASSERT(name != NULL);
     ASSERT(limit == NULL || varUInt64(limit) > 0);
 
-    OBJ_NEW_BEGIN(StorageReadS3, .childQty = MEM_CONTEXT_QTY_MAX)
-    {
-        *this = (StorageReadS3)
-        {
-            .storage = storage,
-
-            .interface = (StorageReadInterface)
-            {
-                .type = STORAGE_S3_TYPE,
-                .name = strDup(name),
-                .ignoreMissing = ignoreMissing,
-                .offset = offset,
-                .limit = varDup(limit),
-
-                .ioInterface = (IoReadInterface)
-                {
-                    .eof = storageReadS3Eof,
-                    .open = storageReadS3Open,
-                    .read = storageReadS3,
-                },
-            },
-        };
-    }
-    OBJ_NEW_END();
-
-    FUNCTION_LOG_RETURN(STORAGE_READ, storageReadNew(this, &this->interface));
+    FUNCTION_LOG_RETURN(
+        STORAGE_READ,
+        storageReadHttpNew(
+            storage, &storageReadS3Interface, STORAGE_S3_TYPE, name, ignoreMissing, offset, limit, chunkSize, chunkMax));
 }
@@ -101,6 +101,9 @@ struct StorageS3
     const String *sseCustomerKey;                                   // Base64 of SSE-C encryption key
     const String *sseCustomerKeyMd5;                                // Base64 of MD5 of SSE-C key
     size_t partSize;                                                // Part size for multi-part upload
+    unsigned int partMax;                                           // Maximum parts in flight for multi-part upload
+    size_t readChunkSize;                                           // Chunk size for ranged reads
+    unsigned int readChunkMax;                                      // Maximum chunks in flight for ranged reads
     const String *tag;                                              // Tags to be applied to objects
     unsigned int deleteMax;                                         // Maximum objects that can be deleted in one request
     StorageS3UriStyle uriStyle;                                     // Path or host style URIs
@@ -892,7 +895,9 @@ storageS3NewRead(THIS_VOID, const String *const file, const bool ignoreMissing,
     ASSERT(this != NULL);
     ASSERT(file != NULL);
 
-    FUNCTION_LOG_RETURN(STORAGE_READ, storageReadS3New(this, file, ignoreMissing, param.offset, param.limit));
+    FUNCTION_LOG_RETURN(
+        STORAGE_READ,
+        storageReadS3New(this, file, ignoreMissing, param.offset, param.limit, this->readChunkSize, this->readChunkMax));
 }
 
 /**********************************************************************************************************************************/
@@ -915,7 +920,7 @@ storageS3NewWrite(THIS_VOID, const String *const file, const StorageInterfaceNew
     ASSERT(param.group == NULL);
     ASSERT(param.timeModified == 0);
 
-    FUNCTION_LOG_RETURN(STORAGE_WRITE, storageWriteS3New(this, file, this->partSize));
+    FUNCTION_LOG_RETURN(STORAGE_WRITE, storageWriteS3New(this, file, this->partSize, this->partMax));
 }
 
 /**********************************************************************************************************************************/
@@ -1118,8 +1123,9 @@ storageS3New(
     const String *const endPoint, const StorageS3UriStyle uriStyle, const String *const region, const StorageS3KeyType keyType,
     const String *const accessKey, const String *const secretAccessKey, const String *const securityToken,
     const String *const kmsKeyId, const String *sseCustomerKey, const String *const credRole, const String *const webIdToken,
-    const size_t partSize, const KeyValue *const tag, const String *host, const unsigned int port, const TimeMSec timeout,
-    const bool verifyPeer, const String *const caFile, const String *const caPath)
+    const size_t partSize, const unsigned int partMax, const size_t readChunkSize, const unsigned int readChunkMax,
+    const KeyValue *const tag, const String *host, const unsigned int port, const TimeMSec timeout, const bool verifyPeer,
+    const String *const caFile, const String *const caPath)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, path);
@@ -1138,6 +1144,9 @@ storageS3New(
         FUNCTION_TEST_PARAM(STRING, credRole);
         FUNCTION_TEST_PARAM(STRING, webIdToken);
         FUNCTION_LOG_PARAM(SIZE, partSize);
+        FUNCTION_LOG_PARAM(UINT, partMax);
+        FUNCTION_LOG_PARAM(SIZE, readChunkSize);
+        FUNCTION_LOG_PARAM(UINT, readChunkMax);
         FUNCTION_LOG_PARAM(KEY_VALUE, tag);
         FUNCTION_LOG_PARAM(STRING, host);
         FUNCTION_LOG_PARAM(UINT, port);
@@ -1152,6 +1161,9 @@ storageS3New(
     ASSERT(endPoint != NULL);
     ASSERT(region != NULL);
     ASSERT(partSize != 0);
+    ASSERT(partMax != 0);
+    ASSERT(readChunkSize != 0);
+    ASSERT(readChunkMax != 0);
 
     OBJ_NEW_BEGIN(StorageS3, .childQty = MEM_CONTEXT_QTY_MAX)
     {
@@ -1164,6 +1176,9 @@ storageS3New(
             .kmsKeyId = strDup(kmsKeyId),
             .sseCustomerKey = strDup(sseCustomerKey),
             .partSize = partSize,
+            .partMax = partMax,
+            .readChunkSize = readChunkSize,
+            .readChunkMax = readChunkMax,
             .deleteMax = STORAGE_S3_DELETE_MAX,
             .uriStyle = uriStyle,
             .bucketEndpoint =
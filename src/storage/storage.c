@@ -117,14 +117,22 @@ storageCopy(StorageRead *const source, StorageWrite *const destination)
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
+        // The driver can only copy the file when there are no filters since filters must see all the data. Check before opening
+        // since opening adds a buffer filter.
+        const bool filter =
+            ioFilterGroupSize(ioReadFilterGroup(storageReadIo(source))) > 0 ||
+            ioFilterGroupSize(ioWriteFilterGroup(storageWriteIo(destination))) > 0;
+
         // Open source file
         if (ioReadOpen(storageReadIo(source)))
         {
             // Open the destination file now that we know the source file exists and is readable
             ioWriteOpen(storageWriteIo(destination));
 
-            // Copy data from source to destination
-            ioCopyP(storageReadIo(source), storageWriteIo(destination));
+            // Copy data from source to destination. Let the driver try first since it may be able to copy without the data passing
+            // through user space.
+            if (filter || !storageWriteCopyFrom(destination, source))
+                ioCopyP(storageReadIo(source), storageWriteIo(destination));
 
             // Close the source and destination files
             ioReadClose(storageReadIo(source));
@@ -691,11 +699,12 @@ storagePathRemove(const Storage *const this, const String *const pathExp, const
 
 /**********************************************************************************************************************************/
 FN_EXTERN void
-storagePathSync(const Storage *const this, const String *const pathExp)
+storagePathSync(const Storage *const this, const String *const pathExp, const StoragePathSyncParam param)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STORAGE, this);
         FUNCTION_LOG_PARAM(STRING, pathExp);
+        FUNCTION_LOG_PARAM(BOOL, param.fileSystem);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
@@ -706,7 +715,7 @@ storagePathSync(const Storage *const this, const String *const pathExp)
     {
         MEM_CONTEXT_TEMP_BEGIN()
         {
-            storageInterfacePathSyncP(storageDriver(this), storagePathP(this, pathExp));
+            storageInterfacePathSyncP(storageDriver(this), storagePathP(this, pathExp), .fileSystem = param.fileSystem);
         }
         MEM_CONTEXT_TEMP_END();
     }
@@ -235,10 +235,16 @@ typedef struct StoragePathRemoveParam
 FN_EXTERN void storagePathRemove(const Storage *this, const String *pathExp, StoragePathRemoveParam param);
 
 // Sync a path
-#define storagePathSyncP(this, pathExp)                                                                                            \
-    storagePathSync(this, pathExp)
+typedef struct StoragePathSyncParam
+{
+    VAR_PARAM_HEADER;
+    bool fileSystem;                                                // Sync the entire file system containing the path
+} StoragePathSyncParam;
+
+#define storagePathSyncP(this, pathExp, ...)                                                                                       \
+    storagePathSync(this, pathExp, (StoragePathSyncParam){VAR_PARAM_INIT, __VA_ARGS__})
 
-FN_EXTERN void storagePathSync(const Storage *this, const String *pathExp);
+FN_EXTERN void storagePathSync(const Storage *this, const String *pathExp, StoragePathSyncParam param);
 
 // Write a buffer to storage
 #define storagePutP(file, buffer)                                                                                                  \
@@ -257,6 +257,10 @@ typedef void StorageInterfacePathCreate(
 typedef struct StorageInterfacePathSyncParam
 {
     VAR_PARAM_HEADER;
+
+    // Sync the entire file system containing the path. This is much faster than syncing files individually when there are many
+    // files that have been written without sync.
+    bool fileSystem;
 } StorageInterfacePathSyncParam;
 
 typedef void StorageInterfacePathSync(void *thisVoid, const String *path, StorageInterfacePathSyncParam param);
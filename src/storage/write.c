@@ -72,3 +72,19 @@ storageWriteToLog(const StorageWrite *const this, StringStatic *const debugLog)
         cvtBoolToConstZ(storageWriteCreatePath(this)), cvtBoolToConstZ(storageWriteSyncFile(this)),
         cvtBoolToConstZ(storageWriteSyncPath(this)), cvtBoolToConstZ(storageWriteAtomic(this)));
 }
+
+/**********************************************************************************************************************************/
+FN_EXTERN bool
+storageWriteCopyFrom(StorageWrite *const this, StorageRead *const source)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_WRITE, this);
+        FUNCTION_LOG_PARAM(STORAGE_READ, source);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(source != NULL);
+
+    FUNCTION_LOG_RETURN(
+        BOOL, this->pub.interface->copyFrom != NULL ? this->pub.interface->copyFrom(this->driver, source) : false);
+}
@@ -26,6 +26,10 @@ storageWriteMove(StorageWrite *const this, MemContext *const parentNew)
     return objMove(this, parentNew);
 }
 
+// Copy from an open source file using the driver. Returns false when the driver cannot copy the file, in which case nothing has been
+// written and the caller must copy the data itself.
+FN_EXTERN bool storageWriteCopyFrom(StorageWrite *this, StorageRead *source);
+
 /***********************************************************************************************************************************
 Getters/Setters
 ***********************************************************************************************************************************/
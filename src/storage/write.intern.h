@@ -5,6 +5,7 @@ Storage Write Interface Internal
 #define STORAGE_WRITE_INTERN_H
 
 #include "common/io/write.h"
+#include "storage/read.h"
 #include "version.h"
 
 /***********************************************************************************************************************************
@@ -34,6 +35,10 @@ typedef struct StorageWriteInterface
     const String *user;                                             // User that owns the file
 
     IoWriteInterface ioInterface;
+
+    // Copy from an open source file without passing the data through user space, e.g. with a kernel copy. Returns false when the
+    // copy is not possible so the caller can fall back to copying through the io interface. Optional.
+    bool (*copyFrom)(void *driver, StorageRead *source);
 } StorageWriteInterface;
 
 FN_EXTERN StorageWrite *storageWriteNew(void *driver, const StorageWriteInterface *interface);
@@ -0,0 +1,186 @@
+/***********************************************************************************************************************************
+Harness for Posix Compatibility Testing
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+/***********************************************************************************************************************************
+Include shimmed C modules
+
+The shimmed module sets _GNU_SOURCE so it must be included before any system headers.
+***********************************************************************************************************************************/
+{[SHIM_MODULE]}
+
+#include <errno.h>
+#include <unistd.h>
+
+#include "common/harnessDebug.h"
+#include "common/harnessPosixCompat.h"
+
+/***********************************************************************************************************************************
+Shim install state
+***********************************************************************************************************************************/
+static struct
+{
+    bool cloneFileShim;                                             // Is the posixCompatCloneFile() shim installed?
+    int cloneFileErrNo;                                             // Error returned by posixCompatCloneFile() (0 to emulate)
+    int copyFileRangeErrNo;                                         // Error returned by posixCompatCopyFileRange() when not 0
+    unsigned int copyFileRangeSuccessTotal;                         // Calls to pass to posixCompatCopyFileRange() before failing
+    int syncFsErrNo;                                                // Error returned by posixCompatSyncFs() when not 0
+} hrnPosixCompatStatic;
+
+/***********************************************************************************************************************************
+Shim posixCompatCloneFile()
+***********************************************************************************************************************************/
+int
+posixCompatCloneFile(const int fdDest, const int fdSource)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM(INT, fdDest);
+        FUNCTION_HARNESS_PARAM(INT, fdSource);
+    FUNCTION_HARNESS_END();
+
+    int result = 0;
+
+    if (hrnPosixCompatStatic.cloneFileShim)
+    {
+        // Fail with the requested error
+        if (hrnPosixCompatStatic.cloneFileErrNo != 0)
+        {
+            errno = hrnPosixCompatStatic.cloneFileErrNo;
+            result = -1;
+        }
+        // Else emulate the clone by copying the file
+        else
+        {
+            char buffer[4096];
+            off_t offset = 0;
+            ssize_t size;
+
+            while ((size = pread(fdSource, buffer, sizeof(buffer), offset)) > 0)
+            {
+                if (write(fdDest, buffer, (size_t)size) != size)
+                    THROW_SYS_ERROR(FileWriteError, "unable to emulate clone");
+
+                offset += size;
+            }
+        }
+    }
+    // Else call normal function
+    else
+        result = posixCompatCloneFile_SHIMMED(fdDest, fdSource);
+
+    FUNCTION_HARNESS_RETURN(INT, result);
+}
+
+/***********************************************************************************************************************************
+Shim posixCompatCopyFileRange()
+***********************************************************************************************************************************/
+ssize_t
+posixCompatCopyFileRange(const int fdSource, off_t *const offsetSource, const int fdDest, const size_t size)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM(INT, fdSource);
+        FUNCTION_HARNESS_PARAM_P(VOID, offsetSource);
+        FUNCTION_HARNESS_PARAM(INT, fdDest);
+        FUNCTION_HARNESS_PARAM(SIZE, size);
+    FUNCTION_HARNESS_END();
+
+    ssize_t result;
+
+    if (hrnPosixCompatStatic.copyFileRangeErrNo != 0 && hrnPosixCompatStatic.copyFileRangeSuccessTotal == 0)
+    {
+        errno = hrnPosixCompatStatic.copyFileRangeErrNo;
+        result = -1;
+    }
+    // Else call normal function
+    else
+    {
+        if (hrnPosixCompatStatic.copyFileRangeSuccessTotal > 0)
+            hrnPosixCompatStatic.copyFileRangeSuccessTotal--;
+
+        result = posixCompatCopyFileRange_SHIMMED(fdSource, offsetSource, fdDest, size);
+    }
+
+    FUNCTION_HARNESS_RETURN(SIZE, result);
+}
+
+/***********************************************************************************************************************************
+Shim posixCompatSyncFs()
+***********************************************************************************************************************************/
+int
+posixCompatSyncFs(const int fd)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM(INT, fd);
+    FUNCTION_HARNESS_END();
+
+    int result;
+
+    if (hrnPosixCompatStatic.syncFsErrNo != 0)
+    {
+        errno = hrnPosixCompatStatic.syncFsErrNo;
+        result = -1;
+    }
+    // Else call normal function
+    else
+        result = posixCompatSyncFs_SHIMMED(fd);
+
+    FUNCTION_HARNESS_RETURN(INT, result);
+}
+
+/**********************************************************************************************************************************/
+void
+hrnPosixCompatCloneFileShimInstall(const int errNo)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM(INT, errNo);
+    FUNCTION_HARNESS_END();
+
+    hrnPosixCompatStatic.cloneFileShim = true;
+    hrnPosixCompatStatic.cloneFileErrNo = errNo;
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+void
+hrnPosixCompatCopyFileRangeShimInstall(const int errNo, const unsigned int successTotal)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM(INT, errNo);
+        FUNCTION_HARNESS_PARAM(UINT, successTotal);
+    FUNCTION_HARNESS_END();
+
+    hrnPosixCompatStatic.copyFileRangeErrNo = errNo;
+    hrnPosixCompatStatic.copyFileRangeSuccessTotal = successTotal;
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+void
+hrnPosixCompatSyncFsShimInstall(const int errNo)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM(INT, errNo);
+    FUNCTION_HARNESS_END();
+
+    hrnPosixCompatStatic.syncFsErrNo = errNo;
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+void
+hrnPosixCompatShimUninstall(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    hrnPosixCompatStatic.cloneFileShim = false;
+    hrnPosixCompatStatic.cloneFileErrNo = 0;
+    hrnPosixCompatStatic.copyFileRangeErrNo = 0;
+    hrnPosixCompatStatic.copyFileRangeSuccessTotal = 0;
+    hrnPosixCompatStatic.syncFsErrNo = 0;
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
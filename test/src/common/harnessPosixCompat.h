@@ -0,0 +1,22 @@
+/***********************************************************************************************************************************
+Harness for Posix Compatibility Testing
+
+Shim the posix compatibility wrappers so they fail with a specified errno. This simulates kernels and file systems that do not
+support a system call in order to test the fallbacks.
+***********************************************************************************************************************************/
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Install shim to fail posixCompatCloneFile() with errNo. When errNo is 0 the clone is emulated by copying the file so a successful
+// clone can be tested on file systems that do not support reflinks.
+void hrnPosixCompatCloneFileShimInstall(int errNo);
+
+// Install shim to fail posixCompatCopyFileRange() with errNo after successTotal calls have been passed to the real function
+void hrnPosixCompatCopyFileRangeShimInstall(int errNo, unsigned int successTotal);
+
+// Install shim to fail posixCompatSyncFs() with errNo
+void hrnPosixCompatSyncFsShimInstall(int errNo);
+
+// Uninstall all shims
+void hrnPosixCompatShimUninstall(void);
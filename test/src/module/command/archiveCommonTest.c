@@ -3,6 +3,7 @@ Test Archive Common
 ***********************************************************************************************************************************/
 #include <unistd.h>
 
+#include "common/crypto/hash.h"
 #include "storage/helper.h"
 #include "storage/posix/storage.h"
 
@@ -374,6 +375,41 @@ testRun(void)
             " 123456781234567912345679-dddddddddddddddddddddddddddddddddddddddd.zst"
             ", 123456781234567912345679-eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee.gz\n"
             "HINT: are multiple primaries archiving to this stanza?");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("find segments in a bundle");
+
+        HRN_STORAGE_PUT_EMPTY(
+            storageTest, "archive/db/9.6-2/1234567812345680/123456781234568000000001-123456781234568000000003.bundle.gz");
+        HRN_STORAGE_PUT_EMPTY(
+            storageTest, "archive/db/9.6-2/1234567812345680/123456781234568000000004-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+
+        TEST_RESULT_STR_Z(
+            walSegmentFindOne(storageRepo(), STRDEF("9.6-2"), STRDEF("123456781234568000000002"), 0),
+            "123456781234568000000001-123456781234568000000003.bundle.gz", "find single in bundle");
+        TEST_RESULT_STR(
+            walSegmentFindOne(storageRepo(), STRDEF("9.6-2"), STRDEF("123456781234568000000005"), 0), NULL,
+            "bundle does not contain segment");
+
+        TEST_ASSIGN(find, walSegmentFindNew(storageRepo(), STRDEF("9.6-2"), false, 0), "new find");
+
+        TEST_RESULT_STR_Z(
+            walSegmentFind(find, STRDEF("123456781234568000000001")), "123456781234568000000001-123456781234568000000003.bundle.gz",
+            "find first in bundle");
+        TEST_RESULT_STRLST_Z(
+            find->list == NULL ? strLstNew() : find->list,
+            "123456781234568000000001-123456781234568000000003.bundle.gz\n"
+            "123456781234568000000004-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\n",
+            "bundle is kept");
+        TEST_RESULT_STR_Z(
+            walSegmentFind(find, STRDEF("123456781234568000000003")), "123456781234568000000001-123456781234568000000003.bundle.gz",
+            "find last in bundle");
+        TEST_RESULT_STRLST_Z(
+            find->list == NULL ? strLstNew() : find->list, "123456781234568000000004-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\n",
+            "bundle is removed");
+        TEST_RESULT_STR_Z(
+            walSegmentFind(find, STRDEF("123456781234568000000004")),
+            "123456781234568000000004-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", "find after bundle");
     }
 
     // *****************************************************************************************************************************
@@ -449,5 +485,191 @@ testRun(void)
         TEST_RESULT_STRLST_Z(strLstSort(list, sortOrderDesc), "11-10\n10-4\n9.4-2\n9.6-1\n", "sort descending");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("archiveSegmentList()"))
+    {
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "db");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, "/path/to/pg");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH);
+        HRN_CFG_LOAD(cfgCmdArchiveGet, argList);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("missing path");
+
+        TEST_RESULT_STRLST_Z(archiveSegmentList(0, STRDEF("9.6-2"), STRDEF("0000000100000001"), false), NULL, "empty list");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("list is cached until refreshed");
+
+        HRN_STORAGE_PUT_EMPTY(
+            storageRepoWrite(),
+            STORAGE_REPO_ARCHIVE "/9.6-2/0000000100000001/000000010000000100000002-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa.gz");
+        HRN_STORAGE_PUT_EMPTY(
+            storageRepoWrite(),
+            STORAGE_REPO_ARCHIVE "/9.6-2/0000000100000001/000000010000000100000001-bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb");
+        HRN_STORAGE_PUT_EMPTY(
+            storageRepoWrite(),
+            STORAGE_REPO_ARCHIVE "/9.6-2/0000000100000001/000000010000000100000003.partial-cccccccccccccccccccccccccccccccccccccccc");
+        HRN_STORAGE_PUT_EMPTY(
+            storageRepoWrite(),
+            STORAGE_REPO_ARCHIVE "/9.6-2/0000000200000001/000000020000000100000001-dddddddddddddddddddddddddddddddddddddddd");
+
+        TEST_RESULT_STRLST_Z(
+            archiveSegmentList(0, STRDEF("9.6-2"), STRDEF("0000000100000001"), false), NULL, "cached empty list");
+        TEST_RESULT_STRLST_Z(
+            archiveSegmentList(0, STRDEF("9.6-2"), STRDEF("0000000100000001"), true),
+            "000000010000000100000001-bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb\n"
+            "000000010000000100000002-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa.gz\n",
+            "refreshed list");
+        TEST_RESULT_STRLST_Z(
+            archiveSegmentList(0, STRDEF("9.6-2"), STRDEF("0000000200000001"), false),
+            "000000020000000100000001-dddddddddddddddddddddddddddddddddddddddd\n", "another path");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("WAL bundles"))
+    {
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "db");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, "/path/to/pg");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH);
+        HRN_CFG_LOAD(cfgCmdArchiveGet, argList);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("bundle name");
+
+        const String *const bundle = STRDEF("000000010000000100000002-000000010000000100000004.bundle");
+
+        TEST_RESULT_BOOL(walIsBundle(bundle), true, "bundle");
+        TEST_RESULT_BOOL(walIsBundle(STRDEF("000000010000000100000002-000000010000000100000004.bundle.zst")), true, "compressed");
+        TEST_RESULT_BOOL(
+            walIsBundle(STRDEF("000000010000000100000002-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa")), false, "segment");
+
+        TEST_RESULT_BOOL(walBundleContains(bundle, STRDEF("000000010000000100000001")), false, "before bundle");
+        TEST_RESULT_BOOL(walBundleContains(bundle, STRDEF("000000010000000100000002")), true, "first in bundle");
+        TEST_RESULT_BOOL(walBundleContains(bundle, STRDEF("000000010000000100000004")), true, "last in bundle");
+        TEST_RESULT_BOOL(walBundleContains(bundle, STRDEF("000000010000000100000005")), false, "after bundle");
+        TEST_RESULT_BOOL(walBundleContains(bundle, STRDEF("000000010000000100000003.partial")), false, "partial");
+
+        TEST_RESULT_STR_Z(walArchiveFileStop(bundle), "000000010000000100000004", "bundle stop");
+        TEST_RESULT_STR_Z(
+            walArchiveFileStop(STRDEF("000000010000000100000002-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa")),
+            "000000010000000100000002", "segment stop");
+
+        TEST_RESULT_STRLST_Z(
+            walBundleSegmentList(bundle), "000000010000000100000002\n000000010000000100000003\n000000010000000100000004\n",
+            "segment list");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("segment expression");
+
+        const String *expression = NULL;
+
+        TEST_ASSIGN(expression, walSegmentExpression(STRDEF("000000010000000100000003")), "segment expression");
+        TEST_RESULT_BOOL(
+            regExpMatchOne(expression, STRDEF("000000010000000100000003-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa.gz")), true,
+            "match segment");
+        TEST_RESULT_BOOL(
+            regExpMatchOne(expression, STRDEF("000000010000000100000004-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa")), false,
+            "no match other segment");
+        TEST_RESULT_BOOL(regExpMatchOne(expression, bundle), true, "match bundle");
+        TEST_RESULT_BOOL(
+            regExpMatchOne(expression, STRDEF("000000010000000200000002-000000010000000200000004.bundle")), false,
+            "no match bundle in another path");
+
+        TEST_ASSIGN(expression, walSegmentExpression(STRDEF("000000010000000100000003.partial")), "partial expression");
+        TEST_RESULT_BOOL(
+            regExpMatchOne(expression, STRDEF("000000010000000100000003.partial-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa")), true,
+            "match partial");
+        TEST_RESULT_BOOL(regExpMatchOne(expression, bundle), false, "no match bundle");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("read segments from a bundle");
+
+        Buffer *index = bufNew(0);
+        walBundleIndexAdd(index, cryptoHashOne(hashTypeSha1, BUFSTRDEF("ABC")), 3);
+        walBundleIndexAdd(index, cryptoHashOne(hashTypeSha1, BUFSTRDEF("DEFG")), 4);
+        walBundleIndexAdd(index, cryptoHashOne(hashTypeSha1, BUFSTRDEF("HI")), 2);
+        TEST_RESULT_UINT(bufUsed(index), 3 * WAL_BUNDLE_INDEX_ENTRY_SIZE, "index size");
+
+        Buffer *content = bufDup(index);
+        bufCat(content, BUFSTRDEF("ABCDEFGHI"));
+
+        const String *const bundlePathFile = STRDEF(
+            STORAGE_REPO_ARCHIVE "/9.6-2/000000010000000100000002-000000010000000100000004.bundle");
+
+        HRN_STORAGE_PUT(storageRepoWrite(), strZ(bundlePathFile), content);
+
+        List *indexList = NULL;
+        TEST_ASSIGN(indexList, walBundleIndex(storageRepo(), bundlePathFile, false), "read index");
+        TEST_RESULT_UINT(lstSize(indexList), 3, "index entries");
+        TEST_RESULT_STR_Z(((WalBundleSegment *)lstGet(indexList, 1))->segment, "000000010000000100000003", "segment");
+        TEST_RESULT_STR_Z(
+            ((WalBundleSegment *)lstGet(indexList, 1))->checksum, "bd0579dcfc535f166e923da1262a47dec907608c", "checksum");
+        TEST_RESULT_UINT(((WalBundleSegment *)lstGet(indexList, 1))->offset, 3 * WAL_BUNDLE_INDEX_ENTRY_SIZE + 3, "offset");
+        TEST_RESULT_UINT(((WalBundleSegment *)lstGet(indexList, 1))->size, 4, "size");
+
+        TEST_RESULT_STR_Z(
+            walArchiveFileChecksum(storageRepo(), bundlePathFile, STRDEF("000000010000000100000004")),
+            "253420c1158bc6382093d409ce2e9cff5806e980", "bundle checksum");
+        TEST_RESULT_STR_Z(
+            strNewBuf(
+                storageGetP(
+                    walSegmentReadNew(storageRepo(), bundlePathFile, STRDEF("000000010000000100000003"), false, false))),
+            "DEFG", "read segment from bundle");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("bundle index is cached");
+
+        HRN_STORAGE_REMOVE(storageRepoWrite(), strZ(bundlePathFile), .errorOnMissing = true);
+
+        TEST_RESULT_STR_Z(
+            walArchiveFileChecksum(storageRepo(), bundlePathFile, STRDEF("000000010000000100000002")),
+            "3c01bdbb26f358bab27f267924aa2c9a03fcfdb8", "checksum from cached index");
+        TEST_ERROR(
+            walArchiveFileChecksum(storageRepoWrite(), bundlePathFile, STRDEF("000000010000000100000002")), FileMissingError,
+            "unable to open missing file '" TEST_PATH "/archive/db/9.6-2/0000000100000001/"
+            "000000010000000100000002-000000010000000100000004.bundle' for read");
+
+        HRN_STORAGE_PUT(storageRepoWrite(), strZ(bundlePathFile), content);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("read segment that is not in a bundle");
+
+        const String *const segmentPathFile = STRDEF(
+            STORAGE_REPO_ARCHIVE "/9.6-2/000000010000000100000001-717c4ecc723910edc13dd2491b0fae91442619da");
+
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), strZ(segmentPathFile), "XYZ");
+
+        TEST_RESULT_STR_Z(
+            walArchiveFileChecksum(storageRepo(), segmentPathFile, STRDEF("000000010000000100000001")),
+            "717c4ecc723910edc13dd2491b0fae91442619da", "segment checksum");
+        TEST_RESULT_STR_Z(
+            strNewBuf(
+                storageGetP(
+                    walSegmentReadNew(storageRepo(), segmentPathFile, STRDEF("000000010000000100000001"), false, false))),
+            "XYZ", "read segment");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("missing and invalid bundles");
+
+        const String *const invalidPathFile = STRDEF(
+            STORAGE_REPO_ARCHIVE "/9.6-2/000000010000000100000005-000000010000000100000006.bundle");
+
+        TEST_RESULT_PTR(
+            walSegmentReadNew(storageRepo(), invalidPathFile, STRDEF("000000010000000100000005"), false, true),
+            NULL, "missing bundle");
+        TEST_RESULT_PTR(
+            walBundleIndex(storageRepo(), invalidPathFile, true), NULL, "missing index");
+
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), strZ(invalidPathFile), "BOGUS");
+
+        TEST_ERROR(
+            walBundleIndex(storageRepo(), invalidPathFile, false), FileReadError,
+            "unable to read 56 byte(s) from '" TEST_PATH "/archive/db/9.6-2/0000000100000001/"
+            "000000010000000100000005-000000010000000100000006.bundle'");
+    }
+
     FUNCTION_HARNESS_RETURN_VOID();
 }
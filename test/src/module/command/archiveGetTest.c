@@ -1,6 +1,7 @@
 /***********************************************************************************************************************************
 Test Archive Get Command
 ***********************************************************************************************************************************/
+#include "common/crypto/hash.h"
 #include "common/io/fdRead.h"
 #include "common/io/fdWrite.h"
 
@@ -930,6 +931,26 @@ testRun(void)
             storageRepoWrite(), STORAGE_REPO_ARCHIVE "/10-4/01ABCDEF01ABCDEF01ABCDEF-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
             .remove = true);
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("get WAL segment from a bundle");
+
+        Buffer *bundle = bufNew(0);
+        walBundleIndexAdd(bundle, cryptoHashOne(hashTypeSha1, BUFSTRDEF("SEGMENT1")), 8);
+        walBundleIndexAdd(bundle, cryptoHashOne(hashTypeSha1, BUFSTRDEF("SEGMENT02")), 9);
+        bufCat(bundle, BUFSTRDEF("SEGMENT1SEGMENT02"));
+
+        HRN_STORAGE_PUT(
+            storageRepoWrite(), STORAGE_REPO_ARCHIVE "/10-4/01ABCDEF01ABCDEF01ABCDEE-01ABCDEF01ABCDEF01ABCDEF.bundle", bundle);
+
+        TEST_RESULT_INT(cmdArchiveGet(), 0, "get");
+
+        TEST_RESULT_LOG("P00   INFO: found 01ABCDEF01ABCDEF01ABCDEF in the repo1: 10-4 archive");
+
+        TEST_STORAGE_GET(storagePgWrite(), "pg_wal/RECOVERYXLOG", "SEGMENT02", .remove = true);
+        TEST_STORAGE_EXISTS(
+            storageRepoWrite(), STORAGE_REPO_ARCHIVE "/10-4/01ABCDEF01ABCDEF01ABCDEE-01ABCDEF01ABCDEF01ABCDEF.bundle",
+            .remove = true);
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("get partial");
 
@@ -1284,6 +1305,29 @@ testRun(void)
         TEST_ERROR(
             cmdArchiveGet(), ConfigError,
             "The buffer must be greater than or equal to the page size of the WAL file. Page size: 32KB, buffer size: 16KB.");
+
+        TEST_TITLE("contiguous ranges of segments per client");
+
+        List *const archiveFileMapList = lstNewP(sizeof(ArchiveFileMap));
+
+        for (unsigned int archiveFileIdx = 0; archiveFileIdx < 5; archiveFileIdx++)
+            lstAdd(archiveFileMapList, &(ArchiveFileMap){0});
+
+        ArchiveGetAsyncData jobData =
+        {
+            .archiveFileMapList = archiveFileMapList,
+            .rangeList = lstNewP(sizeof(ArchiveGetAsyncRange)),
+        };
+        lstAdd(jobData.rangeList, &(ArchiveGetAsyncRange){.archiveFileIdx = 0, .archiveFileEnd = 2});
+        lstAdd(jobData.rangeList, &(ArchiveGetAsyncRange){.archiveFileIdx = 2, .archiveFileEnd = 5});
+
+        TEST_RESULT_UINT(archiveGetAsyncRangeNext(&jobData, 0), 0, "client 1 starts its range");
+        TEST_RESULT_UINT(archiveGetAsyncRangeNext(&jobData, 1), 2, "client 2 starts its range");
+        TEST_RESULT_UINT(archiveGetAsyncRangeNext(&jobData, 0), 1, "client 1 continues its range");
+        TEST_RESULT_UINT(archiveGetAsyncRangeNext(&jobData, 0), 4, "client 1 takes second half of client 2 range");
+        TEST_RESULT_UINT(archiveGetAsyncRangeNext(&jobData, 1), 3, "client 2 continues its range");
+        TEST_RESULT_UINT(archiveGetAsyncRangeNext(&jobData, 1), 5, "no segments left");
+        TEST_RESULT_UINT(archiveGetAsyncRangeNext(&jobData, 0), 5, "no segments left");
     }
 
     FUNCTION_HARNESS_RETURN_VOID();
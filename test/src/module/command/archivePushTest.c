@@ -1,9 +1,12 @@
 /***********************************************************************************************************************************
 Test Archive Push Command
 ***********************************************************************************************************************************/
+#include "common/compress/helper.h"
+#include "common/crypto/cipherBlock.h"
 #include "common/io/fdRead.h"
 #include "common/io/fdWrite.h"
 #include "common/time.h"
+#include "common/wait.h"
 #include "postgres/version.h"
 #include "storage/posix/storage.h"
 
@@ -13,6 +16,31 @@ Test Archive Push Command
 #include "common/harnessPostgres.h"
 #include "common/harnessProtocol.h"
 
+/***********************************************************************************************************************************
+Wait for a status file in the spool path to exist or be removed
+***********************************************************************************************************************************/
+static bool
+testStatusWait(const char *const file, const bool exists)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM(STRINGZ, file);
+        FUNCTION_HARNESS_PARAM(BOOL, exists);
+    FUNCTION_HARNESS_END();
+
+    Wait *const wait = waitNew(5000);
+    bool result;
+
+    do
+    {
+        result = storageExistsP(storageSpool(), strNewFmt(STORAGE_SPOOL_ARCHIVE_OUT "/%s", file)) == exists;
+    }
+    while (!result && waitMore(wait));
+
+    waitFree(wait);
+
+    FUNCTION_HARNESS_RETURN(BOOL, result);
+}
+
 /***********************************************************************************************************************************
 Test Run
 ***********************************************************************************************************************************/
@@ -54,9 +82,12 @@ testRun(void)
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("ready list");
 
+        StringList *okList = strLstNew();
+
         TEST_RESULT_STRLST_Z(
-            archivePushProcessList(STRDEF(TEST_PATH "/db/pg_wal")),
+            archivePushProcessList(STRDEF(TEST_PATH "/db/pg_wal"), okList),
             "000000010000000100000002\n000000010000000100000005\n000000010000000100000006\n", "ready list");
+        TEST_RESULT_STRLST_Z(okList, "000000010000000100000003\n", "kept ok list");
 
         TEST_STORAGE_LIST(
             storageSpool(), STORAGE_SPOOL_ARCHIVE_OUT, "000000010000000100000003.ok\n", .comment = "remaining status list");
@@ -81,7 +112,8 @@ testRun(void)
 
         // Queue max is high enough that no WAL will be dropped
         TEST_RESULT_BOOL(
-            archivePushDrop(STRDEF("pg_wal"), archivePushProcessList(STRDEF(TEST_PATH "/db/pg_wal"))), false, "wal is not dropped");
+            archivePushDrop(STRDEF("pg_wal"), archivePushProcessList(STRDEF(TEST_PATH "/db/pg_wal"), NULL)), false,
+            "wal is not dropped");
 
         // Now set queue max low enough that WAL will be dropped
         argListDrop = strLstDup(argList);
@@ -89,7 +121,8 @@ testRun(void)
         HRN_CFG_LOAD(cfgCmdArchivePush, argListDrop, .role = cfgCmdRoleAsync);
 
         TEST_RESULT_BOOL(
-            archivePushDrop(STRDEF("pg_wal"), archivePushProcessList(STRDEF(TEST_PATH "/db/pg_wal"))), true, "wal is dropped");
+            archivePushDrop(STRDEF("pg_wal"), archivePushProcessList(STRDEF(TEST_PATH "/db/pg_wal"), NULL)), true,
+            "wal is dropped");
 
         // No WAL to be processed
         TEST_RESULT_BOOL(archivePushDrop(STRDEF("pg_wal"), strLstNew()), false, "no WAL to be processed");
@@ -416,6 +449,59 @@ testRun(void)
                 strNewFmt("repo/archive/test/11-1/0000000100000001/000000010000000100000002-%s.gz.pgbackrest.tmp", walBuffer2Sha1)),
             false, "check WAL tmp file is gone");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("push WAL in a single pass");
+
+        argListTemp = strLstNew();
+        hrnCfgArgRawZ(argListTemp, cfgOptStanza, "test");
+        hrnCfgArgRawZ(argListTemp, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawBool(argListTemp, cfgOptArchivePushSinglePass, true);
+        strLstAddZ(argListTemp, TEST_PATH "/pg/pg_wal/000000010000000100000003");
+        HRN_CFG_LOAD(cfgCmdArchivePush, argListTemp);
+
+        HRN_STORAGE_PUT(storageTest, "pg/pg_wal/000000010000000100000003", walBuffer2, .comment = "write WAL");
+
+        TEST_RESULT_VOID(cmdArchivePush(), "push the WAL segment");
+        TEST_RESULT_LOG("P00   INFO: pushed WAL file '000000010000000100000003' to the archive");
+
+        StorageRead *read = storageNewReadP(
+            storageRepoIdx(0),
+            strNewFmt(STORAGE_REPO_ARCHIVE "/11-1/0000000100000001/000000010000000100000003-%s.gz", walBuffer2Sha1));
+        ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), decompressFilterP(compressTypeGz));
+
+        TEST_RESULT_BOOL(bufEq(storageGetP(read), walBuffer2), true, "check repo for compressed WAL file");
+
+        argListTemp = strLstNew();
+        hrnCfgArgRawZ(argListTemp, cfgOptStanza, "test");
+        hrnCfgArgRawZ(argListTemp, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawBool(argListTemp, cfgOptArchivePushSinglePass, true);
+        hrnCfgArgRawZ(argListTemp, cfgOptCompressType, "none");
+        strLstAddZ(argListTemp, TEST_PATH "/pg/pg_wal/000000010000000100000004");
+        HRN_CFG_LOAD(cfgCmdArchivePush, argListTemp);
+
+        HRN_STORAGE_PUT(storageTest, "pg/pg_wal/000000010000000100000004", walBuffer2, .comment = "write WAL");
+
+        TEST_RESULT_VOID(cmdArchivePush(), "push the WAL segment uncompressed");
+        TEST_RESULT_LOG("P00   INFO: pushed WAL file '000000010000000100000004' to the archive");
+
+        TEST_RESULT_BOOL(
+            bufEq(
+                storageGetP(
+                    storageNewReadP(
+                        storageRepoIdx(0),
+                        strNewFmt(STORAGE_REPO_ARCHIVE "/11-1/0000000100000001/000000010000000100000004-%s", walBuffer2Sha1))),
+                walBuffer2),
+            true, "check repo for uncompressed WAL file");
+
+        HRN_STORAGE_REMOVE(
+            storageRepoIdxWrite(0),
+            zNewFmt(STORAGE_REPO_ARCHIVE "/11-1/0000000100000001/000000010000000100000003-%s.gz", walBuffer2Sha1),
+            .errorOnMissing = true);
+        HRN_STORAGE_REMOVE(
+            storageRepoIdxWrite(0),
+            zNewFmt(STORAGE_REPO_ARCHIVE "/11-1/0000000100000001/000000010000000100000004-%s", walBuffer2Sha1),
+            .errorOnMissing = true);
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("push a history file");
 
@@ -642,6 +728,77 @@ testRun(void)
             .remove = true);
 
         HRN_STORAGE_MODE(storageTest, "repo2/archive/test/11-1");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("push a compressed bundle to multiple repos, one encrypted");
+
+        HRN_STORAGE_PUT(storageTest, "pg/pg_wal/000000010000000100000003", walBuffer2, .comment = "write WAL");
+
+        List *repoList = lstNewP(sizeof(ArchivePushFileRepoData));
+        lstAdd(
+            repoList,
+            &(ArchivePushFileRepoData){
+                .repoIdx = 0, .archiveId = STRDEF("11-1"), .cipherType = cipherTypeAes256Cbc,
+                .cipherPass = STRDEF("badsubpassphrase")});
+        lstAdd(repoList, &(ArchivePushFileRepoData){.repoIdx = 1, .archiveId = STRDEF("11-1"), .cipherType = cipherTypeNone});
+
+        const String *const bundleFile = STRDEF("000000010000000100000002-000000010000000100000003.bundle");
+        const String *const bundlePathFile = STRDEF(
+            STORAGE_REPO_ARCHIVE "/11-1/000000010000000100000002-000000010000000100000003.bundle.gz");
+
+        TEST_RESULT_STRLST_Z(
+            archivePushBundle(
+                STRDEF(TEST_PATH "/pg/pg_wal"), true, PG_VERSION_11, HRN_PG_SYSTEMID_11, bundleFile, compressTypeGz, 1, repoList,
+                strLstNew()).warnList,
+            NULL, "push bundle");
+
+        TEST_RESULT_STR_Z(
+            walArchiveFileChecksum(storageRepoIdx(0), bundlePathFile, STRDEF("000000010000000100000003")), walBuffer2Sha1,
+            "repo2 checksum");
+
+        read = walSegmentReadNew(storageRepoIdx(0), bundlePathFile, STRDEF("000000010000000100000003"), false, false);
+        ioFilterGroupAdd(
+            ioReadFilterGroup(storageReadIo(read)),
+            cipherBlockNewP(cipherModeDecrypt, cipherTypeAes256Cbc, BUFSTRDEF("badsubpassphrase")));
+        ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), decompressFilterP(compressTypeGz));
+        TEST_RESULT_BOOL(bufEq(storageGetP(read), walBuffer2), true, "repo2 segment");
+
+        read = walSegmentReadNew(storageRepoIdx(1), bundlePathFile, STRDEF("000000010000000100000002"), false, false);
+        ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), decompressFilterP(compressTypeGz));
+        TEST_RESULT_BOOL(bufEq(storageGetP(read), walBuffer2), true, "repo3 segment");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("WAL already exists in a bundle in both repos");
+
+        TEST_RESULT_VOID(cmdArchivePush(), "push the WAL segment");
+        TEST_RESULT_LOG(
+            "P00   WARN: WAL file '000000010000000100000002' already exists in the repo2 archive with the same checksum\n"
+            "            HINT: this is valid in some recovery scenarios but may also indicate a problem.\n"
+            "P00   WARN: WAL file '000000010000000100000002' already exists in the repo3 archive with the same checksum\n"
+            "            HINT: this is valid in some recovery scenarios but may also indicate a problem.\n"
+            "P00   INFO: pushed WAL file '000000010000000100000002' to the archive");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("bundle write error on one repo but other repo succeeds");
+
+        HRN_STORAGE_MODE(storageTest, "repo2/archive/test/11-1/0000000100000001", .mode = 0500);
+
+        TEST_ERROR(
+            archivePushBundle(
+                STRDEF(TEST_PATH "/pg/pg_wal"), false, PG_VERSION_11, HRN_PG_SYSTEMID_11, bundleFile, compressTypeNone, 0, repoList,
+                strLstNew()),
+            CommandError,
+            "archive-push command encountered error(s):\n"
+            "repo2: [FileOpenError] unable to open file '" TEST_PATH "/repo2/archive/test/11-1/0000000100000001"
+            "/000000010000000100000002-000000010000000100000003.bundle' for write: [13] Permission denied");
+
+        TEST_STORAGE_LIST(
+            storageTest, "repo3/archive/test/11-1/0000000100000001",
+            "000000010000000100000002-000000010000000100000003.bundle\n"
+            "000000010000000100000002-000000010000000100000003.bundle.gz\n",
+            .comment = "check repo3 for bundles");
+
+        HRN_STORAGE_MODE(storageTest, "repo2/archive/test/11-1/0000000100000001");
     }
 
     // *****************************************************************************************************************************
@@ -876,7 +1033,8 @@ testRun(void)
             "P01 DETAIL: pushed WAL file '000000010000000100000001' to the archive\n"
             "P01   WARN: could not push WAL file '000000010000000100000002' to the archive (will be retried): "
             "[55] raised from local-1 shim protocol: " STORAGE_ERROR_READ_MISSING "\n"
-            "            [RETRY DETAIL OMITTED]",
+            "            [RETRY DETAIL OMITTED]\n"
+            "P00 DETAIL: avoided 2 repo list request(s) when checking for existing WAL",
             TEST_PATH "/pg/pg_xlog/000000010000000100000002");
 
         TEST_STORAGE_EXISTS(
@@ -907,6 +1065,7 @@ testRun(void)
 
         argListTemp = strLstDup(argList);
         hrnCfgArgRawZ(argListTemp, cfgOptArchivePushQueueMax, "1gb");
+        hrnCfgArgRawBool(argListTemp, cfgOptArchivePushSinglePass, true);
         HRN_CFG_LOAD(cfgCmdArchivePush, argListTemp, .role = cfgCmdRoleAsync);
 
         TEST_RESULT_VOID(cmdArchivePushAsync(), "push WAL segments");
@@ -972,6 +1131,272 @@ testRun(void)
         // Remove the ready file to prevent WAL 3 from being considered for the next test
         HRN_STORAGE_REMOVE(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000003.ready", .errorOnMissing = true);
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("archive path is listed once per batch");
+
+        ArchivePushAsyncData existData = {.existList = lstNewP(sizeof(ArchivePushAsyncExist))};
+        lstAdd(existData.existList, &(ArchivePushAsyncExist){0});
+
+        ArchivePushFileRepoData existRepo = {.archiveId = STRDEF("9.4-1")};
+
+        TEST_RESULT_VOID(
+            archivePushAsyncExist(&existData, 0, STRDEF("000000010000000100000001"), &existRepo), "check WAL 1");
+        TEST_RESULT_BOOL(existRepo.existChecked, true, "WAL 1 checked");
+        TEST_RESULT_STR(existRepo.existFile, strNewFmt("000000010000000100000001-%s", walBuffer1Sha1), "WAL 1 found");
+        TEST_RESULT_UINT(existData.existAvoidTotal, 0, "list was not avoided");
+
+        HRN_STORAGE_PUT_EMPTY(
+            storageTest,
+            "repo/archive/test/9.4-1/0000000100000001/000000010000000100000009-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+
+        existRepo = (ArchivePushFileRepoData){.archiveId = STRDEF("9.4-1")};
+
+        TEST_RESULT_VOID(
+            archivePushAsyncExist(&existData, 0, STRDEF("000000010000000100000009"), &existRepo), "check WAL 9");
+        TEST_RESULT_BOOL(existRepo.existChecked, true, "WAL 9 checked");
+        TEST_RESULT_STR(existRepo.existFile, NULL, "WAL 9 pushed after the list is not found");
+        TEST_RESULT_UINT(existData.existAvoidTotal, 1, "list was avoided");
+
+        existData = (ArchivePushAsyncData){.existList = lstNewP(sizeof(ArchivePushAsyncExist))};
+        lstAdd(existData.existList, &(ArchivePushAsyncExist){0});
+
+        existRepo = (ArchivePushFileRepoData){.archiveId = STRDEF("9.4-1")};
+
+        TEST_RESULT_VOID(
+            archivePushAsyncExist(&existData, 0, STRDEF("000000010000000100000009"), &existRepo), "check WAL 9 in next batch");
+        TEST_RESULT_BOOL(existRepo.existChecked, true, "WAL 9 checked");
+        TEST_RESULT_STR_Z(existRepo.existFile, "000000010000000100000009-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", "WAL 9 found");
+        TEST_RESULT_UINT(existData.existAvoidTotal, 0, "list was not avoided");
+
+        HRN_STORAGE_REMOVE(
+            storageTest,
+            "repo/archive/test/9.4-1/0000000100000001/000000010000000100000009-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("local reports duplicates and list errors when checking for existing WAL");
+
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000100000004", walBuffer3);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000004.ready");
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000100000005", walBuffer3);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000005.ready");
+        HRN_STORAGE_PUT_Z(storagePgWrite(), "pg_xlog/00000002.history", "HISTORY");
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/00000002.history.ready");
+
+        HRN_STORAGE_PUT_EMPTY(
+            storageTest,
+            "repo/archive/test/9.4-1/0000000100000001/000000010000000100000004-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+        HRN_STORAGE_PUT_EMPTY(
+            storageTest,
+            "repo/archive/test/9.4-1/0000000100000001/000000010000000100000004-bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb");
+        HRN_STORAGE_MODE(storageTest, "repo3/archive/test/9.4-1/0000000100000001", .mode = 0300);
+
+        TEST_RESULT_VOID(cmdArchivePushAsync(), "push WAL segments");
+        TEST_RESULT_LOG(
+            "P00   INFO: push 3 WAL file(s) to archive: 000000010000000100000004...00000002.history\n"
+            "P00 DETAIL: unable to check repo3 for existing WAL: unable to list file info for path '" TEST_PATH
+            "/repo3/archive/test/9.4-1/0000000100000001': [13] Permission denied\n"
+            "P01   WARN: could not push WAL file '000000010000000100000004' to the archive (will be retried): [104] raised from"
+            " local-1 shim protocol: archive-push command encountered error(s):\n"
+            "            repo1: [ArchiveDuplicateError] duplicates found in archive for WAL segment 000000010000000100000004:"
+            " 000000010000000100000004-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa,"
+            " 000000010000000100000004-bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb\n"
+            "            HINT: are multiple primaries archiving to this stanza?\n"
+            "            repo3: [PathOpenError] unable to list file info for path '" TEST_PATH "/repo3/archive/test/9.4-1"
+            "/0000000100000001': [13] Permission denied\n"
+            "P01   WARN: could not push WAL file '000000010000000100000005' to the archive (will be retried): [104] raised from"
+            " local-1 shim protocol: archive-push command encountered error(s):\n"
+            "            repo3: [PathOpenError] unable to list file info for path '" TEST_PATH "/repo3/archive/test/9.4-1"
+            "/0000000100000001': [13] Permission denied\n"
+            "P01 DETAIL: pushed WAL file '00000002.history' to the archive\n"
+            "P00 DETAIL: avoided 1 repo list request(s) when checking for existing WAL");
+
+        TEST_STORAGE_EXISTS(
+            storageTest, zNewFmt("repo/archive/test/9.4-1/0000000100000001/000000010000000100000005-%s", walBuffer3Sha1),
+            .remove = true, .comment = "check repo1 for WAL 5 file then remove");
+
+        HRN_STORAGE_MODE(storageTest, "repo3/archive/test/9.4-1/0000000100000001");
+        HRN_STORAGE_REMOVE(
+            storageTest,
+            "repo/archive/test/9.4-1/0000000100000001/000000010000000100000004-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+        HRN_STORAGE_REMOVE(
+            storageTest,
+            "repo/archive/test/9.4-1/0000000100000001/000000010000000100000004-bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb");
+        HRN_STORAGE_REMOVE(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000004.ready", .errorOnMissing = true);
+        HRN_STORAGE_REMOVE(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000005.ready", .errorOnMissing = true);
+        HRN_STORAGE_REMOVE(storagePgWrite(), "pg_xlog/archive_status/00000002.history.ready", .errorOnMissing = true);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("push consecutive WAL in bundles");
+
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000100000006", walBuffer1);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000006.ready");
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000100000007", walBuffer2);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000007.ready");
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000100000008", walBuffer3);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000008.ready");
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000100000009", walBuffer1);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000009.ready");
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/00000001000000010000000A", walBuffer2);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/00000001000000010000000A.ready");
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000100000010", walBuffer3);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000010.ready");
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000100000011.partial", walBuffer1);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000011.partial.ready");
+        HRN_STORAGE_PUT_Z(storagePgWrite(), "pg_xlog/00000003.history", "HISTORY");
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/00000003.history.ready");
+
+        // WAL 9 already exists in repo1 so it cannot be bundled
+        HRN_STORAGE_PUT(
+            storageTest, zNewFmt("repo/archive/test/9.4-1/0000000100000001/000000010000000100000009-%s", walBuffer1Sha1),
+            walBuffer1);
+
+        argListTemp = strLstDup(argList);
+        hrnCfgArgRawBool(argListTemp, cfgOptArchivePushBundle, true);
+        hrnCfgArgRawZ(argListTemp, cfgOptArchivePushBundleMax, "2");
+        HRN_CFG_LOAD(cfgCmdArchivePush, argListTemp, .role = cfgCmdRoleAsync);
+
+        TEST_RESULT_VOID(cmdArchivePushAsync(), "push WAL segments");
+        TEST_RESULT_LOG(
+            "P00   INFO: push 8 WAL file(s) to archive: 000000010000000100000006...00000003.history\n"
+            "P01 DETAIL: pushed WAL file '000000010000000100000006' to the archive in bundle"
+            " '000000010000000100000006-000000010000000100000007.bundle'\n"
+            "P01 DETAIL: pushed WAL file '000000010000000100000007' to the archive in bundle"
+            " '000000010000000100000006-000000010000000100000007.bundle'\n"
+            "P01 DETAIL: pushed WAL file '000000010000000100000008' to the archive\n"
+            "P01   WARN: WAL file '000000010000000100000009' already exists in the repo1 archive with the same checksum\n"
+            "            HINT: this is valid in some recovery scenarios but may also indicate a problem.\n"
+            "P01 DETAIL: pushed WAL file '000000010000000100000009' to the archive\n"
+            "P01 DETAIL: pushed WAL file '00000001000000010000000A' to the archive\n"
+            "P01 DETAIL: pushed WAL file '000000010000000100000010' to the archive\n"
+            "P01 DETAIL: pushed WAL file '000000010000000100000011.partial' to the archive\n"
+            "P01 DETAIL: pushed WAL file '00000003.history' to the archive\n"
+            "P00 DETAIL: avoided 14 repo list request(s) when checking for existing WAL\n"
+            "P00 DETAIL: pushed 2 WAL segment(s) to the archive in 1 bundle(s)");
+
+        TEST_STORAGE_EXISTS(
+            storageTest, "repo/archive/test/9.4-1/0000000100000001/000000010000000100000006-000000010000000100000007.bundle",
+            .comment = "check repo1 for bundle");
+        TEST_STORAGE_EXISTS(
+            storageTest, "repo3/archive/test/9.4-1/0000000100000001/000000010000000100000006-000000010000000100000007.bundle",
+            .comment = "check repo3 for bundle");
+        TEST_RESULT_BOOL(
+            bufEq(
+                storageGetP(
+                    walSegmentReadNew(
+                        storageRepoIdx(1),
+                        STRDEF(STORAGE_REPO_ARCHIVE "/9.4-1/000000010000000100000006-000000010000000100000007.bundle"),
+                        STRDEF("000000010000000100000007"), false, false)),
+                walBuffer2),
+            true, "check WAL 7 in repo3 bundle");
+
+        TEST_STORAGE_LIST(
+            storageSpool(), STORAGE_SPOOL_ARCHIVE_OUT,
+            "000000010000000100000001.ok\n"
+            "000000010000000100000002.ok\n"
+            "000000010000000100000006.ok\n"
+            "000000010000000100000007.ok\n"
+            "000000010000000100000008.ok\n"
+            "000000010000000100000009.ok\n"
+            "00000001000000010000000A.ok\n"
+            "000000010000000100000010.ok\n"
+            "000000010000000100000011.partial.ok\n"
+            "00000003.history.ok\n",
+            .comment = "check status files");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("push WAL that already exists in a bundle");
+
+        HRN_STORAGE_REMOVE(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_OUT "/000000010000000100000007.ok");
+
+        TEST_RESULT_VOID(cmdArchivePushAsync(), "push WAL segments");
+        TEST_RESULT_LOG(
+            "P00   INFO: push 1 WAL file(s) to archive: 000000010000000100000007\n"
+            "P01   WARN: WAL file '000000010000000100000007' already exists in the repo1 archive with the same checksum\n"
+            "            HINT: this is valid in some recovery scenarios but may also indicate a problem.\n"
+            "P01   WARN: WAL file '000000010000000100000007' already exists in the repo3 archive with the same checksum\n"
+            "            HINT: this is valid in some recovery scenarios but may also indicate a problem.\n"
+            "P01 DETAIL: pushed WAL file '000000010000000100000007' to the archive");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("bundle size is limited");
+
+        HRN_STORAGE_REMOVE(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000007.ready", .errorOnMissing = true);
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000200000001", walBuffer1);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000200000001.ready");
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000200000002", walBuffer2);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000200000002.ready");
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000200000003", walBuffer3);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000200000003.ready");
+
+        argListTemp = strLstDup(argList);
+        hrnCfgArgRawBool(argListTemp, cfgOptArchivePushBundle, true);
+        hrnCfgArgRawZ(argListTemp, cfgOptArchivePushBundleSize, "32MiB");
+        HRN_CFG_LOAD(cfgCmdArchivePush, argListTemp, .role = cfgCmdRoleAsync);
+
+        TEST_RESULT_VOID(cmdArchivePushAsync(), "push WAL segments");
+        TEST_RESULT_LOG(
+            "P00   INFO: push 3 WAL file(s) to archive: 000000010000000200000001...000000010000000200000003\n"
+            "P01 DETAIL: pushed WAL file '000000010000000200000001' to the archive in bundle"
+            " '000000010000000200000001-000000010000000200000002.bundle'\n"
+            "P01 DETAIL: pushed WAL file '000000010000000200000002' to the archive in bundle"
+            " '000000010000000200000001-000000010000000200000002.bundle'\n"
+            "P01 DETAIL: pushed WAL file '000000010000000200000003' to the archive\n"
+            "P00 DETAIL: avoided 6 repo list request(s) when checking for existing WAL\n"
+            "P00 DETAIL: pushed 2 WAL segment(s) to the archive in 1 bundle(s)");
+
+        HRN_STORAGE_REMOVE(storagePgWrite(), "pg_xlog/archive_status/000000010000000200000001.ready", .errorOnMissing = true);
+        HRN_STORAGE_REMOVE(storagePgWrite(), "pg_xlog/archive_status/000000010000000200000002.ready", .errorOnMissing = true);
+        HRN_STORAGE_REMOVE(storagePgWrite(), "pg_xlog/archive_status/000000010000000200000003.ready", .errorOnMissing = true);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("bundle push error is reported for each WAL");
+
+        argListTemp = strLstDup(argList);
+        hrnCfgArgRawBool(argListTemp, cfgOptArchivePushBundle, true);
+        HRN_CFG_LOAD(cfgCmdArchivePush, argListTemp, .role = cfgCmdRoleAsync);
+
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/00000001000000010000000B", walBuffer3);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/00000001000000010000000B.ready");
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/00000001000000010000000C.ready");
+
+        TEST_RESULT_VOID(cmdArchivePushAsync(), "push WAL segments");
+        TEST_RESULT_LOG_FMT(
+            "P00   INFO: push 2 WAL file(s) to archive: 00000001000000010000000B...00000001000000010000000C\n"
+            "P01   WARN: could not push WAL file '00000001000000010000000B' to the archive (will be retried): "
+            "[55] raised from local-1 shim protocol: " STORAGE_ERROR_READ_MISSING "\n"
+            "P01   WARN: could not push WAL file '00000001000000010000000C' to the archive (will be retried): "
+            "[55] raised from local-1 shim protocol: " STORAGE_ERROR_READ_MISSING "\n"
+            "P00 DETAIL: avoided 2 repo list request(s) when checking for existing WAL",
+            TEST_PATH "/pg/pg_xlog/00000001000000010000000C", TEST_PATH "/pg/pg_xlog/00000001000000010000000C");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("WAL is not bundled when a repo cannot be checked for existing WAL");
+
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/00000001000000010000000C", walBuffer1);
+        HRN_STORAGE_MODE(storageTest, "repo3/archive/test/9.4-1/0000000100000001", .mode = 0300);
+
+        TEST_RESULT_VOID(cmdArchivePushAsync(), "push WAL segments");
+        TEST_RESULT_LOG(
+            "P00   INFO: push 2 WAL file(s) to archive: 00000001000000010000000B...00000001000000010000000C\n"
+            "P00 DETAIL: unable to check repo3 for existing WAL: unable to list file info for path '" TEST_PATH
+            "/repo3/archive/test/9.4-1/0000000100000001': [13] Permission denied\n"
+            "P01   WARN: could not push WAL file '00000001000000010000000B' to the archive (will be retried): [104] raised from"
+            " local-1 shim protocol: archive-push command encountered error(s):\n"
+            "            repo3: [PathOpenError] unable to list file info for path '" TEST_PATH "/repo3/archive/test/9.4-1"
+            "/0000000100000001': [13] Permission denied\n"
+            "P01   WARN: could not push WAL file '00000001000000010000000C' to the archive (will be retried): [104] raised from"
+            " local-1 shim protocol: archive-push command encountered error(s):\n"
+            "            repo3: [PathOpenError] unable to list file info for path '" TEST_PATH "/repo3/archive/test/9.4-1"
+            "/0000000100000001': [13] Permission denied\n"
+            "P00 DETAIL: avoided 1 repo list request(s) when checking for existing WAL");
+
+        HRN_STORAGE_MODE(storageTest, "repo3/archive/test/9.4-1/0000000100000001");
+
+        HRN_STORAGE_PATH_REMOVE(storagePgWrite(), "pg_xlog/archive_status", .recurse = true);
+        HRN_STORAGE_PATH_CREATE(storagePgWrite(), "pg_xlog/archive_status");
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000001.ready");
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000002.ready");
+
         // Check that drop functionality works
         // -------------------------------------------------------------------------------------------------------------------------
         // Remove status files
@@ -1002,6 +1427,108 @@ testRun(void)
             "000000010000000100000002.ok\n",
             .comment = "check status files");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("warn when archive_status cannot be watched");
+
+        HRN_STORAGE_PATH_REMOVE(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_OUT, .recurse = true);
+        HRN_STORAGE_PATH_REMOVE(storagePgWrite(), "pg_xlog/archive_status", .recurse = true);
+
+        argListTemp = strLstDup(argList);
+        hrnCfgArgRawZ(argListTemp, cfgOptArchivePushWatch, "1");
+        HRN_CFG_LOAD(cfgCmdArchivePush, argListTemp, .role = cfgCmdRoleAsync);
+
+        TEST_ERROR(
+            cmdArchivePushAsync(), PathMissingError,
+            "unable to list file info for missing path '" TEST_PATH "/pg/pg_xlog/archive_status'");
+        TEST_RESULT_LOG(
+            "P00   WARN: unable to watch '" TEST_PATH "/pg/pg_xlog/archive_status' for WAL files that are ready: [2] No such file"
+            " or directory");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("exit when no WAL file becomes ready while watching");
+
+        HRN_STORAGE_PATH_REMOVE(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_OUT, .recurse = true);
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/00000001000000010000000D", walBuffer1);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/00000001000000010000000D.ready");
+
+        argListTemp = strLstDup(argList);
+        hrnCfgArgRawZ(argListTemp, cfgOptArchivePushWatch, "0.5");
+        HRN_CFG_LOAD(cfgCmdArchivePush, argListTemp, .role = cfgCmdRoleAsync);
+
+        TEST_RESULT_VOID(cmdArchivePushAsync(), "push WAL segment and wait");
+        TEST_RESULT_LOG(
+            "P00   INFO: push 1 WAL file(s) to archive: 00000001000000010000000D\n"
+            "P01 DETAIL: pushed WAL file '00000001000000010000000D' to the archive");
+
+        TEST_STORAGE_LIST(
+            storageSpool(), STORAGE_SPOOL_ARCHIVE_OUT, "00000001000000010000000D.ok\n", .comment = "check status files");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("push WAL files as they become ready while watching");
+
+        HRN_STORAGE_MOVE(
+            storagePgWrite(), "pg_xlog/archive_status/00000001000000010000000D.ready",
+            "pg_xlog/archive_status/00000001000000010000000D.done");
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/00000001000000010000000E", walBuffer1);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/00000001000000010000000E.ready");
+
+        argListTemp = strLstDup(argList);
+        hrnCfgArgRawZ(argListTemp, cfgOptArchivePushWatch, "10");
+        HRN_CFG_LOAD(cfgCmdArchivePush, argListTemp, .role = cfgCmdRoleAsync);
+
+        // Free local processes so the child does not share them with the parent
+        protocolFree();
+
+        HRN_FORK_BEGIN()
+        {
+            HRN_FORK_CHILD_BEGIN()
+            {
+                TEST_RESULT_VOID(cmdArchivePushAsync(), "push WAL segments while watching");
+                TEST_RESULT_LOG(
+                    "P01   INFO: push 1 WAL file(s) to archive: 00000001000000010000000E\n"
+                    "P01 DETAIL: pushed WAL file '00000001000000010000000E' to the archive\n"
+                    "P01   INFO: push 1 WAL file(s) to archive: 00000001000000010000000F\n"
+                    "P01 DETAIL: pushed WAL file '00000001000000010000000F' to the archive\n"
+                    "P01 DETAIL: stop watching archive_status since events were lost or the path was removed");
+
+                // Free local processes before exiting
+                protocolFree();
+            }
+            HRN_FORK_CHILD_END();
+
+            HRN_FORK_PARENT_BEGIN()
+            {
+                TEST_RESULT_BOOL(testStatusWait("00000001000000010000000E.ok", true), true, "WAL E pushed");
+
+                // WAL D was acknowledged before the process started so the ok file was removed when listing the spool path
+                TEST_STORAGE_LIST(
+                    storageSpool(), STORAGE_SPOOL_ARCHIVE_OUT, "00000001000000010000000E.ok\n", .comment = "check status files");
+
+                // Push WAL F when it becomes ready
+                HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/00000001000000010000000F", walBuffer1);
+                HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/00000001000000010000000F.ready");
+
+                TEST_RESULT_BOOL(testStatusWait("00000001000000010000000F.ok", true), true, "WAL F pushed");
+
+                // WAL E is not pushed again when the ready file is written again
+                HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/00000001000000010000000E.ready");
+
+                // The ok file is removed when PostgreSQL acknowledges WAL E
+                HRN_STORAGE_MOVE(
+                    storagePgWrite(), "pg_xlog/archive_status/00000001000000010000000E.ready",
+                    "pg_xlog/archive_status/00000001000000010000000E.done");
+
+                TEST_RESULT_BOOL(testStatusWait("00000001000000010000000E.ok", false), true, "WAL E ok removed");
+
+                // Stop watching when archive_status is removed
+                HRN_STORAGE_PATH_REMOVE(storagePgWrite(), "pg_xlog/archive_status", .recurse = true);
+            }
+            HRN_FORK_PARENT_END();
+        }
+        HRN_FORK_END();
+
+        TEST_STORAGE_LIST_EMPTY(storageSpool(), STORAGE_SPOOL_ARCHIVE_OUT, .comment = "check status files");
+
         // Uninstall local command handler shim
         hrnProtocolLocalShimUninstall();
     }
@@ -4,6 +4,7 @@ Test Backup Command
 #include "command/stanza/create.h"
 #include "command/stanza/upgrade.h"
 #include "common/crypto/hash.h"
+#include "common/crypto/xxhash.h"
 #include "common/io/bufferRead.h"
 #include "common/io/bufferWrite.h"
 #include "postgres/interface/static.vendor.h"
@@ -63,16 +64,23 @@ testBackupValidateFile(
         StorageRead *read = storageNewReadP(
             storage, strNewFmt("%s/%s", strZ(path), strZ(fileName)), .offset = file.bundleOffset,
             .limit = VARUINT64(file.sizeRepo));
-        const Buffer *const checksum = cryptoHashOne(hashTypeSha1, storageGetP(read));
+        const Buffer *const repo = storageGetP(read);
 
-        if (!bufEq(checksum, BUF(file.checksumRepoSha1, HASH_TYPE_SHA1_SIZE)))
+        if (!bufEq(cryptoHashOne(hashTypeSha1, repo), BUF(file.checksumRepoSha1, HASH_TYPE_SHA1_SIZE)))
             THROW_FMT(AssertError, "'%s' repo checksum does match manifest", strZ(file.name));
+
+        if (file.checksumRepoXxh3 != NULL &&
+            !bufEq(xxHashOne(XX_HASH_SIZE_MAX, repo), BUF(file.checksumRepoXxh3, XX_HASH_SIZE_MAX)))
+        {
+            THROW_FMT(AssertError, "'%s' repo xxh3 checksum does match manifest", strZ(file.name));
+        }
     }
 
     // Calculate checksum/size and decompress if needed
     // -------------------------------------------------------------------------------------------------------------
     uint64_t size = 0;
     const Buffer *checksum = NULL;
+    const Buffer *checksumXxh3 = NULL;
 
     // If block incremental
     if (file.blockIncrMapSize != 0)
@@ -157,6 +165,7 @@ testBackupValidateFile(
         strCatFmt(result, ", m=%s}", strZ(mapLog));
 
         checksum = cryptoHashOne(hashTypeSha1, fileBuffer);
+        checksumXxh3 = xxHashOne(XX_HASH_SIZE_MAX, fileBuffer);
     }
     // Else normal file
     else
@@ -181,16 +190,22 @@ testBackupValidateFile(
         }
 
         ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), cryptoHashNew(hashTypeSha1));
+        ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), xxHashNew(XX_HASH_SIZE_MAX));
 
         size = bufUsed(storageGetP(read));
         checksum = pckReadBinP(
             ioFilterGroupResultP(ioReadFilterGroup(storageReadIo(read)), CRYPTO_HASH_FILTER_TYPE));
+        checksumXxh3 = pckReadBinP(
+            ioFilterGroupResultP(ioReadFilterGroup(storageReadIo(read)), XX_HASH_FILTER_TYPE));
     }
 
     // Validate checksum
     if (!bufEq(checksum, BUF(file.checksumSha1, HASH_TYPE_SHA1_SIZE)))
         THROW_FMT(AssertError, "'%s' checksum does match manifest", strZ(file.name));
 
+    if (file.checksumXxh3 != NULL && !bufEq(checksumXxh3, BUF(file.checksumXxh3, XX_HASH_SIZE_MAX)))
+        THROW_FMT(AssertError, "'%s' xxh3 checksum does match manifest", strZ(file.name));
+
     // Test size and repo-size
     // -------------------------------------------------------------------------------------------------------------
     if (size != file.size)
@@ -226,6 +241,11 @@ testBackupValidateFile(
             strCatZ(result, "t");
     }
 
+    // xxh3 checksum (validated above)
+    // -------------------------------------------------------------------------------------------------------------
+    if (file.checksumXxh3 != NULL)
+        strCatZ(result, ", xxh");
+
     // pg_control and WAL headers have different checksums depending on cpu architecture so remove the checksum from
     // the test output.
     // -------------------------------------------------------------------------------------------------------------
@@ -1501,6 +1521,47 @@ testRun(void)
         TEST_RESULT_LOG(
             "P00   WARN: option backup-standby is enabled but backup is offline - backups will be performed from the primary");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("warn when compress-thread-max is less than process-max");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawZ(argList, cfgOptCompressThreadMax, "1");
+        hrnCfgArgRawZ(argList, cfgOptProcessMax, "2");
+        hrnCfgArgRawBool(argList, cfgOptOnline, false);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        TEST_RESULT_VOID(
+            backupInit(infoBackupNew(PG_VERSION_96, HRN_PG_SYSTEMID_96, hrnPgCatalogVersion(PG_VERSION_96), NULL)),
+            "backup init");
+        TEST_RESULT_LOG(
+            "P00   WARN: option compress-thread-max (1) is less than process-max (2) - each process will use one compress thread");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg1");
+        hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+        hrnCfgArgRawZ(argList, cfgOptCompressThreadMax, "2");
+        hrnCfgArgRawZ(argList, cfgOptProcessMax, "2");
+        hrnCfgArgRawBool(argList, cfgOptOnline, false);
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        TEST_RESULT_VOID(
+            backupInit(infoBackupNew(PG_VERSION_96, HRN_PG_SYSTEMID_96, hrnPgCatalogVersion(PG_VERSION_96), NULL)),
+            "no warning when compress-thread-max is not less than process-max");
+
+        TEST_RESULT_UINT(backupJobCompressThread(1, 2, false, 1), 1, "at least one thread");
+        TEST_RESULT_UINT(backupJobCompressThread(0, 2, false, 1), 0, "no threads");
+        TEST_RESULT_UINT(backupJobCompressThread(5, 2, false, 0), 3, "remainder to first process");
+        TEST_RESULT_UINT(backupJobCompressThread(5, 2, false, 1), 2, "no remainder for second process");
+        TEST_RESULT_UINT(backupJobCompressThread(5, 2, true, 0), 0, "no threads for primary client from standby");
+        TEST_RESULT_UINT(backupJobCompressThread(5, 2, true, 1), 3, "remainder to first standby process");
+        TEST_RESULT_UINT(backupJobCompressThread(5, 2, true, 2), 2, "no remainder for second standby process");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("error when pg_control does not match stanza");
 
@@ -1822,6 +1883,30 @@ testRun(void)
         // Set log level to detail
         harnessLogLevelSet(logLevelDetail);
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("verify queue steal calculations");
+
+        List *queueList = lstNewP(sizeof(void *));
+        List *queueSizeList = lstNewP(sizeof(uint64_t));
+
+        for (unsigned int queueIdx = 0; queueIdx < 3; queueIdx++)
+        {
+            List *const queue = lstNewP(sizeof(ManifestFile *));
+            lstAdd(queueList, &queue);
+            lstAdd(queueSizeList, &(uint64_t){0});
+        }
+
+        TEST_RESULT_INT(backupJobQueueSteal(queueList, queueSizeList, 0), -1, "all queues empty");
+
+        lstAdd(*(List **)lstGet(queueList, 0), &(ManifestFile *){NULL});
+        *(uint64_t *)lstGet(queueSizeList, 0) = 32768;
+        lstAdd(*(List **)lstGet(queueList, 1), &(ManifestFile *){NULL});
+        *(uint64_t *)lstGet(queueSizeList, 1) = 8192;
+        lstAdd(*(List **)lstGet(queueList, 2), &(ManifestFile *){NULL});
+        *(uint64_t *)lstGet(queueSizeList, 2) = 16384;
+        TEST_RESULT_INT(backupJobQueueSteal(queueList, queueSizeList, 0), 0, "steal from queue 0 with most bytes");
+        TEST_RESULT_INT(backupJobQueueSteal(queueList, queueSizeList, 1), 2, "skip primary queue");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("report job error");
 
@@ -3590,6 +3675,7 @@ testRun(void)
             hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
             hrnCfgArgRawZ(argList, cfgOptRepoBundleLimit, "8KiB");
             hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
+            hrnCfgArgRawBool(argList, cfgOptRepoChecksumXxh3, true);
             hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MAX_FILE_SIZE) "=" STRINGIFY(BLOCK_MAX_SIZE));
             hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MIN_FILE_SIZE) "=" STRINGIFY(BLOCK_MIN_SIZE));
             hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MID_FILE_SIZE) "=" STRINGIFY(BLOCK_MID_SIZE));
@@ -3638,11 +3724,11 @@ testRun(void)
                     storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest"), .cipherType = cipherTypeAes256Cbc,
                     .cipherPass = TEST_CIPHER_PASS),
                 ".> {d=20191108-080000F}\n"
-                "bundle/1/pg_data/PG_VERSION {s=2, ts=-400000}\n"
-                "bundle/1/pg_data/global/pg_control {s=8192}\n"
-                "pg_data/backup_label.gz {s=17, ts=+2}\n"
-                "pg_data/block-incr-grow.pgbi {s=24576, m=0:{0,1,2}}\n"
-                "pg_data/block-incr-no-resume.pgbi {s=24576, m=0:{0,1,2}}\n"
+                "bundle/1/pg_data/PG_VERSION {s=2, ts=-400000, xxh}\n"
+                "bundle/1/pg_data/global/pg_control {s=8192, xxh}\n"
+                "pg_data/backup_label.gz {s=17, ts=+2, xxh}\n"
+                "pg_data/block-incr-grow.pgbi {s=24576, m=0:{0,1,2}, xxh}\n"
+                "pg_data/block-incr-no-resume.pgbi {s=24576, m=0:{0,1,2}, xxh}\n"
                 "--------\n"
                 "[backup:target]\n"
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
@@ -3666,6 +3752,7 @@ testRun(void)
             hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
             hrnCfgArgRawZ(argList, cfgOptRepoBundleLimit, "8KiB");
             hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
+            hrnCfgArgRawBool(argList, cfgOptRepoChecksumXxh3, true);
             hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MAX_FILE_SIZE) "=" STRINGIFY(BLOCK_MAX_SIZE));
             hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MIN_FILE_SIZE) "=" STRINGIFY(BLOCK_MIN_SIZE));
             hrnCfgArgRawZ(argList, cfgOptRepoBlockSizeMap, STRINGIFY(BLOCK_MID_FILE_SIZE) "=" STRINGIFY(BLOCK_MID_SIZE));
@@ -3724,12 +3811,12 @@ testRun(void)
                     storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest"), .cipherType = cipherTypeAes256Cbc,
                     .cipherPass = TEST_CIPHER_PASS),
                 ".> {d=20191108-080000F}\n"
-                "bundle/1/pg_data/PG_VERSION {s=2, ts=-500000}\n"
-                "bundle/1/pg_data/global/pg_control {s=8192}\n"
-                "pg_data/backup_label.gz {s=17, ts=+2}\n"
-                "pg_data/block-incr-grow.pgbi {s=24576, m=0:{0,1,2}, ts=-100000}\n"
-                "pg_data/block-incr-no-resume.pgbi {s=24576, m=0:{0,1,2}, ts=-100000}\n"
-                "pg_data/block-incr-wayback.pgbi {s=16384, m=0:{0,1}}\n"
+                "bundle/1/pg_data/PG_VERSION {s=2, ts=-500000, xxh}\n"
+                "bundle/1/pg_data/global/pg_control {s=8192, xxh}\n"
+                "pg_data/backup_label.gz {s=17, ts=+2, xxh}\n"
+                "pg_data/block-incr-grow.pgbi {s=24576, m=0:{0,1,2}, ts=-100000, xxh}\n"
+                "pg_data/block-incr-no-resume.pgbi {s=24576, m=0:{0,1,2}, ts=-100000, xxh}\n"
+                "pg_data/block-incr-wayback.pgbi {s=16384, m=0:{0,1}, xxh}\n"
                 "--------\n"
                 "[backup:target]\n"
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
@@ -3755,6 +3842,7 @@ testRun(void)
             hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
             hrnCfgArgRawZ(argList, cfgOptRepoBundleLimit, "4MiB");
             hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
+            hrnCfgArgRawBool(argList, cfgOptRepoChecksumXxh3, true);
             hrnCfgArgRawZ(argList, cfgOptRepoCipherType, "aes-256-cbc");
             hrnCfgArgRawZ(argList, cfgOptRepoBlockAgeMap, "1=2");
             hrnCfgArgRawZ(argList, cfgOptRepoBlockAgeMap, "2=0");
@@ -3822,13 +3910,13 @@ testRun(void)
                     storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest"), .cipherType = cipherTypeAes256Cbc,
                     .cipherPass = TEST_CIPHER_PASS),
                 ".> {d=20191108-080000F_20191110-153320D}\n"
-                "bundle/1/pg_data/block-age-multiplier {s=32768, m=1:{0,1}, ts=-86400}\n"
-                "bundle/1/pg_data/block-age-to-zero {s=16384, ts=-172800}\n"
-                "bundle/1/pg_data/block-incr-grow {s=49152, m=0:{0,1},1:{0,1,2,3}, ts=-200000}\n"
-                "bundle/1/pg_data/global/pg_control {s=8192}\n"
-                "pg_data/backup_label.gz {s=17, ts=+2}\n"
-                "20191108-080000F/bundle/1/pg_data/PG_VERSION {s=2, ts=-600000}\n"
-                "20191108-080000F/pg_data/block-incr-wayback.pgbi {s=16384, m=0:{0,1}, ts=-172800}\n"
+                "bundle/1/pg_data/block-age-multiplier {s=32768, m=1:{0,1}, ts=-86400, xxh}\n"
+                "bundle/1/pg_data/block-age-to-zero {s=16384, ts=-172800, xxh}\n"
+                "bundle/1/pg_data/block-incr-grow {s=49152, m=0:{0,1},1:{0,1,2,3}, ts=-200000, xxh}\n"
+                "bundle/1/pg_data/global/pg_control {s=8192, xxh}\n"
+                "pg_data/backup_label.gz {s=17, ts=+2, xxh}\n"
+                "20191108-080000F/bundle/1/pg_data/PG_VERSION {s=2, ts=-600000, xxh}\n"
+                "20191108-080000F/pg_data/block-incr-wayback.pgbi {s=16384, m=0:{0,1}, ts=-172800, xxh}\n"
                 "--------\n"
                 "[backup:target]\n"
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
@@ -127,6 +127,17 @@ testRun(void)
             "P00 DETAIL: statistics: {\"test\":{\"total\":1}}\n"
             "P00   INFO: restore command end: completed successfully");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("command end with memory statistics");
+
+        harnessLogLevelSet(logLevelTrace);
+
+        TEST_RESULT_VOID(cmdEnd(0, NULL), "command end");
+        hrnLogReplaceAdd("(malloc|realloc|free|arena|rss) [0-9]+", "[0-9]+", "N", false);
+        TEST_RESULT_LOG_EMPTY_OR_CONTAINS("command::cmdEnd: memory: malloc [N], realloc [N], free [N], arena [N], peak rss [N]\n");
+
+        harnessLogLevelSet(logLevelDetail);
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("switch to a new command so some options are not valid");
 
@@ -217,6 +217,8 @@ testRun(void)
             "  --recovery-option                   set an option in postgresql.auto.conf or\n"
             "                                      recovery.conf\n"
             "  --set                               backup set to restore [default=latest]\n"
+            "  --sync-defer                        sync restored files at the end of the\n"
+            "                                      restore [default=n]\n"
             "  --tablespace-map                    restore a tablespace into the specified\n"
             "                                      directory\n"
             "  --tablespace-map-all                restore all tablespaces into the\n"
@@ -248,6 +250,8 @@ testRun(void)
             "                                      [default=n]\n"
             "  --fork                              postgreSQL fork name [default=PostgreSQL]\n"
             "  --io-timeout                        I/O timeout [default=60]\n"
+            "  --io-uring                          use io_uring for local file I/O\n"
+            "                                      (experimental) [default=n]\n"
             "  --lock-path                         path where lock files are stored\n"
             "                                      [default=/tmp/pgbackrest]\n"
             "  --neutral-umask                     use a neutral umask [default=y]\n"
@@ -339,9 +343,15 @@ testRun(void)
             "  --repo-sftp-public-key-file         SFTP public key file\n"
             "  --repo-storage-ca-file              repository storage CA file\n"
             "  --repo-storage-ca-path              repository storage CA path\n"
+            "  --repo-storage-download-chunk-max   repository storage download chunk maximum\n"
+            "                                      [default=1]\n"
+            "  --repo-storage-download-chunk-size  repository storage download chunk size\n"
+            "                                      [default=8MiB]\n"
             "  --repo-storage-host                 repository storage host\n"
             "  --repo-storage-port                 repository storage port [default=443]\n"
             "  --repo-storage-tag                  repository storage tag(s)\n"
+            "  --repo-storage-upload-chunk-max     repository storage upload chunk maximum\n"
+            "                                      [default=1]\n"
             "  --repo-storage-upload-chunk-size    repository storage upload chunk size\n"
             "  --repo-storage-verify-tls           repository storage certificate verify\n"
             "                                      [default=y]\n"
@@ -306,10 +306,73 @@ testRun(void)
         TEST_ERROR(
             restoreFile(
                 strNewFmt(STORAGE_REPO_BACKUP "/%s/%s.gz", strZ(repoFileReferenceFull), strZ(repoFile1)), repoIdx, compressTypeGz,
-                0, false, false, false, STRDEF("badpass"), NULL, fileList),
+                0, false, false, false, false, STRDEF("badpass"), NULL, fileList),
             ChecksumError,
             "error restoring 'normal': actual checksum 'd1cd8a7d11daa26814b93eb604e1d49ab4b43770' does not match expected checksum"
             " 'ffffffffffffffffffffffffffffffffffffffff'");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("delta updates changed blocks in place");
+
+        // Repo file has three full blocks and a partial block
+        Buffer *const repoBuffer = bufNew(128 * 1024 * 3 + 100);
+        memset(bufPtr(repoBuffer), 'a', 128 * 1024);
+        memset(bufPtr(repoBuffer) + 128 * 1024, 'b', 128 * 1024);
+        memset(bufPtr(repoBuffer) + 128 * 1024 * 2, 'c', 128 * 1024);
+        memset(bufPtr(repoBuffer) + 128 * 1024 * 3, 'd', 100);
+        bufUsedSet(repoBuffer, bufSize(repoBuffer));
+
+        HRN_STORAGE_PUT(
+            storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/delta", strZ(repoFileReferenceFull)), repoBuffer);
+
+        // Existing file has a changed second block and has been extended
+        Buffer *const pgBuffer = bufNew(bufUsed(repoBuffer) + 10);
+        bufCat(pgBuffer, repoBuffer);
+        memset(bufPtr(pgBuffer) + 128 * 1024, 'x', 128 * 1024);
+        memset(bufPtr(pgBuffer) + bufUsed(repoBuffer), 'e', 10);
+        bufUsedSet(pgBuffer, bufSize(pgBuffer));
+
+        HRN_STORAGE_PUT(storagePgWrite(), "delta", pgBuffer);
+
+        fileList = lstNewP(sizeof(RestoreFile));
+
+        file = (RestoreFile)
+        {
+            .name = STRDEF("delta"),
+            .checksum = cryptoHashOne(hashTypeSha1, repoBuffer),
+            .size = bufUsed(repoBuffer),
+            .timeModified = 1557432154,
+            .mode = 0600,
+        };
+
+        lstAdd(fileList, &file);
+
+        List *result = NULL;
+
+        TEST_ASSIGN(
+            result,
+            restoreFile(
+                strNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/delta", strZ(repoFileReferenceFull)), repoIdx, compressTypeNone, 0, true,
+                false, false, false, NULL, NULL, fileList),
+            "restore file");
+        TEST_RESULT_UINT(((RestoreFileResult *)lstGet(result, 0))->result, restoreResultCopy, "check result");
+        TEST_RESULT_UINT(((RestoreFileResult *)lstGet(result, 0))->blockIncrDeltaSize, 128 * 1024, "only changed block written");
+        TEST_RESULT_BOOL(bufEq(storageGetP(storageNewReadP(storagePg(), STRDEF("delta"))), repoBuffer), true, "check file");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("delta preserves unchanged file without generating block checksums");
+
+        fileList = lstNewP(sizeof(RestoreFile));
+        lstAdd(fileList, &file);
+
+        TEST_ASSIGN(
+            result,
+            restoreFile(
+                strNewFmt(STORAGE_REPO_BACKUP "/%s/pg_data/delta", strZ(repoFileReferenceFull)), repoIdx, compressTypeNone, 0, true,
+                false, false, false, NULL, NULL, fileList),
+            "restore file");
+        TEST_RESULT_UINT(((RestoreFileResult *)lstGet(result, 0))->result, restoreResultPreserve, "check result");
+        TEST_RESULT_PTR(((RestoreFile *)lstGet(fileList, 0))->blockChecksum, NULL, "no block checksums");
     }
 
     // *****************************************************************************************************************************
@@ -2207,14 +2270,36 @@ testRun(void)
         // Set log level to detail
         harnessLogLevelSet(logLevelDetail);
 
+        // Replace restore timing
+        hrnLogReplaceAdd(" [0-9]+ms", "[0-9]+", "TIME", false);
+
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("verify next queue calculations");
+        TEST_TITLE("verify queue steal calculations");
+
+        List *queueList = lstNewP(sizeof(void *));
+        List *queueSizeList = lstNewP(sizeof(uint64_t));
+
+        for (unsigned int queueIdx = 0; queueIdx < 3; queueIdx++)
+        {
+            List *const queue = lstNewP(sizeof(ManifestFilePack *));
+            lstAdd(queueList, &queue);
+            lstAdd(queueSizeList, &(uint64_t){0});
+        }
+
+        TEST_RESULT_INT(restoreJobQueueSteal(queueList, queueSizeList), -1, "all queues empty");
+
+        lstAdd(*(List **)lstGet(queueList, 0), &(ManifestFilePack *){NULL});
+        TEST_RESULT_INT(restoreJobQueueSteal(queueList, queueSizeList), 0, "zero-length file in queue 0");
+
+        lstAdd(*(List **)lstGet(queueList, 1), &(ManifestFilePack *){NULL});
+        *(uint64_t *)lstGet(queueSizeList, 1) = 8192;
+        lstAdd(*(List **)lstGet(queueList, 2), &(ManifestFilePack *){NULL});
+        *(uint64_t *)lstGet(queueSizeList, 2) = 16384;
+        TEST_RESULT_INT(restoreJobQueueSteal(queueList, queueSizeList), 2, "steal from queue 2 with most bytes");
 
-        TEST_RESULT_INT(restoreJobQueueNext(0, 0, 1), 0, "client idx 0, queue idx 0, 1 queue");
-        TEST_RESULT_INT(restoreJobQueueNext(0, 0, 2), 1, "client idx 0, queue idx 0, 2 queues");
-        TEST_RESULT_INT(restoreJobQueueNext(1, 1, 2), 0, "client idx 1, queue idx 1, 2 queues");
-        TEST_RESULT_INT(restoreJobQueueNext(0, 1, 2), 0, "client idx 0, queue idx 1, 2 queues");
-        TEST_RESULT_INT(restoreJobQueueNext(1, 0, 2), 1, "client idx 1, queue idx 0, 2 queues");
+        lstClear(*(List **)lstGet(queueList, 2));
+        *(uint64_t *)lstGet(queueSizeList, 2) = 0;
+        TEST_RESULT_INT(restoreJobQueueSteal(queueList, queueSizeList), 1, "steal from queue 1 with most bytes");
 
         // Locality error
         // -------------------------------------------------------------------------------------------------------------------------
@@ -2338,7 +2423,8 @@ testRun(void)
                 "P00 DETAIL: sync path '" TEST_PATH "/pg/pg_tblspc'\n"
                 "P00   WARN: backup does not contain 'global/pg_control' -- cluster will not start\n"
                 "P00 DETAIL: sync path '" TEST_PATH "/pg/global'\n"
-                "P00   INFO: restore size = 4B, file total = 1",
+                "P00   INFO: restore size = 4B, file total = 1\n"
+                "P00 DETAIL: restore time: copy [TIME]ms, file sync [TIME]ms, path sync [TIME]ms, total [TIME]ms",
                 TEST_PATH, TEST_PATH, TEST_PATH, TEST_PATH));
 
         // Remove recovery.conf before file comparison since it will have a new timestamp. Make sure it existed, though.
@@ -2353,7 +2439,7 @@ testRun(void)
             .level = storageInfoLevelBasic, .includeDot = true);
 
         // -------------------------------------------------------------------------------------------------------------------------
-        TEST_TITLE("full restore with delta force");
+        TEST_TITLE("full restore with delta force and deferred sync");
 
         argList = strLstNew();
         hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
@@ -2364,6 +2450,7 @@ testRun(void)
         hrnCfgArgRawZ(argList, cfgOptSet, "20161219-212741F");
         hrnCfgArgRawBool(argList, cfgOptDelta, true);
         hrnCfgArgRawBool(argList, cfgOptForce, true);
+        hrnCfgArgRawBool(argList, cfgOptSyncDefer, true);
         hrnCfgArgKeyRawStrId(argList, cfgOptRepoCipherType, 2, cipherTypeAes256Cbc);
         hrnCfgEnvKeyRawZ(cfgOptRepoCipherPass, 2, TEST_CIPHER_PASS);
         HRN_CFG_LOAD(cfgCmdRestore, argList);
@@ -2485,6 +2572,8 @@ testRun(void)
             "P01 DETAIL: restore file " TEST_PATH "/pg/tablespace_map (0B, 88.24%)\n"
             "P01 DETAIL: restore file " TEST_PATH "/pg/pg_tblspc/1/16384/PG_VERSION (4B, 100.00%)"
             " checksum 8dbabb96e032b8d9f1993c0e4b9141e71ade01a1\n"
+            "P00 DETAIL: sync file system for '" TEST_PATH "/pg'\n"
+            "P00 DETAIL: sync file system for '" TEST_PATH "/ts/1'\n"
             "P00   WARN: recovery type is preserve but recovery file does not exist at '" TEST_PATH "/pg/recovery.conf'\n"
             "P00 DETAIL: sync path '" TEST_PATH "/pg'\n"
             "P00 DETAIL: sync path '" TEST_PATH "/pg/pg_tblspc'\n"
@@ -2493,7 +2582,8 @@ testRun(void)
             "P00 DETAIL: sync path '" TEST_PATH "/pg/pg_tblspc/1/PG_9.4_201409291'\n"
             "P00   WARN: backup does not contain 'global/pg_control' -- cluster will not start\n"
             "P00 DETAIL: sync path '" TEST_PATH "/pg/global'\n"
-            "P00   INFO: restore size = 34B, file total = 6");
+            "P00   INFO: restore size = 34B, file total = 6\n"
+            "P00 DETAIL: restore time: copy [TIME]ms, file sync [TIME]ms, path sync [TIME]ms, total [TIME]ms");
 
         TEST_STORAGE_LIST(
             storagePg(), NULL,
@@ -2565,7 +2655,8 @@ testRun(void)
             "P00 DETAIL: sync path '" TEST_PATH "/pg/pg_tblspc/1/PG_9.4_201409291'\n"
             "P00   WARN: backup does not contain 'global/pg_control' -- cluster will not start\n"
             "P00 DETAIL: sync path '" TEST_PATH "/pg/global'\n"
-            "P00   INFO: restore size = [SIZE], file total = 6");
+            "P00   INFO: restore size = [SIZE], file total = 6\n"
+            "P00 DETAIL: restore time: copy [TIME]ms, file sync [TIME]ms, path sync [TIME]ms, total [TIME]ms");
 
         TEST_STORAGE_LIST(
             storagePg(), NULL,
@@ -3011,7 +3102,8 @@ testRun(void)
             "P00 DETAIL: sync path '" TEST_PATH "/pg/pg_tblspc/1/PG_10_201707211'\n"
             "P00   INFO: restore global/pg_control (performed last to ensure aborted restores cannot be started)\n"
             "P00 DETAIL: sync path '" TEST_PATH "/pg/global'\n"
-            "P00   INFO: restore size = [SIZE], file total = 23",
+            "P00   INFO: restore size = [SIZE], file total = 23\n"
+            "P00 DETAIL: restore time: copy [TIME]ms, file sync [TIME]ms, path sync [TIME]ms, total [TIME]ms",
             pgControlSha1);
 
         TEST_STORAGE_LIST(
@@ -3205,7 +3297,8 @@ testRun(void)
             "P00 DETAIL: sync path '" TEST_PATH "/pg/pg_tblspc/1/PG_10_201707211'\n"
             "P00   INFO: restore global/pg_control (performed last to ensure aborted restores cannot be started)\n"
             "P00 DETAIL: sync path '" TEST_PATH "/pg/global'\n"
-            "P00   INFO: restore size = [SIZE], file total = 23",
+            "P00   INFO: restore size = [SIZE], file total = 23\n"
+            "P00 DETAIL: restore time: copy [TIME]ms, file sync [TIME]ms, path sync [TIME]ms, total [TIME]ms",
             pgControlSha1);
 
         // Check stanza archive spool path was removed
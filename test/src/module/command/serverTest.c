@@ -193,6 +193,156 @@ testRun(void)
             HRN_FORK_PARENT_END();
         }
         HRN_FORK_END();
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("server with persistent worker");
+        HRN_FORK_BEGIN(.timeout = 15000)
+        {
+            const unsigned int testPort = hrnServerPortNext();
+
+            HRN_FORK_CHILD_BEGIN(.prefix = "server")
+            {
+                StringList *argList = strLstNew();
+                hrnCfgArgRawZ(argList, cfgOptConfig, TEST_PATH "/pgbackrest.conf");
+                hrnCfgArgRawFmt(argList, cfgOptTlsServerPort, "%u", testPort);
+                hrnCfgArgRawZ(argList, cfgOptTlsServerWorker, "1");
+                hrnCfgArgRawZ(argList, cfgOptLogLevelFile, "off");
+                hrnCfgArgRawZ(argList, cfgOptLogLevelStderr, CFGOPTVAL_ARCHIVE_MODE_OFF_Z);
+                HRN_CFG_LOAD(cfgCmdServer, argList);
+
+                // Init exit signal handlers
+                exitInit();
+
+                // No log testing needed
+                harnessLogLevelSet(logLevelError);
+
+                // Get pid of this process to identify worker process later
+                pid_t pid = getpid();
+
+                // Add parameters to arg list required for a reload
+                strLstInsert(argList, 0, cfgExe());
+                strLstAddZ(argList, CFGCMD_SERVER);
+
+                TEST_RESULT_VOID(cmdServer(strLstSize(argList), strLstPtr(argList)), "server");
+
+                // If this is a worker process then notify that it stopped on reload and exit
+                if (pid != getpid())
+                {
+                    HRN_FORK_CHILD_NOTIFY_PUT();
+                    exit(0);
+                }
+            }
+            HRN_FORK_CHILD_END();
+
+            HRN_FORK_CHILD_BEGIN(.prefix = "client")
+            {
+                StringList *argListRepo = strLstNew();
+                hrnCfgArgRawZ(argListRepo, cfgOptPgPath, "/BOGUS");
+                hrnCfgArgRaw(argListRepo, cfgOptRepoHost, hrnServerHost());
+                hrnCfgArgRawZ(argListRepo, cfgOptRepoHostConfig, TEST_PATH "/pgbackrest.conf");
+                hrnCfgArgRawZ(argListRepo, cfgOptRepoHostType, "tls");
+#if !TEST_IN_CONTAINER
+                hrnCfgArgRawZ(argListRepo, cfgOptRepoHostCaFile, HRN_SERVER_CA);
+#endif
+                hrnCfgArgRawZ(argListRepo, cfgOptRepoHostCertFile, HRN_SERVER_CLIENT_CERT);
+                hrnCfgArgRawZ(argListRepo, cfgOptRepoHostKeyFile, HRN_SERVER_CLIENT_KEY);
+                hrnCfgArgRawFmt(argListRepo, cfgOptRepoHostPort, "%u", testPort);
+
+                // Clients with the same config reuse the worker storage
+                StringList *argList = strLstDup(argListRepo);
+                hrnCfgArgRawZ(argList, cfgOptStanza, "db");
+                HRN_CFG_LOAD(cfgCmdArchiveGet, argList);
+
+                const Storage *storageRemote = NULL;
+                TEST_ASSIGN(
+                    storageRemote,
+                    storageRemoteNew(
+                        STORAGE_MODE_FILE_DEFAULT, STORAGE_MODE_PATH_DEFAULT, true, NULL,
+                        protocolRemoteGet(protocolStorageTypeRepo, 0), cfgOptionUInt(cfgOptCompressLevelNetwork)),
+                    "new storage 1");
+
+                HRN_STORAGE_PUT_Z(storageRemote, "worker1.txt", "WORKER1");
+
+                TEST_RESULT_VOID(protocolRemoteFree(0), "free client 1");
+
+                TEST_ASSIGN(
+                    storageRemote,
+                    storageRemoteNew(
+                        STORAGE_MODE_FILE_DEFAULT, STORAGE_MODE_PATH_DEFAULT, true, NULL,
+                        protocolRemoteGet(protocolStorageTypeRepo, 0), cfgOptionUInt(cfgOptCompressLevelNetwork)),
+                    "new storage 2");
+
+                HRN_STORAGE_PUT_Z(storageRemote, "worker2.txt", "WORKER2");
+
+                TEST_RESULT_VOID(protocolRemoteFree(0), "free client 2");
+
+                // A client with a different config gets new storage
+                argList = strLstNew();
+                hrnCfgArgRawZ(argList, cfgOptRepoPath, "/BOGUS");
+                hrnCfgArgRaw(argList, cfgOptPgHost, hrnServerHost());
+                hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg");
+                hrnCfgArgRawZ(argList, cfgOptPgHostType, "tls");
+#if !TEST_IN_CONTAINER
+                hrnCfgArgRawZ(argList, cfgOptPgHostCaFile, HRN_SERVER_CA);
+#endif
+                hrnCfgArgRawZ(argList, cfgOptPgHostCertFile, HRN_SERVER_CLIENT_CERT);
+                hrnCfgArgRawZ(argList, cfgOptPgHostKeyFile, HRN_SERVER_CLIENT_KEY);
+                hrnCfgArgRawFmt(argList, cfgOptPgHostPort, "%u", testPort);
+                hrnCfgArgRawZ(argList, cfgOptStanza, "db");
+                hrnCfgArgRawZ(argList, cfgOptProcess, "1");
+                HRN_CFG_LOAD(cfgCmdBackup, argList, .role = cfgCmdRoleLocal);
+
+                TEST_ASSIGN(
+                    storageRemote,
+                    storageRemoteNew(
+                        STORAGE_MODE_FILE_DEFAULT, STORAGE_MODE_PATH_DEFAULT, true, NULL,
+                        protocolRemoteGet(protocolStorageTypePg, 0), cfgOptionUInt(cfgOptCompressLevelNetwork)),
+                    "new storage 3");
+
+                HRN_STORAGE_PUT_Z(storageRemote, "worker3.txt", "WORKER3");
+
+                TEST_RESULT_VOID(protocolRemoteFree(0), "free client 3");
+
+                // Client error frees the worker storage
+                argList = strLstDup(argListRepo);
+                hrnCfgArgRawZ(argList, cfgOptStanza, "bogus");
+                HRN_CFG_LOAD(cfgCmdArchiveGet, argList);
+
+                TEST_ERROR_FMT(
+                    protocolRemoteGet(protocolStorageTypeRepo, 0), AccessError,
+                    "raised from remote-0 tls protocol on '%s': access denied", strZ(hrnServerHost()));
+
+                // Notify parent on exit
+                HRN_FORK_CHILD_NOTIFY_PUT();
+            }
+            HRN_FORK_CHILD_END();
+
+            HRN_FORK_PARENT_BEGIN(.prefix = "server control")
+            {
+                // Wait for the client to finish
+                HRN_FORK_PARENT_NOTIFY_GET(1);
+
+                // Reload stops the worker and starts a new one, which answers the ping
+                kill(HRN_FORK_PROCESS_ID(0), SIGHUP);
+                HRN_FORK_PARENT_NOTIFY_GET(0);
+
+                StringList *argList = strLstNew();
+                hrnCfgArgRawFmt(argList, cfgOptTlsServerPort, "%u", testPort);
+                HRN_CFG_LOAD(cfgCmdServerPing, argList);
+
+                TEST_RESULT_VOID(cmdServerPing(), "ping new worker");
+
+                // Send term to server process
+                kill(HRN_FORK_PROCESS_ID(0), SIGTERM);
+
+                // Check that files written by the client are present
+                TEST_STORAGE_GET(storageTest, "repo/worker1.txt", "WORKER1");
+                TEST_STORAGE_GET(storageTest, "repo/worker2.txt", "WORKER2");
+                TEST_STORAGE_GET(storageTest, "pg/worker3.txt", "WORKER3");
+            }
+            HRN_FORK_PARENT_END();
+        }
+        HRN_FORK_END();
     }
 
     // *****************************************************************************************************************************
@@ -294,7 +294,7 @@ testRun(void)
 
         char buffer[STACK_TRACE_PARAM_MAX];
 
-        Bz2Compress *compress = (Bz2Compress *)ioFilterDriver(bz2CompressNew(1, false));
+        Bz2Compress *compress = (Bz2Compress *)ioFilterDriver(bz2CompressNew(1, false, 0));
 
         compress->stream.avail_in = 999;
 
@@ -335,7 +335,7 @@ testRun(void)
 
         char buffer[STACK_TRACE_PARAM_MAX];
 
-        Lz4Compress *compress = (Lz4Compress *)ioFilterDriver(lz4CompressNew(7, false));
+        Lz4Compress *compress = (Lz4Compress *)ioFilterDriver(lz4CompressNew(7, false, 0));
 
         compress->inputSame = true;
         compress->flushing = true;
@@ -376,19 +376,38 @@ testRun(void)
         TEST_RESULT_INT(compressLevelMin(compressTypeZst), -7, "level default");
         TEST_RESULT_INT(compressLevelMax(compressTypeZst), 22, "level default");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compress with worker threads");
+
+        Buffer *const threadData = bufNew(4 * 1024 * 1024);
+
+        for (size_t dataIdx = 0; dataIdx < bufSize(threadData); dataIdx++)
+            bufPtr(threadData)[dataIdx] = (unsigned char)(dataIdx / 8 % 251);
+
+        bufUsedSet(threadData, bufSize(threadData));
+
+        Buffer *threadCompressed = NULL;
+
+        TEST_ASSIGN(
+            threadCompressed, testCompress(compressFilterP(compressTypeZst, 3, .thread = 2), threadData, 65536, 1024),
+            "compress with two workers");
+        TEST_RESULT_BOOL(
+            bufEq(testDecompress(decompressFilterP(compressTypeZst), threadCompressed, 1024, 65536), threadData), true,
+            "check decompressed");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("zstDecompressToLog() and zstCompressToLog()");
 
         char buffer[STACK_TRACE_PARAM_MAX];
 
-        ZstCompress *compress = (ZstCompress *)ioFilterDriver(zstCompressNew(14, false));
+        ZstCompress *compress = (ZstCompress *)ioFilterDriver(zstCompressNew(14, false, 0));
 
         compress->inputSame = true;
         compress->inputOffset = 49;
         compress->flushing = true;
 
         TEST_RESULT_VOID(FUNCTION_LOG_OBJECT_FORMAT(compress, zstCompressToLog, buffer, sizeof(buffer)), "zstCompressToLog");
-        TEST_RESULT_Z(buffer, "{level: 14, inputSame: true, inputOffset: 49, flushing: true}", "check log");
+        TEST_RESULT_Z(buffer, "{level: 14, thread: 0, inputSame: true, inputOffset: 49, flushing: true}", "check log");
 
         ZstDecompress *decompress = (ZstDecompress *)ioFilterDriver(zstDecompressNew(false));
 
@@ -386,6 +386,21 @@ testRun(void)
         TEST_RESULT_STR_Z(
             strNewEncode(encodingHex, pckReadBinP(pckReadNew(ioFilterResult(hash)))), HASH_TYPE_SHA256_ZERO, "    check empty hash");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("digest cache");
+
+        TEST_RESULT_UINT(cryptoHashLocal.digestTotal, 2, "sha1 and sha256 cached");
+
+        // Lookup a digest without caching it when the cache is full
+        const unsigned int digestTotal = cryptoHashLocal.digestTotal;
+        cryptoHashLocal.digestTotal = CRYPTO_HASH_DIGEST_CACHE_MAX;
+
+        TEST_RESULT_STR_Z(
+            strNewEncode(encodingHex, cryptoHashOne(strIdFromZ("sha224"), BUFSTRDEF(""))),
+            "d14a028c2a3a2bc9476102bb288234c415a2b01f828ea62ac5b3e42f", "sha224 is not cached");
+
+        cryptoHashLocal.digestTotal = digestTotal;
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_RESULT_STR_Z(
             strNewEncode(encodingHex, cryptoHashOne(hashTypeSha1, BUFSTRDEF("12345"))), "8cb2237d0679ca88db6464eac60da96345513964",
@@ -536,6 +536,214 @@ testRun(void)
         TEST_RESULT_PTR(memContextChildOne(memContextParent2)->context, memContextChild, "check parent2");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("memContext*() with arena"))
+    {
+        TEST_TITLE("struct size");
+
+        TEST_RESULT_UINT(sizeof(MemContextArenaBlock), MEM_CONTEXT_ARENA_ALIGN, "MemContextArenaBlock size");
+        TEST_RESULT_UINT(MEM_CONTEXT_ARENA_SIZE(1), MEM_CONTEXT_ARENA_ALIGN, "align up");
+        TEST_RESULT_UINT(MEM_CONTEXT_ARENA_SIZE(MEM_CONTEXT_ARENA_ALIGN), MEM_CONTEXT_ARENA_ALIGN, "already aligned");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("arena context");
+
+        const MemContextStat statBegin = memContextStat();
+        MemContext *memContextOther = NULL;
+
+        MEM_CONTEXT_TEMP_BEGIN(.arena = true)
+        {
+            MemContext *const memContext = MEM_CONTEXT_TEMP();
+            MemContextArena *const arena = memContextArenaOwned(memContext);
+
+            TEST_RESULT_BOOL(memContextArena(memContext), true, "arena");
+            TEST_RESULT_BOOL(memContext->arenaOwner, true, "arena owner");
+            TEST_RESULT_PTR(arena->blockList, NULL, "no blocks");
+            TEST_RESULT_UINT(
+                memContextSize(memContext),
+                sizeof(MemContext) + sizeof(MemContextChildMany) + sizeof(MemContextAllocMany) + sizeof(MemContextArena),
+                "check size");
+
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE("allocations");
+
+            unsigned char *buffer = memNew(8);
+            memset(buffer, 0xFE, 8);
+
+            TEST_RESULT_PTR(MEM_CONTEXT_ALLOC_HEADER(buffer), arena->blockList + 1, "allocation at start of block");
+            TEST_RESULT_UINT(arena->blockList->size, MEM_CONTEXT_ARENA_BLOCK_SIZE, "block size");
+            TEST_RESULT_PTR(
+                arena->free, buffer + MEM_CONTEXT_ARENA_SIZE(sizeof(MemContextAlloc) + 8) - sizeof(MemContextAlloc),
+                "free space after allocation");
+
+            TEST_RESULT_PTR(memResize(buffer, 64), buffer, "resize last allocation in place");
+            TEST_RESULT_PTR(memResize(buffer, 16), buffer, "shrink last allocation in place");
+            TEST_RESULT_PTR(
+                arena->free, buffer + MEM_CONTEXT_ARENA_SIZE(sizeof(MemContextAlloc) + 16) - sizeof(MemContextAlloc),
+                "free space after shrink");
+
+            unsigned char *const buffer2 = memNew(8);
+            TEST_RESULT_BOOL(buffer2 > buffer, true, "next allocation follows");
+
+            unsigned char *const bufferResize = memResize(buffer, 32);
+            TEST_RESULT_BOOL(bufferResize != buffer && bufferResize > buffer2, true, "resize allocation that is not last");
+            TEST_RESULT_BOOL(bufferResize[0] == 0xFE && bufferResize[7] == 0xFE, true, "contents copied");
+
+            const uint64_t freeTotal = memContextStat().freeTotal;
+            TEST_RESULT_VOID(memFree(bufferResize), "free allocation");
+            TEST_RESULT_UINT(memContextStat().freeTotal, freeTotal, "memory not freed until arena is freed");
+
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE("large allocations");
+
+            const MemContextArenaBlock *const blockCurrent = arena->blockList;
+            unsigned char *const free = arena->free;
+
+            unsigned char *bufferLarge = memNew(MEM_CONTEXT_ARENA_BLOCK_SIZE);
+            TEST_RESULT_PTR(MEM_CONTEXT_ALLOC_HEADER(bufferLarge), arena->blockList + 1, "large allocation in own block");
+            TEST_RESULT_PTR(arena->blockList->next, blockCurrent, "current block is next");
+            TEST_RESULT_PTR(arena->free, free, "free space in current block unchanged");
+
+            bufferLarge[0] = 0xFD;
+            bufferLarge = memResize(bufferLarge, MEM_CONTEXT_ARENA_BLOCK_SIZE * 2);
+            TEST_RESULT_PTR(MEM_CONTEXT_ALLOC_HEADER(bufferLarge), arena->blockList + 1, "large allocation resized");
+            TEST_RESULT_UINT(bufferLarge[0], 0xFD, "contents copied");
+
+            TEST_RESULT_VOID(memNew(MEM_CONTEXT_ARENA_BLOCK_SIZE / 4 - sizeof(MemContextAlloc)), "largest allocation in block");
+            TEST_RESULT_PTR(arena->blockList->next->next, blockCurrent, "allocation in current block");
+
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE("new block when current block is full");
+
+            const uint64_t arenaTotal = memContextStat().arenaTotal;
+
+            for (unsigned int allocIdx = 0; allocIdx < 4; allocIdx++)
+                memNew(MEM_CONTEXT_ARENA_BLOCK_SIZE / 4 - sizeof(MemContextAlloc));
+
+            TEST_RESULT_PTR(arena->blockList->next->next->next, blockCurrent, "new block");
+            TEST_RESULT_UINT(memContextStat().arenaTotal - arenaTotal, 4, "allocations from arena");
+
+            arena->freeSize = 0;
+            buffer = memNew(16);
+            TEST_RESULT_BOOL(memResize(buffer, MEM_CONTEXT_ARENA_BLOCK_SIZE / 2) != buffer, true, "large resize not in place");
+
+            buffer = memNew(16);
+            arena->freeSize = 0;
+            TEST_RESULT_BOOL(memResize(buffer, 32) != buffer, true, "resize not in place when block is full");
+
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE("child contexts");
+
+            MemContext *memContextChild;
+            TEST_ASSIGN(memContextChild, memContextNewP("child", .childQty = 1, .allocQty = 1, .arena = true), "new child");
+            TEST_RESULT_VOID(memContextKeep(), "keep child");
+            TEST_RESULT_BOOL(memContextArena(memContextChild), true, "child in arena");
+            TEST_RESULT_BOOL(memContextChild->arenaOwner, false, "child does not own an arena");
+            TEST_RESULT_PTR(memContextArenaOwner(memContextChild), memContext, "arena owner");
+            TEST_RESULT_PTR(
+                memContextChild, arena->free - MEM_CONTEXT_ARENA_SIZE(memContextSize(memContextChild)), "child in block");
+
+            MemContext *memContextGrandChild;
+            TEST_ASSIGN(
+                memContextGrandChild, memContextNewP("grandchild", .childQty = 1, .allocQty = MEM_CONTEXT_QTY_MAX),
+                "new grandchild");
+            TEST_RESULT_VOID(memContextKeep(), "keep grandchild");
+
+            MEM_CONTEXT_BEGIN(memContextChild)
+            {
+                buffer = memNew(16);
+                TEST_RESULT_PTR(buffer, memResize(buffer, 8), "resize");
+                TEST_RESULT_VOID(memFree(buffer), "free");
+                TEST_RESULT_VOID(memNew(16), "new");
+
+                MemContext *memContextGreatGrandChild;
+                TEST_ASSIGN(memContextGreatGrandChild, memContextNewP("great-grandchild"), "new great-grandchild");
+                TEST_RESULT_VOID(memContextKeep(), "keep great-grandchild");
+
+                TEST_RESULT_VOID(memContextMove(memContextGreatGrandChild, memContextGrandChild), "move in arena");
+            }
+            MEM_CONTEXT_END();
+
+            MEM_CONTEXT_BEGIN(memContextGrandChild)
+            {
+                memNew(16);
+                memNew(16);
+            }
+            MEM_CONTEXT_END();
+
+            TEST_RESULT_VOID(memContextFree(memContextGrandChild), "free grandchild");
+
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE("move contexts");
+
+            MEM_CONTEXT_BEGIN(memContextTop())
+            {
+                memContextOther = memContextNewP("other", .childQty = 1);
+                memContextKeep();
+            }
+            MEM_CONTEXT_END();
+
+            TEST_ERROR(
+                memContextMove(memContextChild, memContextOther), AssertError, "cannot move context 'child' out of arena");
+            TEST_ERROR(
+                memContextMove(memContextChild, memContextTop()), AssertError, "cannot move context 'child' out of arena");
+
+            TEST_RESULT_VOID(memContextMove(memContextOther, memContext), "move context into arena");
+            TEST_RESULT_BOOL(memContextArena(memContextOther), false, "moved context not in arena");
+            TEST_RESULT_VOID(memContextMove(memContextOther, memContextTop()), "move context out of arena");
+            TEST_RESULT_VOID(memContextMove(memContextOther, memContextChild), "move context into arena child");
+
+            MemContext *memContextChild2;
+            TEST_ASSIGN(memContextChild2, memContextNewP("child2"), "new child2");
+            TEST_RESULT_VOID(memContextKeep(), "keep child2");
+
+            TEST_RESULT_VOID(memContextMove(memContextChild2, memContextOther), "move to context moved into arena");
+            TEST_RESULT_PTR(memContextArenaOwner(memContextChild2), memContext, "arena owner");
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        const MemContextStat statEnd = memContextStat();
+        TEST_RESULT_UINT(
+            statEnd.allocTotal - statBegin.allocTotal, statEnd.freeTotal - statBegin.freeTotal, "all memory freed with arena");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("move arena owner");
+
+        MemContext *memContextArenaParent;
+        TEST_ASSIGN(memContextArenaParent, memContextNewP("arena-parent", .childQty = 1), "new arena parent");
+        TEST_RESULT_VOID(memContextKeep(), "keep arena parent");
+
+        MemContext *memContextArenaMove;
+        TEST_ASSIGN(memContextArenaMove, memContextNewP("arena-move", .arena = true), "new arena");
+        TEST_RESULT_VOID(memContextKeep(), "keep arena");
+
+        TEST_RESULT_VOID(memContextMove(memContextArenaMove, memContextArenaParent), "move arena owner");
+        TEST_RESULT_VOID(memContextFree(memContextArenaParent), "free arena parent");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("temp context reset keeps arena");
+
+        MEM_CONTEXT_TEMP_RESET_BEGIN(.arena = true)
+        {
+            for (unsigned int loopIdx = 0; loopIdx < 2; loopIdx++)
+            {
+                memNew(16);
+                MEM_CONTEXT_TEMP_RESET(1);
+
+                TEST_RESULT_BOOL(memContextArena(MEM_CONTEXT_TEMP()), true, "arena after reset");
+                TEST_RESULT_BOOL(MEM_CONTEXT_TEMP()->arenaOwner, true, "arena owner after reset");
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        MEM_CONTEXT_TEMP_RESET_BEGIN()
+        {
+            MEM_CONTEXT_TEMP_RESET(1);
+            TEST_RESULT_BOOL(memContextArena(MEM_CONTEXT_TEMP()), false, "no arena after reset");
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("memContextAudit*s()"))
     {
@@ -139,5 +139,69 @@ testRun(void)
         TEST_RESULT_BOOL(isRelationNeeded(20000, 1600, 16384), true, "user table exists in JSON");
         TEST_RESULT_BOOL(isRelationNeeded(5, 1600,  16394), false, "user table from system DB doesn't exist in JSON");
         TEST_RESULT_BOOL(isRelationNeeded(20002, 1600,  16394), false, "user table from user DB doesn't exist in JSON");
+        TEST_RESULT_BOOL(isRelationNeeded(20001, 1700, 16386), true, "user table in non-default tablespace exists in JSON");
+        TEST_RESULT_BOOL(isRelationNeeded(20001, 1701, 16386), false, "user table in wrong tablespace");
+        TEST_RESULT_BOOL(isRelationNeeded(20000, 1663, 16388), true, "user table in default tablespace exists in JSON");
+
+        TEST_TITLE("filter is loaded once");
+        HRN_STORAGE_REMOVE(storageTest, "recovery_filter.json");
+        TEST_RESULT_BOOL(isRelationNeeded(20000, 1600, 16384), true, "user table exists in loaded filter");
+    }
+
+    if (testBegin("relationFilterNew()"))
+    {
+        TEST_TITLE("empty filter");
+
+        RelationFilter *filter = relationFilterNew(buildFilterList(jsonReadNew(STRDEF("[]"))));
+        TEST_RESULT_UINT(filter->slotMask, 15, "minimum slots");
+        TEST_RESULT_BOOL(relationFilterExists(filter, 20000, 0, 0), false, "database does not exist");
+
+        TEST_TITLE("large filter");
+
+        String *const json = strCatZ(strNew(), "[");
+
+        for (unsigned int dbIdx = 0; dbIdx < 4; dbIdx++)
+        {
+            strCatFmt(json, "%s{\"dbOid\": %u, \"tables\": [", dbIdx == 0 ? "" : ",", 20000 + dbIdx);
+
+            for (unsigned int tableIdx = 0; tableIdx < 5000; tableIdx++)
+            {
+                strCatFmt(
+                    json, "%s{\"tablespace\": %u, \"relfilenode\": %u}", tableIdx == 0 ? "" : ",", 1663 + tableIdx % 3,
+                    16384 + tableIdx);
+            }
+
+            strCatZ(json, "]}");
+        }
+
+        strCatZ(json, "]");
+
+        filter = relationFilterNew(buildFilterList(jsonReadNew(json)));
+        TEST_RESULT_UINT(filter->slotMask, 65535, "slots for 20004 entries");
+
+        bool found = true;
+        unsigned int slotUsed = 0;
+
+        for (unsigned int dbIdx = 0; dbIdx < 4; dbIdx++)
+        {
+            found = found && relationFilterExists(filter, 20000 + dbIdx, 0, 0);
+
+            for (unsigned int tableIdx = 0; tableIdx < 5000; tableIdx++)
+            {
+                found = found && relationFilterExists(filter, 20000 + dbIdx, 1663 + tableIdx % 3, 16384 + tableIdx);
+                found = found && !relationFilterExists(filter, 20000 + dbIdx, 1663 + (tableIdx + 1) % 3, 16384 + tableIdx);
+                found = found && !relationFilterExists(filter, 20004 + dbIdx, 1663 + tableIdx % 3, 16384 + tableIdx);
+            }
+        }
+
+        for (unsigned int slotIdx = 0; slotIdx <= filter->slotMask; slotIdx++)
+        {
+            if (filter->slotList[slotIdx].dbOid != 0)
+                slotUsed++;
+        }
+
+        TEST_RESULT_BOOL(found, true, "all entries found and no false positives");
+        TEST_RESULT_UINT(slotUsed, 20004, "slots used");
+        TEST_RESULT_BOOL(relationFilterExists(filter, 20004, 0, 0), false, "database does not exist");
     }
 }
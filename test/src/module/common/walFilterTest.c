@@ -479,6 +479,69 @@ testRun(void)
             STORAGE_REPO_ARCHIVE "/9.4-1/0000000100000000/000000010000000000000001-abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd");
         MEM_CONTEXT_TEMP_END();
 
+        TEST_TITLE("begin of the record is restored from the previously filtered segment");
+        MEM_CONTEXT_TEMP_BEGIN();
+        {
+            Buffer *wal1 = bufNew(DEFAULT_GDPB_XLOG_PAGE_SIZE);
+
+            record = hrnGpdbCreateXRecordP(
+                RM_XLOG_ID, XLOG_NOOP, DEFAULT_GDPB_XLOG_PAGE_SIZE - SizeOfXLogLongPHD - SizeOfXLogRecord - 8, NULL);
+            hrnGpdbWalInsertXRecordSimple(wal1, record);
+
+            record = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_NOOP, 100, NULL);
+            hrnGpdbWalInsertXRecordP(wal1, record, INCOMPLETE_RECORD);
+            fillLastPage(wal1, DEFAULT_GDPB_XLOG_PAGE_SIZE);
+
+            HRN_STORAGE_PUT(
+                storageRepoWrite(),
+                STORAGE_REPO_ARCHIVE "/9.4-1/0000000100000000/000000010000000000000001-abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd",
+                wal1);
+
+            wal2 = bufNew(1024 * 1024);
+            record = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_NOOP, 100, NULL);
+            hrnGpdbWalInsertXRecordP(wal2, record, NO_FLAGS, .segno = 2, .beginOffset = 132 - 8);
+            record = hrnGpdbCreateXRecordP(0, XLOG_SWITCH, 0, NULL);
+            hrnGpdbWalInsertXRecordSimple(wal2, record);
+            fillLastPage(wal2, DEFAULT_GDPB_XLOG_PAGE_SIZE);
+
+            HRN_STORAGE_PUT(
+                storageRepoWrite(),
+                STORAGE_REPO_ARCHIVE "/9.4-1/0000000100000000/000000010000000000000002-abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd",
+                wal2);
+
+            // Filter the first segment to remember the incomplete record at its end
+            ArchiveGetFile archiveInfoTail = archiveInfo;
+            archiveInfoTail.file = STRDEF(
+                "9.4-1/0000000100000000/000000010000000000000001-abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd");
+
+            result = testFilter(walFilterNew(pgControl, &archiveInfoTail), wal1, bufSize(wal1), bufSize(wal1));
+            TEST_RESULT_BOOL(bufEq(wal1, result), true, "WAL not the same");
+
+            // The first segment is not read from the repository again, otherwise filtering would fail on the invalid page
+            Buffer *zeros = bufNew(DEFAULT_GDPB_XLOG_PAGE_SIZE);
+            memset(bufPtr(zeros), 0, bufSize(zeros));
+            bufUsedSet(zeros, bufSize(zeros));
+
+            HRN_STORAGE_PUT(
+                storageRepoWrite(),
+                STORAGE_REPO_ARCHIVE "/9.4-1/0000000100000000/000000010000000000000001-abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd",
+                zeros);
+
+            archiveInfoTail.file = STRDEF(
+                "9.4-1/0000000100000000/000000010000000000000002-abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd");
+
+            result = testFilter(walFilterNew(pgControl, &archiveInfoTail), wal2, bufSize(wal2), bufSize(wal2));
+            TEST_RESULT_BOOL(bufEq(wal2, result), true, "WAL not the same");
+        }
+
+        HRN_STORAGE_REMOVE(
+            storageRepoWrite(),
+            STORAGE_REPO_ARCHIVE "/9.4-1/0000000100000000/000000010000000000000001-abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd");
+        HRN_STORAGE_REMOVE(
+            storageRepoWrite(),
+            STORAGE_REPO_ARCHIVE "/9.4-1/0000000100000000/000000010000000000000002-abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd");
+        MEM_CONTEXT_TEMP_END();
+
         TEST_TITLE("compressed and encrypted WAL file");
         MEM_CONTEXT_TEMP_BEGIN();
         HRN_STORAGE_PATH_REMOVE(storageRepoWrite(), STORAGE_REPO_ARCHIVE, .recurse = true);
@@ -893,6 +956,23 @@ testRun(void)
         TEST_RESULT_BOOL(bufEq(wal, result), true, "WAL not the same");
         MEM_CONTEXT_TEMP_END();
 
+        TEST_TITLE("record forwarded from input gets zeroed alignment padding");
+        MEM_CONTEXT_TEMP_BEGIN();
+        filter = walFilterNew(pgControl, NULL);
+        {
+            wal = bufNew(1024 * 1024);
+            XRecordInfo walRecords[] = {
+                {RM_XLOG_ID, XLOG_NOOP, 100}
+            };
+            buildWalP(wal, walRecords, LENGTH_OF(walRecords), 0);
+        }
+        Buffer *walDirty = bufDup(wal);
+        bufPtr(walDirty)[SizeOfXLogLongPHD + SizeOfXLogRecord + 100] = 0xFF;
+
+        result = testFilter(filter, walDirty, bufSize(walDirty), bufSize(walDirty));
+        TEST_RESULT_BOOL(bufEq(wal, result), true, "WAL not the same");
+        MEM_CONTEXT_TEMP_END();
+
         TEST_TITLE("split header");
         MEM_CONTEXT_TEMP_BEGIN();
         filter = walFilterNew(pgControl, NULL);
@@ -1576,7 +1576,8 @@ testRun(void)
             "pg_data/=equal=more=={\"mode\":\"0640\",\"size\":0,\"timestamp\":1565282120}\n"                                       \
             "pg_data/PG_VERSION={\"checksum\":\"184473f470864e067ee3a22e64b47b0a1c356f29\""                                        \
                 ",\"rck\":\"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\",\"reference\":\"20190818-084502F_20190819-084506D\""        \
-                ",\"size\":4,\"timestamp\":1565282114}\n"                                                                          \
+                ",\"rxh\":\"bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb\",\"size\":4,\"timestamp\":1565282114"                                \
+                ",\"xxh\":\"cccccccccccccccccccccccccccccccc\"}\n"                                                                 \
             "pg_data/base/16384/17000={\"bi\":4,\"bni\":1,\"checksum\":\"e0101dd8ffb910c9c202ca35b5f828bcb9697bed\""               \
                 ",\"checksum-page\":false,\"checksum-page-error\":[1],\"repo-size\":4096,\"size\":8192,\"szo\":16384"             \
                 ",\"timestamp\":1565282114}\n"                                                                                     \
@@ -13,6 +13,7 @@ stress testing as needed.
 
 #include "common/compress/gz/compress.h"
 #include "common/compress/lz4/compress.h"
+#include "common/compress/zst/compress.h"
 #include "common/crypto/hash.h"
 #include "common/io/bufferRead.h"
 #include "common/io/bufferWrite.h"
@@ -277,6 +278,17 @@ testRun(void)
         uint64_t lz41Total = 1;
 #endif // HAVE_LIBLZ4
 
+#ifdef HAVE_LIBZST
+        // Compare zst levels with and without worker threads
+        static const int zstLevel[] = {1, 3, 9};
+        static const unsigned int zstThread[] = {0, 4};
+        uint64_t zstTotal[LENGTH_OF(zstLevel)][LENGTH_OF(zstThread)];
+
+        for (unsigned int levelIdx = 0; levelIdx < LENGTH_OF(zstLevel); levelIdx++)
+            for (unsigned int threadIdx = 0; threadIdx < LENGTH_OF(zstThread); threadIdx++)
+                zstTotal[levelIdx][threadIdx] = 1;
+#endif // HAVE_LIBZST
+
         for (unsigned int idx = 0; idx < iteration; idx++)
         {
             // -------------------------------------------------------------------------------------------------------------------------
@@ -328,7 +340,7 @@ testRun(void)
             MEM_CONTEXT_TEMP_BEGIN()
             {
                 BENCHMARK_BEGIN();
-                BENCHMARK_FILTER_ADD(gzCompressNew(6, false));
+                BENCHMARK_FILTER_ADD(gzCompressNew(6, false, 0));
                 BENCHMARK_END(gzip6Total);
             }
             MEM_CONTEXT_TEMP_END();
@@ -340,11 +352,31 @@ testRun(void)
             MEM_CONTEXT_TEMP_BEGIN()
             {
                 BENCHMARK_BEGIN();
-                BENCHMARK_FILTER_ADD(lz4CompressNew(1, false));
+                BENCHMARK_FILTER_ADD(lz4CompressNew(1, false, 0));
                 BENCHMARK_END(lz41Total);
             }
             MEM_CONTEXT_TEMP_END();
 #endif // HAVE_LIBLZ4
+
+            // -------------------------------------------------------------------------------------------------------------------------
+#ifdef HAVE_LIBZST
+            for (unsigned int levelIdx = 0; levelIdx < LENGTH_OF(zstLevel); levelIdx++)
+            {
+                for (unsigned int threadIdx = 0; threadIdx < LENGTH_OF(zstThread); threadIdx++)
+                {
+                    TEST_LOG_FMT(
+                        "zst -%d with %u thread(s) iteration %u", zstLevel[levelIdx], zstThread[threadIdx], idx + 1);
+
+                    MEM_CONTEXT_TEMP_BEGIN()
+                    {
+                        BENCHMARK_BEGIN();
+                        BENCHMARK_FILTER_ADD(zstCompressNew(zstLevel[levelIdx], false, zstThread[threadIdx]));
+                        BENCHMARK_END(zstTotal[levelIdx][threadIdx]);
+                    }
+                    MEM_CONTEXT_TEMP_END();
+                }
+            }
+#endif // HAVE_LIBZST
         }
 
         // -------------------------------------------------------------------------------------------------------------------------
@@ -364,6 +396,100 @@ testRun(void)
 #ifdef HAVE_LIBLZ4
         TEST_RESULT("lz4 -1", lz41Total);
 #endif // HAVE_LIBLZ4
+
+#ifdef HAVE_LIBZST
+        for (unsigned int levelIdx = 0; levelIdx < LENGTH_OF(zstLevel); levelIdx++)
+        {
+            for (unsigned int threadIdx = 0; threadIdx < LENGTH_OF(zstThread); threadIdx++)
+            {
+                TEST_RESULT(
+                    zNewFmt("zst -%d with %u thread(s)", zstLevel[levelIdx], zstThread[threadIdx]),
+                    zstTotal[levelIdx][threadIdx]);
+            }
+        }
+#endif // HAVE_LIBZST
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("benchmark io_uring"))
+    {
+#ifdef HAVE_IO_URING
+        // 1MB buffers are the default for restore
+        ioBufferSizeSet(1024 * 1024);
+
+        // Most files in a cluster are small so scale up until there are hundreds of thousands of small files for a realistic
+        // comparison. Source files will be in the page cache unless caches are dropped between runs, which favors direct reads.
+        ASSERT(TEST_SCALE <= 100);
+        const unsigned int smallTotal = (unsigned int)TEST_SCALE * 10000;
+        const unsigned int largeTotal = (unsigned int)TEST_SCALE * 4;
+
+        Buffer *const smallBuffer = bufNew(8 * 1024);
+        memset(bufPtr(smallBuffer), 'S', bufSize(smallBuffer));
+        bufUsedSet(smallBuffer, bufSize(smallBuffer));
+
+        Buffer *const largeBuffer = bufNew(16 * 1024 * 1024);
+        memset(bufPtr(largeBuffer), 'L', bufSize(largeBuffer));
+        bufUsedSet(largeBuffer, bufSize(largeBuffer));
+
+        // Create source files
+        const Storage *const storageSource = storagePosixNewP(STRDEF(TEST_PATH "/source"), .write = true);
+
+        for (unsigned int fileIdx = 0; fileIdx < smallTotal + largeTotal; fileIdx++)
+        {
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                storagePutP(
+                    storageNewWriteP(
+                        storageSource, strNewFmt("%u", fileIdx), .noAtomic = true, .noSyncFile = true, .noSyncPath = true),
+                    fileIdx < smallTotal ? smallBuffer : largeBuffer);
+            }
+            MEM_CONTEXT_TEMP_END();
+        }
+
+        // Copy files the way restore does, i.e. read from one posix storage and write to another. Alternate with and without
+        // io_uring since the first pass is slower while the file system warms up.
+        for (unsigned int passIdx = 0; passIdx < 4; passIdx++)
+        {
+            const bool ioUring = passIdx % 2 == 1;
+
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE_FMT(
+                "copy %u small and %u large file(s) %s io_uring (pass %u)", smallTotal, largeTotal, ioUring ? "with" : "without",
+                passIdx / 2 + 1);
+
+            const Storage *const storageRead = storagePosixNewP(STRDEF(TEST_PATH "/source"), .ioUring = ioUring);
+            const Storage *const storageWrite = storagePosixNewP(STRDEF(TEST_PATH "/dest"), .write = true, .ioUring = ioUring);
+
+            TimeMSec timeBegin = timeMSec();
+
+            for (unsigned int fileIdx = 0; fileIdx < smallTotal + largeTotal; fileIdx++)
+            {
+                MEM_CONTEXT_TEMP_BEGIN()
+                {
+                    const String *const file = strNewFmt("%u", fileIdx);
+
+                    storageCopyP(
+                        storageNewReadP(storageRead, file),
+                        storageNewWriteP(storageWrite, file, .noAtomic = true, .noSyncFile = true, .noSyncPath = true));
+                }
+                MEM_CONTEXT_TEMP_END();
+
+                if (fileIdx + 1 == smallTotal)
+                {
+                    TEST_LOG_FMT("small files copied in %ums", (unsigned int)(timeMSec() - timeBegin));
+                    timeBegin = timeMSec();
+                }
+            }
+
+            const TimeMSec timeElapsed = timeMSec() - timeBegin;
+
+            TEST_LOG_FMT(
+                "large files copied in %ums (%" PRIu64 "MB/s)", (unsigned int)timeElapsed,
+                (uint64_t)largeTotal * 16 * 1000 / (timeElapsed == 0 ? 1 : timeElapsed));
+
+            storagePathRemoveP(storageWrite, NULL, .recurse = true);
+        }
+#endif // HAVE_IO_URING
     }
 
     FUNCTION_HARNESS_RETURN_VOID();
@@ -10,6 +10,9 @@ running out of memory on the test systems or taking an undue amount of time. It
 ***********************************************************************************************************************************/
 #include <unistd.h>
 
+#include <openssl/evp.h>
+
+#include "common/crypto/hash.h"
 #include "common/ini.h"
 #include "common/io/bufferRead.h"
 #include "common/io/bufferWrite.h"
@@ -19,6 +22,7 @@ running out of memory on the test systems or taking an undue amount of time. It
 #include "common/type/list.h"
 #include "common/type/object.h"
 #include "info/manifest.h"
+#include "postgres/interface/crc32.h"
 #include "postgres/version.h"
 #include "storage/posix/storage.h"
 
@@ -354,6 +358,160 @@ testRun(void)
         TEST_LOG_FMT("completed in %ums", (unsigned int)(timeMSec() - timeBegin));
     }
 
+    // Measure CRC throughput for WAL record and pg_control validation
+    // *****************************************************************************************************************************
+    if (testBegin("crc32One()/crc32cOne()"))
+    {
+        ASSERT(TEST_SCALE <= 1000);
+
+        // Use a WAL segment sized buffer with non-trivial content
+        Buffer *const buffer = bufNew((size_t)TEST_SCALE * 64 * 1024 * 1024);
+        bufUsedSet(buffer, bufSize(buffer));
+
+        for (size_t byteIdx = 0; byteIdx < bufUsed(buffer); byteIdx++)
+            bufPtr(buffer)[byteIdx] = (unsigned char)(byteIdx * 31 + (byteIdx >> 11));
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE_FMT("crc32c %s", strZ(strSizeFormat(bufUsed(buffer))));
+
+        TimeMSec timeBegin = timeMSec();
+        uint32_t crc = crc32cOne(bufPtrConst(buffer), bufUsed(buffer));
+        TimeMSec timeElapsed = timeMSec() - timeBegin;
+
+        TEST_LOG_FMT(
+            "completed in %ums (%" PRIu64 "MB/s, crc %08X)", (unsigned int)timeElapsed,
+            (uint64_t)bufUsed(buffer) / 1024 / 1024 * 1000 / (timeElapsed == 0 ? 1 : timeElapsed), crc);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE_FMT("crc32c %s in 8KiB pages", strZ(strSizeFormat(bufUsed(buffer))));
+
+        timeBegin = timeMSec();
+        crc = crc32cInit();
+
+        for (size_t pageIdx = 0; pageIdx < bufUsed(buffer); pageIdx += 8192)
+            crc = crc32cComp(crc, bufPtrConst(buffer) + pageIdx, 8192);
+
+        crc = crc32cFinish(crc);
+        timeElapsed = timeMSec() - timeBegin;
+
+        TEST_LOG_FMT(
+            "completed in %ums (%" PRIu64 "MB/s, crc %08X)", (unsigned int)timeElapsed,
+            (uint64_t)bufUsed(buffer) / 1024 / 1024 * 1000 / (timeElapsed == 0 ? 1 : timeElapsed), crc);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE_FMT("crc32 %s", strZ(strSizeFormat(bufUsed(buffer))));
+
+        timeBegin = timeMSec();
+        crc = crc32One(bufPtrConst(buffer), bufUsed(buffer));
+        timeElapsed = timeMSec() - timeBegin;
+
+        TEST_LOG_FMT(
+            "completed in %ums (%" PRIu64 "MB/s, crc %08X)", (unsigned int)timeElapsed,
+            (uint64_t)bufUsed(buffer) / 1024 / 1024 * 1000 / (timeElapsed == 0 ? 1 : timeElapsed), crc);
+    }
+
+    // Compare backup checksum throughput to calling OpenSSL EVP directly, both for large files and for many small files
+    // *****************************************************************************************************************************
+    if (testBegin("cryptoHashNew()"))
+    {
+        ASSERT(TEST_SCALE <= 1000);
+
+        // Use a buffer with non-trivial content that is large enough to hash in 4MiB chunks like a backup
+        const size_t chunkSize = 4 * 1024 * 1024;
+        Buffer *const buffer = bufNew((size_t)TEST_SCALE * 64 * 1024 * 1024);
+        bufUsedSet(buffer, bufSize(buffer));
+
+        for (size_t byteIdx = 0; byteIdx < bufUsed(buffer); byteIdx++)
+            bufPtr(buffer)[byteIdx] = (unsigned char)(byteIdx * 31 + (byteIdx >> 11));
+
+        // Small files are the size of a single page
+        const size_t fileSize = 8192;
+        const size_t fileTotal = bufUsed(buffer) / fileSize;
+
+        #define TEST_HASH_RESULT(name, timeBegin)                                                                                  \
+            do                                                                                                                     \
+            {                                                                                                                      \
+                const TimeMSec timeElapsed = timeMSec() - timeBegin;                                                               \
+                                                                                                                                   \
+                TEST_LOG_FMT(                                                                                                      \
+                    "%s completed in %ums (%" PRIu64 "MB/s)", name, (unsigned int)timeElapsed,                                     \
+                    (uint64_t)bufUsed(buffer) / 1024 / 1024 * 1000 / (timeElapsed == 0 ? 1 : timeElapsed));                        \
+            }                                                                                                                      \
+            while (0)
+
+        static const HashType hashTypeList[] = {hashTypeSha1, hashTypeSha256};
+        static const char *const hashNameList[] = {"sha1", "sha256"};
+
+        for (unsigned int typeIdx = 0; typeIdx < LENGTH_OF(hashTypeList); typeIdx++)
+        {
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE_FMT(
+                "%s %s in %zuMiB chunks", hashNameList[typeIdx], strZ(strSizeFormat(bufUsed(buffer))), chunkSize >> 20);
+
+            TimeMSec timeBegin = timeMSec();
+
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                IoFilter *const hash = cryptoHashNew(hashTypeList[typeIdx]);
+
+                for (size_t chunkIdx = 0; chunkIdx < bufUsed(buffer); chunkIdx += chunkSize)
+                    ioFilterProcessIn(hash, BUF(bufPtr(buffer) + chunkIdx, chunkSize));
+
+                ioFilterResult(hash);
+            }
+            MEM_CONTEXT_TEMP_END();
+
+            TEST_HASH_RESULT("cryptoHash", timeBegin);
+
+            const EVP_MD *const evpType = EVP_get_digestbyname(hashNameList[typeIdx]);
+            EVP_MD_CTX *const evpContext = EVP_MD_CTX_create();
+            unsigned char evpHash[EVP_MAX_MD_SIZE];
+
+            timeBegin = timeMSec();
+
+            EVP_DigestInit_ex(evpContext, evpType, NULL);
+
+            for (size_t chunkIdx = 0; chunkIdx < bufUsed(buffer); chunkIdx += chunkSize)
+                EVP_DigestUpdate(evpContext, bufPtr(buffer) + chunkIdx, chunkSize);
+
+            EVP_DigestFinal_ex(evpContext, evpHash, NULL);
+
+            TEST_HASH_RESULT("EVP", timeBegin);
+
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE_FMT("%s %zu files of %zuKiB", hashNameList[typeIdx], fileTotal, fileSize >> 10);
+
+            timeBegin = timeMSec();
+
+            for (size_t fileIdx = 0; fileIdx < fileTotal; fileIdx++)
+            {
+                MEM_CONTEXT_TEMP_BEGIN()
+                {
+                    cryptoHashOne(hashTypeList[typeIdx], BUF(bufPtr(buffer) + fileIdx * fileSize, fileSize));
+                }
+                MEM_CONTEXT_TEMP_END();
+            }
+
+            TEST_HASH_RESULT("cryptoHash", timeBegin);
+
+            timeBegin = timeMSec();
+
+            for (size_t fileIdx = 0; fileIdx < fileTotal; fileIdx++)
+            {
+                EVP_MD_CTX *const evpFileContext = EVP_MD_CTX_create();
+
+                EVP_DigestInit_ex(evpFileContext, EVP_get_digestbyname(hashNameList[typeIdx]), NULL);
+                EVP_DigestUpdate(evpFileContext, bufPtr(buffer) + fileIdx * fileSize, fileSize);
+                EVP_DigestFinal_ex(evpFileContext, evpHash, NULL);
+                EVP_MD_CTX_destroy(evpFileContext);
+            }
+
+            TEST_HASH_RESULT("EVP", timeBegin);
+
+            EVP_MD_CTX_destroy(evpContext);
+        }
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("SocketClient"))
     {
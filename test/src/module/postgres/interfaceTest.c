@@ -1,6 +1,7 @@
 /***********************************************************************************************************************************
 Test PostgreSQL Interface
 ***********************************************************************************************************************************/
+#include "postgres/interface/crc32.h"
 #include "storage/posix/storage.h"
 
 #include "common/harnessConfig.h"
@@ -736,5 +737,72 @@ testRun(void)
         TEST_RESULT_UINT(info.checkpoint, 0xDEAD, "check invalid checkpoint");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("crc32One(), crc32cOne(), and crc32cComp()"))
+    {
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("check values");
+
+        TEST_RESULT_UINT(crc32cOne((const unsigned char *)"123456789", 9), 0xE3069283, "crc32c check value");
+        TEST_RESULT_UINT(crc32cOne((const unsigned char *)"", 0), 0, "crc32c empty");
+        TEST_RESULT_UINT(crc32One((const unsigned char *)"", 0), 0, "crc32 empty");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compare all engines with byte-at-a-time calculation");
+
+        unsigned char data[1024 + 8];
+        uint32_t seed = 0x12345678;
+
+        for (unsigned int dataIdx = 0; dataIdx < sizeof(data); dataIdx++)
+        {
+            seed = seed * 1103515245 + 12345;
+            data[dataIdx] = (unsigned char)(seed >> 16);
+        }
+
+        bool match = true;
+
+        for (size_t offset = 0; offset < 8; offset++)
+        {
+            for (size_t size = 0; size <= 1024; size += size < 64 ? 1 : 61)
+            {
+                const unsigned char *const dataPtr = data + offset;
+
+                // CRC-32 (legacy)
+                uint32_t expect = 0xffffffff;
+
+                for (size_t byteIdx = 0; byteIdx < size; byteIdx++)
+                    expect = crc32_lookup[((expect >> 24) ^ dataPtr[byteIdx]) & 0xFF] ^ (expect << 8);
+
+                if (crc32One(dataPtr, size) != (expect ^ 0xffffffff))
+                    match = false;
+
+                // CRC-32C
+                expect = 0xffffffff;
+
+                for (size_t byteIdx = 0; byteIdx < size; byteIdx++)
+                    expect = crc32c_lookup[(expect ^ dataPtr[byteIdx]) & 0xFF] ^ (expect >> 8);
+
+                if (crc32cCompSlice8(0xffffffff, dataPtr, size) != expect || crc32cComp(0xffffffff, dataPtr, size) != expect)
+                    match = false;
+
+#ifdef HAVE_CRC32C_SSE42
+                if (__builtin_cpu_supports("sse4.2") && crc32cCompSse42(0xffffffff, dataPtr, size) != expect)
+                    match = false;
+#endif
+
+                // CRC-32C split into two parts
+                const size_t split = size / 3;
+
+                if (crc32cFinish(crc32cComp(crc32cComp(crc32cInit(), dataPtr, split), dataPtr + split, size - split)) !=
+                        crc32cOne(dataPtr, size))
+                {
+                    match = false;
+                }
+            }
+        }
+
+        TEST_RESULT_BOOL(match, true, "all engines match");
+    }
+
     FUNCTION_HARNESS_RETURN_VOID();
 }
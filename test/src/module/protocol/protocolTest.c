@@ -1097,6 +1097,15 @@ testRun(void)
                 TEST_RESULT_BOOL(protocolParallelDone(parallel), true, "check done");
                 TEST_RESULT_BOOL(protocolParallelDone(parallel), true, "check still done");
 
+                // Job 1 was running while processing waited for the timeout with no result
+                TEST_RESULT_BOOL(protocolParallelClientBusyTime(parallel, 0) >= 2000, true, "check client 1 busy time");
+                TEST_RESULT_BOOL(
+                    protocolParallelClientIdleTime(parallel, 0) < protocolParallelClientBusyTime(parallel, 0), true,
+                    "check client 1 idle time");
+
+                // Client 2 ran out of jobs while job 1 was still running
+                TEST_RESULT_BOOL(protocolParallelTailTime(parallel) >= 2000, true, "check tail time");
+
                 TEST_RESULT_VOID(protocolParallelFree(parallel), "free parallel");
 
                 // -----------------------------------------------------------------------------------------------------------------
@@ -32,6 +32,7 @@ typedef struct TestRequestParam
     VAR_PARAM_HEADER;
     const char *content;
     const char *blobType;
+    const char *ifMatch;
     const char *range;
     const char *tag;
 } TestRequestParam;
@@ -87,6 +88,10 @@ testRequest(IoWrite *write, const char *verb, const char *path, TestRequestParam
     // Add host
     strCatFmt(request, "host:%s\r\n", strZ(hrnServerHost()));
 
+    // Add if-match
+    if (param.ifMatch != NULL)
+        strCatFmt(request, "if-match:%s\r\n", param.ifMatch);
+
     // Add range
     if (param.range != NULL)
         strCatFmt(request, "range:bytes=%s\r\n", param.range);
@@ -120,6 +125,7 @@ typedef struct TestResponseParam
 {
     VAR_PARAM_HEADER;
     unsigned int code;
+    const char *http;
     const char *header;
     const char *content;
 } TestResponseParam;
@@ -134,7 +140,7 @@ testResponse(IoWrite *write, TestResponseParam param)
     param.code = param.code == 0 ? 200 : param.code;
 
     // Output header and code
-    String *response = strCatFmt(strNew(), "HTTP/1.1 %u ", param.code);
+    String *response = strCatFmt(strNew(), "HTTP/%s %u ", param.http == NULL ? "1.1" : param.http, param.code);
 
     // Add reason for some codes
     switch (param.code)
@@ -146,6 +152,10 @@ testResponse(IoWrite *write, TestResponseParam param)
         case 403:
             strCatZ(response, "Forbidden");
             break;
+
+        case 412:
+            strCatZ(response, "Precondition Failed");
+            break;
     }
 
     // End header
@@ -398,8 +408,8 @@ testRun(void)
             (StorageAzure *)storageDriver(
                 storageAzureNew(
                     STRDEF("/repo"), false, NULL, TEST_CONTAINER_STR, TEST_ACCOUNT_STR, storageAzureKeyTypeShared,
-                    TEST_KEY_SHARED_STR, 16, NULL, STRDEF("blob.core.windows.net"), storageAzureUriStyleHost, 443, 1000, true, NULL,
-                    NULL)),
+                    TEST_KEY_SHARED_STR, 16, 1, 16, 1, NULL, STRDEF("blob.core.windows.net"), storageAzureUriStyleHost, 443, 1000,
+                    true, NULL, NULL)),
             "new azure storage - shared key");
 
         // -------------------------------------------------------------------------------------------------------------------------
@@ -440,7 +450,8 @@ testRun(void)
             (StorageAzure *)storageDriver(
                 storageAzureNew(
                     STRDEF("/repo"), false, NULL, TEST_CONTAINER_STR, TEST_ACCOUNT_STR, storageAzureKeyTypeSas, TEST_KEY_SAS_STR,
-                    16, NULL, STRDEF("blob.core.usgovcloudapi.net"), storageAzureUriStyleHost, 443, 1000, true, NULL, NULL)),
+                    16, 1, 16, 1, NULL, STRDEF("blob.core.usgovcloudapi.net"), storageAzureUriStyleHost, 443, 1000, true, NULL,
+                    NULL)),
             "new azure storage - sas key");
 
         query = httpQueryAdd(httpQueryNewP(), STRDEF("a"), STRDEF("b"));
@@ -526,6 +537,132 @@ testRun(void)
                     strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .offset = 1, .limit = VARUINT64(21)))),
                     "this is a sample file", "get file");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file with offset and limit in chunks");
+
+                driver->readChunkSize = 8;
+                driver->readChunkMax = 2;
+
+                // The remaining chunks are requested on separate sessions for the ETag of the first chunk before the first chunk is
+                // read. Respond with HTTP 1.0 so the client closes each session and the harness can accept the next one.
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "1-8");
+                testResponseP(service, .http = "1.0", .header = "etag:\"0x8D1\"", .content = "this is ");
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .ifMatch = "\"0x8D1\"", .range = "9-16");
+                testResponseP(service, .http = "1.0", .content = "a sample");
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .ifMatch = "\"0x8D1\"", .range = "17-21");
+                testResponseP(service, .http = "1.0", .content = " file");
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                TEST_RESULT_STR_Z(
+                    strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .offset = 1, .limit = VARUINT64(21)))),
+                    "this is a sample file", "get file");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file in chunks without an ETag and read chunks in parts");
+
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "0-7");
+                testResponseP(service, .http = "1.0", .content = "this is ");
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "8-15");
+                testResponseP(service, .content = "a sample");
+
+                // Only the read buffer is small so the chunks are read in parts but the HTTP sessions can still read whole lines
+                const size_t bufferSize = ioBufferSize();
+                ioBufferSizeSet(5);
+
+                StorageRead *readPart = NULL;
+                TEST_ASSIGN(readPart, storageNewReadP(storage, STRDEF("file.txt"), .limit = VARUINT64(16)), "new read");
+
+                ioBufferSizeSet(bufferSize);
+
+                TEST_RESULT_BOOL(ioReadOpen(storageReadIo(readPart)), true, "open");
+
+                Buffer *const part = bufNew(5);
+                Buffer *const content = bufNew(0);
+
+                do
+                {
+                    bufUsedZero(part);
+                    ioRead(storageReadIo(readPart), part);
+                    bufCat(content, part);
+                }
+                while (!ioReadEof(storageReadIo(readPart)));
+
+                TEST_RESULT_STR_Z(strNewBuf(content), "this is a sample", "read in parts");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file without chunks when there is no limit or the limit is not larger than the chunk size");
+
+                testRequestP(service, HTTP_VERB_GET, "/file.txt");
+                testResponseP(service, .content = "this is a sample file");
+
+                TEST_RESULT_STR_Z(
+                    strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt")))), "this is a sample file", "get file");
+
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "0-7");
+                testResponseP(service, .content = "this is ");
+
+                TEST_RESULT_STR_Z(
+                    strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .limit = VARUINT64(8)))), "this is ",
+                    "get file");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("error when file changes during read in chunks");
+
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "1-8");
+                testResponseP(service, .http = "1.0", .header = "etag:\"0x8D1\"", .content = "this is ");
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .ifMatch = "\"0x8D1\"", .range = "9-16");
+                testResponseP(service, .http = "1.0", .code = 412);
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                TEST_ERROR_FMT(
+                    storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .offset = 1, .limit = VARUINT64(16))), ProtocolError,
+                    "HTTP request failed with 412 (Precondition Failed):\n"
+                    "*** Path/Query ***:\n"
+                    "GET /account/container/file.txt\n"
+                    "*** Request Headers ***:\n"
+                    "authorization: <redacted>\n"
+                    "content-length: 0\n"
+                    "date: <redacted>\n"
+                    "host: %s\n"
+                    "if-match: \"0x8D1\"\n"
+                    "range: bytes=9-16\n"
+                    "x-ms-version: 2019-12-12",
+                    strZ(hrnServerHost()));
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("ignore missing file read in chunks");
+
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "1-8");
+                testResponseP(service, .code = 404);
+
+                TEST_RESULT_PTR(
+                    storageGetP(
+                        storageNewReadP(storage, STRDEF("file.txt"), .ignoreMissing = true, .offset = 1, .limit = VARUINT64(21))),
+                    NULL, "get file");
+
+                driver->readChunkSize = 8 * 1024 * 1024;
+                driver->readChunkMax = 1;
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("get zero-length file");
 
@@ -680,6 +817,47 @@ testRun(void)
                 TEST_ASSIGN(write, storageNewWriteP(storage, STRDEF("file.txt")), "new write");
                 TEST_RESULT_VOID(storagePutP(write, BUFSTRDEF("12345678901234567890")), "write");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("write file in chunks with multiple blocks in flight");
+
+                driver->blockMax = 2;
+
+                // The first two blocks are sent on separate sessions before either response is read. Respond with HTTP 1.0 so
+                // the client closes each session and the harness can accept the next one.
+                testRequestP(
+                    service, HTTP_VERB_PUT, "/file.txt?blockid=0AAAAAAACCCCCCCEx0000000&comp=block", .content = "1234567890123456");
+                testResponseP(service, .http = "1.0");
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                testRequestP(
+                    service, HTTP_VERB_PUT, "/file.txt?blockid=0AAAAAAACCCCCCCEx0000001&comp=block", .content = "7890123456789012");
+                testResponseP(service, .http = "1.0");
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                testRequestP(
+                    service, HTTP_VERB_PUT, "/file.txt?blockid=0AAAAAAACCCCCCCEx0000002&comp=block", .content = "3456");
+                testResponseP(service);
+
+                testRequestP(
+                    service, HTTP_VERB_PUT, "/file.txt?comp=blocklist",
+                    .content =
+                        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                        "<BlockList>"
+                        "<Uncommitted>0AAAAAAACCCCCCCEx0000000</Uncommitted>"
+                        "<Uncommitted>0AAAAAAACCCCCCCEx0000001</Uncommitted>"
+                        "<Uncommitted>0AAAAAAACCCCCCCEx0000002</Uncommitted>"
+                        "</BlockList>\n");
+                testResponseP(service);
+
+                TEST_ASSIGN(write, storageNewWriteP(storage, STRDEF("file.txt")), "new write");
+                TEST_RESULT_VOID(storagePutP(write, BUFSTRDEF("123456789012345678901234567890123456")), "write");
+
+                driver->blockMax = 1;
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("info for / does not exist");
 
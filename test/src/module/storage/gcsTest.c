@@ -151,6 +151,7 @@ typedef struct TestResponseParam
     VAR_PARAM_HEADER;
     unsigned int code;
     bool multiPart;
+    const char *http;
     const char *header;
     const char *content;
 } TestResponseParam;
@@ -165,7 +166,7 @@ testResponse(IoWrite *write, TestResponseParam param)
     param.code = param.code == 0 ? 200 : param.code;
 
     // Output header and code
-    String *response = strCatFmt(strNew(), "HTTP/1.1 %u ", param.code);
+    String *response = strCatFmt(strNew(), "HTTP/%s %u ", param.http == NULL ? "1.1" : param.http, param.code);
 
     // Add reason for some codes
     switch (param.code)
@@ -260,7 +261,7 @@ testRun(void)
             (StorageGcs *)storageDriver(
                 storageGcsNew(
                     STRDEF("/repo"), false, NULL, TEST_BUCKET_STR, storageGcsKeyTypeService, TEST_KEY_FILE_STR, TEST_CHUNK_SIZE,
-                    NULL, TEST_ENDPOINT_STR, TEST_TIMEOUT, true, NULL, NULL)),
+                    TEST_CHUNK_SIZE, 1, NULL, TEST_ENDPOINT_STR, TEST_TIMEOUT, true, NULL, NULL)),
             "read-only gcs storage - service key");
         TEST_RESULT_STR_Z(httpUrlHost(storage->authUrl), "test.com", "check host");
         TEST_RESULT_STR_Z(httpUrlPath(storage->authUrl), "/token", "check path");
@@ -285,7 +286,7 @@ testRun(void)
             (StorageGcs *)storageDriver(
                 storageGcsNew(
                     STRDEF("/repo"), true, NULL, TEST_BUCKET_STR, storageGcsKeyTypeService, TEST_KEY_FILE_STR, TEST_CHUNK_SIZE,
-                    NULL, TEST_ENDPOINT_STR, TEST_TIMEOUT, true, NULL, NULL)),
+                    TEST_CHUNK_SIZE, 1, NULL, TEST_ENDPOINT_STR, TEST_TIMEOUT, true, NULL, NULL)),
             "read/write gcs storage - service key");
 
         TEST_RESULT_STR_Z(
@@ -445,6 +446,40 @@ testRun(void)
                     strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .offset = 1, .limit = VARUINT64(21)))),
                     "this is a sample file", "get file");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file with offset and limit in chunks");
+
+                ((StorageGcs *)storageDriver(storage))->readChunkSize = 8;
+                ((StorageGcs *)storageDriver(storage))->readChunkMax = 2;
+
+                // The remaining chunks are requested on separate sessions for the generation of the first chunk before the first
+                // chunk is read. Respond with HTTP 1.0 so the client closes each session and the harness can accept the next one.
+                testRequestP(service, HTTP_VERB_GET, .object = "file.txt", .query = "alt=media", .range = "1-8");
+                testResponseP(service, .http = "1.0", .header = "x-goog-generation:1700000000000001", .content = "this is ");
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                testRequestP(
+                    service, HTTP_VERB_GET, .object = "file.txt", .query = "alt=media&ifGenerationMatch=1700000000000001",
+                    .range = "9-16");
+                testResponseP(service, .http = "1.0", .content = "a sample");
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                testRequestP(
+                    service, HTTP_VERB_GET, .object = "file.txt", .query = "alt=media&ifGenerationMatch=1700000000000001",
+                    .range = "17-21");
+                testResponseP(service, .content = " file");
+
+                TEST_RESULT_STR_Z(
+                    strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .offset = 1, .limit = VARUINT64(21)))),
+                    "this is a sample file", "get file");
+
+                ((StorageGcs *)storageDriver(storage))->readChunkSize = 8 * 1024 * 1024;
+                ((StorageGcs *)storageDriver(storage))->readChunkMax = 1;
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("switch to auto auth");
 
@@ -0,0 +1,122 @@
+/***********************************************************************************************************************************
+Test Posix Storage Compatibility
+***********************************************************************************************************************************/
+#include <errno.h>
+#include <fcntl.h>
+
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+#include "storage/posix/storage.h"
+
+#include "common/harnessStorage.h"
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+static void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    // *****************************************************************************************************************************
+    if (testBegin("posixCompatOpenDirect() and posixCompatAdvise()"))
+    {
+        HRN_STORAGE_PUT_Z(storagePosixNewP(TEST_PATH_STR, .write = true), "file", "TESTFILE");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("open with direct I/O");
+
+        const int fd = posixCompatOpenDirect(TEST_PATH "/file", O_RDONLY);
+        TEST_RESULT_BOOL(fd != -1 || errno == EINVAL, true, "open file");
+
+        if (fd != -1)
+            close(fd);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("open missing file with direct I/O");
+
+        TEST_RESULT_INT(posixCompatOpenDirect(TEST_PATH "/missing", O_RDONLY), -1, "open missing file");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("advise");
+
+        const int fdAdvise = open(TEST_PATH "/file", O_RDONLY, 0);
+        TEST_RESULT_BOOL(fdAdvise != -1, true, "open file");
+
+        TEST_RESULT_VOID(posixCompatAdvise(fdAdvise, 0, 0, posixCompatAdviseSequential), "sequential");
+        TEST_RESULT_VOID(posixCompatAdvise(fdAdvise, 0, 8, posixCompatAdviseWillNeed), "will need");
+        TEST_RESULT_VOID(posixCompatAdvise(fdAdvise, 0, 0, posixCompatAdviseDontNeed), "don't need");
+
+        close(fdAdvise);
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("posixCompatCloneFile() and posixCompatCopyFileRange()"))
+    {
+        const int fdSource = open(TEST_PATH "/source", O_RDWR | O_CREAT, 0640);
+        TEST_RESULT_BOOL(fdSource != -1, true, "open source");
+        TEST_RESULT_INT(write(fdSource, "TESTFILE", 8), 8, "write source");
+
+        const int fdDest = open(TEST_PATH "/dest", O_WRONLY | O_CREAT, 0640);
+        TEST_RESULT_BOOL(fdDest != -1, true, "open destination");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("clone fails when the destination is not a regular file");
+
+        const int fdPath = open(TEST_PATH, O_RDONLY, 0);
+
+        TEST_RESULT_INT(posixCompatCloneFile(fdPath, fdSource), -1, "clone to path");
+
+        close(fdPath);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy range");
+
+        off_t offsetSource = 4;
+
+        TEST_RESULT_INT(posixCompatCopyFileRange(fdSource, &offsetSource, fdDest, 8), 4, "copy");
+        TEST_RESULT_INT(offsetSource, 8, "check source offset");
+        TEST_STORAGE_GET(storagePosixNewP(TEST_PATH_STR), "dest", "FILE");
+
+        close(fdSource);
+        close(fdDest);
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("posixCompatUringSetup() and posixCompatUringEnter()"))
+    {
+#ifdef HAVE_IO_URING
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("setup fails with invalid depth");
+
+        struct io_uring_params params = {0};
+
+        TEST_RESULT_INT(posixCompatUringSetup(0, &params), -1, "setup");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("enter fails with invalid file descriptor");
+
+        TEST_RESULT_INT(posixCompatUringEnter(-1, 0, 0, 0), -1, "enter");
+#endif // HAVE_IO_URING
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("posixCompatSync() and posixCompatSyncFs()"))
+    {
+        const int fd = open(TEST_PATH, O_RDONLY, 0);
+        TEST_RESULT_BOOL(fd != -1, true, "open path");
+
+        TEST_RESULT_VOID(posixCompatSync(), "sync");
+#ifdef HAVE_SYNCFS
+        TEST_RESULT_INT(posixCompatSyncFs(fd), 0, "sync file system");
+#else
+        TEST_RESULT_BOOL(posixCompatSyncFs(fd) == -1 && errno == ENOSYS, true, "sync file system not supported");
+#endif
+
+        close(fd);
+    }
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
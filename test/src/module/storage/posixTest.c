@@ -1,6 +1,7 @@
 /***********************************************************************************************************************************
 Test Posix/CIFS Storage
 ***********************************************************************************************************************************/
+#include "common/io/filter/size.h"
 #include "common/io/io.h"
 #include "common/time.h"
 #include "storage/read.h"
@@ -8,6 +9,7 @@ Test Posix/CIFS Storage
 
 #include "common/harnessConfig.h"
 #include "common/harnessFork.h"
+#include "common/harnessPosixCompat.h"
 #include "common/harnessStorage.h"
 
 /***********************************************************************************************************************************
@@ -600,6 +602,95 @@ testRun(void)
         TEST_RESULT_BOOL(storageCopyP(source, destination), true, "copy file");
         TEST_RESULT_BOOL(bufEq(expectedBuffer, storageGetP(storageNewReadP(storageTest, destinationFile))), true, "check file");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy - offset and limit");
+
+        source = storageNewReadP(storageTest, sourceFile, .offset = 4, .limit = VARUINT64(3));
+        destination = storageNewWriteP(storageTest, destinationFile);
+
+        TEST_RESULT_BOOL(storageCopyP(source, destination), true, "copy file");
+        TEST_STORAGE_GET(storageTest, strZ(destinationFile), "FIL");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy - filters require copy through the io interface");
+
+        source = storageNewReadP(storageTest, sourceFile);
+        destination = storageNewWriteP(storageTest, destinationFile);
+        ioFilterGroupAdd(ioWriteFilterGroup(storageWriteIo(destination)), ioSizeNew());
+
+        TEST_RESULT_BOOL(storageCopyP(source, destination), true, "copy file");
+        TEST_RESULT_UINT(
+            pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(storageWriteIo(destination)), SIZE_FILTER_TYPE)), 9, "check size");
+        TEST_STORAGE_GET(storageTest, strZ(destinationFile), "TESTFILE\n");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy - kernel copy not supported");
+
+        source = storageNewReadP(storagePosixNewP(FSLASH_STR), STRDEF("/dev/zero"), .limit = VARUINT64(10));
+        destination = storageNewWriteP(storageTest, destinationFile);
+
+        TEST_RESULT_BOOL(storageCopyP(source, destination), true, "copy file");
+        TEST_RESULT_BOOL(
+            bufEq(bufNewC("\0\0\0\0\0\0\0\0\0\0", 10), storageGetP(storageNewReadP(storageTest, destinationFile))), true,
+            "check file");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy - clone");
+
+        hrnPosixCompatCloneFileShimInstall(0);
+
+        source = storageNewReadP(storageTest, sourceFile);
+        destination = storageNewWriteP(storageTest, destinationFile);
+
+        TEST_RESULT_BOOL(storageCopyP(source, destination), true, "copy file");
+        TEST_STORAGE_GET(storageTest, strZ(destinationFile), "TESTFILE\n");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy - fall back when clone and kernel copy are not supported");
+
+        const int errNoList[] = {ENOSYS, EXDEV, EOPNOTSUPP};
+
+        for (unsigned int errNoIdx = 0; errNoIdx < LENGTH_OF(errNoList); errNoIdx++)
+        {
+            hrnPosixCompatCloneFileShimInstall(errNoList[errNoIdx]);
+            hrnPosixCompatCopyFileRangeShimInstall(errNoList[errNoIdx], 0);
+
+            source = storageNewReadP(storageTest, sourceFile);
+            destination = storageNewWriteP(storageTest, destinationFile);
+
+            TEST_RESULT_BOOL(storageCopyP(source, destination), true, zNewFmt("copy file [%d]", errNoList[errNoIdx]));
+            TEST_STORAGE_GET(storageTest, strZ(destinationFile), "TESTFILE\n");
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy - kernel copy error");
+
+        hrnPosixCompatCloneFileShimInstall(EOPNOTSUPP);
+        hrnPosixCompatCopyFileRangeShimInstall(EIO, 0);
+
+        source = storageNewReadP(storageTest, sourceFile);
+        destination = storageNewWriteP(storageTest, destinationFile);
+
+        TEST_ERROR_FMT(
+            storageCopyP(source, destination), FileWriteError,
+            "unable to copy '%s' to '%s." STORAGE_FILE_TEMP_EXT "': [5] Input/output error", strZ(sourceFile),
+            strZ(destinationFile));
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("copy - kernel copy not supported after part of the file was copied");
+
+        hrnPosixCompatCopyFileRangeShimInstall(EXDEV, 1);
+
+        source = storageNewReadP(storageTest, sourceFile);
+        destination = storageNewWriteP(storageTest, destinationFile);
+
+        TEST_ERROR_FMT(
+            storageCopyP(source, destination), FileWriteError,
+            "unable to copy '%s' to '%s." STORAGE_FILE_TEMP_EXT "': [18] Invalid cross-device link", strZ(sourceFile),
+            strZ(destinationFile));
+
+        hrnPosixCompatShimUninstall();
+
         storageRemoveP(storageTest, sourceFile, .errorOnMissing = true);
         storageRemoveP(storageTest, destinationFile, .errorOnMissing = true);
     }
@@ -882,6 +973,25 @@ testRun(void)
 
         TEST_RESULT_VOID(storagePathCreateP(storageTest, pathName), "create path to sync");
         TEST_RESULT_VOID(storagePathSyncP(storageTest, pathName), "sync path");
+        TEST_RESULT_VOID(storagePathSyncP(storageTest, pathName, .fileSystem = true), "sync file system");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("file system sync - fall back to sync() when syncfs() is not supported");
+
+        hrnPosixCompatSyncFsShimInstall(ENOSYS);
+
+        TEST_RESULT_VOID(storagePathSyncP(storageTest, pathName, .fileSystem = true), "sync all file systems");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("file system sync - error");
+
+        hrnPosixCompatSyncFsShimInstall(EIO);
+
+        TEST_ERROR_FMT(
+            storagePathSyncP(storageTest, pathName, .fileSystem = true), PathSyncError,
+            STORAGE_ERROR_PATH_SYNC ": [5] Input/output error", strZ(pathName));
+
+        hrnPosixCompatShimUninstall();
     }
 
     // *****************************************************************************************************************************
@@ -1433,6 +1543,257 @@ testRun(void)
         TEST_RESULT_INT(storageInfoP(storageTest, STRDEF("no-truncate")).timeModified, 77777, "check time");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("StorageRead and StorageWrite with io_uring"))
+    {
+#ifdef HAVE_IO_URING
+        Storage *const storageUring = storagePosixNewP(TEST_PATH_STR, .write = true, .ioUring = true);
+        StoragePosix *const driver = storageDriver(storageUring);
+        ioBufferSizeSet(8);
+
+        // Skip the test when io_uring is not available
+        PosixUring *const uring = storagePosixUringClaim(driver);
+
+        if (uring != NULL)
+        {
+            storagePosixUringRelease(driver);
+
+            const Buffer *const content = BUFSTRDEF("0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmn");
+            const String *const fileName = STRDEF(TEST_PATH "/uring.file");
+
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE("write behind");
+
+            StorageWrite *write = NULL;
+
+            TEST_ASSIGN(write, storageNewWriteP(storageUring, fileName), "new write file");
+            TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(write)), "open file");
+            TEST_RESULT_BOOL(driver->uringClaimed, true, "io_uring claimed");
+            TEST_RESULT_VOID(ioWrite(storageWriteIo(write), content), "write to file");
+            TEST_RESULT_VOID(ioWriteClose(storageWriteIo(write)), "close file");
+            TEST_RESULT_BOOL(driver->uringClaimed, false, "io_uring released");
+
+            TEST_STORAGE_GET(storageUring, strZ(fileName), strZ(strNewBuf(content)));
+
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE("write behind then seek with file descriptor");
+
+            TEST_ASSIGN(write, storageNewWriteP(storageUring, fileName, .noAtomic = true), "new write file");
+            TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(write)), "open file");
+            TEST_RESULT_VOID(ioWrite(storageWriteIo(write), BUFSTRDEF("0123456789ABCDEFGHIJKLMNOPQRSTUVWX")), "write to file");
+            TEST_RESULT_VOID(ioWriteFlush(storageWriteIo(write)), "flush file");
+
+            const int fd = ioWriteFd(storageWriteIo(write));
+            TEST_RESULT_BOOL(driver->uringClaimed, false, "io_uring released");
+            TEST_RESULT_INT(lseek(fd, 0, SEEK_CUR), 34, "file position after writes");
+            TEST_RESULT_INT(lseek(fd, 2, SEEK_SET), 2, "seek");
+            TEST_RESULT_VOID(ioWrite(storageWriteIo(write), BUFSTRDEF("xy")), "write to file");
+            TEST_RESULT_VOID(ioWriteClose(storageWriteIo(write)), "close file");
+
+            TEST_STORAGE_GET(storageUring, strZ(fileName), "01xy456789ABCDEFGHIJKLMNOPQRSTUVWX");
+
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE("write error");
+
+            TEST_ASSIGN(write, storageNewWriteP(storageUring, fileName, .noAtomic = true), "new write file");
+            TEST_RESULT_VOID(ioWriteOpen(storageWriteIo(write)), "open file");
+            TEST_RESULT_VOID(storageWritePosix(write->driver, BUFSTRDEF("01234567")), "write to file");
+
+            // Replace the file descriptor with a read-only descriptor so the queued write fails
+            const int fdReadOnly = open("/dev/null", O_RDONLY);
+            const int fdWrite = ((StorageWritePosix *)write->driver)->fd;
+
+            TEST_RESULT_INT(dup2(fdReadOnly, fdWrite), fdWrite, "replace file descriptor");
+            close(fdReadOnly);
+
+            TEST_RESULT_VOID(storageWritePosix(write->driver, BUFSTRDEF("89ABCDEF")), "queue write");
+            TEST_ERROR_FMT(
+                storageWritePosixClose(write->driver), FileWriteError, "unable to write '%s': [9] Bad file descriptor",
+                strZ(fileName));
+            TEST_RESULT_VOID(storageWriteFree(write), "free file");
+            TEST_RESULT_BOOL(driver->uringClaimed, false, "io_uring released");
+
+            HRN_STORAGE_PUT(storageUring, strZ(fileName), content);
+
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE("read ahead");
+
+            StorageRead *read = NULL;
+
+            TEST_ASSIGN(read, storageNewReadP(storageUring, fileName), "new read file");
+            TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open file");
+            TEST_RESULT_UINT(((StorageReadPosix *)read->driver)->slotTotal, 7, "slot total");
+            TEST_RESULT_BOOL(bufEq(ioReadBuf(storageReadIo(read)), content), true, "check content");
+            TEST_RESULT_BOOL(driver->uringClaimed, false, "io_uring released");
+
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE("read ahead into a small buffer with offset and limit");
+
+            Buffer *const outBuffer = bufNew(3);
+            Buffer *const buffer = bufNew(0);
+
+            TEST_ASSIGN(
+                read, storageNewReadP(storageUring, fileName, .offset = 2, .limit = VARUINT64(40)), "new read file");
+            TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open file");
+
+            do
+            {
+                bufUsedZero(outBuffer);
+                ioRead(storageReadIo(read), outBuffer);
+                bufCat(buffer, outBuffer);
+            }
+            while (!ioReadEof(storageReadIo(read)));
+
+            TEST_RESULT_STR_Z(strNewBuf(buffer), "23456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdef", "check content");
+            TEST_RESULT_VOID(ioReadClose(storageReadIo(read)), "close file");
+
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE("read ahead of file that is a multiple of the buffer size");
+
+            HRN_STORAGE_PUT_Z(storageUring, strZ(fileName), "0123456789ABCDEFGHIJKLMNOPQRSTUV");
+
+            TEST_ASSIGN(read, storageNewReadP(storageUring, fileName), "new read file");
+            TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open file");
+            TEST_RESULT_UINT(((StorageReadPosix *)read->driver)->slotTotal, 5, "slot total");
+            TEST_RESULT_STR_Z(strNewBuf(ioReadBuf(storageReadIo(read))), "0123456789ABCDEFGHIJKLMNOPQRSTUV", "check content");
+
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE("small file is not read ahead");
+
+            HRN_STORAGE_PUT_Z(storageUring, strZ(fileName), "0123");
+
+            TEST_ASSIGN(read, storageNewReadP(storageUring, fileName), "new read file");
+            TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open file");
+            TEST_RESULT_PTR(((StorageReadPosix *)read->driver)->uring, NULL, "no read ahead");
+            TEST_RESULT_BOOL(driver->uringClaimed, false, "io_uring released");
+            TEST_RESULT_STR_Z(strNewBuf(ioReadBuf(storageReadIo(read))), "0123", "check content");
+
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE("second read does not read ahead while io_uring is claimed");
+
+            HRN_STORAGE_PUT(storageUring, strZ(fileName), content);
+
+            StorageRead *read2 = NULL;
+
+            TEST_ASSIGN(read, storageNewReadP(storageUring, fileName), "new read file");
+            TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open file");
+            TEST_ASSIGN(read2, storageNewReadP(storageUring, fileName), "new read file");
+            TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read2)), true, "open file");
+            TEST_RESULT_PTR(((StorageReadPosix *)read2->driver)->uring, NULL, "no read ahead");
+            TEST_RESULT_BOOL(bufEq(ioReadBuf(storageReadIo(read2)), content), true, "check content");
+            TEST_RESULT_VOID(storageReadFree(read), "free file before reads complete");
+            TEST_RESULT_BOOL(driver->uringClaimed, false, "io_uring released");
+
+            // ---------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE("read error");
+
+            TEST_ASSIGN(read, storageNewReadP(storageUring, TEST_PATH_STR), "new read path");
+            TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open path");
+            TEST_ERROR_FMT(
+                ioRead(storageReadIo(read), outBuffer), FileReadError, "unable to read '%s': [21] Is a directory", TEST_PATH);
+            TEST_RESULT_VOID(storageReadFree(read), "free path");
+            TEST_RESULT_BOOL(driver->uringClaimed, false, "io_uring released");
+
+            HRN_STORAGE_REMOVE(storageUring, strZ(fileName));
+        }
+#endif // HAVE_IO_URING
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("StorageRead and StorageWrite bypassing the page cache"))
+    {
+        Storage *const storageDirect = storagePosixNewP(TEST_PATH_STR, .write = true, .direct = true);
+        const String *const fileName = STRDEF(TEST_PATH "/direct.file");
+        ioBufferSizeSet(4000);
+
+        Buffer *const content = bufNew(10000);
+
+        for (unsigned int contentIdx = 0; contentIdx < bufSize(content); contentIdx++)
+            bufPtr(content)[contentIdx] = (unsigned char)('a' + contentIdx % 26);
+
+        bufUsedSet(content, bufSize(content));
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write file and drop from page cache");
+
+        TEST_RESULT_VOID(storagePutP(storageNewWriteP(storageDirect, fileName), content), "put file");
+        TEST_STORAGE_GET(storageDirect, strZ(fileName), strZ(strNewBuf(content)));
+
+        TEST_RESULT_VOID(storagePutP(storageNewWriteP(storageDirect, fileName, .noSyncFile = true), content), "put file");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("missing file");
+
+        TEST_RESULT_BOOL(
+            ioReadOpen(storageReadIo(storageNewReadP(storageDirect, STRDEF(BOGUS_STR), .ignoreMissing = true))), false,
+            "open missing file");
+
+        StorageRead *read = NULL;
+
+#ifdef HAVE_O_DIRECT
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("direct read");
+
+        TEST_ASSIGN(read, storageNewReadP(storageDirect, fileName), "new read file");
+        TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open file");
+        TEST_RESULT_BOOL(((StorageReadPosix *)read->driver)->directBuffer != NULL, true, "direct read");
+        TEST_RESULT_UINT(((StorageReadPosix *)read->driver)->directSize, 4096, "direct read size");
+        TEST_RESULT_UINT((uintptr_t)((StorageReadPosix *)read->driver)->directPtr % 4096, 0, "direct read buffer aligned");
+        TEST_RESULT_BOOL(bufEq(ioReadBuf(storageReadIo(read)), content), true, "check content");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("direct read into a small buffer with offset and limit");
+
+        Buffer *const outBuffer = bufNew(1000);
+        Buffer *const buffer = bufNew(0);
+
+        TEST_ASSIGN(read, storageNewReadP(storageDirect, fileName, .offset = 4100, .limit = VARUINT64(5000)), "new read file");
+        TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open file");
+
+        do
+        {
+            bufUsedZero(outBuffer);
+            ioRead(storageReadIo(read), outBuffer);
+            bufCat(buffer, outBuffer);
+        }
+        while (!ioReadEof(storageReadIo(read)));
+
+        TEST_RESULT_BOOL(bufEq(buffer, BUF(bufPtrConst(content) + 4100, 5000)), true, "check content");
+        TEST_RESULT_VOID(ioReadClose(storageReadIo(read)), "close file");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("direct read of file that is a multiple of the block size");
+
+        HRN_STORAGE_PUT(storageDirect, strZ(fileName), BUF(bufPtrConst(content), 8192));
+
+        TEST_ASSIGN(read, storageNewReadP(storageDirect, fileName, .offset = 8192), "new read file");
+        TEST_RESULT_UINT(bufUsed(storageGetP(read)), 0, "check content");
+
+        TEST_ASSIGN(read, storageNewReadP(storageDirect, fileName), "new read file");
+        TEST_RESULT_BOOL(bufEq(storageGetP(read), BUF(bufPtrConst(content), 8192)), true, "check content");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("direct read error");
+
+        TEST_ASSIGN(read, storageNewReadP(storageDirect, TEST_PATH_STR), "new read path");
+        TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open path");
+        TEST_ERROR_FMT(
+            ioRead(storageReadIo(read), outBuffer), FileReadError, "unable to read '%s': [21] Is a directory", TEST_PATH);
+#endif // HAVE_O_DIRECT
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("drop pages from the page cache when direct I/O is not supported");
+
+        TEST_ASSIGN(read, storageNewReadP(storagePosixNewP(STRDEF("/dev"), .direct = true), STRDEF("zero"), .limit = VARUINT64(10)),
+            "new read file");
+        TEST_RESULT_BOOL(ioReadOpen(storageReadIo(read)), true, "open file");
+        TEST_RESULT_PTR(((StorageReadPosix *)read->driver)->directBuffer, NULL, "no direct read");
+        TEST_RESULT_BOOL(((StorageReadPosix *)read->driver)->dropCache, true, "drop pages");
+        TEST_RESULT_BOOL(bufEq(ioReadBuf(storageReadIo(read)), BUF((const unsigned char[10]){0}, 10)), true, "check content");
+
+        HRN_STORAGE_REMOVE(storageDirect, strZ(fileName));
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("storageLocal() and storageLocalWrite()"))
     {
@@ -581,6 +581,7 @@ testRun(void)
         const String *path = STRDEF("testpath");
         TEST_RESULT_VOID(storagePathCreateP(storageRepoWrite, path), "new path");
         TEST_RESULT_VOID(storagePathSyncP(storageRepoWrite, path), "sync path");
+        TEST_RESULT_VOID(storagePathSyncP(storageRepoWrite, path, .fileSystem = true), "sync file system");
     }
 
     // *****************************************************************************************************************************
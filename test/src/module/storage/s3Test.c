@@ -27,6 +27,7 @@ typedef struct TestRequestParam
     const char *content;
     const char *accessKey;
     const char *securityToken;
+    const char *ifMatch;
     const char *range;
     const char *kms;
     const char *sseC;
@@ -72,6 +73,9 @@ testRequest(IoWrite *write, Storage *s3, const char *verb, const char *path, Tes
 
         strCatZ(request, "host;");
 
+        if (param.ifMatch != NULL)
+            strCatZ(request, "if-match;");
+
         if (param.range != NULL)
             strCatZ(request, "range;");
 
@@ -118,6 +122,10 @@ testRequest(IoWrite *write, Storage *s3, const char *verb, const char *path, Tes
     else
         strCatFmt(request, "host:%s\r\n", strZ(hrnServerHost()));
 
+    // Add if-match
+    if (param.ifMatch != NULL)
+        strCatFmt(request, "if-match:%s\r\n", param.ifMatch);
+
     // Add range
     if (param.range != NULL)
         strCatFmt(request, "range:bytes=%s\r\n", param.range);
@@ -493,6 +501,69 @@ testRun(void)
                     strNewBuf(storageGetP(storageNewReadP(s3, STRDEF("file.txt"), .offset = 1, .limit = VARUINT64(21)))),
                     "this is a sample file", "get file");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file with offset and limit in chunks");
+
+                driver->readChunkSize = 8;
+                driver->readChunkMax = 2;
+
+                // The remaining chunks are requested on separate sessions for the ETag of the first chunk before the first chunk is
+                // read. Respond with HTTP 1.0 so the client closes each session and the harness can accept the next one.
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .range = "1-8");
+                testResponseP(service, .http = "1.0", .header = "etag:\"eTaG1\"", .content = "this is ");
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .ifMatch = "\"eTaG1\"", .range = "9-16");
+                testResponseP(service, .http = "1.0", .content = "a sample");
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .ifMatch = "\"eTaG1\"", .range = "17-21");
+                testResponseP(service, .content = " file");
+
+                TEST_RESULT_STR_Z(
+                    strNewBuf(storageGetP(storageNewReadP(s3, STRDEF("file.txt"), .offset = 1, .limit = VARUINT64(21)))),
+                    "this is a sample file", "get file");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("error when file changes during read in chunks");
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .range = "1-8");
+                testResponseP(service, .http = "1.0", .header = "etag:\"eTaG1\"", .content = "this is ");
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .ifMatch = "\"eTaG1\"", .range = "9-16");
+                testResponseP(service, .http = "1.0", .code = 412);
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                TEST_ERROR(
+                    storageGetP(storageNewReadP(s3, STRDEF("file.txt"), .offset = 1, .limit = VARUINT64(16))), ProtocolError,
+                    "HTTP request failed with 412:\n"
+                    "*** Path/Query ***:\n"
+                    "GET /file.txt\n"
+                    "*** Request Headers ***:\n"
+                    "authorization: <redacted>\n"
+                    "content-length: 0\n"
+                    "host: bucket." S3_TEST_HOST "\n"
+                    "if-match: \"eTaG1\"\n"
+                    "range: bytes=9-16\n"
+                    "x-amz-content-sha256: e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855\n"
+                    "x-amz-date: <redacted>\n"
+                    "x-amz-security-token: <redacted>");
+
+                driver->readChunkSize = 8 * 1024 * 1024;
+                driver->readChunkMax = 1;
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("get zero-length file");
 
@@ -922,6 +993,64 @@ testRun(void)
                 TEST_ASSIGN(write, storageNewWriteP(s3, STRDEF("file.txt")), "new write");
                 TEST_RESULT_VOID(storagePutP(write, BUFSTRDEF("12345678901234567890")), "write");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("write file in chunks with multiple parts in flight");
+
+                driver->partMax = 2;
+
+                testRequestP(service, s3, HTTP_VERB_POST, "/file.txt?uploads=", .kms = "kmskey1", .sseC = "rA1P");
+                testResponseP(
+                    service,
+                    .content =
+                        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                        "<InitiateMultipartUploadResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"
+                        "<Bucket>bucket</Bucket>"
+                        "<Key>file.txt</Key>"
+                        "<UploadId>PP77</UploadId>"
+                        "</InitiateMultipartUploadResult>");
+
+                // Part 1 is sent on the existing session and part 2 on a new session before the response to part 1 is read
+                testRequestP(
+                    service, s3, HTTP_VERB_PUT, "/file.txt?partNumber=1&uploadId=PP77", .content = "1234567890123456",
+                    .sseC = "rA1P");
+                testResponseP(service, .http = "1.0", .header = "etag:PP771");
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                testRequestP(
+                    service, s3, HTTP_VERB_PUT, "/file.txt?partNumber=2&uploadId=PP77", .content = "7890123456789012",
+                    .sseC = "rA1P");
+                testResponseP(service, .http = "1.0", .header = "etag:PP772");
+
+                hrnServerScriptClose(service);
+                hrnServerScriptAccept(service);
+
+                // Part 3 is sent on a new session after the response to part 1 has been read so the window is not exceeded
+                testRequestP(
+                    service, s3, HTTP_VERB_PUT, "/file.txt?partNumber=3&uploadId=PP77", .content = "3456", .sseC = "rA1P");
+                testResponseP(service, .header = "etag:PP773");
+
+                testRequestP(
+                    service, s3, HTTP_VERB_POST, "/file.txt?uploadId=PP77",
+                    .content =
+                        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                        "<CompleteMultipartUpload>"
+                        "<Part><PartNumber>1</PartNumber><ETag>PP771</ETag></Part>"
+                        "<Part><PartNumber>2</PartNumber><ETag>PP772</ETag></Part>"
+                        "<Part><PartNumber>3</PartNumber><ETag>PP773</ETag></Part>"
+                        "</CompleteMultipartUpload>\n");
+                testResponseP(
+                    service,
+                    .content =
+                        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                        "<CompleteMultipartUploadResult><ETag>XXX</ETag></CompleteMultipartUploadResult>");
+
+                TEST_ASSIGN(write, storageNewWriteP(s3, STRDEF("file.txt")), "new write");
+                TEST_RESULT_VOID(storagePutP(write, BUFSTRDEF("123456789012345678901234567890123456")), "write");
+
+                driver->partMax = 1;
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("file missing");
 